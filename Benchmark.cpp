@@ -0,0 +1,998 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <thread>
+#include "Simulation.h"
+#include "CpuSkinning.h"
+#include "DDSHeader.h"
+#include "TerrainMesh.h"
+#include "TerrainTileFile.h"
+
+namespace
+{
+	std::atomic<uint64_t> gAllocationCount{ 0 };
+	std::atomic<uint64_t> gAllocationBytes{ 0 };
+
+	using Clock = std::chrono::steady_clock;
+
+	double GetPercentile(const std::vector<double>& sorted, double percentile)
+	{
+		size_t rank = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+		return sorted[std::max<size_t>(rank, 1) - 1];
+	}
+
+	double ElapsedNs(Clock::time_point begin, Clock::time_point end)
+	{
+		return std::chrono::duration<double, std::nano>(end - begin).count();
+	}
+
+	// Just enough JSON for the files Save writes: an array of flat objects of strings and numbers.
+	class JsonCursor
+	{
+	public:
+		explicit JsonCursor(const std::string& text) : mText{ text } {}
+
+		bool Skip(char expected)
+		{
+			SkipSpace();
+			if (mPosition >= mText.size() || mText[mPosition] != expected) return false;
+			++mPosition;
+			return true;
+		}
+
+		bool Peek(char expected)
+		{
+			SkipSpace();
+			return mPosition < mText.size() && mText[mPosition] == expected;
+		}
+
+		bool ReadString(std::string& value)
+		{
+			if (!Skip('"')) return false;
+			value.clear();
+			while (mPosition < mText.size() && mText[mPosition] != '"')
+			{
+				if (mText[mPosition] == '\\' && mPosition + 1 < mText.size()) ++mPosition;
+				value += mText[mPosition++];
+			}
+			return Skip('"');
+		}
+
+		bool ReadNumber(double& value)
+		{
+			SkipSpace();
+			const char* begin = mText.c_str() + mPosition;
+			char* end = nullptr;
+			value = strtod(begin, &end);
+			if (end == begin) return false;
+			mPosition += end - begin;
+			return true;
+		}
+
+		bool Find(const std::string& text)
+		{
+			size_t position = mText.find(text, mPosition);
+			if (position == std::string::npos) return false;
+			mPosition = position + text.size();
+			return true;
+		}
+
+	private:
+		void SkipSpace()
+		{
+			while (mPosition < mText.size() && isspace(static_cast<unsigned char>(mText[mPosition]))) ++mPosition;
+		}
+
+		const std::string& mText;
+		size_t mPosition = 0;
+	};
+
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\') escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	std::string FormatChange(double before, double after)
+	{
+		char text[32];
+		snprintf(text, sizeof(text), "%+.1f%%", before > 0.0 ? (after / before - 1.0) * 100.0 : 0.0);
+		return text;
+	}
+
+	// Thread counts of the scaling benchmarks: 1, doubling, and last the hardware thread count.
+	std::vector<uint32_t> GetBenchmarkThreadCounts()
+	{
+		const uint32_t hardwareThreads = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+		std::vector<uint32_t> threadCounts;
+		for (uint32_t threads = 1; threads < hardwareThreads; threads *= 2) threadCounts.push_back(threads);
+		threadCounts.push_back(hardwareThreads);
+		return threadCounts;
+	}
+
+	// One line with the p50 speedup of the "<prefix>N threads" cases over 1 thread; empty without a 1 thread result.
+	std::string FormatScaling(const BenchmarkRunner& runner, const std::string& prefix)
+	{
+		double single = 0.0;
+		std::string line;
+		for (const BenchmarkResult& result : runner.GetResults())
+		{
+			if (result.name.compare(0, prefix.size(), prefix) != 0 || result.p50Ns <= 0.0) continue;
+			const std::string threads = result.name.substr(prefix.size());
+			if (threads == "1 threads") single = result.p50Ns;
+			if (single <= 0.0) continue;
+			char speedup[64];
+			snprintf(speedup, sizeof(speedup), "%s%s %.2fx", line.empty() ? "" : ", ", threads.c_str(), single / result.p50Ns);
+			line += speedup;
+		}
+		return line.empty() ? "" : "scaling " + prefix.substr(0, prefix.size() - 1) + ": " + line + "\n";
+	}
+
+	// The skinned meshes the game uses and the animations that move them.
+	const std::pair<std::string, std::string> BenchmarkSkinnedMeshes[] = { { "1P(boy-idle).fbx", "1P(boy-idle).fbx" }, { "0113_tiger.fbx", "0113_tiger_walk.fbx" } };
+	const std::string BenchmarkClipName = "Take 001";
+}
+
+#if BENCHMARK_COUNT_ALLOCATIONS
+// Replaces the global allocation functions for the whole program so benchmarks can count heap use.
+// Two relaxed atomic adds per allocation; the nothrow forms fall back to these.
+void* operator new(std::size_t size)
+{
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	gAllocationBytes.fetch_add(size, std::memory_order_relaxed);
+	if (size == 0) size = 1;
+	while (true)
+	{
+		if (void* memory = std::malloc(size)) return memory;
+		std::new_handler handler = std::get_new_handler();
+		if (!handler) throw std::bad_alloc{};
+		handler();
+	}
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
+
+void BenchmarkReport::Check(bool passed, const std::string& message)
+{
+	if (!passed) failures += "benchmark: " + message + "\n";
+}
+
+uint64_t AllocationCounter::GetCount()
+{
+	return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::GetBytes()
+{
+	return gAllocationBytes.load(std::memory_order_relaxed);
+}
+
+void BenchmarkRunner::SetFilter(const std::string& filter)
+{
+	mFilter = filter;
+}
+
+bool BenchmarkRunner::IsSelected(const std::string& name) const
+{
+	return mFilter.empty() || name.find(mFilter) != std::string::npos;
+}
+
+void BenchmarkRunner::Run(const std::string& name, const std::function<void()>& body)
+{
+	if (IsSelected(name)) Measure(name, nullptr, body);
+}
+
+void BenchmarkRunner::Run(const std::string& name, const std::function<void()>& setup, const std::function<void()>& body)
+{
+	if (IsSelected(name)) Measure(name, &setup, body);
+}
+
+void BenchmarkRunner::Measure(const std::string& name, const std::function<void()>* setup, const std::function<void()>& body)
+{
+	// Calls per sample: 1 with a setup, otherwise enough to last BENCHMARK_MIN_SAMPLE_NS.
+	uint64_t batch = 1;
+	if (!setup)
+	{
+		while (batch < (1ull << 30))
+		{
+			Clock::time_point begin = Clock::now();
+			for (uint64_t i = 0; i < batch; ++i) body();
+			if (ElapsedNs(begin, Clock::now()) >= BENCHMARK_MIN_SAMPLE_NS) break;
+			batch *= 2;
+		}
+	}
+
+	auto runSample = [&]() -> double {
+		if (setup) (*setup)();
+		Clock::time_point begin = Clock::now();
+		for (uint64_t i = 0; i < batch; ++i) body();
+		return ElapsedNs(begin, Clock::now()) / batch;
+	};
+
+	for (int i = 0; i < BENCHMARK_WARMUP_SAMPLES; ++i) runSample();
+
+	// Heap use is counted over the timed samples only; setup allocations are subtracted.
+	std::vector<double> samples;
+	samples.reserve(BENCHMARK_SAMPLES);
+	uint64_t setupAllocations = 0;
+	uint64_t setupBytes = 0;
+	const uint64_t allocations = AllocationCounter::GetCount();
+	const uint64_t bytes = AllocationCounter::GetBytes();
+	const Clock::time_point start = Clock::now();
+	while (samples.size() < BENCHMARK_SAMPLES)
+	{
+		if (setup)
+		{
+			const uint64_t beforeCount = AllocationCounter::GetCount();
+			const uint64_t beforeBytes = AllocationCounter::GetBytes();
+			(*setup)();
+			setupAllocations += AllocationCounter::GetCount() - beforeCount;
+			setupBytes += AllocationCounter::GetBytes() - beforeBytes;
+			Clock::time_point begin = Clock::now();
+			body();
+			samples.push_back(ElapsedNs(begin, Clock::now()));
+		}
+		else
+		{
+			Clock::time_point begin = Clock::now();
+			for (uint64_t i = 0; i < batch; ++i) body();
+			samples.push_back(ElapsedNs(begin, Clock::now()) / batch);
+		}
+		if (samples.size() >= 10 && std::chrono::duration<double>(Clock::now() - start).count() > BENCHMARK_MAX_SECONDS) break;
+	}
+	// The samples vector reserved up front, so it adds nothing to the counts.
+	const double iterations = static_cast<double>(samples.size() * batch);
+
+	BenchmarkResult result;
+	result.name = name;
+	result.iterations = samples.size() * batch;
+	result.allocations = (AllocationCounter::GetCount() - allocations - setupAllocations) / iterations;
+	result.allocatedBytes = (AllocationCounter::GetBytes() - bytes - setupBytes) / iterations;
+	for (double sample : samples) result.meanNs += sample;
+	result.meanNs /= samples.size();
+	std::sort(samples.begin(), samples.end());
+	result.p50Ns = GetPercentile(samples, 0.50);
+	result.p95Ns = GetPercentile(samples, 0.95);
+	result.p99Ns = GetPercentile(samples, 0.99);
+	mResults.push_back(result);
+}
+
+const std::vector<BenchmarkResult>& BenchmarkRunner::GetResults() const
+{
+	return mResults;
+}
+
+std::string BenchmarkRunner::Format() const
+{
+	std::string text = "benchmark                             iterations     p50 us     p95 us     p99 us   allocs   bytes\n";
+	char line[256];
+	for (const BenchmarkResult& result : mResults)
+	{
+		snprintf(line, sizeof(line), "%-36s %11llu %10.3f %10.3f %10.3f %8.1f %7.0f\n", result.name.c_str(),
+			static_cast<unsigned long long>(result.iterations), result.p50Ns / 1000.0, result.p95Ns / 1000.0, result.p99Ns / 1000.0,
+			result.allocations, result.allocatedBytes);
+		text += line;
+	}
+	return text;
+}
+
+bool BenchmarkRunner::Save(const std::wstring& fileName) const
+{
+	std::ofstream out{ std::filesystem::path{ fileName }, std::ios::trunc };
+	if (!out) return false;
+
+	char numbers[320];
+	out << "{\n  \"benchmarks\": [";
+	for (size_t i = 0; i < mResults.size(); ++i)
+	{
+		const BenchmarkResult& result = mResults[i];
+		snprintf(numbers, sizeof(numbers), "\"iterations\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %.1f, \"p95_ns\": %.1f, \"p99_ns\": %.1f, \"allocations\": %.3f, \"allocated_bytes\": %.1f",
+			static_cast<unsigned long long>(result.iterations), result.meanNs, result.p50Ns, result.p95Ns, result.p99Ns, result.allocations, result.allocatedBytes);
+		out << (i ? ",\n" : "\n") << "    {\"name\": \"" << EscapeJson(result.name) << "\", " << numbers << "}";
+	}
+	out << "\n  ]\n}\n";
+	return static_cast<bool>(out);
+}
+
+bool LoadBenchmarkResults(const std::wstring& fileName, std::vector<BenchmarkResult>& results)
+{
+	std::ifstream in{ std::filesystem::path{ fileName } };
+	if (!in) return false;
+	std::string text{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+
+	results.clear();
+	JsonCursor cursor{ text };
+	if (!cursor.Find("\"benchmarks\"") || !cursor.Skip(':') || !cursor.Skip('[')) return false;
+	if (cursor.Skip(']')) return true;
+	do
+	{
+		if (!cursor.Skip('{')) return false;
+		BenchmarkResult result;
+		do
+		{
+			std::string key;
+			if (!cursor.ReadString(key) || !cursor.Skip(':')) return false;
+			if (key == "name")
+			{
+				if (!cursor.ReadString(result.name)) return false;
+				continue;
+			}
+			double value = 0.0;
+			if (!cursor.ReadNumber(value)) return false;
+			if (key == "iterations") result.iterations = static_cast<uint64_t>(value);
+			else if (key == "mean_ns") result.meanNs = value;
+			else if (key == "p50_ns") result.p50Ns = value;
+			else if (key == "p95_ns") result.p95Ns = value;
+			else if (key == "p99_ns") result.p99Ns = value;
+			else if (key == "allocations") result.allocations = value;
+			else if (key == "allocated_bytes") result.allocatedBytes = value;
+		} while (cursor.Skip(','));
+		if (!cursor.Skip('}')) return false;
+		results.push_back(result);
+	} while (cursor.Skip(','));
+	return cursor.Skip(']');
+}
+
+std::string CompareBenchmarkResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& current,
+	double threshold, size_t* regressionCount)
+{
+	size_t regressions = 0;
+	std::string report;
+	char line[320];
+	for (const BenchmarkResult& after : current)
+	{
+		auto it = std::find_if(baseline.begin(), baseline.end(), [&after](const BenchmarkResult& result) { return result.name == after.name; });
+		if (it == baseline.end())
+		{
+			report += after.name + ": new\n";
+			continue;
+		}
+		const BenchmarkResult& before = *it;
+		// Half an allocation of slack: a per-iteration mean, amortized container growth can wobble below 1.
+		const bool slower = after.p50Ns > before.p50Ns * (1.0 + threshold) || after.p95Ns > before.p95Ns * (1.0 + threshold);
+		const bool allocates = after.allocations > before.allocations + 0.5;
+		snprintf(line, sizeof(line), "%s: p50 %s p95 %s p99 %s allocs %.1f -> %.1f%s\n", after.name.c_str(),
+			FormatChange(before.p50Ns, after.p50Ns).c_str(), FormatChange(before.p95Ns, after.p95Ns).c_str(), FormatChange(before.p99Ns, after.p99Ns).c_str(),
+			before.allocations, after.allocations, slower || allocates ? "  REGRESSION" : "");
+		report += line;
+		if (slower || allocates) ++regressions;
+	}
+	for (const BenchmarkResult& before : baseline)
+	{
+		auto it = std::find_if(current.begin(), current.end(), [&before](const BenchmarkResult& result) { return result.name == before.name; });
+		if (it == current.end()) report += before.name + ": missing\n";
+	}
+	if (regressionCount) *regressionCount = regressions;
+	return report;
+}
+
+bool RunBenchmarks(Simulation& simulation, const BenchmarkOptions& options)
+{
+	BenchmarkRunner runner;
+	runner.SetFilter(options.filter);
+	BenchmarkReport report;
+	Scene& scene = simulation.GetScene(L"BaseScene");
+	ResourceManager& resources = scene.GetResourceManager();
+
+	AddAnimationBenchmarks(runner, report, resources);
+	AddSkinningBenchmarks(runner, report, resources);
+	AddJobBenchmarks(runner, report, resources);
+	AddCollisionBenchmarks(runner, report, scene);
+	AddHierarchyBenchmarks(runner, report);
+	AddTerrainBenchmarks(runner, report, simulation.GetJobSystem());
+	AddTerrainTileBenchmarks(runner, report, simulation.GetJobSystem());
+	AddStageBenchmarks(runner, report, simulation);
+	AddShadowBenchmarks(runner, report, simulation);
+	AddDescriptorBenchmarks(runner, report);
+	AddTextureBenchmarks(runner, report);
+
+	std::string text = runner.Format() + report.notes + "checksum " + std::to_string(report.checksum) + "\n" + report.failures;
+	bool passed = report.failures.empty();
+#if !BENCHMARK_COUNT_ALLOCATIONS
+	text += "benchmark: heap allocations are not counted in this build, use the Benchmark configuration\n";
+#endif
+	if (!options.outputFileName.empty() && !runner.Save(options.outputFileName))
+	{
+		text += "benchmark: could not write the results\n";
+		passed = false;
+	}
+	if (!options.baselineFileName.empty())
+	{
+		// A baseline that was never measured cannot be compared with; fail rather than look like a pass.
+		std::vector<BenchmarkResult> baseline;
+		const bool loaded = LoadBenchmarkResults(options.baselineFileName, baseline);
+		const bool measured = loaded && !baseline.empty()
+			&& std::all_of(baseline.begin(), baseline.end(), [](const BenchmarkResult& result) { return result.iterations > 0; });
+		if (measured)
+		{
+			size_t regressions = 0;
+			text += CompareBenchmarkResults(baseline, runner.GetResults(), BENCHMARK_REGRESSION_THRESHOLD, &regressions);
+			text += "benchmark: " + std::to_string(regressions) + " regressions\n";
+			passed = passed && regressions == 0;
+		}
+		else
+		{
+			text += loaded ? "benchmark: the baseline has unmeasured entries, write it with -benchmark on this machine first\n"
+				: "benchmark: could not read the baseline\n";
+			passed = false;
+		}
+	}
+	OutputDebugStringA(text.c_str());
+	fputs(text.c_str(), stdout);
+	fflush(stdout);
+	return passed;
+}
+
+void AddAnimationBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, ResourceManager& resources)
+{
+	// Bone matrices of one clip. The time moves a little every call, so each one interpolates another keyframe pair.
+	SkinnedData& skinnedData = resources.GetAnimationData("1P(boy-idle).fbx");
+	const float clipEnd = skinnedData.GetClipEndTime(BenchmarkClipName);
+	std::vector<XMFLOAT4X4> finalTransforms(skinnedData.BoneCount());
+	float timePos = 0.0f;
+	runner.Run("SkinnedData::GetFinalTransforms", [&]() {
+		timePos = std::fmod(timePos + 1.0f / 60.0f, clipEnd);
+		skinnedData.GetFinalTransforms(BenchmarkClipName, timePos, finalTransforms);
+	});
+	std::vector<XMFLOAT4> finalPalette;
+	runner.Run("SkinnedData::GetFinalPalette", [&]() {
+		timePos = std::fmod(timePos + 1.0f / 60.0f, clipEnd);
+		skinnedData.GetFinalPalette(BenchmarkClipName, timePos, finalPalette);
+	});
+
+	// Loading compares the axis correction (-90 degrees about x) folded into the root keyframes with the per-bone
+	// rotation it replaced. Notes that error and the palette size per rig; over AXIS_FOLD_TOLERANCE fails.
+	bool paletteMatch = true;
+	for (const std::string& name : resources.GetAnimationNames())
+	{
+		SkinnedData& animData = resources.GetAnimationData(name);
+		char line[256];
+		snprintf(line, sizeof(line), "palette/%s: %u bones, %zu B as 3x4 (%zu B as 4x4), max error %.2e\n", name.c_str(), animData.BoneCount(),
+			animData.BoneCount() * sizeof(XMFLOAT4) * 3, animData.BoneCount() * sizeof(XMFLOAT4X4), animData.GetAxisFoldError());
+		report.notes += line;
+		paletteMatch = paletteMatch && animData.GetAxisFoldError() <= AXIS_FOLD_TOLERANCE;
+	}
+	report.Check(paletteMatch, "the folded axis correction does not match the per-bone rotation");
+}
+
+void AddSkinningBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, ResourceManager& resources)
+{
+	// CPU skinning of the whole boy and tiger meshes with the palette of the clip the game plays. Notes the
+	// throughput of every kernel; a kernel that differs from the scalar one fails.
+	bool skinningMatch = true;
+	for (auto& [meshName, animationName] : BenchmarkSkinnedMeshes)
+	{
+		SubMeshData& mesh = resources.GetSubMeshData(meshName);
+		const Vertex* vertices = resources.GetVertexBuffer().data() + mesh.startVertexLocation;
+		const size_t count = mesh.vertexCountPerInstance;
+		SkinnedData& animData = resources.GetAnimationData(animationName);
+		std::vector<XMFLOAT4> palette;
+		animData.GetFinalPalette(BenchmarkClipName, animData.GetClipEndTime(BenchmarkClipName) * 0.5f, palette);
+		std::vector<SkinnedVertex> reference(count), skinned(count);
+		CpuSkinning::Skin(eSkinningKernel::Scalar, vertices, count, palette.data(), reference.data());
+
+		std::string line = "skinning/" + meshName + ": " + std::to_string(count) + " vertices";
+		for (eSkinningKernel kernel : { eSkinningKernel::Scalar, eSkinningKernel::Avx2 })
+		{
+			const std::string name = "CpuSkinning::Skin/" + meshName + "/" + CpuSkinning::GetKernelName(kernel);
+			if (kernel == eSkinningKernel::Avx2 && CpuSkinning::GetBestKernel() != eSkinningKernel::Avx2)
+			{
+				line += ", avx2 not supported";
+				continue;
+			}
+			if (!runner.IsSelected(name)) continue;
+			runner.Run(name, [&]() { CpuSkinning::Skin(kernel, vertices, count, palette.data(), skinned.data()); });
+			const float error = CpuSkinning::Compare(reference.data(), skinned.data(), count);
+			char numbers[128];
+			snprintf(numbers, sizeof(numbers), ", %s %.0f vertices/ms (max difference %.2e)", CpuSkinning::GetKernelName(kernel),
+				count / std::max<double>(runner.GetResults().back().p50Ns * 1e-6, 1e-9), error);
+			line += numbers;
+			skinningMatch = skinningMatch && error <= CPU_SKINNING_TOLERANCE;
+		}
+		report.notes += line + "\n";
+	}
+	report.Check(skinningMatch, "the AVX2 skinning kernel does not match the scalar one");
+
+	// The pre-skinning scheduler: 128 boys and 128 tigers in one frame, each at its own time in its clip, on every
+	// thread count. However the work is split, the vertices must equal skinning every request on its own.
+	SkinningScheduler scheduler{ PRESKIN_JOB_VERTICES };
+	std::vector<XMFLOAT4> schedulerPalette, finalPalette;
+	const Vertex* sourceVertices = resources.GetVertexBuffer().data();
+	for (int i = 0; i < 256; ++i)
+	{
+		auto& [meshName, animationName] = BenchmarkSkinnedMeshes[i % 2];
+		SubMeshData& mesh = resources.GetSubMeshData(meshName);
+		SkinnedData& animData = resources.GetAnimationData(animationName);
+		animData.GetFinalPalette(BenchmarkClipName, std::fmod(i * 0.05f, animData.GetClipEndTime(BenchmarkClipName)), finalPalette);
+		scheduler.Add({ mesh.startVertexLocation, mesh.vertexCountPerInstance, static_cast<uint32_t>(schedulerPalette.size()) });
+		schedulerPalette.insert(schedulerPalette.end(), finalPalette.begin(), finalPalette.end());
+	}
+	std::vector<SkinnedVertex> serialSkinned(scheduler.GetReservedVertexCount()), scheduledSkinned(scheduler.GetReservedVertexCount());
+	for (uint32_t i = 0; i < scheduler.GetRequests().size(); ++i)
+	{
+		const SkinningRequest& request = scheduler.GetRequests()[i];
+		CpuSkinning::Skin(sourceVertices + request.sourceVertex, request.vertexCount, schedulerPalette.data() + request.paletteRow,
+			serialSkinned.data() + scheduler.GetOffset(i));
+	}
+	bool scheduleMatch = true;
+	for (uint32_t threads : GetBenchmarkThreadCounts())
+	{
+		const std::string name = "SkinningScheduler::Execute/256 objects/" + std::to_string(threads) + " threads";
+		if (!runner.IsSelected(name)) continue;
+		JobSystem jobSystem{ threads - 1 };
+		runner.Run(name, [&]() { scheduler.Execute(jobSystem, sourceVertices, schedulerPalette.data(), scheduledSkinned.data()); });
+		scheduleMatch = scheduleMatch && memcmp(serialSkinned.data(), scheduledSkinned.data(), serialSkinned.size() * sizeof(SkinnedVertex)) == 0;
+	}
+	report.Check(scheduleMatch, "SkinningScheduler gave different vertices on different thread counts");
+	// Every job starts at the beginning of a 64-byte line, so no two jobs write the same line.
+	bool jobAlignMatch = true;
+	for (const SkinningJob& job : scheduler.BuildJobs())
+		jobAlignMatch = jobAlignMatch && (scheduler.GetOffset(job.request) + job.begin) % SKINNING_ALIGN_VERTICES == 0;
+	report.Check(jobAlignMatch, "SkinningScheduler split a job inside a 64-byte line");
+	report.notes += FormatScaling(runner, "SkinningScheduler::Execute/256 objects/");
+	report.notes += "preskin/256 objects: " + std::to_string(scheduler.GetSkinnedVertexCount()) + " vertices in " + std::to_string(scheduler.GetJobCount())
+		+ " jobs, " + std::to_string(scheduler.GetReservedVertexCount() * sizeof(SkinnedVertex) / 1024) + " KB transient buffer, "
+		+ std::to_string(scheduler.GetSkinnedVertexCount()) + " of " + std::to_string(scheduler.GetSkinnedVertexCount() * 2) + " shadow + main pass vertex skinnings saved\n";
+}
+
+void AddJobBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, ResourceManager& resources)
+{
+	// Job system scaling: bone matrices of 256 objects split over the workers, against 1 thread. What the job
+	// system guarantees is checked in Tests/JobSystemTest.cpp.
+	SkinnedData& skinnedData = resources.GetAnimationData("1P(boy-idle).fbx");
+	const float clipEnd = skinnedData.GetClipEndTime(BenchmarkClipName);
+	std::vector<std::vector<XMFLOAT4X4>> palettes(256, std::vector<XMFLOAT4X4>(skinnedData.BoneCount()));
+	for (uint32_t threads : GetBenchmarkThreadCounts())
+	{
+		const std::string name = "JobSystem::ParallelFor/" + std::to_string(threads) + " threads";
+		if (!runner.IsSelected(name)) continue;
+		JobSystem jobSystem{ threads - 1 };
+		runner.Run(name, [&]() {
+			jobSystem.ParallelFor(palettes.size(), ANIMATION_JOB_CHUNK, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) skinnedData.GetFinalTransforms(BenchmarkClipName, std::fmod(i * 0.05f, clipEnd), palettes[i]);
+			});
+		});
+	}
+	report.notes += FormatScaling(runner, "JobSystem::ParallelFor/");
+}
+
+void AddCollisionBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, Scene& scene)
+{
+	// Collision data of rotated OBB pairs, spread so that they overlap, taken in turn.
+	std::vector<BoundingOrientedBox> boxes;
+	for (int i = 0; i < 64; ++i)
+	{
+		XMFLOAT4 orientation;
+		XMStoreFloat4(&orientation, XMQuaternionRotationRollPitchYaw(0.1f * i, 0.37f * i, 0.05f * i));
+		boxes.emplace_back(XMFLOAT3(float(i % 8) * 3.0f, 0.0f, float(i / 8) * 3.0f), XMFLOAT3(2.0f, 2.0f, 2.0f), orientation);
+	}
+	size_t boxIndex = 0;
+	runner.Run("Scene::GetCollisionData", [&]() {
+		boxIndex = (boxIndex + 1) % (boxes.size() - 1);
+		auto [normal, penetration] = scene.GetCollisionData(boxes[boxIndex], boxes[boxIndex + 1]);
+		report.checksum += penetration; // used, so the call is not optimized away
+	});
+
+	// Narrow phase under stress: 2000 tiger collision boxes packed so they overlap, into a contact list. The list
+	// from every thread count must be the one a single thread builds.
+	std::vector<BoundingOrientedBox> tigerBoxes;
+	for (int i = 0; i < 2000; ++i)
+	{
+		XMFLOAT4 orientation;
+		XMStoreFloat4(&orientation, XMQuaternionRotationRollPitchYaw(0.0f, XMConvertToRadians(float(i * 37 % 360)), 0.0f));
+		tigerBoxes.emplace_back(XMFLOAT3(float(i % 50) * 6.0f, 6.0f, float(i / 50) * 6.0f), XMFLOAT3(2.0f, 6.0f, 10.0f), orientation);
+	}
+	std::vector<const BoundingOrientedBox*> tigerBoxPointers;
+	for (const BoundingOrientedBox& box : tigerBoxes) tigerBoxPointers.push_back(&box);
+	std::vector<Contact> referenceContacts, contacts;
+	bool contactsMatch = true;
+	for (uint32_t threads : GetBenchmarkThreadCounts())
+	{
+		const std::string name = "Scene::FindContacts/2000 tigers/" + std::to_string(threads) + " threads";
+		if (!runner.IsSelected(name)) continue;
+		JobSystem jobSystem{ threads - 1 };
+		runner.Run(name, [&]() { scene.FindContacts(jobSystem, tigerBoxPointers, contacts); });
+		if (referenceContacts.empty())
+		{
+			JobSystem serial{ 0 };
+			scene.FindContacts(serial, tigerBoxPointers, referenceContacts);
+		}
+		contactsMatch = contactsMatch && contacts.size() == referenceContacts.size()
+			&& memcmp(contacts.data(), referenceContacts.data(), contacts.size() * sizeof(Contact)) == 0;
+	}
+	report.Check(contactsMatch, "FindContacts gave different contacts on different thread counts");
+	if (!referenceContacts.empty()) report.notes += "contacts " + std::to_string(referenceContacts.size()) + "\n";
+	report.notes += FormatScaling(runner, "Scene::FindContacts/2000 tigers/");
+}
+
+void AddHierarchyBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report)
+{
+	// 50k transform nodes, 10k roots with 4 children each: mostly static with 1% of the roots moving every
+	// call, all of them moving, and none.
+	TransformHierarchy hierarchy;
+	std::vector<uint32_t> roots, children;
+	for (int i = 0; i < 10000; ++i)
+	{
+		roots.push_back(hierarchy.AddNode());
+		hierarchy.SetLocal(roots.back(), XMMatrixTranslation(float(i), 0.0f, 0.0f));
+		for (int k = 0; k < 4; ++k)
+		{
+			children.push_back(hierarchy.AddNode(roots.back()));
+			hierarchy.SetLocal(children.back(), XMMatrixRotationY(float(k)) * XMMatrixTranslation(0.0f, 1.0f, 0.0f));
+		}
+	}
+	hierarchy.Update();
+	float hierarchyTime = 0.0f;
+	auto moveRoots = [&](size_t stride) {
+		hierarchyTime += 1.0f;
+		for (size_t i = 0; i < roots.size(); i += stride) hierarchy.SetLocal(roots[i], XMMatrixTranslation(float(i), hierarchyTime, 0.0f));
+		hierarchy.Update();
+	};
+	runner.Run("TransformHierarchy::Update/50k nodes 1% moving", [&]() { moveRoots(100); });
+	runner.Run("TransformHierarchy::Update/50k nodes all moving", [&]() { moveRoots(1); });
+	runner.Run("TransformHierarchy::Update/50k nodes static", [&]() { hierarchy.Update(); });
+
+	// After the last move every child's world is still its local times its parent's world.
+	bool worldMatch = true;
+	for (size_t i = 0; i < children.size(); ++i)
+	{
+		XMMATRIX expected = XMMatrixRotationY(float(i % 4)) * XMMatrixTranslation(0.0f, 1.0f, 0.0f) * hierarchy.GetWorld(roots[i / 4]);
+		XMMATRIX world = hierarchy.GetWorld(children[i]);
+		for (int r = 0; r < 4; ++r) worldMatch = worldMatch && XMVector4NearEqual(world.r[r], expected.r[r], XMVectorReplicate(1e-3f));
+	}
+	report.Check(worldMatch, "TransformHierarchy left a child world matrix stale");
+}
+
+void AddTerrainBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, JobSystem& jobSystem)
+{
+	// The game's terrain from an empty ResourceManager every time: loading the height map through the vertices and indices.
+	std::unique_ptr<ResourceManager> terrainResources;
+	runner.Run("ResourceManager::CreateTerrain",
+		[&]() { terrainResources = std::make_unique<ResourceManager>(); },
+		[&]() { terrainResources->CreateTerrain(jobSystem, "HeightMap.raw", 50, 5, 50); });
+
+	// Normals of 64 rows of synthetic height maps 1k, 4k and 8k wide, four at a time and one by one. The two must
+	// agree within the tolerance; Tests/TerrainMeshTest.cpp checks both against the original per-vertex output.
+	float normalError = 0.0f;
+	for (int width : { 1024, 4096, 8192 })
+	{
+		const int rows = 64;
+		std::vector<float> heights(size_t(width) * rows);
+		for (int z = 0; z < rows; ++z)
+		{
+			for (int x = 0; x < width; ++x) heights[size_t(z) * width + x] = sinf(x * 0.05f) * 20.0f + cosf(z * 0.11f + x * 0.013f) * 7.0f;
+		}
+		std::vector<Vertex> soaRows(heights.size()), scalarRows(heights.size());
+		auto buildRows = [&](std::vector<Vertex>& out, bool soaNormals) {
+			for (int z = 0; z < rows; ++z) TerrainMesh::BuildRow(heights, width, rows, 5, 50, z, &out[size_t(z) * width], soaNormals);
+		};
+		buildRows(soaRows, true);
+		buildRows(scalarRows, false);
+		normalError = std::max(normalError, TerrainMesh::CompareNormals(scalarRows.data(), soaRows.data(), heights.size()));
+
+		const std::string size = std::to_string(width / 1024) + "k";
+		runner.Run("TerrainMesh::BuildRow/" + size + " soa", [&]() { buildRows(soaRows, true); });
+		runner.Run("TerrainMesh::BuildRow/" + size + " scalar", [&]() { buildRows(scalarRows, false); });
+		report.checksum += soaRows[width + 1].normal.y;
+	}
+	report.Check(normalError <= TERRAIN_NORMAL_TOLERANCE, "the SoA terrain normals differ from XMVector3Cross/XMVector3Normalize");
+
+	// LOD selection from above the middle of the map. Tests/TerrainQuadTreeTest.cpp checks the selections for cracks.
+	ResourceManager queryResources;
+	queryResources.CreateTerrain(jobSystem, "HeightMap.raw", 50, 5, 50);
+	const TerrainQuadTree& quadTree = queryResources.GetTerrainQuadTree();
+	const TerrainData& terrainData = queryResources.GetTerrainData();
+	const float extentX = (terrainData.terrainWidth - 1) * quadTree.GetScale();
+	const float extentZ = (terrainData.terrainHeight - 1) * quadTree.GetScale();
+	const TerrainNode& root = quadTree.GetNode(quadTree.GetRoot());
+	std::vector<uint32_t> leaves;
+	runner.Run("TerrainQuadTree::Select", [&]() {
+		quadTree.Select(extentX * 0.5f, root.maxHeight + 1.0f, extentZ * 0.5f, TERRAIN_LOD_DISTANCE, leaves);
+		report.checksum += float(leaves.size());
+	});
+
+	// 100k height field queries at fixed random points above the terrain: the height under each, a vertical ray,
+	// and a segment to below the next point.
+	const HeightField& heightField = queryResources.GetTerrainHeightField();
+	const size_t queryCount = 100000;
+	std::mt19937 random{ 34 };
+	std::uniform_real_distribution<float> alongX{ 0.0f, extentX }, alongZ{ 0.0f, extentZ };
+	std::vector<XMFLOAT3> queryPoints(queryCount);
+	for (XMFLOAT3& point : queryPoints) point = { alongX(random), root.maxHeight + 10.0f, alongZ(random) };
+	std::vector<float> queryHeights(queryCount);
+	heightField.SampleHeights(&queryPoints[0].x, queryCount, 3, queryHeights.data());
+	bool queryMatch = true;
+	for (size_t i = 0; i < queryCount; ++i)
+	{
+		// The vertical ray hits at the sampled height, and a segment ending underground hits where the ray in its
+		// direction, cut to length 1, does.
+		const XMFLOAT3& p = queryPoints[i];
+		const XMFLOAT3& q = queryPoints[(i + 1) % queryCount];
+		const float qy = queryHeights[(i + 1) % queryCount] - 1.0f;
+		float rayT = -1.0f, segmentT = -1.0f, clippedT = -1.0f;
+		queryMatch = queryMatch && heightField.RayCast(p.x, p.y, p.z, 0.0f, -1.0f, 0.0f, 1000.0f, &rayT)
+			&& fabsf(p.y - rayT - queryHeights[i]) <= 1e-3f
+			&& heightField.SegmentCast(p.x, p.y, p.z, q.x, qy, q.z, &segmentT)
+			&& heightField.RayCast(p.x, p.y, p.z, q.x - p.x, qy - p.y, q.z - p.z, 1.0f, &clippedT)
+			&& segmentT == clippedT && segmentT >= 0.0f && segmentT <= 1.0f;
+	}
+	report.Check(queryMatch, "HeightField::RayCast or SegmentCast disagrees with SampleHeights");
+
+	runner.Run("HeightField::SampleHeights/100k", [&]() {
+		heightField.SampleHeights(&queryPoints[0].x, queryCount, 3, queryHeights.data());
+		report.checksum += queryHeights[0];
+	});
+	runner.Run("HeightField::RayCast/100k", [&]() {
+		float sum = 0.0f, hitT = 0.0f;
+		for (const XMFLOAT3& p : queryPoints) sum += heightField.RayCast(p.x, p.y, p.z, 0.0f, -1.0f, 0.0f, 1000.0f, &hitT) ? hitT : 0.0f;
+		report.checksum += sum;
+	});
+	runner.Run("HeightField::SegmentCast/100k", [&]() {
+		float sum = 0.0f, hitT = 0.0f;
+		for (size_t i = 0; i < queryCount; ++i)
+		{
+			const XMFLOAT3& p = queryPoints[i];
+			const XMFLOAT3& q = queryPoints[(i + 1) % queryCount];
+			sum += heightField.SegmentCast(p.x, p.y, p.z, q.x, root.minHeight - 1.0f, q.z, &hitT) ? hitT : 0.0f;
+		}
+		report.checksum += sum;
+	});
+}
+
+void AddTerrainTileBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, JobSystem& jobSystem)
+{
+	// A large synthetic terrain, written one tile row at a time so the whole map is never in memory. The focus
+	// walks diagonally across a map much larger than the budget: tiles must come and go, and the resident tiles
+	// and the coarse grid must answer the original heights.
+	TerrainTileInfo tileInfo;
+	tileInfo.tileSize = 256;
+	tileInfo.tilesX = tileInfo.tilesZ = BENCHMARK_TERRAIN_TILES;
+	tileInfo.coarseStep = 32;
+	tileInfo.scale = 2.0f;
+	tileInfo.minHeight = -100.0f;
+	tileInfo.maxHeight = 100.0f;
+	auto syntheticHeight = [](uint32_t x, uint32_t z) { return sinf(x * 0.013f) * 60.0f + cosf(z * 0.021f) * 30.0f + sinf((x + z) * 0.1f) * 5.0f; };
+	const std::filesystem::path syntheticPath = std::filesystem::temp_directory_path() / L"benchmark_synthetic.tiles";
+	bool tileMatch = WriteTerrainTiles(syntheticPath.wstring(), tileInfo, syntheticHeight);
+
+	TerrainTileCache tiles{ 16 * 1024 * 1024 };
+	tileMatch = tileMatch && tiles.Open(syntheticPath.wstring());
+	const float tileWorld = tileInfo.tileSize * tileInfo.scale;
+	const float quantization = (tileInfo.maxHeight - tileInfo.minHeight) / 65535.0f;
+	const uint32_t lastSample = tileInfo.tilesX * tileInfo.tileSize;
+	uint32_t walkSteps = 0, maxResident = 0;
+	for (uint32_t sample = 0; tileMatch && sample <= lastSample; sample += tileInfo.tileSize / 2, ++walkSteps)
+	{
+		// Update until every tile around the focus is resident; a worker that stalls fails.
+		const float focus = sample * tileInfo.scale;
+		int waits = 0;
+		for (tiles.Update(focus, focus, tileWorld * 1.5f); tiles.GetPendingCount() > 0 && waits < 10000; ++waits)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+			tiles.Update(focus, focus, tileWorld * 1.5f);
+		}
+		bool resident = false;
+		tileMatch = tileMatch && tiles.GetPendingCount() == 0 && tiles.GetResidentBytes() <= tiles.GetBudget()
+			&& fabsf(tiles.SampleHeight(focus, focus, &resident) - syntheticHeight(sample, sample)) <= quantization && resident;
+		maxResident = std::max(maxResident, tiles.GetResidentCount());
+
+		// The opposite corner is not resident, so the coarse grid answers its sample's original height as is.
+		const uint32_t farSample = sample < lastSample / 2 ? lastSample : 0;
+		tileMatch = tileMatch && tiles.SampleHeight(farSample * tileInfo.scale, 0.0f, &resident) == syntheticHeight(farSample, 0) && !resident;
+	}
+	// The budget must have evicted the first tile of the walk.
+	tileMatch = tileMatch && BENCHMARK_TERRAIN_TILES > 4 && !tiles.IsResident(0, 0);
+	report.Check(tileMatch, "TerrainTileCache streamed the synthetic map wrongly or over its budget");
+	report.notes += "tiles: " + std::to_string(tileInfo.tilesX) + "x" + std::to_string(tileInfo.tilesZ) + " synthetic tiles, " + std::to_string(tileInfo.GetFileSize() >> 20)
+		+ " MB file, " + std::to_string(walkSteps) + " steps, at most " + std::to_string(maxResident) + " resident\n";
+
+	std::vector<XMFLOAT3> tilePoints(100000);
+	std::mt19937 tileRandom{ 35 };
+	std::uniform_real_distribution<float> nearFocus{ lastSample * tileInfo.scale - tileWorld, lastSample * tileInfo.scale };
+	for (XMFLOAT3& point : tilePoints) point = { nearFocus(tileRandom), 0.0f, nearFocus(tileRandom) };
+	std::vector<float> tileHeights(tilePoints.size());
+	runner.Run("TerrainTileCache::SampleHeights/100k", [&]() {
+		tiles.SampleHeights(&tilePoints[0].x, tilePoints.size(), 3, tileHeights.data());
+		report.checksum += tileHeights[0];
+	});
+	tiles.Close();
+	std::filesystem::remove(syntheticPath);
+
+	// The game's terrain: the mesh built from HeightMap.raw and a cache holding every tile of the converted file
+	// must give the same heights within the 16-bit quantization.
+	const std::filesystem::path convertedPath = std::filesystem::temp_directory_path() / L"benchmark_HeightMap.tiles";
+	ResourceManager tileResources;
+	tileResources.CreateTerrain(jobSystem, "HeightMap.raw", 50, 5, 50);
+	bool sourceMatch = ResourceManager::ConvertTerrainToTiles(jobSystem, "HeightMap.raw", convertedPath.wstring(), 50, 5)
+		&& tiles.Open(convertedPath.wstring());
+	if (sourceMatch)
+	{
+		const float tolerance = (tiles.GetInfo().maxHeight - tiles.GetInfo().minHeight) / 65535.0f * 0.5f + 1e-4f;
+		const HeightField& meshHeights = tileResources.GetTerrainHeightField();
+		const float scale = meshHeights.GetScale();
+		for (int waits = 0; tiles.GetResidentCount() < tiles.GetInfo().tilesX * tiles.GetInfo().tilesZ && waits < 10000; ++waits)
+		{
+			tiles.Update(meshHeights.GetWidth() * scale * 0.5f, meshHeights.GetHeight() * scale * 0.5f, meshHeights.GetWidth() * scale * 2.0f);
+			std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+		}
+		for (uint32_t z = 0; z < meshHeights.GetHeight(); ++z)
+		{
+			for (uint32_t x = 0; x < meshHeights.GetWidth(); ++x)
+			{
+				bool resident = false;
+				const float meshHeight = meshHeights.GetHeights()[z * meshHeights.GetWidth() + x];
+				sourceMatch = sourceMatch && fabsf(tiles.SampleHeight(x * scale, z * scale, &resident) - meshHeight) <= tolerance && resident;
+			}
+		}
+	}
+	tiles.Close();
+	std::filesystem::remove(convertedPath);
+	report.Check(sourceMatch, "the tile cache answers heights that differ from the terrain mesh by more than quantization");
+}
+
+void AddStageBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, Simulation& simulation)
+{
+	Scene& scene = simulation.GetScene(L"BaseScene");
+	const std::wstring stages[] = { L"Base", L"Hunting", L"God" };
+	for (const std::wstring& stage : stages)
+	{
+		const std::string stageName(stage.begin(), stage.end());
+		const std::string boundsName = "Scene::GetBounds/" + stageName;
+		const std::string collisionName = "Scene::OnProcessCollision/" + stageName;
+		const std::string frameName = "Frame/" + stageName;
+		const std::string preSkinnedFrameName = frameName + " preskin";
+		if (!runner.IsSelected(boundsName) && !runner.IsSelected(collisionName) && !runner.IsSelected(frameName) && !runner.IsSelected(preSkinnedFrameName)) continue;
+
+		// A stage change applies on the next step. A few steps push apart the objects that start out overlapping
+		// before anything is timed.
+		auto settleStage = [&]() {
+			scene.SetStage(stage);
+			for (int i = 0; i < 10; ++i) simulation.Step();
+		};
+		settleStage();
+
+		// Upload memory of the old layout, 90 bones in every object CB, against a small CB and a shared palette
+		// the size of the skeleton.
+		ConstantMemoryStats memory = scene.GetConstantMemoryStats();
+		const uint64_t legacyBytes = uint64_t(memory.objects) * scene.CalcConstantBufferByteSize(sizeof(XMFLOAT4X4) * 91 + sizeof(XMFLOAT4) * 2);
+		const uint64_t uploadBytes = uint64_t(memory.uploadObjects) * scene.CalcConstantBufferByteSize(sizeof(ObjectCB)) + memory.paletteBytes;
+		report.notes += "constants/" + stageName + ": " + std::to_string(memory.objects) + " objects, " + std::to_string(legacyBytes / 1024) + " KB upload before, "
+			+ std::to_string(uploadBytes / 1024) + " KB now (" + std::to_string(memory.paletteUsedBytes / 1024) + " KB of palettes used), "
+			+ std::to_string((legacyBytes - std::min(legacyBytes, uploadBytes)) / 1024) + " KB saved\n";
+
+		float x = 0.0f;
+		runner.Run(boundsName, [&]() {
+			x = std::fmod(x + 7.3f, 500.0f);
+			report.checksum += std::get<1>(scene.GetBounds(x, 500.0f - x));
+		});
+
+		// Collision response moves and removes objects and schedules stages, so every iteration starts again from
+		// the saved state. The other side effects, such as hit states, go when the stage is set up again before
+		// the frames are timed.
+		if (runner.IsSelected(collisionName))
+		{
+			const CollisionSnapshot snapshot = scene.SaveCollisionSnapshot();
+			runner.Run(collisionName,
+				[&]() { scene.RestoreCollisionSnapshot(snapshot); },
+				[&]() { scene.OnProcessCollision(); });
+			settleStage();
+		}
+
+		// One headless frame: a fixed step, then the shadow and main passes on the recording device. Shader
+		// skinning, the default, and pre-skinning.
+		scene.SetPreSkinning(false);
+		runner.Run(frameName, [&]() { simulation.RecordStep(); });
+		scene.SetPreSkinning(true);
+		scene.ResetPreSkinningStats();
+		runner.Run(preSkinnedFrameName, [&]() { simulation.RecordStep(); });
+		scene.SetPreSkinning(PRESKIN_ANIMATED_OBJECTS);
+		PreSkinningStats skinning = scene.GetPreSkinningStats();
+		if (skinning.frames > 0)
+		{
+			report.notes += "preskin/" + stageName + ": " + std::to_string(skinning.skinnedObjects / skinning.frames) + " objects, "
+				+ std::to_string(skinning.skinnedVertices / skinning.frames) + " vertices skinned and " + std::to_string(skinning.drawnVertices / skinning.frames)
+				+ " drawn per frame, " + std::to_string((skinning.drawnVertices - std::min(skinning.drawnVertices, skinning.skinnedVertices)) / skinning.frames)
+				+ " vertex skinnings saved per frame\n";
+		}
+	}
+}
+
+void AddShadowBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, Simulation& simulation)
+{
+	// 1000 static casters reporting their world matrices at once, as on a stage load. The invalidation policy
+	// itself is checked in Tests/ShadowCacheTest.cpp.
+	ShadowCache cache;
+	std::vector<XMFLOAT4X4> casters(1000);
+	for (size_t i = 0; i < casters.size(); ++i) XMStoreFloat4x4(&casters[i], XMMatrixTranslation(float(i), 0.0f, 0.0f));
+	runner.Run("ShadowCache::UpdateStaticCaster/1000 casters", [&]() {
+		for (uint32_t i = 0; i < casters.size(); ++i) cache.UpdateStaticCaster(i, casters[i]);
+		cache.OnStaticRedrawn();
+	});
+
+	// In the Hunting stage: once everything has settled nothing is redrawn; moving a tree redraws, then the map
+	// is left alone again.
+	Scene& scene = simulation.GetScene(L"BaseScene");
+	auto renderFrames = [&](int count) {
+		const uint64_t before = scene.GetShadowCache().GetStaticRedrawCount();
+		for (int i = 0; i < count; ++i) simulation.RecordStep();
+		return scene.GetShadowCache().GetStaticRedrawCount() - before;
+	};
+	scene.SetStage(L"Hunting");
+	renderFrames(30);
+	const uint64_t settledRedraws = renderFrames(60);
+	uint64_t movedRedraws = 0, afterMoveRedraws = 0;
+	if (TreeObject* tree = scene.GetObj<TreeObject>())
+	{
+		Transform* transform = tree->GetComponent<Transform>();
+		transform->SetPosition(transform->GetPosition() + XMVectorSet(10.0f, 0.0f, 0.0f, 0.0f));
+		movedRedraws = renderFrames(5);
+		afterMoveRedraws = renderFrames(30);
+	}
+	report.notes += "shadow/Hunting: " + std::to_string(settledRedraws) + " static redraws in 60 settled frames, " + std::to_string(movedRedraws)
+		+ " after moving a tree, " + std::to_string(afterMoveRedraws) + " in the 30 frames after that\n";
+	report.Check(settledRedraws == 0 && movedRedraws > 0 && afterMoveRedraws == 0, "the static shadow cache does not follow static objects");
+}
+
+void AddDescriptorBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report)
+{
+	// One palette view a frame, taken and retired on a ring the size of the scene's. The ring's ranges are
+	// checked in Tests/DescriptorAllocatorTest.cpp.
+	DescriptorAllocator sceneRing{ MAX_PERSISTENT_DESCRIPTOR, MAX_TRANSIENT_DESCRIPTOR };
+	uint64_t fence = 0;
+	runner.Run("DescriptorAllocator::AllocateTransient/1 per frame", [&]() {
+		report.checksum += float(sceneRing.AllocateTransient(1) & 1);
+		sceneRing.FinishFrame(++fence);
+		sceneRing.Retire(fence);
+	});
+}
+
+void AddTextureBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report)
+{
+	// The DDS header of a texture the game loads. Truncated, corrupted and fuzzed headers are in Tests/DDSHeaderTest.cpp.
+	std::ifstream file{ "./Textures/grass.dds", std::ios::binary };
+	const std::vector<uint8_t> dds{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	DDSInfo info;
+	report.Check(ParseDDSHeader(dds.data(), dds.size(), info), "could not parse Textures/grass.dds");
+	runner.Run("ParseDDSHeader", [&]() {
+		report.checksum += float(ParseDDSHeader(dds.data(), dds.size(), info) ? info.mipCount : 0u);
+	});
+}
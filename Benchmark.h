@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_SAMPLES 200                  // timed samples per benchmark
+#define BENCHMARK_WARMUP_SAMPLES 5
+#define BENCHMARK_MIN_SAMPLE_NS 50000          // short bodies are repeated until a sample lasts this long
+#define BENCHMARK_MAX_SECONDS 3.0              // stop sampling early when a benchmark runs longer
+#define BENCHMARK_REGRESSION_THRESHOLD 0.10    // slower than the baseline by more than this fraction
+#define BENCHMARK_TERRAIN_TILES 16             // tiles per side of the synthetic streamed map, 256 quads each; 128 writes about 4 GB
+#ifndef BENCHMARK_COUNT_ALLOCATIONS
+#define BENCHMARK_COUNT_ALLOCATIONS 0          // 1 replaces global operator new/delete to count heap use; set by the Benchmark configuration
+#endif
+
+class Simulation;
+class Scene;
+class ResourceManager;
+class JobSystem;
+
+// Per-iteration timings and heap use of one benchmark. Times are nanoseconds per call of the body.
+struct BenchmarkResult
+{
+	std::string name;
+	uint64_t iterations = 0;
+	double meanNs = 0.0;
+	double p50Ns = 0.0;
+	double p95Ns = 0.0;
+	double p99Ns = 0.0;
+	double allocations = 0.0;    // operator new calls per iteration
+	double allocatedBytes = 0.0; // bytes requested per iteration
+};
+
+// Small in-process harness in the spirit of Google Benchmark: warm up, then time a fixed number of
+// samples and keep percentiles. Results are kept in run order.
+class BenchmarkRunner
+{
+public:
+	// Only benchmarks whose name contains filter run; empty runs everything.
+	void SetFilter(const std::string& filter);
+	bool IsSelected(const std::string& name) const;
+
+	// Bodies shorter than BENCHMARK_MIN_SAMPLE_NS are called several times per sample.
+	void Run(const std::string& name, const std::function<void()>& body);
+	// setup runs before every iteration outside the timed region; every sample is a single call.
+	void Run(const std::string& name, const std::function<void()>& setup, const std::function<void()>& body);
+
+	const std::vector<BenchmarkResult>& GetResults() const;
+	std::string Format() const;
+	bool Save(const std::wstring& fileName) const;
+
+private:
+	void Measure(const std::string& name, const std::function<void()>* setup, const std::function<void()>& body);
+
+	std::string mFilter;
+	std::vector<BenchmarkResult> mResults;
+};
+
+// What the benchmark areas of one run share besides the runner: notes printed under the table, the
+// correctness checks that failed and a checksum that keeps otherwise unused results alive.
+struct BenchmarkReport
+{
+	std::string notes;
+	std::string failures;
+	float checksum = 0.0f;
+
+	// Records message as a failure unless passed.
+	void Check(bool passed, const std::string& message);
+};
+
+// Reads a file written by BenchmarkRunner::Save.
+bool LoadBenchmarkResults(const std::wstring& fileName, std::vector<BenchmarkResult>& results);
+// One line per benchmark: p50/p95/p99 and allocation changes against the baseline. A benchmark regresses
+// when its p50 or p95 grows by more than threshold or it allocates more per iteration. Every baseline entry
+// must have been measured (iterations > 0).
+std::string CompareBenchmarkResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& current,
+	double threshold, size_t* regressionCount);
+
+// Process-wide heap counters, only advanced when BENCHMARK_COUNT_ALLOCATIONS is 1.
+class AllocationCounter
+{
+public:
+	static uint64_t GetCount();
+	static uint64_t GetBytes();
+};
+
+struct BenchmarkOptions
+{
+	std::wstring outputFileName;   // JSON results, usable as a later baseline; empty skips saving
+	std::wstring baselineFileName; // compared against when set
+	std::string filter;            // only benchmarks whose name contains this; empty runs all
+};
+
+// The game's hot paths, one area at a time, on a simulation set up with OnInitHeadless. Prints the table,
+// saves the results and compares them with the baseline; false on an I/O error, a failed check or a regression.
+bool RunBenchmarks(Simulation& simulation, const BenchmarkOptions& options);
+
+// Benchmark areas in the order RunBenchmarks runs them. Each one registers its cases with the runner and adds
+// its notes to the report, with the checks that need the game's assets or scene; the rest are in Tests/.
+void AddAnimationBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, ResourceManager& resources);
+void AddSkinningBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, ResourceManager& resources);
+void AddJobBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, ResourceManager& resources);
+void AddCollisionBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, Scene& scene);
+void AddHierarchyBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report);
+void AddTerrainBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, JobSystem& jobSystem);
+void AddTerrainTileBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, JobSystem& jobSystem);
+void AddStageBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, Simulation& simulation);
+void AddShadowBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report, Simulation& simulation);
+void AddDescriptorBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report);
+void AddTextureBenchmarks(BenchmarkRunner& runner, BenchmarkReport& report);
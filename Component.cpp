@@ -9,6 +9,9 @@ Transform::Transform(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale)
 	XMStoreFloat3(&mPosition, pos);
 	//XMStoreFloat4(&mQuaternion, XMQuaternionNormalize(GetQuaternionFromRotation()));
 	XMStoreFloat4x4(&mFinalM, GetTransformM());
+	mPrevFinalM = mFinalM;
+	mStepStartRotation = mRotation;
+	mStepStartPosition = mPosition;
 }
 
 XMVECTOR Transform::GetScale()
@@ -43,8 +46,13 @@ XMMATRIX Transform::GetScaleM()
 
 XMMATRIX Transform::GetRotationM()
 {
-	XMVECTOR rot = GetRotation();
-	return XMMatrixRotationRollPitchYawFromVector(rot * XM_PI / 180);
+	if (mRotationVersion != mVersion)
+	{
+		XMVECTOR rot = GetRotation();
+		XMStoreFloat4x4(&mRotationM, XMMatrixRotationRollPitchYawFromVector(rot * XM_PI / 180));
+		mRotationVersion = mVersion;
+	}
+	return XMLoadFloat4x4(&mRotationM);
 }
 
 XMMATRIX Transform::GetRotationQuaternionM()
@@ -54,7 +62,12 @@ XMMATRIX Transform::GetRotationQuaternionM()
 
 XMMATRIX Transform::GetTransformM()
 {
-	return GetScaleM() * GetRotationM() * GetTranslateM();
+	if (mTransformVersion != mVersion)
+	{
+		XMStoreFloat4x4(&mTransformM, GetScaleM() * GetRotationM() * GetTranslateM());
+		mTransformVersion = mVersion;
+	}
+	return XMLoadFloat4x4(&mTransformM);
 }
 
 XMMATRIX Transform::GetFinalM()
@@ -76,23 +89,88 @@ XMMATRIX Transform::GetFinalM()
 	
 	void Transform::SetPosition(XMVECTOR pos)
 	{
-		XMStoreFloat3(&mPosition, pos);
+		XMFLOAT3 position;
+		XMStoreFloat3(&position, pos);
+		if (memcmp(&position, &mPosition, sizeof(position)) == 0) return;
+		mPosition = position;
+		++mVersion;
 	}
 	
 	void Transform::SetRotation(XMVECTOR rot)
 	{
-		XMStoreFloat3(&mRotation, rot);
+		XMFLOAT3 rotation;
+		XMStoreFloat3(&rotation, rot);
+		if (memcmp(&rotation, &mRotation, sizeof(rotation)) == 0) return;
+		mRotation = rotation;
 		XMStoreFloat4(&mQuaternion, GetQuaternionFromRotation());
+		++mVersion;
 	}
 	
 	void Transform::SetQuaternion(XMVECTOR qua)
 	{
-		XMStoreFloat4(&mQuaternion, qua);
+		XMFLOAT4 quaternion;
+		XMStoreFloat4(&quaternion, qua);
+		if (memcmp(&quaternion, &mQuaternion, sizeof(quaternion)) == 0) return;
+		mQuaternion = quaternion;
+		++mVersion;
 	}
 	
 	void Transform::SetFinalM(XMMATRIX finalM)
 	{
 		XMStoreFloat4x4(&mFinalM, finalM);
+		++mFinalVersion;
+	}
+
+	void Transform::SaveStepStart()
+	{
+		mPrevFinalM = mFinalM;
+		mStepStartFinalVersion = mFinalVersion;
+		mStepStartRotation = mRotation;
+		mStepStartPosition = mPosition;
+	}
+
+	uint32_t Transform::GetVersion()
+	{
+		return mVersion;
+	}
+
+	uint32_t Transform::GetFinalVersion()
+	{
+		return mFinalVersion;
+	}
+
+	bool Transform::IsMovingThisStep()
+	{
+		return mStepStartFinalVersion != mFinalVersion;
+	}
+
+	XMVECTOR Transform::GetStepStartPosition()
+	{
+		return XMVectorSet(mStepStartPosition.x, mStepStartPosition.y, mStepStartPosition.z, 1.0f);
+	}
+
+	XMMATRIX Transform::GetStepStartRotationM()
+	{
+		XMVECTOR rot = XMLoadFloat3(&mStepStartRotation);
+		return XMMatrixRotationRollPitchYawFromVector(rot * XM_PI / 180);
+	}
+
+	XMMATRIX Transform::GetInterpolatedFinalM(float alpha)
+	{
+		XMMATRIX finalM = GetFinalM();
+		if (alpha >= 1.0f || !IsMovingThisStep()) return finalM;
+
+		// ũ/ȸ/̵ ؼ Ѵ. ذ  Ǵ ( )   ״ .
+		XMVECTOR prevScale, prevRotation, prevTranslation;
+		XMVECTOR scale, rotation, translation;
+		if (!XMMatrixDecompose(&prevScale, &prevRotation, &prevTranslation, XMLoadFloat4x4(&mPrevFinalM))) return finalM;
+		if (!XMMatrixDecompose(&scale, &rotation, &translation, finalM)) return finalM;
+
+		return XMMatrixAffineTransformation(
+			XMVectorLerp(prevScale, scale, alpha),
+			XMVectorZero(),
+			XMQuaternionSlerp(prevRotation, rotation, alpha),
+			XMVectorLerp(prevTranslation, translation, alpha));
 	}
 
 XMMATRIX AdjustTransform::GetTranslateM()
@@ -105,6 +183,8 @@ AdjustTransform::AdjustTransform(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale)
 	XMStoreFloat3(&mScale, scale);
 	XMStoreFloat3(&mRotation, rot);
 	XMStoreFloat3(&mPosition, pos);
+	XMStoreFloat4x4(&mRotationM, XMMatrixRotationRollPitchYawFromVector(rot * XM_PI / 180));
+	XMStoreFloat4x4(&mTransformM, GetScaleM() * GetRotationM() * GetTranslateM());
 }
 
 XMMATRIX AdjustTransform::GetScaleM()
@@ -114,13 +194,12 @@ XMMATRIX AdjustTransform::GetScaleM()
 
 XMMATRIX AdjustTransform::GetRotationM()
 {
-	XMVECTOR rot = XMLoadFloat3(&mRotation);
-	return XMMatrixRotationRollPitchYawFromVector(rot * XM_PI / 180);
+	return XMLoadFloat4x4(&mRotationM);
 }
 
 XMMATRIX AdjustTransform::GetTransformM()
 {
-	return GetScaleM() * GetRotationM() * GetTranslateM();
+	return XMLoadFloat4x4(&mTransformM);
 }
 
 XMVECTOR Gravity::ProcessGravity(XMVECTOR pos, float deltaTime)
@@ -1,9 +1,8 @@
 #pragma once
 #include <variant>
 #include <DirectXCollision.h>
-#include "stdafx.h"
+#include "CoreTypes.h"
 #include "Info.h"
-#include "FbxExtractor.h"
 #include <queue>
 
 struct Component // ü  ʴ Ŭ
@@ -15,7 +14,7 @@ class Transform : public Component
 {
 public:
 	//Transform(XMFLOAT3&& pos, XMFLOAT3&& rot = { 0.0f, 0.0f, 0.0f }, XMFLOAT3&& scale = { 1.0f, 1.0f, 1.0f });
-	Transform(XMVECTOR pos, XMVECTOR rot = { 0.0f, 0.0f, 0.0f, 0.0f }, XMVECTOR scale = { 1.0f, 1.0f, 1.0f, 0.0f });
+	Transform(XMVECTOR pos, XMVECTOR rot = XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVECTOR scale = XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f));
 	XMVECTOR GetScale();
 	XMVECTOR GetRotation();
 	XMVECTOR GetQuaternion();
@@ -30,23 +29,49 @@ public:
 	void SetRotation(XMVECTOR rot);
 	void SetQuaternion(XMVECTOR qua);
 	void SetFinalM(XMMATRIX finalM);
+	//   :       ΰ    .
+	// ġ ȸ   ξ,    ٸ Ʈ   д´.
+	void SaveStepStart();
+	XMMATRIX GetInterpolatedFinalM(float alpha);
+	XMVECTOR GetStepStartPosition();
+	XMMATRIX GetStepStartRotationM();
+	//   ٲ  ö󰡴 .  İ ȸ    ĳؼ ٽ  ʴ´.
+	// ĳø ä Get Լ ̹Ƿ,   ߿ ڱ Ʈ Transform  θ.
+	uint32_t GetVersion();
+	//   SetFinalM  ٲ Ƚ.   ķ ״θ  ʿ䰡 .
+	uint32_t GetFinalVersion();
+	bool IsMovingThisStep();
 private:
 	XMVECTOR GetQuaternionFromRotation();
 	XMFLOAT3 mScale{ 1.0f, 1.0f, 1.0f };
 	XMFLOAT3 mRotation{ 0.0f, 0.0f, 0.0f };
 	XMFLOAT4 mQuaternion{ 0.0f, 0.0f, 0.0f, 1.0f };
 	XMFLOAT3 mPosition{ 0.0f, 0.0f, 0.0f };
+	XMFLOAT3 mStepStartRotation{ 0.0f, 0.0f, 0.0f };
+	XMFLOAT3 mStepStartPosition{ 0.0f, 0.0f, 0.0f };
 	XMFLOAT4X4 mFinalM{
 	1.0f, 0.0f, 0.0f, 0.0f,
 	0.0f, 1.0f, 0.0f, 0.0f,
 	0.0f, 0.0f, 1.0f, 0.0f,
 	0.0f, 0.0f, 0.0f, 1.0f };
+	XMFLOAT4X4 mPrevFinalM{
+	1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 1.0f };
+	uint32_t mVersion = 0;
+	XMFLOAT4X4 mTransformM;
+	uint32_t mTransformVersion = UINT32_MAX;
+	XMFLOAT4X4 mRotationM;
+	uint32_t mRotationVersion = UINT32_MAX;
+	uint32_t mFinalVersion = 0;
+	uint32_t mStepStartFinalVersion = 0;
 };
 
 class AdjustTransform : public Component
 {
 public:
-	AdjustTransform(XMVECTOR pos = { 0.0f, 0.0f, 0.0f, 0.0f }, XMVECTOR rot = { 0.0f, 0.0f, 0.0f, 0.0f }, XMVECTOR scale = { 1.0f, 1.0f, 1.0f, 0.0f });
+	AdjustTransform(XMVECTOR pos = XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVECTOR rot = XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVECTOR scale = XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f));
 	XMMATRIX GetScaleM();
 	XMMATRIX GetRotationM();
 	XMMATRIX GetTranslateM();
@@ -55,6 +80,9 @@ private:
 	XMFLOAT3 mScale{ 1.0f, 1.0f, 1.0f };
 	XMFLOAT3 mRotation{ 0.0f, 0.0f, 0.0f };
 	XMFLOAT3 mPosition{ 0.0f, 0.0f, 0.0f };
+	//  Ŀ ٲ Ƿ ڿ   .
+	XMFLOAT4X4 mRotationM;
+	XMFLOAT4X4 mTransformM;
 };
 
 struct Mesh : public Component
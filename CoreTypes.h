@@ -0,0 +1,57 @@
+#pragma once
+
+// What the simulation core (Scene, Object, the components, Shadow, ResourceManager, Simulation) includes
+// instead of stdafx.h: the Windows integer types and virtual-key codes it uses, DirectXMath and the standard
+// headers. Nothing from D3D12, DXGI or the FBX SDK, so the core also builds on Linux (CMakeLists.txt).
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cstdint>
+using BYTE = uint8_t;
+using UINT = uint32_t;
+using UINT64 = uint64_t;
+
+// The virtual-key codes the core reads from the key state, with their Windows values (InputScript.cpp has the names).
+#define VK_LBUTTON 0x01
+#define VK_SHIFT 0x10
+#define VK_CONTROL 0x11
+#define VK_ESCAPE 0x1B
+#define VK_SPACE 0x20
+#define VK_F1 0x70
+#define VK_F9 0x78
+
+// Debug output goes to the attached debugger on Windows; there is none to send it to here.
+inline void OutputDebugStringA(const char*) {}
+inline void OutputDebugStringW(const wchar_t*) {}
+#endif
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <cfloat>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+using namespace DirectX;
+
+template<typename T> using ptr = T*;
+
+inline void ThrowIfFailed(bool result)
+{
+	if (!result)
+	{
+		throw std::runtime_error("exception");
+	}
+}
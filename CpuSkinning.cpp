@@ -0,0 +1,152 @@
+#include "CpuSkinning.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include "Info.h"
+
+// MSVC compiles AVX2 intrinsics anywhere. GCC and Clang only in functions built for those instructions, so the
+// kernel and the XCR0 read ask for them and the rest of the file stays baseline x64.
+#ifdef _MSC_VER
+#define TARGET_AVX2
+#define TARGET_XSAVE
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TARGET_XSAVE __attribute__((target("xsave")))
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	TARGET_XSAVE bool DetectAvx2()
+	{
+		// AVX2 and FMA from CPUID, and the OS must save the YMM registers (OSXSAVE + XCR0 bits 1 and 2).
+		int info[4] = {};
+#ifdef _MSC_VER
+		__cpuid(info, 0);
+		if (info[0] < 7) return false;
+		__cpuidex(info, 1, 0);
+#else
+		unsigned int maxLeaf = __get_cpuid_max(0, nullptr);
+		if (maxLeaf < 7) return false;
+		__cpuid_count(1, 0, info[0], info[1], info[2], info[3]);
+#endif
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		if (!fma || !osxsave || !avx) return false;
+		if ((_xgetbv(0) & 0x6) != 0x6) return false;
+#ifdef _MSC_VER
+		__cpuidex(info, 7, 0);
+#else
+		__cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+#endif
+		return (info[1] & (1 << 5)) != 0;
+	}
+}
+
+eSkinningKernel CpuSkinning::GetBestKernel()
+{
+	static const eSkinningKernel best = DetectAvx2() ? eSkinningKernel::Avx2 : eSkinningKernel::Scalar;
+	return best;
+}
+
+const char* CpuSkinning::GetKernelName(eSkinningKernel kernel)
+{
+	return kernel == eSkinningKernel::Avx2 ? "avx2" : "scalar";
+}
+
+void CpuSkinning::Skin(eSkinningKernel kernel, const Vertex* vertices, size_t count, const XMFLOAT4* palette, SkinnedVertex* out)
+{
+	if (kernel == eSkinningKernel::Avx2) SkinAvx2(vertices, count, palette, out);
+	else SkinScalar(vertices, count, palette, out);
+}
+
+void CpuSkinning::Skin(const Vertex* vertices, size_t count, const XMFLOAT4* palette, SkinnedVertex* out)
+{
+	Skin(GetBestKernel(), vertices, count, palette, out);
+}
+
+float CpuSkinning::Compare(const SkinnedVertex* expected, const SkinnedVertex* actual, size_t count)
+{
+	float error = 0.0f;
+	for (size_t i = 0; i < count; ++i) {
+		const float* a = &expected[i].position.x;
+		const float* b = &actual[i].position.x;
+		for (int k = 0; k < 8; ++k) {
+			error = std::max(error, fabsf(a[k] - b[k]) / std::max(1.0f, fabsf(a[k])));
+		}
+	}
+	return error;
+}
+
+void CpuSkinning::SkinScalar(const Vertex* vertices, size_t count, const XMFLOAT4* palette, SkinnedVertex* out)
+{
+	const float* rows = &palette[0].x;
+	for (size_t i = 0; i < count; ++i) {
+		const Vertex& v = vertices[i];
+		const float* weights = &v.weight.x;
+		float m[12] = {};
+		for (int k = 0; k < 4; ++k) {
+			const float* bone = rows + v.boneIndex[k] * 12;
+			for (int e = 0; e < 12; ++e) m[e] += weights[k] * bone[e];
+		}
+
+		const XMFLOAT3& p = v.position;
+		const XMFLOAT3& n = v.normal;
+		SkinnedVertex& s = out[i];
+		s.position.x = m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3];
+		s.position.y = m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7];
+		s.position.z = m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11];
+		float nx = m[0] * n.x + m[1] * n.y + m[2] * n.z;
+		float ny = m[4] * n.x + m[5] * n.y + m[6] * n.z;
+		float nz = m[8] * n.x + m[9] * n.y + m[10] * n.z;
+		float length = sqrtf(nx * nx + ny * ny + nz * nz);
+		float scale = length > 0.0f ? 1.0f / length : 0.0f;
+		s.normal = { nx * scale, ny * scale, nz * scale };
+		s.uv = v.uv;
+	}
+}
+
+TARGET_AVX2 void CpuSkinning::SkinAvx2(const Vertex* vertices, size_t count, const XMFLOAT4* palette, SkinnedVertex* out)
+{
+	const float* rows = &palette[0].x;
+	const __m128 zero = _mm_setzero_ps();
+	for (size_t i = 0; i < count; ++i) {
+		const Vertex& v = vertices[i];
+		const float* weights = &v.weight.x;
+		__m256 m01 = _mm256_setzero_ps(); // rows 0 and 1 of the blended matrix
+		__m128 m2 = _mm_setzero_ps();     // row 2
+		for (int k = 0; k < 4; ++k) {
+			const float* bone = rows + v.boneIndex[k] * 12;
+			__m256 w = _mm256_broadcast_ss(weights + k);
+			m01 = _mm256_fmadd_ps(w, _mm256_loadu_ps(bone), m01);
+			m2 = _mm_fmadd_ps(_mm256_castps256_ps128(w), _mm_loadu_ps(bone + 8), m2);
+		}
+
+		__m128 p = _mm_setr_ps(v.position.x, v.position.y, v.position.z, 1.0f);
+		__m128 n = _mm_setr_ps(v.normal.x, v.normal.y, v.normal.z, 0.0f);
+		__m256 h = _mm256_hadd_ps(_mm256_mul_ps(m01, _mm256_set_m128(p, p)), _mm256_mul_ps(m01, _mm256_set_m128(n, n)));
+		h = _mm256_hadd_ps(h, h); // low lane (r0.p, r0.n, r0.p, r0.n), high lane the same for r1
+		__m128 u = _mm_hadd_ps(_mm_mul_ps(m2, p), _mm_mul_ps(m2, n));
+		u = _mm_hadd_ps(u, u); // (r2.p, r2.n, r2.p, r2.n)
+		__m128 x = _mm_unpacklo_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1)); // (r0.p, r1.p, r0.n, r1.n)
+		__m128 position = _mm_shuffle_ps(x, u, _MM_SHUFFLE(1, 0, 1, 0));
+		__m128 normal = _mm_shuffle_ps(x, u, _MM_SHUFFLE(0, 1, 3, 2));
+
+		__m128 lengthSq = _mm_dp_ps(normal, normal, 0x7F);
+		normal = _mm_and_ps(_mm_div_ps(normal, _mm_sqrt_ps(lengthSq)), _mm_cmpgt_ps(lengthSq, zero));
+
+		// Each store writes one float past its field; the next field is written after it, and uv is
+		// the last field, so nothing outside this vertex is touched.
+		SkinnedVertex& s = out[i];
+		_mm_storeu_ps(&s.position.x, position);
+		_mm_storeu_ps(&s.normal.x, normal);
+		s.uv = v.uv;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <DirectXMath.h>
+
+#define CPU_SKINNING_TOLERANCE 1e-4f // relative difference allowed between the kernels
+
+struct Vertex;
+
+// A vertex after skinning: what the vertex shaders compute from the bone palette, plus the uv so the
+// result can be drawn without the source vertex.
+struct SkinnedVertex
+{
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT3 normal;
+	DirectX::XMFLOAT2 uv;
+};
+
+enum class eSkinningKernel
+{
+	Scalar,
+	Avx2
+};
+
+// Linear blend skinning on the CPU with the same math as Opaque.hlsl: every vertex blends the four
+// bones named by Vertex::boneIndex with Vertex::weight into one 3x4 matrix, transforms its position
+// and normal by it and renormalises the normal. palette holds three float4 rows per bone, as written
+// by SkinnedData::GetFinalPalette. Bone indices are trusted.
+class CpuSkinning
+{
+public:
+	// Avx2 when both the processor and the OS support AVX2 and FMA, otherwise Scalar.
+	static eSkinningKernel GetBestKernel();
+	static const char* GetKernelName(eSkinningKernel kernel);
+
+	static void Skin(eSkinningKernel kernel, const Vertex* vertices, size_t count, const DirectX::XMFLOAT4* palette, SkinnedVertex* out);
+	static void Skin(const Vertex* vertices, size_t count, const DirectX::XMFLOAT4* palette, SkinnedVertex* out);
+
+	// Largest difference between two skinned arrays, relative to the magnitude of the first.
+	static float Compare(const SkinnedVertex* expected, const SkinnedVertex* actual, size_t count);
+
+private:
+	static void SkinScalar(const Vertex* vertices, size_t count, const DirectX::XMFLOAT4* palette, SkinnedVertex* out);
+	// One vertex per iteration: the blended matrix is two rows in a 256-bit register and one in a
+	// 128-bit register, accumulated with FMA, and the six dot products come out of two hadd rounds.
+	static void SkinAvx2(const Vertex* vertices, size_t count, const DirectX::XMFLOAT4* palette, SkinnedVertex* out);
+};
@@ -0,0 +1,322 @@
+#include "D3D12RenderDevice.h"
+#include "DXSampleHelper.h"
+
+namespace
+{
+	D3D12_RESOURCE_STATES ToD3D12(RenderState state)
+	{
+		switch (state)
+		{
+		case RenderState::GenericRead: return D3D12_RESOURCE_STATE_GENERIC_READ;
+		case RenderState::CopySource: return D3D12_RESOURCE_STATE_COPY_SOURCE;
+		case RenderState::CopyDest: return D3D12_RESOURCE_STATE_COPY_DEST;
+		case RenderState::DepthWrite: return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+		case RenderState::RenderTarget: return D3D12_RESOURCE_STATE_RENDER_TARGET;
+		case RenderState::Present: return D3D12_RESOURCE_STATE_PRESENT;
+		default: return D3D12_RESOURCE_STATE_COMMON;
+		}
+	}
+
+	D3D12_DESCRIPTOR_HEAP_TYPE ToD3D12(RenderDescriptorType type)
+	{
+		switch (type)
+		{
+		case RenderDescriptorType::Rtv: return D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+		case RenderDescriptorType::Dsv: return D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+		default: return D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+		}
+	}
+}
+
+D3D12RenderDevice::D3D12RenderDevice(ID3D12Device* device, ID3D12GraphicsCommandList* commandList) :
+	mDevice{ device },
+	mCommandList{ commandList }
+{
+}
+
+RenderBuffer D3D12RenderDevice::CreateUploadBuffer(uint64_t size)
+{
+	ComPtr<ID3D12Resource> resource;
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(size),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&resource)));
+
+	// Upload buffers stay mapped until released; the CPU never reads them.
+	RenderBuffer buffer;
+	CD3DX12_RANGE readRange(0, 0);
+	ThrowIfFailed(resource->Map(0, &readRange, reinterpret_cast<void**>(&buffer.mappedData)));
+	buffer.address = resource->GetGPUVirtualAddress();
+	buffer.size = size;
+	buffer.resource = Keep(move(resource));
+	return buffer;
+}
+
+RenderBuffer D3D12RenderDevice::CreateStaticBuffer(const void* data, uint64_t size)
+{
+	ComPtr<ID3D12Resource> resource;
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(size),
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&resource)));
+
+	ComPtr<ID3D12Resource> staging;
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(size),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&staging)));
+
+	D3D12_SUBRESOURCE_DATA subResourceData{};
+	subResourceData.pData = data;
+	subResourceData.RowPitch = static_cast<LONG_PTR>(size);
+	subResourceData.SlicePitch = subResourceData.RowPitch;
+
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(resource.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
+	UpdateSubresources(mCommandList, resource.Get(), staging.Get(), 0, 0, 1, &subResourceData);
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(resource.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+	mStagingBuffers.push_back(move(staging));
+	mUploadBytes += size;
+
+	RenderBuffer buffer;
+	buffer.address = resource->GetGPUVirtualAddress();
+	buffer.size = size;
+	buffer.resource = Keep(move(resource));
+	return buffer;
+}
+
+RenderTexture D3D12RenderDevice::CreateDepthTexture(uint32_t width, uint32_t height, RenderState initialState)
+{
+	// Typeless so the same texture can be a depth target and a shader resource.
+	D3D12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R24G8_TYPELESS, width, height, 1, 1);
+	resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+	D3D12_CLEAR_VALUE clearValue{};
+	clearValue.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	clearValue.DepthStencil.Depth = 1.f;
+	clearValue.DepthStencil.Stencil = 0;
+
+	ComPtr<ID3D12Resource> resource;
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&resourceDesc,
+		ToD3D12(initialState),
+		&clearValue,
+		IID_PPV_ARGS(&resource)));
+
+	RenderTexture texture;
+	texture.width = width;
+	texture.height = height;
+	texture.resource = Keep(move(resource));
+	return texture;
+}
+
+void D3D12RenderDevice::Release(RenderHandle resource)
+{
+	mResources.erase(resource);
+}
+
+void D3D12RenderDevice::Write(const RenderBuffer& buffer, uint64_t offset, const void* data, uint64_t size)
+{
+	memcpy(buffer.mappedData + offset, data, static_cast<size_t>(size));
+	mUploadBytes += size;
+}
+
+RenderDescriptorHeap D3D12RenderDevice::CreateDescriptorHeap(RenderDescriptorType type, uint32_t count, bool shaderVisible)
+{
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+	heapDesc.NumDescriptors = count;
+	heapDesc.Type = ToD3D12(type);
+	heapDesc.Flags = shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	ComPtr<ID3D12DescriptorHeap> descriptorHeap;
+	ThrowIfFailed(mDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&descriptorHeap)));
+
+	RenderDescriptorHeap heap;
+	heap.heap = ToHandle(descriptorHeap.Get());
+	heap.cpuStart = descriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
+	if (shaderVisible) heap.gpuStart = descriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+	heap.increment = mDevice->GetDescriptorHandleIncrementSize(heapDesc.Type);
+	heap.count = count;
+	mHeaps.push_back(move(descriptorHeap));
+	return heap;
+}
+
+void D3D12RenderDevice::CreateConstantBufferView(RenderAddress address, uint32_t size, RenderDescriptor descriptor)
+{
+	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
+	cbvDesc.BufferLocation = address;
+	cbvDesc.SizeInBytes = size;
+	mDevice->CreateConstantBufferView(&cbvDesc, D3D12_CPU_DESCRIPTOR_HANDLE{ descriptor });
+}
+
+void D3D12RenderDevice::CreateDepthStencilView(const RenderTexture& texture, RenderDescriptor descriptor)
+{
+	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
+	dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+	dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	dsvDesc.Texture2D.MipSlice = 0;
+	mDevice->CreateDepthStencilView(ToResource(texture.resource), &dsvDesc, D3D12_CPU_DESCRIPTOR_HANDLE{ descriptor });
+}
+
+void D3D12RenderDevice::CreateDepthShaderResourceView(const RenderTexture* texture, RenderDescriptor descriptor)
+{
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = 1;
+	srvDesc.Texture2D.PlaneSlice = 0;
+	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+	mDevice->CreateShaderResourceView(texture ? ToResource(texture->resource) : nullptr, &srvDesc, D3D12_CPU_DESCRIPTOR_HANDLE{ descriptor });
+}
+
+void D3D12RenderDevice::CreateStructuredBufferView(const RenderBuffer& buffer, uint32_t stride, RenderDescriptor descriptor)
+{
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = static_cast<UINT>(buffer.size / stride);
+	srvDesc.Buffer.StructureByteStride = stride;
+	srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
+	mDevice->CreateShaderResourceView(ToResource(buffer.resource), &srvDesc, D3D12_CPU_DESCRIPTOR_HANDLE{ descriptor });
+}
+
+void D3D12RenderDevice::BeginFrame(uint64_t frame)
+{
+	// Framework resets, closes and submits the command list. It waits for each frame before recording the
+	// next one, so the copies out of earlier staging buffers are done by now.
+	mStagingBuffers.clear();
+}
+
+void D3D12RenderDevice::EndFrame()
+{
+}
+
+void D3D12RenderDevice::SetRootSignature(RenderHandle rootSignature)
+{
+	mCommandList->SetGraphicsRootSignature(reinterpret_cast<ID3D12RootSignature*>(rootSignature));
+}
+
+void D3D12RenderDevice::SetPipelineState(RenderHandle pipeline)
+{
+	mCommandList->SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(pipeline));
+}
+
+void D3D12RenderDevice::SetDescriptorHeap(RenderHandle heap)
+{
+	ID3D12DescriptorHeap* ppHeaps[] = { reinterpret_cast<ID3D12DescriptorHeap*>(heap) };
+	mCommandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+}
+
+void D3D12RenderDevice::SetRootDescriptorTable(uint32_t slot, RenderDescriptor descriptor)
+{
+	mCommandList->SetGraphicsRootDescriptorTable(slot, D3D12_GPU_DESCRIPTOR_HANDLE{ descriptor });
+}
+
+void D3D12RenderDevice::SetRootConstantBuffer(uint32_t slot, RenderAddress address)
+{
+	mCommandList->SetGraphicsRootConstantBufferView(slot, address);
+}
+
+void D3D12RenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	D3D12_VIEWPORT d3dViewport{ viewport.x, viewport.y, viewport.width, viewport.height, viewport.minDepth, viewport.maxDepth };
+	mCommandList->RSSetViewports(1, &d3dViewport);
+}
+
+void D3D12RenderDevice::SetScissor(const RenderRect& rect)
+{
+	D3D12_RECT d3dRect{ rect.left, rect.top, rect.right, rect.bottom };
+	mCommandList->RSSetScissorRects(1, &d3dRect);
+}
+
+void D3D12RenderDevice::SetTriangleList()
+{
+	mCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void D3D12RenderDevice::SetVertexBuffer(RenderAddress address, uint32_t size, uint32_t stride)
+{
+	D3D12_VERTEX_BUFFER_VIEW view{ address, size, stride };
+	mCommandList->IASetVertexBuffers(0, 1, &view);
+}
+
+void D3D12RenderDevice::SetIndexBuffer(RenderAddress address, uint32_t size)
+{
+	D3D12_INDEX_BUFFER_VIEW view{ address, size, DXGI_FORMAT_R32_UINT };
+	mCommandList->IASetIndexBuffer(&view);
+}
+
+void D3D12RenderDevice::SetRenderTarget(RenderDescriptor renderTarget, RenderDescriptor depthStencil)
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE rtv{ renderTarget };
+	D3D12_CPU_DESCRIPTOR_HANDLE dsv{ depthStencil };
+	mCommandList->OMSetRenderTargets(renderTarget ? 1 : 0, renderTarget ? &rtv : nullptr, FALSE, depthStencil ? &dsv : nullptr);
+}
+
+void D3D12RenderDevice::ClearRenderTarget(RenderDescriptor renderTarget, const float color[4])
+{
+	mCommandList->ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE{ renderTarget }, color, 0, nullptr);
+}
+
+void D3D12RenderDevice::ClearDepthStencil(RenderDescriptor depthStencil, float depth, uint8_t stencil)
+{
+	mCommandList->ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE{ depthStencil }, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, depth, stencil, 0, nullptr);
+}
+
+void D3D12RenderDevice::Barrier(RenderHandle resource, RenderState before, RenderState after)
+{
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(ToResource(resource), ToD3D12(before), ToD3D12(after)));
+}
+
+void D3D12RenderDevice::CopyResource(RenderHandle destination, RenderHandle source)
+{
+	mCommandList->CopyResource(ToResource(destination), ToResource(source));
+}
+
+void D3D12RenderDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	mCommandList->DrawInstanced(vertexCount, 1, startVertex, 0);
+}
+
+void D3D12RenderDevice::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	mCommandList->DrawIndexedInstanced(indexCount, 1, startIndex, baseVertex, 0);
+}
+
+RenderHandle D3D12RenderDevice::ToHandle(ID3D12Object* object)
+{
+	return reinterpret_cast<RenderHandle>(object);
+}
+
+ID3D12Resource* D3D12RenderDevice::ToResource(RenderHandle handle)
+{
+	return reinterpret_cast<ID3D12Resource*>(handle);
+}
+
+uint64_t D3D12RenderDevice::GetUploadBytes() const
+{
+	return mUploadBytes;
+}
+
+RenderHandle D3D12RenderDevice::Keep(ComPtr<ID3D12Resource> resource)
+{
+	RenderHandle handle = ToHandle(resource.Get());
+	mResources.emplace(handle, move(resource));
+	return handle;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "stdafx.h"
+#include "RenderDevice.h"
+
+// RenderDevice on top of an ID3D12Device and the frame's graphics command list. Handles are the raw
+// resource, heap and pipeline pointers, descriptor handle values and GPU virtual addresses, so code
+// that still talks to D3D12 directly (root signature, PSOs, texture loading) can mix with it.
+class D3D12RenderDevice : public RenderDevice
+{
+public:
+	D3D12RenderDevice(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
+	D3D12RenderDevice(const D3D12RenderDevice&) = delete;
+	D3D12RenderDevice& operator=(const D3D12RenderDevice&) = delete;
+
+	RenderBuffer CreateUploadBuffer(uint64_t size) override;
+	RenderBuffer CreateStaticBuffer(const void* data, uint64_t size) override;
+	RenderTexture CreateDepthTexture(uint32_t width, uint32_t height, RenderState initialState) override;
+	void Release(RenderHandle resource) override;
+	void Write(const RenderBuffer& buffer, uint64_t offset, const void* data, uint64_t size) override;
+
+	RenderDescriptorHeap CreateDescriptorHeap(RenderDescriptorType type, uint32_t count, bool shaderVisible) override;
+	void CreateConstantBufferView(RenderAddress address, uint32_t size, RenderDescriptor descriptor) override;
+	void CreateDepthStencilView(const RenderTexture& texture, RenderDescriptor descriptor) override;
+	void CreateDepthShaderResourceView(const RenderTexture* texture, RenderDescriptor descriptor) override;
+	void CreateStructuredBufferView(const RenderBuffer& buffer, uint32_t stride, RenderDescriptor descriptor) override;
+
+	void BeginFrame(uint64_t frame) override;
+	void EndFrame() override;
+	void SetRootSignature(RenderHandle rootSignature) override;
+	void SetPipelineState(RenderHandle pipeline) override;
+	void SetDescriptorHeap(RenderHandle heap) override;
+	void SetRootDescriptorTable(uint32_t slot, RenderDescriptor descriptor) override;
+	void SetRootConstantBuffer(uint32_t slot, RenderAddress address) override;
+	void SetViewport(const RenderViewport& viewport) override;
+	void SetScissor(const RenderRect& rect) override;
+	void SetTriangleList() override;
+	void SetVertexBuffer(RenderAddress address, uint32_t size, uint32_t stride) override;
+	void SetIndexBuffer(RenderAddress address, uint32_t size) override;
+	void SetRenderTarget(RenderDescriptor renderTarget, RenderDescriptor depthStencil) override;
+	void ClearRenderTarget(RenderDescriptor renderTarget, const float color[4]) override;
+	void ClearDepthStencil(RenderDescriptor depthStencil, float depth, uint8_t stencil) override;
+	void Barrier(RenderHandle resource, RenderState before, RenderState after) override;
+	void CopyResource(RenderHandle destination, RenderHandle source) override;
+	void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+
+	static RenderHandle ToHandle(ID3D12Object* object);
+	static ID3D12Resource* ToResource(RenderHandle handle);
+	// Bytes written to upload memory since the device was created: Write calls and static buffer contents.
+	uint64_t GetUploadBytes() const;
+
+private:
+	RenderHandle Keep(ComPtr<ID3D12Resource> resource);
+
+	ID3D12Device* mDevice = nullptr;
+	ID3D12GraphicsCommandList* mCommandList = nullptr;
+	unordered_map<RenderHandle, ComPtr<ID3D12Resource>> mResources;
+	vector<ComPtr<ID3D12Resource>> mStagingBuffers; // sources of static buffer copies, dropped at the next BeginFrame
+	uint64_t mUploadBytes = 0;
+	vector<ComPtr<ID3D12DescriptorHeap>> mHeaps;
+};
@@ -0,0 +1,260 @@
+#include "D3D12SceneGraphics.h"
+#include "DXSampleHelper.h"
+#include "D3D12RenderDevice.h"
+#include "TextureResidency.h"
+#include "CpuSkinning.h"
+
+D3D12SceneGraphics::D3D12SceneGraphics(ID3D12Device* device, UINT64 stagingSize, UINT loadThreads) :
+	mDevice{ device },
+	mStagingSize{ stagingSize },
+	mLoadThreads{ loadThreads }
+{
+}
+
+RenderHandle D3D12SceneGraphics::BuildPipelines(unordered_map<string, RenderHandle>& pipelines)
+{
+	BuildRootSignature();
+	BuildInputElement();
+	BuildShaders();
+	BuildPSO();
+	for (auto& [name, pso] : mPSOs)
+	{
+		pipelines[name] = D3D12RenderDevice::ToHandle(pso.Get());
+	}
+	return D3D12RenderDevice::ToHandle(mRootSignature.Get());
+}
+
+void D3D12SceneGraphics::BuildTextures(const RenderDescriptorHeap& heap, uint32_t tableIndex, uint32_t viewCount,
+	const vector<wstring>& fileNames, uint32_t tailSize)
+{
+	// Files are read and parsed on the loader threads and uploaded on the copy queue; until a texture is done its
+	// slot shows the placeholder. Only the tail mips up to tailSize come first, Scene asks for finer mips later.
+	mHeap = heap;
+	mTableIndex = tableIndex;
+	mTextureLoader = make_unique<TextureLoader>(mDevice, mStagingSize, mLoadThreads);
+	mTextures.resize(viewCount);
+	for (uint32_t slot = 0; slot < viewCount; ++slot)
+	{
+		CreateTextureView(slot, mTextureLoader->GetPlaceholder());
+	}
+	for (int slot = 0; slot < fileNames.size(); ++slot)
+	{
+		mTextureLoader->Request(slot, fileNames[slot], tailSize);
+	}
+}
+
+void D3D12SceneGraphics::ProcessTextureLoads(TextureResidency& residency)
+{
+	// The CPU waits for the GPU every frame, so a view rewritten here is not one the GPU is reading (DESCRIPTORS_VOLATILE).
+	vector<TextureLoader::LoadedTexture> completed;
+	mTextureLoader->Update(completed);
+	for (TextureLoader::LoadedTexture& loaded : completed)
+	{
+		UINT firstMip = loaded.mipCount - loaded.texture->GetDesc().MipLevels;
+		if (!residency.Contains(loaded.slot))
+		{
+			// First load, the tail. The size of every mip is estimated from the most detailed one loaded.
+			vector<uint64_t> mipBytes(loaded.mipCount);
+			for (UINT i = 0; i < loaded.mipCount; ++i)
+			{
+				if (i < firstMip) mipBytes[i] = loaded.topMipBytes << (2 * (firstMip - i));
+				else mipBytes[i] = std::max<uint64_t>(loaded.topMipBytes >> (2 * (i - firstMip)), 1);
+			}
+			residency.AddTexture(loaded.slot, std::max<UINT>(loaded.width, loaded.height), mipBytes, firstMip);
+		}
+		else if (firstMip != residency.GetResidentMip(loaded.slot))
+		{
+			continue; // a later request for this slot is still in flight
+		}
+
+		CreateTextureView(loaded.slot, loaded.texture.Get());
+		mTextures[loaded.slot] = move(loaded.texture);
+	}
+}
+
+void D3D12SceneGraphics::RequestTexture(int slot, const wstring& fileName, uint32_t maxSize)
+{
+	mTextureLoader->Request(slot, fileName, maxSize);
+}
+
+void D3D12SceneGraphics::CreateTextureView(int slot, ID3D12Resource* texture)
+{
+	// Describe and create a SRV for the texture.
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Format = texture->GetDesc().Format;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = texture->GetDesc().MipLevels;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE hDescriptor{ mHeap.GetCpu(mTableIndex + slot) };
+	mDevice->CreateShaderResourceView(texture, &srvDesc, hDescriptor);
+}
+
+void D3D12SceneGraphics::BuildRootSignature()
+{
+	// Create a root signature consisting of a descriptor table with a single CBV.
+	D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData{};
+
+	// This is the highest version the sample supports. If CheckFeatureSupport succeeds, the HighestVersion returned will not be greater than this.
+	featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+
+	if (FAILED(mDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+	{
+		featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+	}
+
+	CD3DX12_DESCRIPTOR_RANGE1 ranges[4] = {};
+	ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0, 0);
+	// Every texture as one unbounded range (t0, space1). Slots can be empty, so it is volatile.
+	ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 1, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE);
+	ranges[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 1, 0);
+	ranges[3].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 2, 0); // bone palette
+
+	CD3DX12_ROOT_PARAMETER1 rootParameters[5] = {};
+	rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_VERTEX);
+	rootParameters[1].InitAsDescriptorTable(1, &ranges[1], D3D12_SHADER_VISIBILITY_PIXEL);
+	rootParameters[2].InitAsConstantBufferView(1);
+	rootParameters[3].InitAsDescriptorTable(1, &ranges[2], D3D12_SHADER_VISIBILITY_PIXEL);
+	rootParameters[4].InitAsDescriptorTable(1, &ranges[3], D3D12_SHADER_VISIBILITY_VERTEX);
+
+	std::array<D3D12_STATIC_SAMPLER_DESC, 2> samplerDesc = {};
+	D3D12_STATIC_SAMPLER_DESC* descPtr = nullptr;
+
+	descPtr = &samplerDesc[0];
+	descPtr->Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	descPtr->AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	descPtr->AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	descPtr->AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	descPtr->MipLODBias = 0;
+	descPtr->MaxAnisotropy = 0; // only used by anisotropic filters
+	descPtr->ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	descPtr->BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+	descPtr->MinLOD = 0.0f;
+	descPtr->MaxLOD = D3D12_FLOAT32_MAX;
+	descPtr->ShaderRegister = 0;
+	descPtr->RegisterSpace = 0;
+	descPtr->ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+	descPtr = &samplerDesc[1];
+	descPtr->Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+	descPtr->AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+	descPtr->AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+	descPtr->AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+	descPtr->MipLODBias = 0;
+	descPtr->MaxAnisotropy = 0; // only used by anisotropic filters
+	descPtr->ComparisonFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	descPtr->BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
+	descPtr->MinLOD = 0.0f;
+	descPtr->MaxLOD = 0.0f;
+	descPtr->ShaderRegister = 1;
+	descPtr->RegisterSpace = 0;
+	descPtr->ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+	D3D12_ROOT_SIGNATURE_FLAGS flags =
+		D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, samplerDesc.size(), samplerDesc.data(), flags);
+
+	ComPtr<ID3DBlob> signature;
+	ComPtr<ID3DBlob> error;
+	ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &signature, &error));
+	ThrowIfFailed(mDevice->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&mRootSignature)));
+}
+
+void D3D12SceneGraphics::BuildShaders()
+{
+	mShaders["VS_Opaque"] = CompileShader(L"Shaders/Opaque.hlsl", nullptr, "VS", "vs_5_1");
+	mShaders["PS_Opaque"] = CompileShader(L"Shaders/Opaque.hlsl", nullptr, "PS", "ps_5_1");
+	mShaders["VS_Shadow"] = CompileShader(L"Shaders/Shadow.hlsl", nullptr, "VS", "vs_5_1");
+	mShaders["PS_Shadow"] = CompileShader(L"Shaders/Shadow.hlsl", nullptr, "PS", "ps_5_1");
+
+	// Vertex shaders for pre-skinned vertices. The pixel shaders stay the same.
+	const D3D_SHADER_MACRO preSkinned[] = { { "PRESKINNED", "1" }, { nullptr, nullptr } };
+	mShaders["VS_OpaqueSkinned"] = CompileShader(L"Shaders/Opaque.hlsl", preSkinned, "VS", "vs_5_1");
+	mShaders["VS_ShadowSkinned"] = CompileShader(L"Shaders/Shadow.hlsl", preSkinned, "VS", "vs_5_1");
+}
+
+void D3D12SceneGraphics::BuildInputElement()
+{
+	// Define the vertex input layout.
+	mInputElement =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "WEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "BONEINDEX", 0, DXGI_FORMAT_R32G32B32A32_SINT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+	mSkinnedInputElement =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(SkinnedVertex, position), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(SkinnedVertex, normal), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, offsetof(SkinnedVertex, uv), D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+}
+
+void D3D12SceneGraphics::BuildPSO()
+{
+	// Describe and create the graphics pipeline state object (PSO).
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+	psoDesc.InputLayout = { mInputElement.data(), static_cast<UINT>(mInputElement.size()) };
+	psoDesc.pRootSignature = mRootSignature.Get();
+	psoDesc.VS = CD3DX12_SHADER_BYTECODE(mShaders.at("VS_Opaque").Get());
+	psoDesc.PS = CD3DX12_SHADER_BYTECODE(mShaders.at("PS_Opaque").Get());
+	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+	psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	psoDesc.SampleMask = UINT_MAX;
+	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	psoDesc.NumRenderTargets = 1;
+	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	psoDesc.SampleDesc.Count = 1;
+	psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(mPSOs["PSO_Opaque"].GetAddressOf())));
+
+	psoDesc.RasterizerState.DepthBias = 10000;
+	psoDesc.RasterizerState.DepthBiasClamp = 0.0f;
+	psoDesc.RasterizerState.SlopeScaledDepthBias = 1.2f;
+	psoDesc.VS = CD3DX12_SHADER_BYTECODE(mShaders.at("VS_Shadow").Get());
+	psoDesc.PS = CD3DX12_SHADER_BYTECODE(mShaders.at("PS_Shadow").Get());
+	psoDesc.NumRenderTargets = 0;
+	psoDesc.RTVFormats[0] = DXGI_FORMAT_UNKNOWN;
+	ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(mPSOs["PSO_Shadow"].GetAddressOf())));
+
+	// The same two states taking pre-skinned vertices (SkinnedVertex).
+	psoDesc.InputLayout = { mSkinnedInputElement.data(), static_cast<UINT>(mSkinnedInputElement.size()) };
+	psoDesc.VS = CD3DX12_SHADER_BYTECODE(mShaders.at("VS_ShadowSkinned").Get());
+	ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(mPSOs["PSO_ShadowSkinned"].GetAddressOf())));
+
+	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	psoDesc.VS = CD3DX12_SHADER_BYTECODE(mShaders.at("VS_OpaqueSkinned").Get());
+	psoDesc.PS = CD3DX12_SHADER_BYTECODE(mShaders.at("PS_Opaque").Get());
+	psoDesc.NumRenderTargets = 1;
+	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(mPSOs["PSO_OpaqueSkinned"].GetAddressOf())));
+}
+
+ComPtr<ID3DBlob> D3D12SceneGraphics::CompileShader(
+	const std::wstring& fileName, const D3D_SHADER_MACRO* defines, const std::string& entryPoint, const std::string& target)
+{
+	UINT compileFlags = 0;
+#if defined(_DEBUG) || defined(DBG)
+	compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+	HRESULT hr;
+
+	ComPtr<ID3DBlob> byteCode = nullptr;
+	ComPtr<ID3DBlob> errors;
+	hr = D3DCompileFromFile(fileName.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+		entryPoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
+
+	if (errors != nullptr)
+	{
+		OutputDebugStringA((char*)errors->GetBufferPointer());
+	}
+	ThrowIfFailed(hr);
+
+	return byteCode;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "stdafx.h"
+#include "SceneGraphics.h"
+#include "TextureLoader.h"
+
+// SceneGraphics on an ID3D12Device: compiles the scene's shaders into its root signature and PSOs, and streams
+// its textures through a TextureLoader, writing their SRVs into the scene's texture table.
+class D3D12SceneGraphics : public SceneGraphics
+{
+public:
+	D3D12SceneGraphics(ID3D12Device* device, UINT64 stagingSize, UINT loadThreads);
+	D3D12SceneGraphics(const D3D12SceneGraphics&) = delete;
+	D3D12SceneGraphics& operator=(const D3D12SceneGraphics&) = delete;
+
+	RenderHandle BuildPipelines(unordered_map<string, RenderHandle>& pipelines) override;
+	void BuildTextures(const RenderDescriptorHeap& heap, uint32_t tableIndex, uint32_t viewCount,
+		const vector<wstring>& fileNames, uint32_t tailSize) override;
+	void ProcessTextureLoads(TextureResidency& residency) override;
+	void RequestTexture(int slot, const wstring& fileName, uint32_t maxSize) override;
+
+private:
+	void BuildRootSignature();
+	void BuildShaders();
+	void BuildInputElement();
+	void BuildPSO();
+	void CreateTextureView(int slot, ID3D12Resource* texture);
+	ComPtr<ID3DBlob> CompileShader(
+		const std::wstring& fileName, const D3D_SHADER_MACRO* defines, const std::string& entryPoint, const std::string& target);
+
+	ID3D12Device* mDevice = nullptr;
+	UINT64 mStagingSize = 0;
+	UINT mLoadThreads = 0;
+
+	ComPtr<ID3D12RootSignature> mRootSignature;
+	unordered_map<string, ComPtr<ID3D12PipelineState>> mPSOs;
+	unordered_map<string, ComPtr<ID3DBlob>> mShaders;
+	vector<D3D12_INPUT_ELEMENT_DESC> mInputElement;
+	vector<D3D12_INPUT_ELEMENT_DESC> mSkinnedInputElement; // SkinnedVertex, for the pre-skinned pipelines
+
+	RenderDescriptorHeap mHeap;
+	uint32_t mTableIndex = 0;
+	unique_ptr<TextureLoader> mTextureLoader;
+	vector<ComPtr<ID3D12Resource>> mTextures; // indexed by slot, nullptr until loaded
+};
@@ -0,0 +1,69 @@
+#include "DDSHeader.h"
+#include <cstring>
+
+namespace
+{
+	const uint32_t DDSMagic = 0x20534444; // "DDS "
+	const uint32_t DDSFourCC = 0x00000004;
+	const uint32_t DX10FourCC = 0x30315844; // "DX10"
+	const uint32_t DDSHeaderSize = 124;
+	const uint32_t DDSPixelFormatSize = 32;
+	const uint32_t DX10HeaderSize = 20;
+	const uint32_t MaxDimension = 16384;
+	const uint32_t MaxMipCount = 15;
+
+	// Field offsets inside DDS_HEADER, counted from the end of the magic number.
+	const size_t HeaderSizeOffset = 0;
+	const size_t HeightOffset = 8;
+	const size_t WidthOffset = 12;
+	const size_t DepthOffset = 20;
+	const size_t MipCountOffset = 24;
+	const size_t PixelFormatOffset = 72;
+	const size_t ArraySizeOffset = 12; // inside DDS_HEADER_DXT10
+
+	uint32_t ReadU32(const uint8_t* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(value)); // mappings are not guaranteed to be aligned
+		return value;
+	}
+}
+
+bool ParseDDSHeader(const uint8_t* data, size_t size, DDSInfo& info)
+{
+	info = DDSInfo{};
+	if (data == nullptr || size < sizeof(uint32_t) + DDSHeaderSize) return false;
+	if (ReadU32(data) != DDSMagic) return false;
+
+	const uint8_t* header = data + sizeof(uint32_t);
+	const uint8_t* pixelFormat = header + PixelFormatOffset;
+	if (ReadU32(header + HeaderSizeOffset) != DDSHeaderSize) return false;
+	if (ReadU32(pixelFormat) != DDSPixelFormatSize) return false;
+
+	info.height = ReadU32(header + HeightOffset);
+	info.width = ReadU32(header + WidthOffset);
+	info.depth = ReadU32(header + DepthOffset);
+	info.mipCount = ReadU32(header + MipCountOffset);
+	if (info.depth == 0) info.depth = 1;
+	if (info.mipCount == 0) info.mipCount = 1;
+
+	if (info.width == 0 || info.height == 0) return false;
+	if (info.width > MaxDimension || info.height > MaxDimension || info.depth > MaxDimension) return false;
+	if (info.mipCount > MaxMipCount) return false;
+
+	info.dataOffset = sizeof(uint32_t) + DDSHeaderSize;
+	const uint32_t pixelFlags = ReadU32(pixelFormat + 4);
+	const uint32_t fourCC = ReadU32(pixelFormat + 8);
+	if ((pixelFlags & DDSFourCC) && fourCC == DX10FourCC)
+	{
+		if (size < info.dataOffset + DX10HeaderSize) return false;
+		info.hasDX10Header = true;
+		info.arraySize = ReadU32(data + info.dataOffset + ArraySizeOffset);
+		if (info.arraySize == 0 || info.arraySize > 2048) return false;
+		info.dataOffset += DX10HeaderSize;
+	}
+
+	if (size <= info.dataOffset) return false;
+	info.dataSize = size - info.dataOffset;
+	return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// What the texture paths need to know about a DDS file before touching the device.
+struct DDSInfo
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t depth = 1;
+	uint32_t mipCount = 1;
+	uint32_t arraySize = 1;
+	bool hasDX10Header = false;
+	size_t dataOffset = 0; // first byte of pixel data
+	size_t dataSize = 0;
+};
+
+// Validates the DDS magic and header in place and fills info. Only reads inside [data, data + size),
+// so it is safe on a memory-mapped file of any length. Returns false for anything malformed.
+bool ParseDDSHeader(const uint8_t* data, size_t size, DDSInfo& info);
@@ -0,0 +1,131 @@
+#include "DescriptorAllocator.h"
+
+DescriptorAllocator::DescriptorAllocator(uint32_t persistentCount, uint32_t ringCount) :
+	mPersistentCount{ persistentCount },
+	mRingCount{ ringCount },
+	mGenerations(persistentCount, 0),
+	mLiveCounts(persistentCount, 0)
+{
+	if (persistentCount > 0) mFreeRanges.push_back({ 0, persistentCount });
+}
+
+DescriptorHandle DescriptorAllocator::Allocate(uint32_t count)
+{
+	DescriptorHandle handle{};
+	if (count == 0) return handle;
+
+	// First fit keeps long-lived views packed at the front of the heap.
+	for (auto it = mFreeRanges.begin(); it != mFreeRanges.end(); ++it)
+	{
+		if (it->count < count) continue;
+
+		handle.index = it->index;
+		handle.count = count;
+		handle.generation = mGenerations[it->index];
+
+		it->index += count;
+		it->count -= count;
+		if (it->count == 0) mFreeRanges.erase(it);
+
+		mLiveCounts[handle.index] = count;
+		return handle;
+	}
+	return handle;
+}
+
+bool DescriptorAllocator::Free(const DescriptorHandle& handle)
+{
+	if (!IsAlive(handle)) return false;
+
+	mLiveCounts[handle.index] = 0;
+	++mGenerations[handle.index];
+
+	auto it = mFreeRanges.begin();
+	while (it != mFreeRanges.end() && it->index < handle.index) ++it;
+	it = mFreeRanges.insert(it, { handle.index, handle.count });
+
+	// Merge with the following and preceding ranges.
+	auto next = it + 1;
+	if (next != mFreeRanges.end() && it->index + it->count == next->index)
+	{
+		it->count += next->count;
+		mFreeRanges.erase(next);
+	}
+	if (it != mFreeRanges.begin())
+	{
+		auto prev = it - 1;
+		if (prev->index + prev->count == it->index)
+		{
+			prev->count += it->count;
+			mFreeRanges.erase(it);
+		}
+	}
+	return true;
+}
+
+bool DescriptorAllocator::IsAlive(const DescriptorHandle& handle) const
+{
+	if (handle.IsNull() || handle.index >= mPersistentCount) return false;
+	return mGenerations[handle.index] == handle.generation && mLiveCounts[handle.index] == handle.count;
+}
+
+uint32_t DescriptorAllocator::AllocateTransient(uint32_t count)
+{
+	if (count == 0 || count > mRingCount) return UINT32_MAX;
+
+	if (mRingUsed == 0) mRingHead = 0;
+
+	uint32_t waste = 0;
+	if (mRingHead + count > mRingCount) waste = mRingCount - mRingHead; // wrap, ranges must be contiguous
+	if (mRingUsed + waste + count > mRingCount) return UINT32_MAX;
+
+	if (waste > 0) mRingHead = 0;
+	uint32_t index = mPersistentCount + mRingHead;
+
+	mRingHead = (mRingHead + count) % mRingCount;
+	mRingUsed += waste + count;
+	mRingFrameUsed += waste + count;
+	return index;
+}
+
+void DescriptorAllocator::FinishFrame(uint64_t fenceValue)
+{
+	mFrameMarkers.push_back({ fenceValue, mRingFrameUsed });
+	mRingFrameUsed = 0;
+}
+
+void DescriptorAllocator::Retire(uint64_t completedFenceValue)
+{
+	while (!mFrameMarkers.empty() && mFrameMarkers.front().fenceValue <= completedFenceValue)
+	{
+		mRingUsed -= mFrameMarkers.front().used;
+		mFrameMarkers.pop_front();
+	}
+}
+
+uint32_t DescriptorAllocator::GetHeapSize() const
+{
+	return mPersistentCount + mRingCount;
+}
+
+uint32_t DescriptorAllocator::GetPersistentCount() const
+{
+	return mPersistentCount;
+}
+
+uint32_t DescriptorAllocator::GetRingCount() const
+{
+	return mRingCount;
+}
+
+uint32_t DescriptorAllocator::GetFreePersistentCount() const
+{
+	uint32_t count = 0;
+	for (const FreeRange& range : mFreeRanges) count += range.count;
+	return count;
+}
+
+uint32_t DescriptorAllocator::GetUsedRingCount() const
+{
+	return mRingUsed;
+}
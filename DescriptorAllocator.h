@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <deque>
+
+// Index of a descriptor range inside a heap. The generation makes handles to
+// retired ranges detectable after the slots have been handed out again.
+struct DescriptorHandle
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t count = 0;
+	uint32_t generation = 0;
+	bool IsNull() const { return index == UINT32_MAX; }
+};
+
+// Slot bookkeeping for a descriptor heap, kept free of D3D12 so it runs without a device.
+// [0, persistentCount) is a free-list region for long-lived views (CBVs, textures, shadow maps).
+// [persistentCount, persistentCount + ringCount) is a linear ring for per-frame views,
+// retired by fence value once the GPU is done with the frame that used them.
+class DescriptorAllocator
+{
+public:
+	DescriptorAllocator(uint32_t persistentCount = 0, uint32_t ringCount = 0);
+
+	// Persistent region. Returns a null handle when no contiguous block of count slots is free.
+	DescriptorHandle Allocate(uint32_t count = 1);
+	bool Free(const DescriptorHandle& handle);
+	bool IsAlive(const DescriptorHandle& handle) const;
+
+	// Ring region. Returns the first heap index of count contiguous slots, or UINT32_MAX when full.
+	uint32_t AllocateTransient(uint32_t count = 1);
+	// Tags everything allocated since the last call with the fence value the frame will signal.
+	void FinishFrame(uint64_t fenceValue);
+	// Releases ring space of every frame whose fence value is <= completedFenceValue.
+	void Retire(uint64_t completedFenceValue);
+
+	uint32_t GetHeapSize() const;
+	uint32_t GetPersistentCount() const;
+	uint32_t GetRingCount() const;
+	uint32_t GetFreePersistentCount() const;
+	uint32_t GetUsedRingCount() const;
+
+private:
+	struct FreeRange
+	{
+		uint32_t index;
+		uint32_t count;
+	};
+	struct FrameMarker
+	{
+		uint64_t fenceValue;
+		uint32_t used;
+	};
+
+	uint32_t mPersistentCount = 0;
+	uint32_t mRingCount = 0;
+
+	std::vector<FreeRange> mFreeRanges; // sorted by index, adjacent ranges merged
+	std::vector<uint32_t> mGenerations;
+	std::vector<uint32_t> mLiveCounts; // size of the live range starting at a slot, 0 otherwise
+
+	uint32_t mRingHead = 0;
+	uint32_t mRingUsed = 0;
+	uint32_t mRingFrameUsed = 0;
+	std::deque<FrameMarker> mFrameMarkers;
+};
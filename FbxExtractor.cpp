@@ -1,5 +1,5 @@
 #include "FbxExtractor.h"
-#include <Windows.h>
+#include "CoreTypes.h"
 
 FbxExtractor::FbxExtractor() : 
 	mFbxManager{nullptr}, 
@@ -590,7 +590,7 @@ void FbxExtractor::NormalizeWeight()
 	}
 }
 
-XMFLOAT4X4 FbxExtractor::ToXMFloat4x4(FbxAMatrix& fbxmatrix)
+XMFLOAT4X4 FbxExtractor::ToXMFloat4x4(const FbxAMatrix& fbxmatrix)
 {
 	XMFLOAT4X4 xmMatrix;
 	XMStoreFloat4x4(&xmMatrix, XMMatrixIdentity());
@@ -606,7 +606,7 @@ XMFLOAT4X4 FbxExtractor::ToXMFloat4x4(FbxAMatrix& fbxmatrix)
 	return xmMatrix;
 }
 
-XMFLOAT3 FbxExtractor::ToXMFloat3(FbxVector4& fbxV4)
+XMFLOAT3 FbxExtractor::ToXMFloat3(const FbxVector4& fbxV4)
 {
 	XMFLOAT3 xmV3;
 	xmV3.x = static_cast<float>(fbxV4[0]);
@@ -615,7 +615,7 @@ XMFLOAT3 FbxExtractor::ToXMFloat3(FbxVector4& fbxV4)
 	return xmV3;
 }
 
-XMFLOAT4 FbxExtractor::ToXMFloat4(FbxVector4& fbxV4)
+XMFLOAT4 FbxExtractor::ToXMFloat4(const FbxVector4& fbxV4)
 {
 	XMFLOAT4 xmV4;
 	xmV4.x = static_cast<float>(fbxV4[0]);
@@ -625,7 +625,7 @@ XMFLOAT4 FbxExtractor::ToXMFloat4(FbxVector4& fbxV4)
 	return xmV4;
 }
 
-XMFLOAT4 FbxExtractor::ToXMFloat4(FbxQuaternion& fbxQ)
+XMFLOAT4 FbxExtractor::ToXMFloat4(const FbxQuaternion& fbxQ)
 {
 	XMFLOAT4 xmV4;
 	xmV4.x = fbxQ[0];
@@ -46,10 +46,10 @@ private:
 	int FindBoneIndex(const string& name);
 	void ExtractWeightAndOffsetMatrix(ptr<FbxMesh>);
 	void NormalizeWeight();
-	XMFLOAT4X4 ToXMFloat4x4(FbxAMatrix&);
-	XMFLOAT3 ToXMFloat3(FbxVector4&);
-	XMFLOAT4 ToXMFloat4(FbxVector4&);
-	XMFLOAT4 ToXMFloat4(FbxQuaternion&);
+	XMFLOAT4X4 ToXMFloat4x4(const FbxAMatrix&);
+	XMFLOAT3 ToXMFloat3(const FbxVector4&);
+	XMFLOAT4 ToXMFloat4(const FbxVector4&);
+	XMFLOAT4 ToXMFloat4(const FbxQuaternion&);
 
 	ptr<FbxManager> mFbxManager;
 	ptr<FbxIOSettings> mFbxIOS;
@@ -0,0 +1,59 @@
+#include "FixedTimestep.h"
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double step, uint32_t maxSubsteps) : mStep{ step }, mMaxSubsteps{ maxSubsteps }
+{
+}
+
+uint32_t FixedTimestep::Advance(double elapsed)
+{
+	if (elapsed > 0.0) mAccumulator += elapsed;
+
+	uint32_t steps = 0;
+	while (mAccumulator >= mStep && steps < mMaxSubsteps)
+	{
+		mAccumulator -= mStep;
+		++steps;
+	}
+	if (mAccumulator >= mStep)
+	{
+		double kept = std::fmod(mAccumulator, mStep);
+		mDroppedTime += mAccumulator - kept;
+		mAccumulator = kept;
+	}
+
+	mStepCount += steps;
+	return steps;
+}
+
+void FixedTimestep::Reset()
+{
+	mAccumulator = 0.0;
+	mStepCount = 0;
+	mDroppedTime = 0.0;
+}
+
+float FixedTimestep::GetAlpha() const
+{
+	return static_cast<float>(mAccumulator / mStep);
+}
+
+double FixedTimestep::GetStep() const
+{
+	return mStep;
+}
+
+uint32_t FixedTimestep::GetMaxSubsteps() const
+{
+	return mMaxSubsteps;
+}
+
+uint64_t FixedTimestep::GetStepCount() const
+{
+	return mStepCount;
+}
+
+double FixedTimestep::GetDroppedTime() const
+{
+	return mDroppedTime;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+// Accumulates real frame time and hands it out as whole simulation steps of a fixed size.
+// At most maxSubsteps run per frame; time beyond that is dropped so one long hitch does not
+// snowball into ever longer frames. The remainder is exposed as an interpolation factor.
+class FixedTimestep
+{
+public:
+	FixedTimestep(double step, uint32_t maxSubsteps);
+
+	// Adds elapsed seconds and returns the number of steps to simulate now.
+	uint32_t Advance(double elapsed);
+	void Reset();
+
+	// How far the render time lies between the last two simulated steps, in [0, 1).
+	float GetAlpha() const;
+	double GetStep() const;
+	uint32_t GetMaxSubsteps() const;
+	uint64_t GetStepCount() const;
+	double GetDroppedTime() const;
+
+private:
+	double mStep = 0.0;
+	uint32_t mMaxSubsteps = 0;
+	double mAccumulator = 0.0;
+	uint64_t mStepCount = 0;
+	double mDroppedTime = 0.0;
+};
@@ -1,13 +1,16 @@
 #include "Framework.h"
 #include "DXSampleHelper.h"
 #include <DirectXColors.h>
+#include "D3D12RenderDevice.h"
+#include "D3D12SceneGraphics.h"
+#include "Profiler.h"
 
 Framework::~Framework()
 {
+    //   ҽ ̽ , GPU    ڿ ´.
     OnDestroy();
-    for (auto [key, value] : m_scenes) {
-        delete value;
-    }
+    DeleteScenes();
+    m_renderDevice.reset();
 }
 
 void Framework::OnInit(HINSTANCE hInstance, UINT width, UINT height)
@@ -20,6 +23,9 @@ void Framework::OnInit(HINSTANCE hInstance, UINT width, UINT height)
     BuildFactoryAndDevice();
     BuildCommandQueueAndSwapChain();
     BuildCommandListAndAllocator();
+    auto d3d12Device = make_unique<D3D12RenderDevice>(m_device.Get(), m_commandList.Get());
+    m_d3d12Device = d3d12Device.get();
+    m_renderDevice = move(d3d12Device);
     BuildRtvDescriptorHeap();
     BuildRtv();
     BuildDsvDescriptorHeap();
@@ -28,7 +34,7 @@ void Framework::OnInit(HINSTANCE hInstance, UINT width, UINT height)
     BuildFence();
 
     //  
-    BuildScenes(m_device.Get(), m_commandList.Get());
+    BuildScenes(m_win32App->GetWidth(), m_win32App->GetHeight());
 
     // Close the command list and execute it to begin the initial GPU setup.
     ThrowIfFailed(m_commandList->Close());
@@ -37,28 +43,33 @@ void Framework::OnInit(HINSTANCE hInstance, UINT width, UINT height)
     WaitForPreviousFrame();
 
     m_Timer.Reset();
+    m_stepTimer.Reset();
 }
 
-void Framework::OnUpdate()
+void Framework::OnFrame()
 {
+    //   ð    ùķ̼ϰ,  ðŭ  ̸ ؼ ׸.
+    PROFILE_ZONE("Framework::OnFrame");
     CalculateFrame();
-    ProcessInput();
-    m_scenes.at(L"BaseScene")->OnUpdate(m_Timer);
-}
-
-void Framework::OnProcessCollision()
-{
-    m_scenes.at(L"BaseScene")->OnProcessCollision();
+    UINT stepCount = m_fixedTimestep.Advance(m_Timer.DeltaTime());
+    for (UINT i = 0; i < stepCount; ++i) {
+        Step();
+    }
+    m_scenes.at(L"BaseScene")->UpdateRenderTransforms(m_fixedTimestep.GetAlpha());
+    OnRender();
 }
 
-void Framework::LateUpdate()
+bool Framework::RunBenchmarks(const BenchmarkOptions& options)
 {
-    m_scenes.at(L"BaseScene")->LateUpdate(m_Timer);
+    //  ġũ Benchmark.cpp  ִ.    Ƿ Է ũƮ ó ǵ д.
+    m_inputScript.Reset();
+    return ::RunBenchmarks(*this, options);
 }
 
 // Render the scene.
 void Framework::OnRender()
 {
+    PROFILE_ZONE("Framework::OnRender");
     // Record all the commands we need to render the scene into the command list.
     PopulateCommandList();
 
@@ -69,7 +80,9 @@ void Framework::OnRender()
     // Present the frame.
     ThrowIfFailed(m_swapChain->Present(0, 0));
 
+    const UINT64 frameFence = m_fenceValue;
     WaitForPreviousFrame();
+    m_scenes.at(L"BaseScene")->OnFrameEnd(frameFence, m_fence->GetCompletedValue());
 }
 
 void Framework::OnResize(UINT width, UINT height, bool minimized)
@@ -109,6 +122,7 @@ void Framework::OnResize(UINT width, UINT height, bool minimized)
 
 void Framework::OnDestroy()
 {
+    if (m_headless) return;
     WaitForPreviousFrame();
     CloseHandle(m_fenceEvent);
 }
@@ -286,17 +300,6 @@ void Framework::BuildRtv()
     }
 }
 
-void Framework::BuildDsvDescriptorHeap()
-{
-    D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc;
-    dsvHeapDesc.NumDescriptors = 1 + 1; // 1  shdowmap
-    dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-    dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-    dsvHeapDesc.NodeMask = 0;
-    ThrowIfFailed(m_device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(m_dsvHeap.GetAddressOf())));
-    m_dsvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
-}
-
 void Framework::BuildDepthStencilBuffer(UINT width, UINT height)
 {
     D3D12_RESOURCE_DESC depthStencilDesc;
@@ -326,7 +329,7 @@ void Framework::BuildDepthStencilBuffer(UINT width, UINT height)
 
 void Framework::BuildDsv()
 {
-    m_device->CreateDepthStencilView(m_depthStencilBuffer.Get(), nullptr, m_dsvHeap->GetCPUDescriptorHandleForHeapStart());
+    m_device->CreateDepthStencilView(m_depthStencilBuffer.Get(), nullptr, D3D12_CPU_DESCRIPTOR_HANDLE{ GetDsvDescriptor(m_mainDsvHandle) });
 }
 
 void Framework::BuildFence()
@@ -347,45 +350,32 @@ void Framework::PopulateCommandList()
     ThrowIfFailed(m_commandAllocator->Reset());
     ThrowIfFailed(m_commandList->Reset(m_commandAllocator.Get(), nullptr));
 
-    m_scenes.at(L"BaseScene")->OnRender(m_device.Get(), m_commandList.Get(), ePass::Shadow);
+    RenderDevice& renderDevice = *m_renderDevice;
+    renderDevice.BeginFrame(m_renderFrame++);
+    m_scenes.at(L"BaseScene")->OnRender(renderDevice, ePass::Shadow);
 
     // Indicate that the back buffer will be used as a render target.
-    D3D12_RESOURCE_BARRIER barrier{};
-    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-    barrier.Transition.pResource = m_renderTargets[m_frameIndex].Get();
-    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    m_commandList->ResourceBarrier(1, &barrier);
+    RenderHandle backBuffer = D3D12RenderDevice::ToHandle(m_renderTargets[m_frameIndex].Get());
+    renderDevice.Barrier(backBuffer, RenderState::Present, RenderState::RenderTarget);
 
         // Record commands.
     CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameIndex, m_rtvDescriptorSize);
-    CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(m_dsvHeap->GetCPUDescriptorHandleForHeapStart(), 0, m_dsvDescriptorSize);
+    RenderDescriptor dsvHandle = GetDsvDescriptor(m_mainDsvHandle);
     
-    m_commandList->ClearRenderTargetView(rtvHandle, Colors::LightSteelBlue, 0, nullptr);
-    m_commandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1, 0, 0, nullptr);
+    renderDevice.ClearRenderTarget(rtvHandle.ptr, Colors::LightSteelBlue);
+    renderDevice.ClearDepthStencil(dsvHandle, 1.0f, 0);
 
-    m_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+    renderDevice.SetRenderTarget(rtvHandle.ptr, dsvHandle);
     
     // Rendering
-    m_scenes.at(L"BaseScene")->OnRender(m_device.Get(), m_commandList.Get(), ePass::Default);
+    m_scenes.at(L"BaseScene")->OnRender(renderDevice, ePass::Default);
     
     // Indicate that the back buffer will now be used to present.
-    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-    m_commandList->ResourceBarrier(1, &barrier);
+    renderDevice.Barrier(backBuffer, RenderState::RenderTarget, RenderState::Present);
+    renderDevice.EndFrame();
     ThrowIfFailed(m_commandList->Close());
 }
 
-void Framework::BuildScenes(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
-{
-    wstring name = L"BaseScene";
-    m_scenes.emplace(name, new Scene{ this, m_win32App->GetWidth(), m_win32App->GetHeight()});
-    m_scenes.at(name)->OnInit(device, commandList);
-    m_currentSceneName = name;
-}
-
 void Framework::WaitForPreviousFrame()
 {
     // Signal and increment the fence value.
@@ -402,17 +392,34 @@ void Framework::WaitForPreviousFrame()
     m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
 }
 
+void Framework::ReadKeyState(BYTE* keyState)
+{
+    if (m_headless) {
+        Simulation::ReadKeyState(keyState);
+    }
+    else {
+        BOOL booooool = GetKeyboardState(keyState);
+    }
+}
+
 void Framework::ProcessInput()
 {
-    static const int keySize = 256;
-    static BYTE keyState[keySize]{};
-    BOOL booooool = GetKeyboardState(keyState);
+    Simulation::ProcessInput();
+    if (m_headless) return;
 
-    for (int i = 0; i < keySize; ++i)
+    // F9: Ϸ Ѱ .      , ŸӶ profile.json  .
+    if ((mKeyState[VK_F9] & 0x88) == 0x80)
     {
-        if (mKeyState[i] & 0x80) keyState[i] |= 0x08;
+        if (Profiler::IsEnabled()) {
+            Profiler::SetEnabled(false);
+            OutputDebugStringA(Profiler::FormatZoneStats().c_str());
+            Profiler::SaveChromeTrace(L"profile.json");
+        }
+        else {
+            Profiler::Clear();
+            Profiler::SetEnabled(true);
+        }
     }
-    memcpy(mKeyState, keyState, keySize);
 
     if ((mKeyState[VK_ESCAPE] & 0x88) == 0x80)
     {
@@ -425,11 +432,19 @@ void Framework::ProcessInput()
     }
 }
 
+unique_ptr<SceneGraphics> Framework::CreateSceneGraphics()
+{
+    // 帮 ̽ Ƿ ̴ ؽó .
+    if (!m_device) return nullptr;
+    return make_unique<D3D12SceneGraphics>(m_device.Get(), TEXTURE_STAGING_SIZE, TEXTURE_LOAD_THREAD);
+}
+
 void Framework::CalculateFrame()
 {
     m_Timer.Tick();
     static int frameCnt = 0;
     static float timeElapsed = 0.0f;
+    static UINT64 uploadBytes = 0;
 
     frameCnt++;
 
@@ -437,10 +452,13 @@ void Framework::CalculateFrame()
     if ((m_Timer.TotalTime() - timeElapsed) >= 1.0f)
     {
         float fps = (float)frameCnt; // fps = frameCnt / 1
-        wstring windowText = L" FPS " + to_wstring(fps);
+        // ε   Ʈ  1     ش.
+        UINT64 totalUploadBytes = m_d3d12Device->GetUploadBytes();
+        wstring windowText = L" FPS " + to_wstring(fps) + L" upload " + to_wstring((totalUploadBytes - uploadBytes) / frameCnt) + L" B/frame";
         m_win32App->SetCustomWindowText(windowText.c_str());
         // Reset for next average.
         frameCnt = 0;
+        uploadBytes = totalUploadBytes;
         timeElapsed += 1.0f;
     }
 
@@ -452,16 +470,6 @@ GameTimer& Framework::GetTimer()
     return m_Timer;
 }
 
-Scene& Framework::GetScene(const wstring& name)
-{
-    return *m_scenes.at(name);
-}
-
-const wstring& Framework::GetCurrentSceneName()
-{
-    return m_currentSceneName;
-}
-
 Win32Application& Framework::GetWin32App()
 {
     return *m_win32App.get();
@@ -477,18 +485,7 @@ ID3D12GraphicsCommandList* Framework::GetCommandList()
     return m_commandList.Get();
 }
 
-ID3D12DescriptorHeap* Framework::GetDsvDescHeap()
-{
-    return m_dsvHeap.Get();
-}
-
-BYTE* Framework::GetKeyState()
-{
-    return mKeyState;
-}
-
 HWND Framework::GetHWnd()
 {
     return m_win32App->GetHwnd();
 }
-
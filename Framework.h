@@ -1,31 +1,35 @@
 #pragma once
 #include "stdafx.h"
-#include "Scene.h"
+#include "Simulation.h"
 #include "Win32Application.h"
-#include "GameTimer.h"
+#include "Benchmark.h"
 
-class Framework
+class D3D12RenderDevice;
+
+// The game in a window: Simulation plus the Win32 window, the D3D12 device and the swap chain. OnInitHeadless
+// (from Simulation) skips all of those, which is how -headless and -benchmark run from the Windows build.
+class Framework : public Simulation
 {
 public:
 	~Framework();	
 	void OnInit(HINSTANCE hInstance, UINT width, UINT height);
-	void OnUpdate();
-	void OnProcessCollision();
-	void LateUpdate();
+	void OnFrame();
+	bool RunBenchmarks(const BenchmarkOptions& options); // false on an I/O error, a failed check or a regression
 	void OnRender();
 	void OnResize(UINT width, UINT height, bool minimized);
 	void OnDestroy();
 
 	GameTimer& GetTimer();
-	Scene& GetScene(const wstring& name);
-	const wstring& GetCurrentSceneName();
 	Win32Application& GetWin32App();
 	ID3D12Device* GetDevice();
 	ID3D12GraphicsCommandList* GetCommandList();
-	ID3D12DescriptorHeap* GetDsvDescHeap();
-	BYTE* GetKeyState();
 	HWND GetHWnd();
 
+protected:
+	void ReadKeyState(BYTE* keyState) override;
+	void ProcessInput() override;
+	unique_ptr<SceneGraphics> CreateSceneGraphics() override;
+
 private:
 	void GetHardwareAdapter(
 		IDXGIFactory1* pFactory,
@@ -37,18 +41,14 @@ private:
 	void BuildCommandListAndAllocator();
 	void BuildRtvDescriptorHeap();
 	void BuildRtv();
-	void BuildDsvDescriptorHeap();
 	void BuildDepthStencilBuffer(UINT width, UINT height);
 	void BuildDsv();
 	void BuildFence();
 
 	void CalculateFrame();
 	void PopulateCommandList();
-	void BuildScenes(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
 	void WaitForPreviousFrame();
 
-	void ProcessInput();
-
 	unique_ptr<Win32Application> m_win32App;
 
 	GameTimer m_Timer;
@@ -64,24 +64,19 @@ private:
 	ComPtr<ID3D12CommandQueue> m_commandQueue;
 	ComPtr<IDXGISwapChain3> m_swapChain;
 	ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
-	ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
 	ComPtr<ID3D12Resource> m_renderTargets[FrameCount];
 	ComPtr<ID3D12Resource> m_depthStencilBuffer;
 	ComPtr<ID3D12CommandAllocator> m_commandAllocator;
 	ComPtr<ID3D12GraphicsCommandList> m_commandList;
 
+	D3D12RenderDevice* m_d3d12Device = nullptr; // same object as m_renderDevice in a window
+
 	UINT m_rtvDescriptorSize;
-	UINT m_dsvDescriptorSize;
 
 	// Synchronization objects.
 	UINT m_frameIndex;
 	HANDLE m_fenceEvent;
 	ComPtr<ID3D12Fence> m_fence;
 	UINT64 m_fenceValue;
-
-	unordered_map<wstring, Scene*> m_scenes;
-	wstring m_currentSceneName;
-
-	BYTE mKeyState[256]{};
 };
 
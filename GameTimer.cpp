@@ -2,13 +2,43 @@
 // GameTimer.cpp by Frank Luna (C) 2011 All Rights Reserved.
 //***************************************************************************************
 #include "GameTimer.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+namespace
+{
+	// QueryPerformanceCounter on Windows, steady_clock elsewhere (the Linux headless build).
+	int64_t ReadCounter()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		return counter.QuadPart;
+#else
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	int64_t ReadFrequency()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		return frequency.QuadPart;
+#else
+		return std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num;
+#endif
+	}
+}
 
 GameTimer::GameTimer()
 : mSecondsPerCount(0.0), mDeltaTime(-1.0), mBaseTime(0), 
   mPausedTime(0), mPrevTime(0), mCurrTime(0), mStopped(false)
 {
-	__int64 countsPerSec;
-	QueryPerformanceFrequency((LARGE_INTEGER*)&countsPerSec);
+	int64_t countsPerSec = ReadFrequency();
 	mSecondsPerCount = 1.0 / (double)countsPerSec;
 }
 
@@ -53,8 +83,7 @@ float GameTimer::DeltaTime()const
 
 void GameTimer::Reset()
 {
-	__int64 currTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
+	int64_t currTime = ReadCounter();
 
 	mBaseTime = currTime;
 	mPrevTime = currTime;
@@ -64,8 +93,7 @@ void GameTimer::Reset()
 
 void GameTimer::Start()
 {
-	__int64 startTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&startTime);
+	int64_t startTime = ReadCounter();
 
 
 	// Accumulate the time elapsed between stop and start pairs.
@@ -88,8 +116,7 @@ void GameTimer::Stop()
 {
 	if( !mStopped )
 	{
-		__int64 currTime;
-		QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
+		int64_t currTime = ReadCounter();
 
 		mStopTime = currTime;
 		mStopped  = true;
@@ -104,8 +131,7 @@ void GameTimer::Tick()
 		return;
 	}
 
-	__int64 currTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
+	int64_t currTime = ReadCounter();
 	mCurrTime = currTime;
 
 	// Time difference between this frame and the previous.
@@ -122,3 +148,12 @@ void GameTimer::Tick()
 		mDeltaTime = 0.0;
 	}
 }
+
+void GameTimer::Step(double deltaTime)
+{
+	// Fixed-step simulation clock: DeltaTime() is always the step and TotalTime()
+	// counts simulated time, independent of how long the frame really took.
+	mDeltaTime = deltaTime;
+	mCurrTime = mPrevTime + (int64_t)(deltaTime / mSecondsPerCount);
+	mPrevTime = mCurrTime;
+}
@@ -1,7 +1,7 @@
 //***************************************************************************************
 // GameTimer.h by Frank Luna (C) 2011 All Rights Reserved.
 //***************************************************************************************
-#include "stdafx.h"
+#include <cstdint>
 
 #ifndef GAMETIMER_H
 #define GAMETIMER_H
@@ -18,16 +18,17 @@ public:
 	void Start(); // Call when unpaused.
 	void Stop();  // Call when paused.
 	void Tick();  // Call every frame.
+	void Step(double deltaTime); // Advance by a fixed amount instead of reading the counter.
 
 private:
 	double mSecondsPerCount;
 	double mDeltaTime;
 
-	__int64 mBaseTime;
-	__int64 mPausedTime;
-	__int64 mStopTime;
-	__int64 mPrevTime;
-	__int64 mCurrTime;
+	int64_t mBaseTime;
+	int64_t mPausedTime;
+	int64_t mStopTime;
+	int64_t mPrevTime;
+	int64_t mCurrTime;
 
 	bool mStopped;
 
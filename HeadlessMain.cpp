@@ -0,0 +1,37 @@
+﻿#include "Simulation.h"
+#include <cstdio>
+#include <filesystem>
+
+// Linux 등 D3D12 가 없는 곳에서 쓰는 헤드리스 실행 파일 (CMakeLists.txt 의 Headless).
+// Windows 실행 파일의 -headless 와 같은 인자를 받고 같은 Simulation 을 돌린다. 창과 -benchmark, -renderdiff 는 없다.
+// Headless -headless N [-script 파일] [-record 파일] [-profile 파일] [-deterministic] [-preskinning]
+int main(int argc, char* argv[])
+{
+    vector<string> arguments(argv + 1, argv + argc);
+    auto getOption = [&arguments](const char* name) -> wstring {
+        auto it = find(arguments.begin(), arguments.end(), name);
+        if (arguments.end() - it < 2) return L"";
+        return filesystem::path(*(it + 1)).wstring();
+    };
+    auto hasSwitch = [&arguments](const char* name) {
+        return find(arguments.begin(), arguments.end(), name) != arguments.end();
+    };
+
+    HeadlessOptions headless;
+    unsigned long long stepCount = 0;
+    if (swscanf(getOption("-headless").c_str(), L"%llu", &stepCount) != 1)
+    {
+        fputs("usage: Headless -headless N [-script file] [-record file] [-profile file] [-deterministic] [-preskinning]\n", stderr);
+        return 2;
+    }
+    headless.stepCount = stepCount;
+    headless.scriptFileName = getOption("-script");
+    headless.recordFileName = getOption("-record");
+    headless.profileFileName = getOption("-profile");
+
+    Simulation simulation;
+    simulation.OnInitHeadless(1280, 720);
+    simulation.GetJobSystem().SetDeterministic(hasSwitch("-deterministic"));
+    if (hasSwitch("-preskinning")) simulation.GetScene(L"BaseScene").SetPreSkinning(true);
+    return simulation.RunHeadless(headless) ? 0 : 1;
+}
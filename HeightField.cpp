@@ -0,0 +1,282 @@
+#include "HeightField.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+void HeightField::Build(std::vector<float> heights, uint32_t width, uint32_t height, float scale)
+{
+	mHeights = std::move(heights);
+	mWidth = width;
+	mHeight = height;
+	mScale = scale;
+	mLevels.clear();
+	if (IsEmpty()) return;
+
+	Level base;
+	base.width = width - 1;
+	base.height = height - 1;
+	base.ranges.resize(static_cast<size_t>(base.width) * base.height);
+	for (uint32_t row = 0; row < base.height; ++row)
+	{
+		for (uint32_t column = 0; column < base.width; ++column)
+		{
+			const float* bottom = &mHeights[static_cast<size_t>(row) * width + column];
+			const float* top = bottom + width;
+			HeightRange& range = base.ranges[static_cast<size_t>(row) * base.width + column];
+			range.minHeight = std::min({ bottom[0], bottom[1], top[0], top[1] });
+			range.maxHeight = std::max({ bottom[0], bottom[1], top[0], top[1] });
+		}
+	}
+	mLevels.push_back(std::move(base));
+
+	while (mLevels.back().width > 1 || mLevels.back().height > 1)
+	{
+		const Level& fine = mLevels.back();
+		Level coarse;
+		coarse.width = (fine.width + 1) / 2;
+		coarse.height = (fine.height + 1) / 2;
+		coarse.ranges.resize(static_cast<size_t>(coarse.width) * coarse.height);
+		for (uint32_t row = 0; row < coarse.height; ++row)
+		{
+			for (uint32_t column = 0; column < coarse.width; ++column)
+			{
+				HeightRange range = fine.ranges[static_cast<size_t>(row * 2) * fine.width + column * 2];
+				for (uint32_t child = 1; child < 4; ++child)
+				{
+					uint32_t childColumn = column * 2 + (child & 1);
+					uint32_t childRow = row * 2 + (child >> 1);
+					if (childColumn >= fine.width || childRow >= fine.height) continue;
+					const HeightRange& other = fine.ranges[static_cast<size_t>(childRow) * fine.width + childColumn];
+					range.minHeight = std::min(range.minHeight, other.minHeight);
+					range.maxHeight = std::max(range.maxHeight, other.maxHeight);
+				}
+				coarse.ranges[static_cast<size_t>(row) * coarse.width + column] = range;
+			}
+		}
+		mLevels.push_back(std::move(coarse));
+	}
+}
+
+bool HeightField::IsEmpty() const
+{
+	return mWidth < 2 || mHeight < 2 || mHeights.size() < static_cast<size_t>(mWidth) * mHeight;
+}
+
+float HeightField::SampleHeight(float x, float z) const
+{
+	if (IsEmpty()) return 0.0f;
+
+	// Same arithmetic as the old per-object lookup, so clamped positions do not move.
+	int indexX = (int)(x / mScale);
+	int indexZ = (int)(z / mScale);
+	if (indexX < 0) indexX = 0;
+	if (indexZ < 0) indexZ = 0;
+	if (indexX > (int)mWidth - 2) indexX = mWidth - 2;
+	if (indexZ > (int)mHeight - 2) indexZ = mHeight - 2;
+
+	const float* bottom = &mHeights[static_cast<size_t>(indexZ) * mWidth + indexX];
+	const float* top = bottom + mWidth;
+
+	float offsetX = x / mScale - indexX;
+	float offsetZ = z / mScale - indexZ;
+
+	float lerpXBottom = (1 - offsetX) * bottom[0] + offsetX * bottom[1];
+	float lerpXTop = (1 - offsetX) * top[0] + offsetX * top[1];
+	return (1 - offsetZ) * lerpXBottom + offsetZ * lerpXTop;
+}
+
+void HeightField::SampleHeights(const float* positions, size_t count, size_t stride, float* heights) const
+{
+	for (size_t i = 0; i < count; ++i, positions += stride)
+		heights[i] = SampleHeight(positions[0], positions[2]);
+}
+
+bool HeightField::RayCast(float originX, float originY, float originZ, float directionX, float directionY, float directionZ, float maxT, float* hitT) const
+{
+	if (IsEmpty() || !(maxT >= 0.0f)) return false;
+
+	Ray ray = { { originX, originY, originZ }, { directionX, directionY, directionZ }, {} };
+	for (int axis = 0; axis < 3; ++axis) ray.inverse[axis] = 1.0f / ray.direction[axis];
+
+	// Front-to-back descent: every level pushes at most four children, nearest on top.
+	struct Entry
+	{
+		uint32_t level;
+		uint32_t column;
+		uint32_t row;
+		float enter;
+	};
+	Entry stack[4 * 32];
+	uint32_t stackSize = 0;
+
+	float best = maxT;
+	bool found = false;
+	float enter, exit;
+	const uint32_t top = static_cast<uint32_t>(mLevels.size()) - 1;
+	if (!ClipToNode(top, 0, 0, ray, best, true, enter, exit)) return false;
+	stack[stackSize++] = { top, 0, 0, enter };
+
+	while (stackSize > 0)
+	{
+		Entry entry = stack[--stackSize];
+		if (found && entry.enter > best) continue;
+
+		if (entry.level == 0)
+		{
+			// Test the whole footprint, the bilinear surface never leaves the quad's range.
+			float hit;
+			if (ClipToNode(0, entry.column, entry.row, ray, best, false, enter, exit) &&
+				IntersectQuad(entry.column, entry.row, ray, enter, exit, hit) && (!found || hit < best))
+			{
+				best = hit;
+				found = true;
+			}
+			continue;
+		}
+
+		const Level& fine = mLevels[entry.level - 1];
+		Entry children[4];
+		uint32_t childCount = 0;
+		for (uint32_t child = 0; child < 4; ++child)
+		{
+			uint32_t column = entry.column * 2 + (child & 1);
+			uint32_t row = entry.row * 2 + (child >> 1);
+			if (column >= fine.width || row >= fine.height) continue;
+			if (!ClipToNode(entry.level - 1, column, row, ray, best, true, enter, exit)) continue;
+			children[childCount++] = { entry.level - 1, column, row, enter };
+		}
+		for (uint32_t i = 1; i < childCount; ++i)
+		{
+			for (uint32_t j = i; j > 0 && children[j - 1].enter < children[j].enter; --j) std::swap(children[j - 1], children[j]);
+		}
+		for (uint32_t i = 0; i < childCount; ++i) stack[stackSize++] = children[i];
+	}
+
+	if (found && hitT) *hitT = best;
+	return found;
+}
+
+bool HeightField::SegmentCast(float x0, float y0, float z0, float x1, float y1, float z1, float* hitT) const
+{
+	return RayCast(x0, y0, z0, x1 - x0, y1 - y0, z1 - z0, 1.0f, hitT);
+}
+
+HeightRange HeightField::GetRange(uint32_t level, uint32_t column, uint32_t row) const
+{
+	const Level& nodes = mLevels[level];
+	return nodes.ranges[static_cast<size_t>(row) * nodes.width + column];
+}
+
+uint32_t HeightField::GetLevelCount() const
+{
+	return static_cast<uint32_t>(mLevels.size());
+}
+
+uint32_t HeightField::GetWidth() const
+{
+	return mWidth;
+}
+
+uint32_t HeightField::GetHeight() const
+{
+	return mHeight;
+}
+
+float HeightField::GetScale() const
+{
+	return mScale;
+}
+
+const std::vector<float>& HeightField::GetHeights() const
+{
+	return mHeights;
+}
+
+bool HeightField::ClipToNode(uint32_t level, uint32_t column, uint32_t row, const Ray& ray, float tMax, bool withHeight, float& enter, float& exit) const
+{
+	const uint32_t quadsX = mWidth - 1;
+	const uint32_t quadsZ = mHeight - 1;
+	float lower[3], upper[3];
+	lower[0] = static_cast<float>(column << level) * mScale;
+	upper[0] = static_cast<float>(std::min((column + 1) << level, quadsX)) * mScale;
+	lower[2] = static_cast<float>(row << level) * mScale;
+	upper[2] = static_cast<float>(std::min((row + 1) << level, quadsZ)) * mScale;
+	if (withHeight)
+	{
+		// Anything under the node's highest point may be under the surface, so only the top bounds the slab.
+		lower[1] = -std::numeric_limits<float>::infinity();
+		upper[1] = GetRange(level, column, row).maxHeight;
+	}
+
+	enter = 0.0f;
+	exit = tMax;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (axis == 1 && !withHeight) continue;
+		if (ray.direction[axis] == 0.0f)
+		{
+			if (ray.origin[axis] < lower[axis] || ray.origin[axis] > upper[axis]) return false;
+			continue;
+		}
+		float t0 = (lower[axis] - ray.origin[axis]) * ray.inverse[axis];
+		float t1 = (upper[axis] - ray.origin[axis]) * ray.inverse[axis];
+		if (t0 > t1) std::swap(t0, t1);
+		enter = std::max(enter, t0);
+		exit = std::min(exit, t1);
+		if (enter > exit) return false;
+	}
+	return true;
+}
+
+bool HeightField::IntersectQuad(uint32_t column, uint32_t row, const Ray& ray, float enter, float exit, float& hit) const
+{
+	const float* bottom = &mHeights[static_cast<size_t>(row) * mWidth + column];
+	const float* top = bottom + mWidth;
+
+	// h(u, v) = a + b u + c v + d u v over the quad, with u and v linear in t along the ray,
+	// so h - y is a quadratic A t^2 + B t + C. Solved in double to keep grazing rays stable.
+	double a = bottom[0];
+	double b = static_cast<double>(bottom[1]) - bottom[0];
+	double c = static_cast<double>(top[0]) - bottom[0];
+	double d = static_cast<double>(bottom[0]) - bottom[1] - top[0] + top[1];
+	double u0 = (ray.origin[0] - static_cast<double>(column) * mScale) / mScale;
+	double v0 = (ray.origin[2] - static_cast<double>(row) * mScale) / mScale;
+	double du = ray.direction[0] / static_cast<double>(mScale);
+	double dv = ray.direction[2] / static_cast<double>(mScale);
+
+	double A = d * du * dv;
+	double B = b * du + c * dv + d * (u0 * dv + v0 * du) - ray.direction[1];
+	double C = a + b * u0 + c * v0 + d * u0 * v0 - ray.origin[1];
+
+	auto below = [&](double t) { return (A * t + B) * t + C >= 0.0; }; // surface at or above the ray
+	if (below(enter))
+	{
+		hit = enter;
+		return true;
+	}
+
+	double roots[2];
+	int rootCount = 0;
+	if (std::abs(A) < 1e-12)
+	{
+		if (B != 0.0) roots[rootCount++] = -C / B;
+	}
+	else
+	{
+		double discriminant = B * B - 4.0 * A * C;
+		if (discriminant < 0.0) return false;
+		double q = -0.5 * (B + std::copysign(std::sqrt(discriminant), B));
+		roots[rootCount++] = q / A;
+		if (q != 0.0) roots[rootCount++] = C / q;
+	}
+
+	bool found = false;
+	for (int i = 0; i < rootCount; ++i)
+	{
+		if (roots[i] < enter || roots[i] > exit) continue;
+		if (!found || roots[i] < hit) hit = static_cast<float>(roots[i]);
+		found = true;
+	}
+	return found;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct HeightRange
+{
+	float minHeight = 0.0f;
+	float maxHeight = 0.0f;
+};
+
+// Terrain heights for gameplay queries, kept apart from the render vertices. Level 0 of the
+// min/max pyramid holds the range of every quad, each further level halves the resolution
+// down to a single root range, so rays can skip whole regions that lie above or below them.
+class HeightField
+{
+public:
+	void Build(std::vector<float> heights, uint32_t width, uint32_t height, float scale);
+	bool IsEmpty() const;
+
+	// Bilinear height at world (x, z). Points outside the field use the nearest edge quad.
+	float SampleHeight(float x, float z) const;
+	// heights[i] = SampleHeight for the i-th {x, y, z} triple of positions; stride is the number of
+	// floats between two triples (3 for a packed XMFLOAT3 array).
+	void SampleHeights(const float* positions, size_t count, size_t stride, float* heights) const;
+
+	// First t in [0, maxT] where origin + t * direction touches the surface. A ray that starts under
+	// the surface hits at t = 0. Only the part of the ray above the field's x/z extent is tested.
+	bool RayCast(float originX, float originY, float originZ, float directionX, float directionY, float directionZ, float maxT, float* hitT) const;
+	// Same test for the segment from p0 to p1; hitT is the fraction along the segment.
+	bool SegmentCast(float x0, float y0, float z0, float x1, float y1, float z1, float* hitT) const;
+
+	// Height range of pyramid node (column, row) at the given level; level 0 nodes are single quads.
+	HeightRange GetRange(uint32_t level, uint32_t column, uint32_t row) const;
+	uint32_t GetLevelCount() const;
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	float GetScale() const;
+	const std::vector<float>& GetHeights() const;
+
+private:
+	struct Level
+	{
+		uint32_t width = 0; // nodes along x
+		uint32_t height = 0;
+		std::vector<HeightRange> ranges;
+	};
+
+	struct Ray
+	{
+		float origin[3];
+		float direction[3];
+		float inverse[3]; // 1 / direction, infinite on axes the ray does not move along
+	};
+
+	// Ray interval inside the node's x/z footprint, and below its highest point when withHeight is set.
+	bool ClipToNode(uint32_t level, uint32_t column, uint32_t row, const Ray& ray, float tMax, bool withHeight, float& enter, float& exit) const;
+	// Smallest root of bilinear(quad) - ray.y in [enter, exit].
+	bool IntersectQuad(uint32_t column, uint32_t row, const Ray& ray, float enter, float exit, float& hit) const;
+
+	std::vector<float> mHeights; // mWidth * mHeight, row 0 is z = 0
+	uint32_t mWidth = 0;
+	uint32_t mHeight = 0;
+	float mScale = 1.0f;
+	std::vector<Level> mLevels; // [0] is per quad, back() is a single node
+};
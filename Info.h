@@ -1,5 +1,5 @@
 #pragma once
-#include "stdafx.h"
+#include "CoreTypes.h"
 
 struct Vertex
 {
@@ -13,9 +13,10 @@ struct Vertex
 struct ObjectCB
 {
     XMFLOAT4X4 world;
-	XMFLOAT4X4 finalTransform[90];
 	int isAnimate;
-	int padding0[3];
+	int textureIndex;
+	UINT paletteOffset; //   ȷƮ ۿ  Ʈ ù float4 .  ϳ 3(3x4 )̴.
+	int padding0;
 	float powValue;
 	float ambiantValue;
 	float padding1[2];
@@ -51,6 +52,13 @@ enum class ePass
 	Default
 };
 
+enum class eCaster
+{
+	All,
+	Static,
+	Dynamic
+};
+
 enum class eKeyTable
 {
 	Up,
@@ -0,0 +1,185 @@
+#include "InputScript.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+	struct KeyName
+	{
+		const char* name;
+		int code;
+	};
+
+	// Win32 virtual-key codes of the keys the game reads; letters and digits are their ASCII codes.
+	const KeyName KeyNames[] = {
+		{ "LBUTTON", 0x01 }, { "RBUTTON", 0x02 }, { "SHIFT", 0x10 }, { "CONTROL", 0x11 }, { "ESCAPE", 0x1B },
+		{ "SPACE", 0x20 }, { "LEFT", 0x25 }, { "UP", 0x26 }, { "RIGHT", 0x27 }, { "DOWN", 0x28 },
+	};
+	const int VirtualKeyF1 = 0x70;
+
+	std::string ToUpper(std::string text)
+	{
+		for (char& c : text) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+		return text;
+	}
+}
+
+bool InputScript::Load(const std::wstring& fileName, std::string* error)
+{
+	std::ifstream in{ std::filesystem::path{ fileName }, std::ios::binary };
+	if (!in)
+	{
+		if (error) *error = "cannot open " + std::filesystem::path{ fileName }.string();
+		mCommands.clear();
+		Reset();
+		return false;
+	}
+	std::string text{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+	return Parse(text, error);
+}
+
+bool InputScript::Parse(const std::string& text, std::string* error)
+{
+	mCommands.clear();
+	Reset();
+
+	std::istringstream lines{ text };
+	std::string line;
+	for (int lineNumber = 1; std::getline(lines, line); ++lineNumber)
+	{
+		size_t comment = line.find('#');
+		if (comment != std::string::npos) line.erase(comment);
+
+		std::istringstream words{ line };
+		std::string stepText, op, argument, extra;
+		if (!(words >> stepText)) continue; // blank line
+
+		Command command;
+		char* end = nullptr;
+		command.step = std::strtoull(stepText.c_str(), &end, 10);
+		bool valid = !stepText.empty() && std::isdigit(static_cast<unsigned char>(stepText[0])) && *end == '\0';
+		valid = valid && static_cast<bool>(words >> op);
+		op = ToUpper(op);
+		if (valid && (op == "DOWN" || op == "UP" || op == "TAP"))
+		{
+			int key = (words >> argument) ? FindKey(argument) : -1;
+			valid = key >= 0;
+			command.op = op == "DOWN" ? Op::Down : op == "UP" ? Op::Up : Op::Tap;
+			command.key = static_cast<uint8_t>(key);
+		}
+		else if (valid && op == "STAGE")
+		{
+			valid = static_cast<bool>(words >> argument);
+			command.op = Op::Stage;
+			command.stage.assign(argument.begin(), argument.end());
+		}
+		else if (valid && op == "QUIT")
+		{
+			command.op = Op::Quit;
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if (!valid || (words >> extra))
+		{
+			if (error) *error = "line " + std::to_string(lineNumber) + ": " + line;
+			mCommands.clear();
+			return false;
+		}
+		mCommands.push_back(std::move(command));
+	}
+
+	std::stable_sort(mCommands.begin(), mCommands.end(), [](const Command& a, const Command& b) { return a.step < b.step; });
+	return true;
+}
+
+void InputScript::Reset()
+{
+	mNext = 0;
+	std::fill(std::begin(mHeld), std::end(mHeld), false);
+	mTapped.clear();
+}
+
+InputScript::StepEvents InputScript::Advance(uint64_t step)
+{
+	for (uint8_t key : mTapped) mHeld[key] = false;
+	mTapped.clear();
+
+	StepEvents events;
+	for (; mNext < mCommands.size() && mCommands[mNext].step <= step; ++mNext)
+	{
+		const Command& command = mCommands[mNext];
+		switch (command.op)
+		{
+		case Op::Down:
+			mHeld[command.key] = true;
+			break;
+		case Op::Up:
+			mHeld[command.key] = false;
+			break;
+		case Op::Tap:
+			mHeld[command.key] = true;
+			mTapped.push_back(command.key);
+			break;
+		case Op::Stage:
+			events.stage = command.stage;
+			break;
+		case Op::Quit:
+			events.quit = true;
+			break;
+		}
+	}
+	return events;
+}
+
+void InputScript::GetKeyState(uint8_t keyState[KeyCount]) const
+{
+	for (size_t i = 0; i < KeyCount; ++i) keyState[i] = mHeld[i] ? 0x80 : 0x00;
+}
+
+bool InputScript::IsEmpty() const
+{
+	return mCommands.empty();
+}
+
+size_t InputScript::GetCommandCount() const
+{
+	return mCommands.size();
+}
+
+uint64_t InputScript::GetLastStep() const
+{
+	return mCommands.empty() ? 0 : mCommands.back().step;
+}
+
+int InputScript::FindKey(const std::string& name)
+{
+	std::string upper = ToUpper(name);
+	if (upper.size() == 1 && std::isalnum(static_cast<unsigned char>(upper[0]))) return upper[0];
+
+	for (const KeyName& key : KeyNames)
+	{
+		if (upper == key.name) return key.code;
+	}
+
+	if (upper.size() >= 2 && upper.size() <= 3 && upper[0] == 'F')
+	{
+		int number = std::atoi(upper.c_str() + 1);
+		if (number >= 1 && number <= 12 && std::to_string(number) == upper.substr(1)) return VirtualKeyF1 + number - 1;
+	}
+
+	if (upper.size() > 2 && upper.compare(0, 2, "0X") == 0)
+	{
+		char* end = nullptr;
+		unsigned long code = std::strtoul(upper.c_str() + 2, &end, 16);
+		if (*end == '\0' && code < KeyCount) return static_cast<int>(code);
+	}
+	return -1;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Keyboard input read from a text file, for headless runs. One command per line, '#' starts a comment:
+//   <step> down <key>     the key is held from this step on
+//   <step> up <key>       released from this step on
+//   <step> tap <key>      held for this step only
+//   <step> stage <name>   Scene::SetStage before this step
+//   <step> quit           the run ends before this step
+// Keys are A-Z, 0-9, SPACE, SHIFT, CONTROL, ESCAPE, LBUTTON, RBUTTON, LEFT, RIGHT, UP, DOWN, F1-F12,
+// or a Win32 virtual-key code written as 0x.. Commands may be listed in any order; commands of the
+// same step apply in file order.
+class InputScript
+{
+public:
+	static const size_t KeyCount = 256;
+
+	struct StepEvents
+	{
+		std::wstring stage; // empty when the step does not change the stage
+		bool quit = false;
+	};
+
+	// Replaces the script. On failure error names the file or the first bad line and the script is left empty.
+	bool Load(const std::wstring& fileName, std::string* error = nullptr);
+	bool Parse(const std::string& text, std::string* error = nullptr);
+	void Reset();
+
+	// Applies every command of the given step. Steps must be visited in increasing order.
+	StepEvents Advance(uint64_t step);
+	// 0x80 for every key held in the last advanced step, like GetKeyboardState.
+	void GetKeyState(uint8_t keyState[KeyCount]) const;
+
+	bool IsEmpty() const;
+	size_t GetCommandCount() const;
+	uint64_t GetLastStep() const;
+
+	// Virtual-key code for a key name, -1 when unknown.
+	static int FindKey(const std::string& name);
+
+private:
+	enum class Op : uint8_t { Down, Up, Tap, Stage, Quit };
+
+	struct Command
+	{
+		uint64_t step = 0;
+		Op op = Op::Down;
+		uint8_t key = 0;
+		std::wstring stage;
+	};
+
+	std::vector<Command> mCommands; // sorted by step, stable
+	size_t mNext = 0;
+	bool mHeld[KeyCount]{};
+	std::vector<uint8_t> mTapped; // released again on the next Advance
+};
@@ -0,0 +1,175 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace
+{
+	// Which system's worker the current thread is, if any. Several systems can exist at once.
+	thread_local const JobSystem* tSystem = nullptr;
+	thread_local uint32_t tQueueIndex = 0;
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+	for (uint32_t i = 0; i < workerCount + 1; ++i) mQueues.push_back(std::make_unique<Queue>());
+	for (uint32_t i = 0; i < workerCount; ++i) mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	mStop.store(true);
+	{
+		std::lock_guard<std::mutex> lock{ mWakeMutex };
+	}
+	mWake.notify_all();
+	for (std::thread& worker : mWorkers) worker.join();
+}
+
+uint32_t JobSystem::GetWorkerCount() const
+{
+	return static_cast<uint32_t>(mWorkers.size());
+}
+
+void JobSystem::SetDeterministic(bool deterministic)
+{
+	mDeterministic.store(deterministic);
+}
+
+bool JobSystem::IsDeterministic() const
+{
+	return mDeterministic.load();
+}
+
+void JobSystem::Schedule(std::function<void()> job, JobCounter* counter, JobCounter* dependency)
+{
+	if (counter) counter->mPending.fetch_add(1, std::memory_order_relaxed);
+	Job scheduled{ std::move(job), counter };
+	if (dependency)
+	{
+		// Checked under the dependency's lock, the job that brings it to zero releases its waiting list under the same lock.
+		std::lock_guard<std::mutex> lock{ dependency->mMutex };
+		if (dependency->mPending.load(std::memory_order_acquire) != 0)
+		{
+			dependency->mWaiting.push_back(std::move(scheduled));
+			return;
+		}
+	}
+	Push(std::move(scheduled));
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	const uint32_t queueIndex = GetQueueIndex();
+	while (!counter.IsDone())
+	{
+		if (!TryRunOne(queueIndex)) std::this_thread::yield();
+	}
+	// The last job may still be releasing dependents under the lock; the counter can be destroyed once it is through.
+	std::lock_guard<std::mutex> lock{ counter.mMutex };
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& body)
+{
+	if (count == 0) return;
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	if (chunkCount == 1 || mWorkers.empty() || IsDeterministic())
+	{
+		for (size_t begin = 0; begin < count; begin += chunkSize) body(begin, std::min<size_t>(begin + chunkSize, count));
+		return;
+	}
+
+	// The caller takes the first chunk itself and then helps with the rest while waiting.
+	JobCounter counter;
+	for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+	{
+		const size_t begin = chunk * chunkSize;
+		const size_t end = std::min<size_t>(begin + chunkSize, count);
+		Schedule([&body, begin, end]() { body(begin, end); }, &counter);
+	}
+	body(0, chunkSize);
+	Wait(counter);
+}
+
+void JobSystem::WorkerLoop(uint32_t index)
+{
+	tSystem = this;
+	tQueueIndex = index;
+	while (true)
+	{
+		if (TryRunOne(index)) continue;
+		std::unique_lock<std::mutex> lock{ mWakeMutex };
+		mWake.wait(lock, [this]() { return mStop.load() || (mQueuedCount.load() > 0 && !mDeterministic.load()); });
+		if (mStop.load()) return;
+	}
+}
+
+void JobSystem::Push(Job job)
+{
+	const uint32_t queueIndex = IsDeterministic() ? static_cast<uint32_t>(mQueues.size()) - 1 : GetQueueIndex();
+	{
+		Queue& queue = *mQueues[queueIndex];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		queue.jobs.push_back(std::move(job));
+	}
+	mQueuedCount.fetch_add(1);
+	// Taking the lock orders this push against a worker that just found nothing and is about to sleep.
+	{
+		std::lock_guard<std::mutex> lock{ mWakeMutex };
+	}
+	mWake.notify_one();
+}
+
+bool JobSystem::TryRunOne(uint32_t queueIndex)
+{
+	Job job;
+	if (!Pop(queueIndex, job)) return false;
+	Run(job);
+	return true;
+}
+
+bool JobSystem::Pop(uint32_t queueIndex, Job& job)
+{
+	const bool deterministic = IsDeterministic();
+	if (deterministic && tSystem == this) return false; // only the waiting thread runs jobs
+
+	// Own queue first: newest job normally, oldest in deterministic mode to keep submission order.
+	const uint32_t queueCount = static_cast<uint32_t>(mQueues.size());
+	for (uint32_t i = 0; i < queueCount; ++i)
+	{
+		Queue& queue = *mQueues[(queueIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (queue.jobs.empty()) continue;
+		if (i == 0 && !deterministic)
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+		else
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+		mQueuedCount.fetch_sub(1);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Run(Job& job)
+{
+	job.function();
+	JobCounter* counter = job.counter;
+	if (!counter) return;
+
+	std::vector<Job> released;
+	{
+		std::lock_guard<std::mutex> lock{ counter->mMutex };
+		if (counter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) released.swap(counter->mWaiting);
+	}
+	for (Job& dependent : released) Push(std::move(dependent));
+}
+
+uint32_t JobSystem::GetQueueIndex() const
+{
+	return tSystem == this ? tQueueIndex : static_cast<uint32_t>(mQueues.size()) - 1;
+}
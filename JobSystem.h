@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Number of scheduled jobs that have not finished yet. Jobs scheduled with a dependency on a counter
+// start only once it drops to zero. A counter must outlive the jobs that reference it.
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	bool IsDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+	struct Job
+	{
+		std::function<void()> function;
+		JobCounter* counter;
+	};
+
+	std::atomic<uint32_t> mPending{ 0 };
+	std::mutex mMutex;
+	std::vector<Job> mWaiting; // dependents held back until mPending reaches zero
+};
+
+// Work-stealing scheduler. Each worker owns a deque: it pushes and pops its own jobs at the back
+// (newest first, still warm in cache) and steals from the front of the others when it runs dry.
+// Threads that are not workers share one more deque. Waiting on a counter runs jobs instead of
+// blocking, so jobs may schedule and wait on further jobs. Jobs must not throw.
+class JobSystem
+{
+public:
+	// workerCount threads besides the caller; 0 runs every job on the thread that waits for it.
+	explicit JobSystem(uint32_t workerCount);
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	~JobSystem();
+
+	uint32_t GetWorkerCount() const;
+	// Deterministic: ParallelFor runs its chunks in order on the calling thread and Schedule'd jobs
+	// only run inside Wait, in submission order. For reproducible runs and for debugging.
+	void SetDeterministic(bool deterministic);
+	bool IsDeterministic() const;
+
+	void Schedule(std::function<void()> job, JobCounter* counter, JobCounter* dependency = nullptr);
+	void Wait(JobCounter& counter);
+
+	// Calls body(begin, end) over [0, count) in chunks of chunkSize and returns when all are done.
+	// Chunk boundaries depend only on count and chunkSize, never on the number of threads, so
+	// per-chunk results combine the same way on every machine.
+	void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& body);
+
+private:
+	using Job = JobCounter::Job;
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void WorkerLoop(uint32_t index);
+	void Push(Job job);
+	bool TryRunOne(uint32_t queueIndex);
+	bool Pop(uint32_t queueIndex, Job& job);
+	void Run(Job& job);
+	uint32_t GetQueueIndex() const;
+
+	// One queue per worker plus the last one for every other thread.
+	std::vector<std::unique_ptr<Queue>> mQueues;
+	std::vector<std::thread> mWorkers;
+	std::atomic<uint32_t> mQueuedCount{ 0 };
+	std::atomic<bool> mStop{ false };
+	std::atomic<bool> mDeterministic{ false };
+	std::mutex mWakeMutex;
+	std::condition_variable mWake;
+};
@@ -1,11 +1,86 @@
 ﻿#include "stdafx.h"
 #include "Framework.h"
+#include <filesystem>
+#include "RenderLog.h"
 
 _Use_decl_annotations_
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow)
 {
     Framework framework;
+
+    // 공백으로 나눈 인자들. 공백이 있는 경로는 따옴표로 감싼다.
+    vector<string> arguments;
+    for (const char* c = lpCmdLine; *c;)
+    {
+        if (*c == ' ') { ++c; continue; }
+        const char end = *c == '"' ? '"' : ' ';
+        if (end == '"') ++c;
+        const char* begin = c;
+        while (*c && *c != end) ++c;
+        arguments.emplace_back(begin, c);
+        if (*c) ++c;
+    }
+    auto getOption = [&arguments](const char* name, size_t index = 0) -> wstring {
+        auto it = find(arguments.begin(), arguments.end(), name);
+        if (arguments.end() - it <= static_cast<ptrdiff_t>(index + 1)) return L"";
+        return filesystem::path(*(it + index + 1)).wstring();
+    };
+
+    // -renderdiff 기준.rlog 현재.rlog : 두 렌더 로그의 프레임별 카운터를 비교해 출력한다. 같으면 0 을 돌려준다.
+    wstring baselineLog = getOption("-renderdiff", 0);
+    wstring currentLog = getOption("-renderdiff", 1);
+    if (!baselineLog.empty() && !currentLog.empty())
+    {
+        RenderStatsTracker baseline, current;
+        if (!LoadRenderLog(baselineLog, baseline) || !LoadRenderLog(currentLog, current))
+        {
+            fputs("renderdiff: could not read the logs\n", stderr);
+            return 2;
+        }
+        string report = CompareRenderStats(baseline, current);
+        fputs(report.empty() ? "renderdiff: identical\n" : report.c_str(), stdout);
+        return report.empty() ? 0 : 1;
+    }
+
+    // -benchmark 결과.json [-baseline 기준.json] [-filter 이름] : 헤드리스 씬으로 핫 경로별 p50/p95/p99 와 할당 수를 재서 JSON 으로 저장한다.
+    // 기준선을 주면 비교해서 느려지거나 할당이 늘어난 항목을 표시하고, 하나라도 있으면 1 을 돌려준다.
+    // 기준선은 저장소에 두지 않는다. 시간은 머신마다 다르므로 비교할 머신에서 Benchmark 구성(할당 수를 센다)으로
+    // 먼저 -benchmark 기준.json 을 돌려 만든다. 기준선이 없거나 재지 않은 항목(iterations 0)이 있으면 비교는 실패한다.
+    BenchmarkOptions benchmark;
+    benchmark.outputFileName = getOption("-benchmark");
+    if (!benchmark.outputFileName.empty())
+    {
+        benchmark.baselineFileName = getOption("-baseline");
+        wstring filter = getOption("-filter");
+        benchmark.filter = string(filter.begin(), filter.end());
+        framework.OnInitHeadless(1280, 720, false);
+        return framework.RunBenchmarks(benchmark) ? 0 : 1;
+    }
+
+    // -headless N [-script 파일] [-record 파일] [-profile 파일] [-deterministic] [-preskinning] : 창과 D3D12 디바이스 없이 N 스텝을 최대한 빨리 시뮬레이션한 뒤 종료한다.
+    // 스크립트는 스텝마다 눌린 키와 스테이지 전환을 정한다 (형식은 InputScript.h).
+    // 창과 D3D12 없이 Simulation 만 돌린다. Linux 에서는 같은 인자를 받는 Headless 실행 파일(HeadlessMain.cpp, CMakeLists.txt)을 쓴다.
+    // -record 를 주면 스텝마다 기록용 디바이스에 한 프레임을 그리고 명령 로그(형식은 RenderLog.h)를 저장한다.
+    // -profile 을 주면 구간별 백분위를 출력하고 Chrome trace JSON 을 저장한다.
+    // -deterministic 을 주면 잡 시스템이 모든 작업을 메인 스레드에서 제출 순서대로 돌린다.
+    // -preskinning 은 헤드리스와 게임 모두에서 애니메이션 메시를 프레임마다 CPU 에서 한 번 스키닝해 두 패스가 같이 쓰게 한다.
+    // 주지 않으면 두 패스의 정점 셰이더에서 스키닝한다(PRESKIN_ANIMATED_OBJECTS).
+    const bool preSkinning = find(arguments.begin(), arguments.end(), "-preskinning") != arguments.end();
+    HeadlessOptions headless;
+    if (sscanf_s(lpCmdLine, " -headless %llu", &headless.stepCount) == 1)
+    {
+        headless.scriptFileName = getOption("-script");
+        headless.recordFileName = getOption("-record");
+        headless.profileFileName = getOption("-profile");
+        framework.OnInitHeadless(1280, 720);
+        framework.GetJobSystem().SetDeterministic(find(arguments.begin(), arguments.end(), "-deterministic") != arguments.end());
+        if (preSkinning) framework.GetScene(L"BaseScene").SetPreSkinning(true);
+        return framework.RunHeadless(headless) ? 0 : 1;
+    }
+
     framework.OnInit(hInstance, 1280, 720);
+    if (preSkinning) framework.GetScene(L"BaseScene").SetPreSkinning(true);
+
     ShowWindow(framework.GetHWnd(), nCmdShow);
     UpdateWindow(framework.GetHWnd());
     ShowCursor(false);
@@ -21,10 +96,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
         }
         else
         {
-            framework.OnUpdate();
-            framework.OnProcessCollision();
-            framework.LateUpdate();
-            framework.OnRender();
+            framework.OnFrame();
         }
     }
     return static_cast<int>(msg.wParam);
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file. CreateFileMapping on Windows, mmap elsewhere.
+// Pointers into the view stay valid until Close or destruction.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	~MappedFile();
+
+	bool Open(const std::wstring& fileName);
+	void Close();
+
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+	bool IsOpen() const;
+
+private:
+	const uint8_t* mData = nullptr;
+	size_t mSize = 0; // file and mapping handles are closed right after mapping, the view keeps them alive
+};
@@ -6,7 +6,8 @@
 
 #pragma once
 
-#include <Windows.h>
+#include <cmath>
+#include <cstdlib>
 #include <DirectXMath.h>
 #include <cstdint>
 
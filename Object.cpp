@@ -1,16 +1,12 @@
 #include "Object.h"
 #include "GameTimer.h"
 #include "Scene.h"
-#include "DXSampleHelper.h"
-#include <random>
-#include "Framework.h"
-
-std::random_device rd;  // ù ° rd ü
-default_random_engine dre(rd());
-uniform_int_distribution uid(-180,180);
+#include "Simulation.h"
+#include "Profiler.h"
 
 Object::~Object()
 {
+    if (m_constantBuffer.resource) m_renderDevice->Release(m_constantBuffer.resource);
     for (Component* component : m_components) {
         delete component;
     }
@@ -18,7 +14,6 @@ Object::~Object()
 
 Object::Object(Scene* scene, uint32_t id, uint32_t parentId) : m_scene{ scene }, m_id{id}, m_parent_id{parentId}
 {
-    BuildConstantBuffer(scene->GetFramework()->GetDevice());
 }
 
 void Object::OnUpdate(GameTimer& gTimer)
@@ -31,23 +26,31 @@ void Object::OnUpdate(GameTimer& gTimer)
         transform->SetPosition(newPos);
     }
 
-    XMMATRIX finalM = transform->GetTransformM();
-    if (m_parent_id != -1) {
-        Object* parentObj = m_scene->GetObjFromId(m_parent_id);
-        if (parentObj) {
-            Transform* parentTransform = parentObj->GetComponent<Transform>();
-            finalM = finalM * parentTransform->GetFinalM();
-        }
-        else {
-            Delete();
-        }
-    }
-    transform->SetFinalM(finalM);
+    //   Scene  TransformHierarchy  θ ռؼ, ٲ Ʈ ApplyWorld  ش.
+    // Transform  ״θ  ĵ ״̹Ƿ,  ʴ Ʈ   ѱ ʴ´.
+    if (transform->GetVersion() == m_localVersion) return;
+    m_localVersion = transform->GetVersion();
+    m_scene->GetTransformHierarchy().SetLocal(m_transformNode, transform->GetTransformM());
+}
 
+void Object::ResolveParent()
+{
+    // θ id  ٲ  Ƿ(QuadObject) ܸ  θ . θ   .
+    if (m_parent_id == -1) return;
+    Object* parentObj = m_scene->GetObjFromId(m_parent_id);
+    if (!parentObj) {
+        Delete();
+        return;
+    }
+    m_scene->GetTransformHierarchy().SetParent(m_transformNode, parentObj->GetTransformNode());
+}
 
+void Object::ApplyWorld(XMMATRIX world)
+{
+    GetComponent<Transform>()->SetFinalM(world);
     Collider* collider = GetComponent<Collider>();
     if (collider) {
-        collider->UpdateOBB(finalM);
+        collider->UpdateOBB(world);
     }
 }
 
@@ -67,79 +70,133 @@ void Object::OnProcessCollision(Object& other, XMVECTOR collisionNormal, float p
 
 void Object::LateUpdate(GameTimer& gTimer)
 {
-    Transform* transform = GetComponent<Transform>();
-    TerrainObject* terrainObj = dynamic_cast<TerrainObject*>(this);
-    if (!terrainObj && m_parent_id == -1) {
-        XMVECTOR pos = transform->GetPosition();
-        char outstatus = m_scene->ClampToBounds(pos, { 0.0f, 0.0f, 0.0f });
-        transform->SetPosition(pos);
-
-        Gravity* gravity = GetComponent<Gravity>();
-        if ((outstatus & 0x04) && gravity)
-        {
-            gravity->ResetElapseTime();
-        }
-    }
-
-    XMMATRIX world = transform->GetFinalM();
-    XMMATRIX adjustM = XMMatrixIdentity();
-    AdjustTransform* adjustTrnasform = GetComponent<AdjustTransform>();
-    if (adjustTrnasform) {
-        adjustM = adjustTrnasform->GetTransformM();
-    }
-    memcpy(m_mappedData, &XMMatrixTranspose(adjustM * world), sizeof(XMMATRIX));
-
-    ProcessAnimation(gTimer);
+    // / Ŭ Scene::ClampObjectsToBounds   Ʈ   óѴ.
+    //    ̸ ؾ ϹǷ UpdateRenderTransform  .
+    //      ٸ  .  ؽó ε    ٲ.
+    ProcessAnimation();
 
     Texture* texture = GetComponent<Texture>();
     float powValue = 1.0f;
     float ambiantValue = 0.4f;
+    int textureIndex = 0;
     if (texture) {
         ambiantValue = texture->mAmbiantValue;
         powValue = texture->mPowValue;
+        int slot = m_scene->GetTextureIndex(texture->mName);
+        if (slot >= 0) textureIndex = slot;
+    }
+    if (textureIndex != m_cbTextureIndex) {
+        WriteConstantBuffer(offsetof(ObjectCB, textureIndex), &textureIndex, sizeof(int));
+        m_cbTextureIndex = textureIndex;
+    }
+    if (powValue != m_cbPowValue || ambiantValue != m_cbAmbiantValue) {
+        float material[2]{ powValue, ambiantValue };
+        WriteConstantBuffer(offsetof(ObjectCB, powValue), material, sizeof(material));
+        m_cbPowValue = powValue;
+        m_cbAmbiantValue = ambiantValue;
+    }
+}
+
+void Object::UpdateRenderTransform(float alpha)
+{
+    // ̹ ܿ  Ʈ ؼ   .     ٲ    .
+    Transform* transform = GetComponent<Transform>();
+    XMFLOAT4X4 world;
+    if (transform->IsMovingThisStep()) {
+        XMMATRIX interpolated = transform->GetInterpolatedFinalM(alpha);
+        AdjustTransform* adjustTransform = GetComponent<AdjustTransform>();
+        if (adjustTransform) interpolated = adjustTransform->GetTransformM() * interpolated;
+        XMStoreFloat4x4(&world, XMMatrixTranspose(interpolated));
+        m_renderWorldVersion = UINT32_MAX;
     }
-    memcpy(m_mappedData + sizeof(XMFLOAT4X4) * 91 + sizeof(int) * 4, &powValue, sizeof(float));
-    memcpy(m_mappedData + sizeof(XMFLOAT4X4) * 91 + sizeof(int) * 4 + sizeof(float), &ambiantValue, sizeof(float));
+    else if (m_renderWorldVersion != transform->GetFinalVersion()) {
+        XMStoreFloat4x4(&world, XMMatrixTranspose(GetModelM()));
+        m_renderWorldVersion = transform->GetFinalVersion();
+    }
+    else return;
+    WriteConstantBuffer(offsetof(ObjectCB, world), &world, sizeof(XMFLOAT4X4));
+    if (IsStatic()) m_scene->UpdateStaticCaster(m_id, world);
 }
 
-void Object::OnRender(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
+XMMATRIX Object::GetModelM()
+{
+    Transform* transform = GetComponent<Transform>();
+    if (m_modelVersion != transform->GetFinalVersion()) {
+        XMMATRIX model = transform->GetFinalM();
+        AdjustTransform* adjustTransform = GetComponent<AdjustTransform>();
+        if (adjustTransform) model = adjustTransform->GetTransformM() * model;
+        XMStoreFloat4x4(&m_modelM, model);
+        m_modelVersion = transform->GetFinalVersion();
+    }
+    return XMLoadFloat4x4(&m_modelM);
+}
+
+void Object::OnRender(RenderDevice& renderDevice)
 {
     Mesh* mesh = GetComponent<Mesh>();
     if (!mesh) return;
     
-    Texture* texture = GetComponent<Texture>();
-    int textureIndex = m_scene->GetTextureIndex(texture->mName);
-
-    CD3DX12_GPU_DESCRIPTOR_HANDLE hDescriptor(m_scene->GetDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-    hDescriptor.Offset(1 + textureIndex, device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV));
-    commandList->SetGraphicsRootDescriptorTable(1, hDescriptor);
-    commandList->SetGraphicsRootConstantBufferView(2, m_constantBuffer.Get()->GetGPUVirtualAddress());
+    // ؽó   textureIndex  bindless ̺ .
+    renderDevice.SetRootConstantBuffer(2, PrepareConstantBuffer());
 
     SubMeshData& data = m_scene->GetResourceManager().GetSubMeshData(mesh->mName);
-    if (data.startIndexLocation == -1) {
-        commandList->DrawInstanced(data.vertexCountPerInstance, 1, data.startVertexLocation, 0);
+    if (IsPreSkinned()) {
+        // Scene::RenderObjects  Ű׵  ۿ PSO  ε ξ.
+        renderDevice.Draw(m_skinnedVertexCount, m_skinnedVertex);
+    }
+    else if (data.startIndexLocation == -1) {
+        renderDevice.Draw(data.vertexCountPerInstance, data.startVertexLocation);
     }
     else {
-        commandList->DrawIndexedInstanced(data.indexCountPerInstance, 1, data.startIndexLocation, data.baseVertexLocation, 0);
+        renderDevice.DrawIndexed(data.indexCountPerInstance, data.startIndexLocation, data.baseVertexLocation);
     }
 
 }
 
 
-void Object::BuildConstantBuffer(ID3D12Device* device)
+void Object::BuildConstantBuffer()
 {
-    const UINT constantBufferSize = m_scene->CalcConstantBufferByteSize(sizeof(ObjectCB));    // CB size is required to be 256-byte aligned.
+    // CB size is required to be 256-byte aligned.
+    //  Ʈ ε   ʴ´.  ý ޸𸮿 Ҵٰ ó ׸  ⺻    ø.
+    m_renderDevice = &m_scene->GetSimulation()->GetRenderDevice();
+    UINT size = m_scene->CalcConstantBufferByteSize(sizeof(ObjectCB));
+    if (IsStatic()) {
+        m_staticConstants.assign(size, 0);
+        m_staticConstantsDirty = true;
+        return;
+    }
+    m_constantBuffer = m_renderDevice->CreateUploadBuffer(size);
+}
 
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_constantBuffer)));
+void Object::WriteConstantBuffer(UINT offset, const void* data, UINT size)
+{
+    if (!m_staticConstants.empty()) {
+        memcpy(m_staticConstants.data() + offset, data, size);
+        m_staticConstantsDirty = true;
+        return;
+    }
+    m_renderDevice->Write(m_constantBuffer, offset, data, size);
+}
+
+RenderAddress Object::PrepareConstantBuffer()
+{
+    // Ŀǵ Ʈ ϴ ߿  ۸   ִ.  ۴   Ƿ ٷ Ƶ ȴ.
+    if (m_staticConstantsDirty) {
+        if (m_constantBuffer.resource) m_renderDevice->Release(m_constantBuffer.resource);
+        m_constantBuffer = m_renderDevice->CreateStaticBuffer(m_staticConstants.data(), m_staticConstants.size());
+        m_staticConstantsDirty = false;
+    }
+    return m_constantBuffer.address;
+}
+
+bool Object::IsPreSkinned()
+{
+    return m_skinnedVertex != UINT32_MAX;
+}
 
-    CD3DX12_RANGE readRange(0, 0);
-    ThrowIfFailed(m_constantBuffer->Map(0, &readRange, reinterpret_cast<void**>(& m_mappedData)));
+UINT Object::GetPreSkinnedVertexCount()
+{
+    return IsPreSkinned() ? m_skinnedVertexCount : 0;
 }
 
 void Object::AddComponent(Component* component)
@@ -147,21 +204,47 @@ void Object::AddComponent(Component* component)
     m_components.push_back(component);
 }
 
-void Object::ProcessAnimation(GameTimer& gTimer)
+void Object::UpdateAnimation(GameTimer& gTimer)
 {
+    //   길 Ѵ. ڱ ִϸ̼ ¸ ٲٹǷ Scene::LateUpdate   忡  θ.
+    PROFILE_ZONE("Object::UpdateAnimation");
+    Animation* animation = GetComponent<Animation>();
+    if (!animation) return;
+    SkinnedData& animData = m_scene->GetResourceManager().GetAnimationData(animation->mCurrentFileName);
+    animation->mAnimationTime += gTimer.DeltaTime();
+    string clipName = "Take 001";
+    if (animation->mAnimationTime >= animData.GetClipEndTime(clipName)) animation->mAnimationTime = 0.0f;
+    animData.GetFinalPalette(clipName, animation->mAnimationTime, m_bonePalette);
+}
+
+void Object::ProcessAnimation()
+{
+    // UpdateAnimation      Scene   ȷƮ ְ, CB  ȷƮ  ġ .
+    //    α׿ Ƿ  忡  Ѵ.
     Animation* animation = GetComponent<Animation>();
     int isAnimate = false;
-    if (animation) {
+    m_skinnedVertex = UINT32_MAX;
+    if (animation && !m_bonePalette.empty()) {
         isAnimate = true;
-        vector<XMFLOAT4X4> finalTransforms{ 90 };
-        SkinnedData& animData = m_scene->GetResourceManager().GetAnimationData(animation->mCurrentFileName);
-        animation->mAnimationTime += gTimer.DeltaTime();
-        string clipName = "Take 001";
-        if (animation->mAnimationTime >= animData.GetClipEndTime(clipName)) animation->mAnimationTime = 0.0f;
-        animData.GetFinalTransforms(clipName, animation->mAnimationTime, finalTransforms);
-        memcpy(m_mappedData + sizeof(XMMATRIX), finalTransforms.data(), sizeof(XMMATRIX) * 90); // ó Ű ּ
+        UINT paletteOffset = m_scene->AddBonePalette(m_bonePalette);
+        if (paletteOffset != m_cbPaletteOffset) {
+            WriteConstantBuffer(offsetof(ObjectCB, paletteOffset), &paletteOffset, sizeof(UINT));
+            m_cbPaletteOffset = paletteOffset;
+        }
+        // ̸ Ű  ޽  Ű Ͽ ø. ε  ޽ø شȴ(FBX ޽ô  ׷).
+        Mesh* mesh = GetComponent<Mesh>();
+        if (mesh && m_scene->IsPreSkinning()) {
+            SubMeshData& data = m_scene->GetResourceManager().GetSubMeshData(mesh->mName);
+            if (data.startIndexLocation == -1) {
+                m_skinnedVertexCount = data.vertexCountPerInstance;
+                m_skinnedVertex = m_scene->AddSkinning({ data.startVertexLocation, data.vertexCountPerInstance, paletteOffset });
+            }
+        }
+    }
+    if (isAnimate != m_cbIsAnimate) {
+        WriteConstantBuffer(offsetof(ObjectCB, isAnimate), &isAnimate, sizeof(int));
+        m_cbIsAnimate = isAnimate;
     }
-    memcpy(m_mappedData + sizeof(XMMATRIX) * 91, &isAnimate, sizeof(int));
 }
 
 uint32_t Object::GetId()
@@ -169,14 +252,110 @@ uint32_t Object::GetId()
     return m_id;
 }
 
+uint32_t Object::GetParentId()
+{
+    return m_parent_id;
+}
+
+uint32_t Object::GetTransformNode()
+{
+    return m_transformNode;
+}
+
+void Object::SetTransformNode(uint32_t node)
+{
+    m_transformNode = node;
+}
+
 bool Object::GetValid()
 {
     return m_valid;
 }
 
+void Object::SetValid(bool valid)
+{
+    m_valid = valid;
+}
+
 void Object::Delete()
 {
-    m_valid = false;
+    m_scene->Defer([this]() { m_valid = false; });
+}
+
+bool Object::IsStatic()
+{
+    return false;
+}
+
+void TerrainObject::LateUpdate(GameTimer& gTimer)
+{
+    Object::LateUpdate(gTimer);
+
+    CameraObject* camera = m_scene->GetObj<CameraObject>();
+    if (!camera) return;
+
+    // ī޶    Űܼ Ÿ  LOD  .
+    TerrainQuadTree& quadTree = m_scene->GetResourceManager().GetTerrainQuadTree();
+    XMMATRIX world = GetComponent<Transform>()->GetFinalM();
+    XMMATRIX cameraWorld = camera->GetComponent<Transform>()->GetTransformM();
+    XMFLOAT3 eye;
+    XMStoreFloat3(&eye, XMVector3Transform(cameraWorld.r[3], XMMatrixInverse(nullptr, world)));
+    quadTree.Select(eye.x, eye.y, eye.z, TERRAIN_LOD_DISTANCE, mSelection);
+    // ׸ н õ ûũ  ׸ ʿ ׸Ƿ,  ٲ ĳø ٽ ׸.
+    if (mSelection != mSelectedChunks) {
+        mSelectedChunks.swap(mSelection);
+        m_scene->InvalidateStaticShadow();
+    }
+
+    // ûũ ü ø
+    BoundingFrustum frustum{ XMLoadFloat4x4(&m_scene->GetProjMatrix()) };
+    frustum.Transform(frustum, cameraWorld);
+    float scale = quadTree.GetScale();
+    TerrainData& terrainData = m_scene->GetResourceManager().GetTerrainData();
+    mVisibleChunks.clear();
+    for (uint32_t index : mSelectedChunks) {
+        const TerrainNode& node = quadTree.GetNode(index);
+        float maxX = std::min<uint32_t>(node.x + node.size, terrainData.terrainWidth - 1) * scale;
+        float maxZ = std::min<uint32_t>(node.z + node.size, terrainData.terrainHeight - 1) * scale;
+        float skirt = quadTree.GetSkirtDepth(node.level);
+        BoundingBox box;
+        BoundingBox::CreateFromPoints(box, XMVECTOR{ node.x * scale, node.minHeight - skirt, node.z * scale }, XMVECTOR{ maxX, node.maxHeight, maxZ });
+        box.Transform(box, world);
+        if (frustum.Intersects(box)) mVisibleChunks.push_back(index);
+    }
+}
+
+void TerrainObject::OnRender(RenderDevice& renderDevice)
+{
+    Mesh* mesh = GetComponent<Mesh>();
+    if (!mesh) return;
+
+    renderDevice.SetRootConstantBuffer(2, PrepareConstantBuffer());
+
+    //  ûũ  ε    ġ ٸ.
+    SubMeshData& data = m_scene->GetResourceManager().GetSubMeshData(mesh->mName);
+    TerrainQuadTree& quadTree = m_scene->GetResourceManager().GetTerrainQuadTree();
+    vector<uint32_t>& chunks = m_scene->GetCurrentPass() == ePass::Default ? mVisibleChunks : mSelectedChunks;
+    for (uint32_t index : chunks) {
+        const TerrainNode& node = quadTree.GetNode(index);
+        renderDevice.DrawIndexed(data.indexCountPerInstance, data.startIndexLocation, data.baseVertexLocation + node.baseVertex);
+    }
+}
+
+bool TerrainObject::IsStatic()
+{
+    return true;
+}
+
+bool TestObject::IsStatic()
+{
+    // θ  θ  δ.
+    return m_parent_id == -1;
+}
+
+bool TreeObject::IsStatic()
+{
+    return m_parent_id == -1;
 }
 
 void PlayerObject::OnUpdate(GameTimer& gTimer)
@@ -211,7 +390,7 @@ void PlayerObject::OnProcessCollision(Object& other, XMVECTOR collisionNormal, f
 void PlayerObject::ProcessInput(const GameTimer& gTimer)
 {
     CalcTime(gTimer.DeltaTime());
-    BYTE* keyState = m_scene->GetFramework()->GetKeyState();
+    BYTE* keyState = m_scene->GetSimulation()->GetKeyState();
     Transform* transform = GetComponent<Transform>();
 
     XMVECTOR dir = XMVectorZero();
@@ -265,7 +444,7 @@ void PlayerObject::Move(XMVECTOR dir, float speed,float deltaTime)
     Transform* transform = GetComponent<Transform>();
     CameraObject* cameraObj = m_scene->GetObj<CameraObject>();
     Transform* cameraTransform = cameraObj->GetComponent<Transform>();
-    dir = XMVector3TransformNormal(dir, cameraTransform->GetRotationM());
+    dir = XMVector3TransformNormal(dir, cameraTransform->GetStepStartRotationM());
 
     dir = XMVector3Normalize(XMVectorSetY(dir, 0.0f));
 
@@ -274,7 +453,7 @@ void PlayerObject::Move(XMVECTOR dir, float speed,float deltaTime)
     transform->SetPosition(pos);
 
     float yaw = atan2f(XMVectorGetX(dir), XMVectorGetZ(dir)) * 180 / 3.141592f;
-    transform->SetRotation({ 0.0f, yaw, 0.0f });
+    transform->SetRotation(XMVectorSet(0.0f, yaw, 0.0f, 0.0f));
 }
 
 void PlayerObject::Idle()
@@ -340,10 +519,12 @@ void PlayerObject::Fire()
     if (mIsFired) return;
     mIsFired = true;
 
-    Object* obj = new PlayerAttackObject(m_scene, m_scene->AllocateId(), m_id);
-    obj->AddComponent(new Transform{ {0.0f, 8.0f, 8.0f} });
-    obj->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {6.0f, 8.0f, 6.0f} });
-    m_scene->AddObj(obj);
+    m_scene->Spawn([scene = m_scene, parentId = m_id]() {
+        Object* obj = new PlayerAttackObject(scene, scene->AllocateId(), parentId);
+        obj->AddComponent(new Transform{ XMVectorSet(0.0f, 8.0f, 8.0f, 0.0f) });
+        obj->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {6.0f, 8.0f, 6.0f} });
+        return obj;
+    });
 
     // ü ߰ 
 }
@@ -411,11 +592,14 @@ void CameraObject::OnUpdate(GameTimer& gTimer)
 
     Object* playerObj = m_scene->GetObj<PlayerObject>();
     Transform* playerTransform = playerObj->GetComponent<Transform>();
-    XMVECTOR targetPos = playerTransform->GetPosition() + XMVECTOR{0.0f, 10.0f, 0.0f};
+    XMVECTOR targetPos = playerTransform->GetStepStartPosition() + XMVECTOR{0.0f, 10.0f, 0.0f};
 
     Transform* myTransform = GetComponent<Transform>();
     XMVECTOR myPos = targetPos + XMVECTOR{ x, y, z, 0.f };
-    char outstatus = m_scene->ClampToBounds(myPos, { 0.0f, 1.0f, 0.0f });
+    // ÷̾ ī޶ ̸   ī޶ ε    .
+    float hitT = 0.0f;
+    if (m_scene->CastTerrainSegment(targetPos, myPos, &hitT)) myPos = XMVectorLerp(targetPos, myPos, hitT * 0.9f);
+    char outstatus = m_scene->ClampToBounds(myPos, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
     myTransform->SetPosition(myPos);
     
     XMVECTOR dir = targetPos - myPos;
@@ -425,33 +609,33 @@ void CameraObject::OnUpdate(GameTimer& gTimer)
 
     float yaw = atan2f(yawPitch.x, yawPitch.z) * 180 / 3.141592f;
     float pitch = atan2f(yawPitch.y, sqrtf(yawPitch.x * yawPitch.x + yawPitch.z * yawPitch.z)) * 180 / 3.141592f;
-    myTransform->SetRotation({ -pitch, yaw, 0.0f });
+    myTransform->SetRotation(XMVectorSet(-pitch, yaw, 0.0f, 0.0f));
 
     Object::OnUpdate(gTimer);
 }
 
 void CameraObject::LateUpdate(GameTimer& gTimer)
 {
+    // ī޶ Ʈ  ۸  ʴ´.   UpdateRenderTransform  ؼ .
+}
+
+void CameraObject::UpdateRenderTransform(float alpha)
+{
+    // ī޶  ְ ̹  ̸   ٽ  ʴ´.
     Transform* transform = GetComponent<Transform>();
-    XMMATRIX transformM = transform->GetTransformM();
+    if (!transform->IsMovingThisStep()) {
+        if (m_renderWorldVersion == transform->GetFinalVersion()) return;
+        m_renderWorldVersion = transform->GetFinalVersion();
+    }
+    else m_renderWorldVersion = UINT32_MAX;
+    XMMATRIX transformM = transform->GetInterpolatedFinalM(alpha);
     XMMATRIX invtransformM = XMMatrixInverse(nullptr, transformM);
-    memcpy(m_scene->GetConstantBufferMappedData(), &XMMatrixTranspose(invtransformM), sizeof(XMMATRIX)); // ó Ű ּ
+    invtransformM = XMMatrixTranspose(invtransformM);
+    m_scene->WriteConstantBuffer(0, &invtransformM, sizeof(XMMATRIX));
 }
 
-void CameraObject::OnMouseInput(WPARAM wParam, HWND hWnd)
+void CameraObject::OnMouseMove(float dx, float dy)
 {
-    //  wnd  ǥ ˾ƿ´
-    RECT clientRect{};
-    GetWindowRect(hWnd, &clientRect);
-    int width = int(clientRect.right - clientRect.left);
-    int height = int(clientRect.bottom - clientRect.top);
-    int centerX = clientRect.left + width / 2;
-    int centerY = clientRect.top + height / 2;
-
-    POINT currentMousePos;
-    GetCursorPos(&currentMousePos);
-    float dx = static_cast<float>(currentMousePos.x - centerX);
-    float dy = static_cast<float>(currentMousePos.y - centerY);
     mTheta -= XMConvertToRadians(dx * 0.02f);
     mPhi -= XMConvertToRadians(dy * 0.02f);
 
@@ -459,8 +643,6 @@ void CameraObject::OnMouseInput(WPARAM wParam, HWND hWnd)
     float min = 0.1f;
     float max = XM_PI - 0.1f;
     mPhi = mPhi < min ? min : (mPhi > max ? max : mPhi);
-
-    SetCursorPos(centerX, centerY);
 }
 
 void TigerObject::OnUpdate(GameTimer& gTimer)
@@ -496,7 +678,7 @@ void TigerObject::TigerBehavior(GameTimer& gTimer)
     XMVECTOR pos = transform->GetPosition();
     PlayerObject* player = m_scene->GetObj<PlayerObject>();
     Transform* playerTransform = player->GetComponent<Transform>();
-    XMVECTOR playerPos = playerTransform->GetPosition();
+    XMVECTOR playerPos = playerTransform->GetStepStartPosition();
     float result = XMVectorGetX(XMVector3Length(playerPos - pos));
     XMVECTOR dir = XMVector3Normalize(playerPos - pos);
     float yaw = atan2f(XMVectorGetX(dir), XMVectorGetZ(dir)) * 180 / 3.141592f;
@@ -508,7 +690,7 @@ void TigerObject::TigerBehavior(GameTimer& gTimer)
             Attack();
             if (anim->mCurrentFileName == "0208_tiger_attack.fbx" && mElapseTime == 0)
             {
-                transform->SetRotation({ 0.0f, yaw, 0.0f });
+                transform->SetRotation(XMVectorSet(0.0f, yaw, 0.0f, 0.0f));
             }
         }
         else // Ž ȿ ÷̾ , ſ  ʴٸ...
@@ -517,7 +699,7 @@ void TigerObject::TigerBehavior(GameTimer& gTimer)
             if (anim->mCurrentFileName == "0722_tiger_run.fbx") 
             {
                 transform->SetPosition(pos + dir * mRunSpeed * gTimer.DeltaTime());
-                transform->SetRotation({ 0.0f, yaw, 0.0f });
+                transform->SetRotation(XMVectorSet(0.0f, yaw, 0.0f, 0.0f));
             }
         }
     }
@@ -536,17 +718,16 @@ void TigerObject::ChangeState(string fileName)
 
 void TigerObject::Search(float deltaTime)
 {
-    static float randYaw = uid(dre);
     Transform* transform = GetComponent<Transform>();
     
     if (mSearchTime > 2.0f)
     {
         mSearchTime = 0.0f;
-        randYaw = uid(dre);
-        transform->SetRotation({ 0.0f, randYaw, 0.0f });
+        float randYaw = static_cast<float>(uniform_int_distribution<int>(-180, 180)(mRandom));
+        transform->SetRotation(XMVectorSet(0.0f, randYaw, 0.0f, 0.0f));
     }
 
-    XMVECTOR dir = XMVector3TransformNormal({ 0.0f, 0.0f, 1.0f }, transform->GetRotationM());
+    XMVECTOR dir = XMVector3TransformNormal(XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), transform->GetRotationM());
     dir = XMVector3Normalize(dir);
     XMVECTOR pos = transform->GetPosition();
     transform->SetPosition(pos + dir * mWalkSpeed * deltaTime);
@@ -600,10 +781,12 @@ void TigerObject::Fire()
     if (mIsFired) return;
     mIsFired = true;
 
-    Object* obj = new TigerAttackObject(m_scene, m_scene->AllocateId(), m_id);
-    obj->AddComponent(new Transform{ {0.0f, 6.0f, 18.0f} });
-    obj->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {4.0f, 6.0f, 8.0f} });
-    m_scene->AddObj(obj);
+    m_scene->Spawn([scene = m_scene, parentId = m_id]() {
+        Object* obj = new TigerAttackObject(scene, scene->AllocateId(), parentId);
+        obj->AddComponent(new Transform{ XMVectorSet(0.0f, 6.0f, 18.0f, 0.0f) });
+        obj->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {4.0f, 6.0f, 8.0f} });
+        return obj;
+    });
 }
 
 void TigerObject::Hit()
@@ -662,16 +845,17 @@ void TigerObject::CreateLeather()
     Transform* transform = GetComponent<Transform>();
     XMVECTOR pos = transform->GetPosition();
 
-    Object* objectPtr = nullptr;
-    float scale = 0.1f;
-    objectPtr = new TigerLeather(m_scene, m_scene->AllocateId());
-    objectPtr->AddComponent(new Transform{ pos });
-    objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 100.0f * scale, 0.0f * scale}, {-90.0f, 0.0f, 0.0f}, {scale, scale, scale} });
-    objectPtr->AddComponent(new Mesh{ "tiger_leather.fbx" });
-    objectPtr->AddComponent(new Texture{ L"tigerLeather", 1.0f, 0.6f });
-    objectPtr->AddComponent(new Collider{ {0.0f, 100.0f * scale, 0.0f}, {90.0f * scale, 100.0f * scale, 20.0f * scale} });
-    objectPtr->AddComponent(new Gravity);
-    m_scene->AddObj(objectPtr);
+    m_scene->Spawn([scene = m_scene, pos]() {
+        float scale = 0.1f;
+        Object* objectPtr = new TigerLeather(scene, scene->AllocateId());
+        objectPtr->AddComponent(new Transform{ pos });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 100.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(-90.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
+        objectPtr->AddComponent(new Mesh{ "tiger_leather.fbx" });
+        objectPtr->AddComponent(new Texture{ L"tigerLeather", 1.0f, 0.6f });
+        objectPtr->AddComponent(new Collider{ {0.0f, 100.0f * scale, 0.0f}, {90.0f * scale, 100.0f * scale, 20.0f * scale} });
+        objectPtr->AddComponent(new Gravity);
+        return objectPtr;
+    });
 }
 
 void TigerAttackObject::OnUpdate(GameTimer& gTimer)
@@ -697,7 +881,6 @@ void PlayerAttackObject::OnUpdate(GameTimer& gTimer)
 
 void TigerMockup::OnUpdate(GameTimer& gTimer)
 {
-    static float randYaw = uid(dre);
     Transform* transform = GetComponent<Transform>();
 
     mSearchTime += gTimer.DeltaTime();
@@ -705,11 +888,11 @@ void TigerMockup::OnUpdate(GameTimer& gTimer)
     if (mSearchTime > 2.0f)
     {
         mSearchTime = 0.0f;
-        randYaw = uid(dre);
-        transform->SetRotation({ 0.0f, randYaw, 0.0f });
+        float randYaw = static_cast<float>(uniform_int_distribution<int>(-180, 180)(mRandom));
+        transform->SetRotation(XMVectorSet(0.0f, randYaw, 0.0f, 0.0f));
     }
 
-    XMVECTOR dir = XMVector3TransformNormal({ 0.0f, 0.0f, 1.0f }, transform->GetRotationM());
+    XMVECTOR dir = XMVector3TransformNormal(XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), transform->GetRotationM());
     dir = XMVector3Normalize(dir);
     XMVECTOR pos = transform->GetPosition();
     transform->SetPosition(pos + dir * mWalkSpeed * gTimer.DeltaTime());
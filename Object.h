@@ -1,6 +1,8 @@
 #pragma once
-#include "stdafx.h"
+#include "CoreTypes.h"
 #include "Component.h"
+#include "RenderDevice.h"
+#include <random>
 
 class GameTimer;
 class Scene;
@@ -10,15 +12,30 @@ public:
 	virtual ~Object();
 	Object(Scene* scene, uint32_t id, uint32_t parentId = -1);
 	virtual void OnUpdate(GameTimer& gTimer);
+	void ResolveParent();
+	void ApplyWorld(XMMATRIX world);
 	virtual void OnProcessCollision(Object& other, XMVECTOR collisionNormal, float penetration);
 	virtual void LateUpdate(GameTimer& gTimer);
-	virtual void OnRender(ID3D12Device* device, ID3D12GraphicsCommandList * commandList);
-	void BuildConstantBuffer(ID3D12Device* device);
+	virtual void OnRender(RenderDevice& renderDevice);
+	virtual void UpdateRenderTransform(float alpha);
+	// AdjustTransform *  .   ٲ  ٽ Ѵ.
+	XMMATRIX GetModelM();
+	// Scene    . IsStatic   Լ ڿ    .
+	void BuildConstantBuffer();
 	void AddComponent(Component* component);
 	Scene* GetScene() { return m_scene; }
-	void ProcessAnimation(GameTimer& gTimer);
+	void UpdateAnimation(GameTimer& gTimer);
+	void ProcessAnimation();
+	// ̹ ܿ Scene  Ű׵  ۿ ڸ ޾  н    ׸.
+	bool IsPreSkinned();
+	UINT GetPreSkinnedVertexCount();
 	uint32_t GetId();
+	uint32_t GetParentId();
+	uint32_t GetTransformNode();
+	void SetTransformNode(uint32_t node);
 	bool GetValid();
+	void SetValid(bool valid);
+	virtual bool IsStatic();
 	void Delete();
 
 	template <typename T>
@@ -36,12 +53,32 @@ protected:
 	Scene* m_scene = nullptr;
 	uint32_t m_id = -1;
 	uint32_t m_parent_id = -1;
+	uint32_t m_transformNode = UINT32_MAX; // Scene  TransformHierarchy 
+	uint32_t m_localVersion = UINT32_MAX; //   ѱ Transform 
+	XMFLOAT4X4 m_modelM;
+	uint32_t m_modelVersion = UINT32_MAX;
+	uint32_t m_renderWorldVersion = UINT32_MAX; // CB       
 	bool m_valid = true;
 	vector<Component*> m_components;
 
-	// Ʈ   CB
-	UINT8* m_mappedData = nullptr;
-	ComPtr<ID3D12Resource> m_constantBuffer;
+	void WriteConstantBuffer(UINT offset, const void* data, UINT size);
+	//  ߿ θ.  Ʈ CB  ٲ ̶ ⺻  ٽ ø.
+	RenderAddress PrepareConstantBuffer();
+
+	// Ʈ   CB. ̴ Ʈ ε ,  Ʈ ⺻  д.
+	RenderDevice* m_renderDevice = nullptr;
+	RenderBuffer m_constantBuffer;
+	vector<uint8_t> m_staticConstants; //  Ʈ CB , ε  ⿡ 
+	bool m_staticConstantsDirty = false;
+	//  CB   . ٲ ͸ ٽ . -1    ʾҴٴ ̴.
+	int m_cbIsAnimate = -1;
+	int m_cbTextureIndex = -1;
+	UINT m_cbPaletteOffset = UINT32_MAX;
+	float m_cbPowValue = -1.0f;
+	float m_cbAmbiantValue = -1.0f;
+	vector<XMFLOAT4> m_bonePalette; // ̹   ( 3x4  ), UpdateAnimation  ä
+	UINT m_skinnedVertex = UINT32_MAX; // Scene  Ű׵  ۿ ù , ̸ Ű  UINT32_MAX
+	UINT m_skinnedVertexCount = 0;
 };
 
 class PlayerObject : public Object
@@ -79,7 +116,9 @@ public:
 	using Object::Object;
 	void OnUpdate(GameTimer& gTimer) override;
 	void LateUpdate(GameTimer& gTimer) override;
-	void OnMouseInput(WPARAM wParam, HWND hWnd);
+	void UpdateRenderTransform(float alpha) override;
+	// 콺  ȼ ŭ ī޶ . Ŀ ġ Win32Application  д´.
+	void OnMouseMove(float dx, float dy);
 private:
 	int mLastPosX = -1;
 	int mLastPosY = -1;
@@ -92,18 +131,27 @@ class TerrainObject : public Object
 {
 public:
 	using Object::Object;
+	void LateUpdate(GameTimer& gTimer) override;
+	void OnRender(RenderDevice& renderDevice) override;
+	bool IsStatic() override;
+private:
+	vector<uint32_t> mSelectedChunks; // LOD  , ׸ н  ׸
+	vector<uint32_t> mSelection;      // ̹ ܿ  ûũ, ٲ  mSelectedChunks  ¹ٲ۴
+	vector<uint32_t> mVisibleChunks;  //   þ ü  ûũ
 };
 
 class TestObject : public Object
 {
 public:
 	using Object::Object;
+	bool IsStatic() override;
 };
 
 class TreeObject : public Object
 {
 public:
 	using Object::Object;
+	bool IsStatic() override;
 };
 
 class TigerObject : public Object
@@ -132,6 +180,7 @@ private:
 	bool mIsFired = false;
 	bool mIsHitted = false;
 	int mLife = 3;
+	default_random_engine mRandom{ m_id }; // Ʈ ,  ſ  ʰ ึ   ´
 };
 
 class TigerAttackObject : public Object
@@ -169,12 +218,13 @@ public:
 private:
 	float mSearchTime = 0.0f;
 	float mWalkSpeed = 20.0f;
+	default_random_engine mRandom{ m_id }; // Ʈ ,  ſ  ʰ ึ   ´
 };
 
 class TigerLeather : public Object
 {
 public:
-	Object::Object;
+	using Object::Object;
 	void OnUpdate(GameTimer& gTimer) override;
 	void OnProcessCollision(Object& other, XMVECTOR collisionNormal, float penetration) override;
 private:
@@ -0,0 +1,208 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+	struct Event
+	{
+		const char* name;
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	// Written only by its own thread; rings stay alive after the thread exits so its zones can still be read.
+	struct Ring
+	{
+		std::vector<Event> events;
+		uint64_t written = 0;
+		uint32_t threadId = 0;
+	};
+
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Ring>> rings;
+		// Reference point for turning timestamps into time, taken when profiling is switched on.
+		uint64_t calibrationTicks = 0;
+		std::chrono::steady_clock::time_point calibrationTime;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	thread_local Ring* tRing = nullptr;
+
+	Ring& GetThreadRing()
+	{
+		if (!tRing)
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock{ registry.mutex };
+			auto ring = std::make_unique<Ring>();
+			ring->events.resize(PROFILER_RING_SIZE);
+			ring->threadId = static_cast<uint32_t>(registry.rings.size()) + 1;
+			tRing = ring.get();
+			registry.rings.push_back(std::move(ring));
+		}
+		return *tRing;
+	}
+
+	double GetTicksPerMs()
+	{
+#if PROFILER_RDTSC
+		Registry& registry = GetRegistry();
+		const uint64_t ticks = Profiler::Now() - registry.calibrationTicks;
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - registry.calibrationTime).count();
+		return ms > 0.0 && ticks > 0 ? ticks / ms : 1.0e6;
+#else
+		return 1.0e6;
+#endif
+	}
+
+	template <typename Function>
+	void ForEachEvent(const Ring& ring, Function&& function)
+	{
+		const uint64_t count = std::min<uint64_t>(ring.written, PROFILER_RING_SIZE);
+		for (uint64_t i = ring.written - count; i < ring.written; ++i)
+		{
+			function(ring.events[i % PROFILER_RING_SIZE]);
+		}
+	}
+
+	double GetPercentile(const std::vector<uint64_t>& sorted, double percentile)
+	{
+		size_t rank = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+		return static_cast<double>(sorted[std::max<size_t>(rank, 1) - 1]);
+	}
+
+	void WriteJsonString(std::ofstream& out, const char* text)
+	{
+		out << '"';
+		for (const char* c = text; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\') out << '\\';
+			out << *c;
+		}
+		out << '"';
+	}
+}
+
+std::atomic<bool> Profiler::sEnabled{ false };
+
+void Profiler::SetEnabled(bool enabled)
+{
+	if (enabled && !IsEnabled())
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock{ registry.mutex };
+		if (registry.calibrationTicks == 0)
+		{
+			registry.calibrationTicks = Now();
+			registry.calibrationTime = std::chrono::steady_clock::now();
+		}
+	}
+	sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::Record(const char* name, uint64_t begin, uint64_t end)
+{
+	Ring& ring = GetThreadRing();
+	ring.events[ring.written % PROFILER_RING_SIZE] = Event{ name, begin, end };
+	++ring.written;
+}
+
+void Profiler::Clear()
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock{ registry.mutex };
+	for (auto& ring : registry.rings) ring->written = 0;
+}
+
+std::vector<ProfileZoneStats> Profiler::GetZoneStats()
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock{ registry.mutex };
+
+	// Keyed by the text, the same literal can have a different address in each translation unit.
+	std::map<std::string, std::vector<uint64_t>> durations;
+	for (auto& ring : registry.rings)
+	{
+		ForEachEvent(*ring, [&durations](const Event& event) { durations[event.name].push_back(event.end - event.begin); });
+	}
+
+	const double ticksPerMs = GetTicksPerMs();
+	std::vector<ProfileZoneStats> result;
+	for (auto& [name, ticks] : durations)
+	{
+		std::sort(ticks.begin(), ticks.end());
+		ProfileZoneStats stats;
+		stats.name = name;
+		stats.count = ticks.size();
+		for (uint64_t value : ticks) stats.totalMs += value;
+		stats.totalMs /= ticksPerMs;
+		stats.p50Ms = GetPercentile(ticks, 0.50) / ticksPerMs;
+		stats.p95Ms = GetPercentile(ticks, 0.95) / ticksPerMs;
+		stats.p99Ms = GetPercentile(ticks, 0.99) / ticksPerMs;
+		stats.maxMs = ticks.back() / ticksPerMs;
+		result.push_back(stats);
+	}
+	return result;
+}
+
+std::string Profiler::FormatZoneStats()
+{
+	std::string text = "zone                          count   total ms   p50 ms   p95 ms   p99 ms   max ms\n";
+	char line[256];
+	for (const ProfileZoneStats& stats : GetZoneStats())
+	{
+		snprintf(line, sizeof(line), "%-28s %7llu %10.3f %8.4f %8.4f %8.4f %8.4f\n", stats.name.c_str(),
+			static_cast<unsigned long long>(stats.count), stats.totalMs, stats.p50Ms, stats.p95Ms, stats.p99Ms, stats.maxMs);
+		text += line;
+	}
+	return text;
+}
+
+bool Profiler::SaveChromeTrace(const std::wstring& fileName)
+{
+	std::ofstream out{ std::filesystem::path{ fileName }, std::ios::trunc };
+	if (!out) return false;
+
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock{ registry.mutex };
+
+	uint64_t origin = UINT64_MAX;
+	for (auto& ring : registry.rings)
+	{
+		ForEachEvent(*ring, [&origin](const Event& event) { origin = std::min<uint64_t>(origin, event.begin); });
+	}
+
+	// Timestamps in microseconds from the oldest zone still recorded.
+	const double ticksPerUs = GetTicksPerMs() / 1000.0;
+	bool first = true;
+	char numbers[96];
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (auto& ring : registry.rings)
+	{
+		const uint32_t threadId = ring->threadId;
+		ForEachEvent(*ring, [&](const Event& event) {
+			out << (first ? "\n" : ",\n") << "{\"name\":";
+			WriteJsonString(out, event.name);
+			snprintf(numbers, sizeof(numbers), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", threadId,
+				(event.begin - origin) / ticksPerUs, (event.end - event.begin) / ticksPerUs);
+			out << numbers;
+			first = false;
+		});
+	}
+	out << "\n]}\n";
+	return static_cast<bool>(out);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_RDTSC 1
+#else
+#define PROFILER_RDTSC 0
+#endif
+
+#define PROFILER_ENABLED 1          // 0 compiles every PROFILE_ZONE away
+#define PROFILER_RING_SIZE 65536    // zones kept per thread, older ones are overwritten
+
+// Scoped CPU zones. PROFILE_ZONE("name") times the rest of the enclosing block on the calling thread.
+// While the profiler is off a zone costs one relaxed atomic load; while it is on, two timestamp reads
+// and a store into the thread's own ring, no locks. The name must outlive the profiler (a literal).
+// Reading the rings (stats, trace, Clear) must happen while no other thread is inside a zone, e.g.
+// between frames.
+struct ProfileZoneStats
+{
+	std::string name;
+	uint64_t count = 0;
+	double totalMs = 0.0;
+	double p50Ms = 0.0;
+	double p95Ms = 0.0;
+	double p99Ms = 0.0;
+	double maxMs = 0.0;
+};
+
+class Profiler
+{
+public:
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+	// Raw timestamp: the TSC where available, steady_clock nanoseconds elsewhere.
+	static uint64_t Now()
+	{
+#if PROFILER_RDTSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	static void Record(const char* name, uint64_t begin, uint64_t end);
+	static void Clear();
+
+	// Per zone name, sorted by name. Percentiles are nearest rank over every zone still in the rings.
+	static std::vector<ProfileZoneStats> GetZoneStats();
+	static std::string FormatZoneStats();
+	// Chrome trace event format (chrome://tracing, Perfetto): one complete event per zone.
+	static bool SaveChromeTrace(const std::wstring& fileName);
+
+private:
+	static std::atomic<bool> sEnabled;
+};
+
+class ProfileZone
+{
+public:
+	explicit ProfileZone(const char* name) : mName{ Profiler::IsEnabled() ? name : nullptr }
+	{
+		if (mName) mBegin = Profiler::Now();
+	}
+	~ProfileZone()
+	{
+		if (mName) Profiler::Record(mName, mBegin, Profiler::Now());
+	}
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* mName;
+	uint64_t mBegin = 0;
+};
+
+#if PROFILER_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__){ name }
+#else
+#define PROFILE_ZONE(name)
+#endif
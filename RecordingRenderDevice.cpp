@@ -0,0 +1,238 @@
+#include "RecordingRenderDevice.h"
+#include <cstring>
+
+namespace
+{
+	// Fake GPU addresses and descriptor values: the id in the high half, the offset in the low half.
+	const uint32_t HandleShift = 32;
+
+	size_t GetEncodedSize(std::initializer_list<uint64_t> args)
+	{
+		size_t size = 1;
+		for (uint64_t value : args)
+		{
+			do
+			{
+				++size;
+				value >>= 7;
+			} while (value != 0);
+		}
+		return size;
+	}
+}
+
+RecordingRenderDevice::RecordingRenderDevice(bool keepLog) : mKeepLog{ keepLog }
+{
+}
+
+RenderBuffer RecordingRenderDevice::CreateUploadBuffer(uint64_t size)
+{
+	RenderBuffer buffer;
+	buffer.resource = CreateHandle();
+	buffer.address = buffer.resource << HandleShift;
+	buffer.size = size;
+	std::vector<uint8_t>& memory = mUploadBuffers[buffer.resource];
+	memory.resize(static_cast<size_t>(size));
+	buffer.mappedData = memory.data();
+	mLiveBytes += size;
+	Record(RenderOp::CreateBuffer, { buffer.resource, size, 0 });
+	return buffer;
+}
+
+RenderBuffer RecordingRenderDevice::CreateStaticBuffer(const void* /*data*/, uint64_t size)
+{
+	// The contents would only be read by a GPU; counting them is enough.
+	RenderBuffer buffer;
+	buffer.resource = CreateHandle();
+	buffer.address = buffer.resource << HandleShift;
+	buffer.size = size;
+	Record(RenderOp::CreateBuffer, { buffer.resource, size, 1 });
+	return buffer;
+}
+
+RenderTexture RecordingRenderDevice::CreateDepthTexture(uint32_t width, uint32_t height, RenderState initialState)
+{
+	RenderTexture texture;
+	texture.resource = CreateHandle();
+	texture.width = width;
+	texture.height = height;
+	Record(RenderOp::CreateTexture, { texture.resource, width, height, static_cast<uint64_t>(initialState) });
+	return texture;
+}
+
+void RecordingRenderDevice::Release(RenderHandle resource)
+{
+	auto it = mUploadBuffers.find(resource);
+	if (it != mUploadBuffers.end())
+	{
+		mLiveBytes -= it->second.size();
+		mUploadBuffers.erase(it);
+	}
+	Record(RenderOp::Release, { resource });
+}
+
+void RecordingRenderDevice::Write(const RenderBuffer& buffer, uint64_t offset, const void* data, uint64_t size)
+{
+	if (buffer.mappedData) memcpy(buffer.mappedData + offset, data, static_cast<size_t>(size));
+	Record(RenderOp::Write, { buffer.resource, offset, size });
+}
+
+RenderDescriptorHeap RecordingRenderDevice::CreateDescriptorHeap(RenderDescriptorType type, uint32_t count, bool shaderVisible)
+{
+	RenderDescriptorHeap heap;
+	heap.heap = CreateHandle();
+	heap.cpuStart = heap.heap << HandleShift;
+	heap.gpuStart = shaderVisible ? heap.cpuStart : 0;
+	heap.increment = 1;
+	heap.count = count;
+	Record(RenderOp::CreateHeap, { heap.heap, static_cast<uint64_t>(type), count, shaderVisible ? 1u : 0u });
+	return heap;
+}
+
+void RecordingRenderDevice::CreateConstantBufferView(RenderAddress address, uint32_t /*size*/, RenderDescriptor descriptor)
+{
+	Record(RenderOp::CreateView, { static_cast<uint64_t>(RenderViewKind::ConstantBuffer), address, descriptor });
+}
+
+void RecordingRenderDevice::CreateDepthStencilView(const RenderTexture& texture, RenderDescriptor descriptor)
+{
+	Record(RenderOp::CreateView, { static_cast<uint64_t>(RenderViewKind::DepthStencil), texture.resource, descriptor });
+}
+
+void RecordingRenderDevice::CreateDepthShaderResourceView(const RenderTexture* texture, RenderDescriptor descriptor)
+{
+	if (texture) Record(RenderOp::CreateView, { static_cast<uint64_t>(RenderViewKind::DepthShaderResource), texture->resource, descriptor });
+	else Record(RenderOp::CreateView, { static_cast<uint64_t>(RenderViewKind::NullShaderResource), 0, descriptor });
+}
+
+void RecordingRenderDevice::CreateStructuredBufferView(const RenderBuffer& buffer, uint32_t /*stride*/, RenderDescriptor descriptor)
+{
+	Record(RenderOp::CreateView, { static_cast<uint64_t>(RenderViewKind::StructuredBuffer), buffer.resource, descriptor });
+}
+
+void RecordingRenderDevice::BeginFrame(uint64_t frame)
+{
+	Record(RenderOp::BeginFrame, { frame });
+}
+
+void RecordingRenderDevice::EndFrame()
+{
+	Record(RenderOp::EndFrame, {});
+}
+
+void RecordingRenderDevice::SetRootSignature(RenderHandle rootSignature)
+{
+	Record(RenderOp::SetRootSignature, { rootSignature });
+}
+
+void RecordingRenderDevice::SetPipelineState(RenderHandle pipeline)
+{
+	Record(RenderOp::SetPipelineState, { pipeline });
+}
+
+void RecordingRenderDevice::SetDescriptorHeap(RenderHandle heap)
+{
+	Record(RenderOp::SetDescriptorHeap, { heap });
+}
+
+void RecordingRenderDevice::SetRootDescriptorTable(uint32_t slot, RenderDescriptor descriptor)
+{
+	Record(RenderOp::SetRootDescriptorTable, { slot, descriptor });
+}
+
+void RecordingRenderDevice::SetRootConstantBuffer(uint32_t slot, RenderAddress address)
+{
+	Record(RenderOp::SetRootConstantBuffer, { slot, address });
+}
+
+void RecordingRenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	Record(RenderOp::SetViewport, { EncodeRenderFloat(viewport.x), EncodeRenderFloat(viewport.y), EncodeRenderFloat(viewport.width),
+		EncodeRenderFloat(viewport.height), EncodeRenderFloat(viewport.minDepth), EncodeRenderFloat(viewport.maxDepth) });
+}
+
+void RecordingRenderDevice::SetScissor(const RenderRect& rect)
+{
+	Record(RenderOp::SetScissor, { EncodeRenderSigned(rect.left), EncodeRenderSigned(rect.top), EncodeRenderSigned(rect.right), EncodeRenderSigned(rect.bottom) });
+}
+
+void RecordingRenderDevice::SetTriangleList()
+{
+	Record(RenderOp::SetTriangleList, {});
+}
+
+void RecordingRenderDevice::SetVertexBuffer(RenderAddress address, uint32_t size, uint32_t stride)
+{
+	Record(RenderOp::SetVertexBuffer, { address, size, stride });
+}
+
+void RecordingRenderDevice::SetIndexBuffer(RenderAddress address, uint32_t size)
+{
+	Record(RenderOp::SetIndexBuffer, { address, size });
+}
+
+void RecordingRenderDevice::SetRenderTarget(RenderDescriptor renderTarget, RenderDescriptor depthStencil)
+{
+	Record(RenderOp::SetRenderTarget, { renderTarget, depthStencil });
+}
+
+void RecordingRenderDevice::ClearRenderTarget(RenderDescriptor renderTarget, const float color[4])
+{
+	Record(RenderOp::ClearRenderTarget, { renderTarget, EncodeRenderFloat(color[0]), EncodeRenderFloat(color[1]), EncodeRenderFloat(color[2]), EncodeRenderFloat(color[3]) });
+}
+
+void RecordingRenderDevice::ClearDepthStencil(RenderDescriptor depthStencil, float depth, uint8_t stencil)
+{
+	Record(RenderOp::ClearDepthStencil, { depthStencil, EncodeRenderFloat(depth), stencil });
+}
+
+void RecordingRenderDevice::Barrier(RenderHandle resource, RenderState before, RenderState after)
+{
+	Record(RenderOp::Barrier, { resource, static_cast<uint64_t>(before), static_cast<uint64_t>(after) });
+}
+
+void RecordingRenderDevice::CopyResource(RenderHandle destination, RenderHandle source)
+{
+	Record(RenderOp::CopyResource, { destination, source });
+}
+
+void RecordingRenderDevice::Draw(uint32_t vertexCount, uint32_t startVertex)
+{
+	Record(RenderOp::Draw, { vertexCount, startVertex });
+}
+
+void RecordingRenderDevice::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+{
+	Record(RenderOp::DrawIndexed, { indexCount, startIndex, EncodeRenderSigned(baseVertex) });
+}
+
+RenderHandle RecordingRenderDevice::CreateHandle()
+{
+	return mNextHandle++;
+}
+
+const RenderStatsTracker& RecordingRenderDevice::GetStats() const
+{
+	return mStats;
+}
+
+const RenderLogWriter& RecordingRenderDevice::GetLog() const
+{
+	return mLog;
+}
+
+bool RecordingRenderDevice::SaveLog(const std::wstring& fileName) const
+{
+	return mKeepLog && mLog.Save(fileName);
+}
+
+uint64_t RecordingRenderDevice::GetLiveBytes() const
+{
+	return mLiveBytes;
+}
+
+void RecordingRenderDevice::Record(RenderOp op, std::initializer_list<uint64_t> args)
+{
+	size_t bytes = mKeepLog ? mLog.Append(op, args) : GetEncodedSize(args);
+	mStats.Apply(op, args.begin(), bytes);
+}
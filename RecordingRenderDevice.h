@@ -0,0 +1,66 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "RenderDevice.h"
+#include "RenderLog.h"
+
+// Null backend: nothing reaches a GPU. Upload buffers are plain system memory so the scene can write
+// its constants as usual, and every call is appended to a RenderLog and counted per frame. Handles are
+// sequential ids, so two runs of the same simulation produce byte-identical logs. No D3D12 calls.
+class RecordingRenderDevice : public RenderDevice
+{
+public:
+	// keepLog = false only counts, for long runs that do not need the log itself.
+	explicit RecordingRenderDevice(bool keepLog = true);
+
+	RenderBuffer CreateUploadBuffer(uint64_t size) override;
+	RenderBuffer CreateStaticBuffer(const void* data, uint64_t size) override;
+	RenderTexture CreateDepthTexture(uint32_t width, uint32_t height, RenderState initialState) override;
+	void Release(RenderHandle resource) override;
+	void Write(const RenderBuffer& buffer, uint64_t offset, const void* data, uint64_t size) override;
+
+	RenderDescriptorHeap CreateDescriptorHeap(RenderDescriptorType type, uint32_t count, bool shaderVisible) override;
+	void CreateConstantBufferView(RenderAddress address, uint32_t size, RenderDescriptor descriptor) override;
+	void CreateDepthStencilView(const RenderTexture& texture, RenderDescriptor descriptor) override;
+	void CreateDepthShaderResourceView(const RenderTexture* texture, RenderDescriptor descriptor) override;
+	void CreateStructuredBufferView(const RenderBuffer& buffer, uint32_t stride, RenderDescriptor descriptor) override;
+
+	void BeginFrame(uint64_t frame) override;
+	void EndFrame() override;
+	void SetRootSignature(RenderHandle rootSignature) override;
+	void SetPipelineState(RenderHandle pipeline) override;
+	void SetDescriptorHeap(RenderHandle heap) override;
+	void SetRootDescriptorTable(uint32_t slot, RenderDescriptor descriptor) override;
+	void SetRootConstantBuffer(uint32_t slot, RenderAddress address) override;
+	void SetViewport(const RenderViewport& viewport) override;
+	void SetScissor(const RenderRect& rect) override;
+	void SetTriangleList() override;
+	void SetVertexBuffer(RenderAddress address, uint32_t size, uint32_t stride) override;
+	void SetIndexBuffer(RenderAddress address, uint32_t size) override;
+	void SetRenderTarget(RenderDescriptor renderTarget, RenderDescriptor depthStencil) override;
+	void ClearRenderTarget(RenderDescriptor renderTarget, const float color[4]) override;
+	void ClearDepthStencil(RenderDescriptor depthStencil, float depth, uint8_t stencil) override;
+	void Barrier(RenderHandle resource, RenderState before, RenderState after) override;
+	void CopyResource(RenderHandle destination, RenderHandle source) override;
+	void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+
+	// Ids for objects the device does not create itself, such as pipelines built outside it.
+	RenderHandle CreateHandle();
+
+	const RenderStatsTracker& GetStats() const;
+	const RenderLogWriter& GetLog() const;
+	bool SaveLog(const std::wstring& fileName) const;
+	uint64_t GetLiveBytes() const; // system memory held by upload buffers
+
+private:
+	void Record(RenderOp op, std::initializer_list<uint64_t> args);
+
+	bool mKeepLog = true;
+	RenderLogWriter mLog;
+	RenderStatsTracker mStats;
+	RenderHandle mNextHandle = 1;
+	std::map<RenderHandle, std::vector<uint8_t>> mUploadBuffers;
+	uint64_t mLiveBytes = 0;
+};
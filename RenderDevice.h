@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Thin rendering interface between the scene code and the graphics API. Handles are opaque 64-bit
+// values: the D3D12 device passes resource and pipeline pointers, GPU virtual addresses and descriptor
+// handle values through them, the recording device hands out small sequential ids. 0 is never valid.
+// Only what Scene, Object, Shadow and Framework use is here; shaders, root signatures and texture
+// streaming stay on the D3D12 side.
+using RenderHandle = uint64_t;
+using RenderAddress = uint64_t;
+using RenderDescriptor = uint64_t;
+
+enum class RenderState : uint8_t
+{
+	Common,
+	GenericRead,
+	CopySource,
+	CopyDest,
+	DepthWrite,
+	RenderTarget,
+	Present,
+};
+
+enum class RenderDescriptorType : uint8_t
+{
+	CbvSrvUav,
+	Rtv,
+	Dsv,
+};
+
+struct RenderBuffer
+{
+	RenderHandle resource = 0;
+	RenderAddress address = 0;
+	uint8_t* mappedData = nullptr; // upload buffers stay mapped for their whole life
+	uint64_t size = 0;
+};
+
+struct RenderTexture
+{
+	RenderHandle resource = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
+struct RenderDescriptorHeap
+{
+	RenderHandle heap = 0;
+	RenderDescriptor cpuStart = 0;
+	RenderDescriptor gpuStart = 0; // 0 when the heap is not shader visible
+	uint32_t increment = 0;
+	uint32_t count = 0;
+
+	RenderDescriptor GetCpu(uint32_t index) const { return cpuStart + static_cast<RenderDescriptor>(index) * increment; }
+	RenderDescriptor GetGpu(uint32_t index) const { return gpuStart + static_cast<RenderDescriptor>(index) * increment; }
+};
+
+struct RenderViewport
+{
+	float x = 0.0f;
+	float y = 0.0f;
+	float width = 0.0f;
+	float height = 0.0f;
+	float minDepth = 0.0f;
+	float maxDepth = 1.0f;
+};
+
+struct RenderRect
+{
+	int32_t left = 0;
+	int32_t top = 0;
+	int32_t right = 0;
+	int32_t bottom = 0;
+};
+
+class RenderDevice
+{
+public:
+	virtual ~RenderDevice() = default;
+
+	// Resources. Static buffers live in GPU memory and are filled through the command list.
+	virtual RenderBuffer CreateUploadBuffer(uint64_t size) = 0;
+	virtual RenderBuffer CreateStaticBuffer(const void* data, uint64_t size) = 0;
+	virtual RenderTexture CreateDepthTexture(uint32_t width, uint32_t height, RenderState initialState) = 0;
+	virtual void Release(RenderHandle resource) = 0;
+	// CPU writes into a mapped upload buffer; every byte the GPU will read goes through here.
+	virtual void Write(const RenderBuffer& buffer, uint64_t offset, const void* data, uint64_t size) = 0;
+
+	// Descriptors.
+	virtual RenderDescriptorHeap CreateDescriptorHeap(RenderDescriptorType type, uint32_t count, bool shaderVisible) = 0;
+	virtual void CreateConstantBufferView(RenderAddress address, uint32_t size, RenderDescriptor descriptor) = 0;
+	virtual void CreateDepthStencilView(const RenderTexture& texture, RenderDescriptor descriptor) = 0;
+	// Depth texture read as a shadow map; a null texture makes a view that samples as 0.
+	virtual void CreateDepthShaderResourceView(const RenderTexture* texture, RenderDescriptor descriptor) = 0;
+	// Whole buffer as a StructuredBuffer of stride-byte elements.
+	virtual void CreateStructuredBufferView(const RenderBuffer& buffer, uint32_t stride, RenderDescriptor descriptor) = 0;
+
+	// Commands, recorded in order between BeginFrame and EndFrame (or during setup before the first frame).
+	virtual void BeginFrame(uint64_t frame) = 0;
+	virtual void EndFrame() = 0;
+	virtual void SetRootSignature(RenderHandle rootSignature) = 0;
+	virtual void SetPipelineState(RenderHandle pipeline) = 0;
+	virtual void SetDescriptorHeap(RenderHandle heap) = 0;
+	virtual void SetRootDescriptorTable(uint32_t slot, RenderDescriptor descriptor) = 0;
+	virtual void SetRootConstantBuffer(uint32_t slot, RenderAddress address) = 0;
+	virtual void SetViewport(const RenderViewport& viewport) = 0;
+	virtual void SetScissor(const RenderRect& rect) = 0;
+	virtual void SetTriangleList() = 0;
+	virtual void SetVertexBuffer(RenderAddress address, uint32_t size, uint32_t stride) = 0;
+	virtual void SetIndexBuffer(RenderAddress address, uint32_t size) = 0; // 32-bit indices
+	virtual void SetRenderTarget(RenderDescriptor renderTarget, RenderDescriptor depthStencil) = 0; // either may be 0
+	virtual void ClearRenderTarget(RenderDescriptor renderTarget, const float color[4]) = 0;
+	virtual void ClearDepthStencil(RenderDescriptor depthStencil, float depth, uint8_t stencil) = 0;
+	virtual void Barrier(RenderHandle resource, RenderState before, RenderState after) = 0;
+	virtual void CopyResource(RenderHandle destination, RenderHandle source) = 0;
+	virtual void Draw(uint32_t vertexCount, uint32_t startVertex) = 0;
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+};
@@ -0,0 +1,342 @@
+#include "RenderLog.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	const uint32_t LogMagic = 0x474F4C52; // "RLOG"
+	const size_t LogHeaderSize = 8;
+	const uint32_t MaxArgCount = 6;
+	const size_t MaxReportLines = 64;
+
+	struct OpInfo
+	{
+		const char* name;
+		uint32_t argCount;
+	};
+
+	// Indexed by RenderOp, keep in the same order.
+	const OpInfo OpInfos[] = {
+		{ "Invalid", 0 },
+		{ "BeginFrame", 1 },
+		{ "EndFrame", 0 },
+		{ "CreateBuffer", 3 },
+		{ "CreateTexture", 4 },
+		{ "CreateHeap", 4 },
+		{ "CreateView", 3 },
+		{ "Release", 1 },
+		{ "Write", 3 },
+		{ "SetRootSignature", 1 },
+		{ "SetPipelineState", 1 },
+		{ "SetDescriptorHeap", 1 },
+		{ "SetRootDescriptorTable", 2 },
+		{ "SetRootConstantBuffer", 2 },
+		{ "SetViewport", 6 },
+		{ "SetScissor", 4 },
+		{ "SetTriangleList", 0 },
+		{ "SetVertexBuffer", 3 },
+		{ "SetIndexBuffer", 2 },
+		{ "SetRenderTarget", 2 },
+		{ "ClearRenderTarget", 5 },
+		{ "ClearDepthStencil", 3 },
+		{ "Barrier", 3 },
+		{ "CopyResource", 2 },
+		{ "Draw", 2 },
+		{ "DrawIndexed", 3 },
+	};
+	static_assert(std::size(OpInfos) == static_cast<size_t>(RenderOp::Count), "OpInfos must cover every RenderOp");
+
+	struct Counter
+	{
+		const char* name;
+		uint64_t(*get)(const RenderFrameStats&);
+	};
+
+	const Counter Counters[] = {
+		{ "commands", [](const RenderFrameStats& s) -> uint64_t { return s.commands; } },
+		{ "draws", [](const RenderFrameStats& s) -> uint64_t { return s.draws; } },
+		{ "primitives", [](const RenderFrameStats& s) -> uint64_t { return s.primitives; } },
+		{ "pipelineChanges", [](const RenderFrameStats& s) -> uint64_t { return s.pipelineChanges; } },
+		{ "bindingChanges", [](const RenderFrameStats& s) -> uint64_t { return s.bindingChanges; } },
+		{ "redundantStates", [](const RenderFrameStats& s) -> uint64_t { return s.redundantStates; } },
+		{ "barriers", [](const RenderFrameStats& s) -> uint64_t { return s.barriers; } },
+		{ "copies", [](const RenderFrameStats& s) -> uint64_t { return s.copies; } },
+		{ "clears", [](const RenderFrameStats& s) -> uint64_t { return s.clears; } },
+		{ "resources", [](const RenderFrameStats& s) -> uint64_t { return s.resources; } },
+		{ "uploadBytes", [](const RenderFrameStats& s) -> uint64_t { return s.uploadBytes; } },
+		{ "logBytes", [](const RenderFrameStats& s) -> uint64_t { return s.logBytes; } },
+	};
+
+	void CompareFrame(const std::string& label, const RenderFrameStats& baseline, const RenderFrameStats& current, std::vector<std::string>& lines)
+	{
+		for (const Counter& counter : Counters)
+		{
+			uint64_t before = counter.get(baseline);
+			uint64_t after = counter.get(current);
+			if (before != after) lines.push_back(label + ": " + counter.name + " " + std::to_string(before) + " -> " + std::to_string(after));
+		}
+	}
+}
+
+uint32_t GetRenderOpArgCount(RenderOp op)
+{
+	size_t index = static_cast<size_t>(op);
+	return index < std::size(OpInfos) ? OpInfos[index].argCount : 0;
+}
+
+const char* GetRenderOpName(RenderOp op)
+{
+	size_t index = static_cast<size_t>(op);
+	return index < std::size(OpInfos) ? OpInfos[index].name : OpInfos[0].name;
+}
+
+uint64_t EncodeRenderFloat(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+uint64_t EncodeRenderSigned(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+void RenderStatsTracker::Apply(RenderOp op, const uint64_t* args, size_t encodedBytes)
+{
+	if (op == RenderOp::BeginFrame)
+	{
+		mFrames.push_back(RenderFrameStats{});
+		mFrames.back().frame = args[0];
+		mBound.clear();
+		mInFrame = true;
+	}
+
+	RenderFrameStats& stats = GetCurrent();
+	stats.commands++;
+	stats.logBytes += encodedBytes;
+
+	const uint32_t count = GetRenderOpArgCount(op);
+	const uint32_t key = static_cast<uint32_t>(op) << 8;
+	switch (op)
+	{
+	case RenderOp::CreateBuffer:
+		stats.resources++;
+		if (args[2]) stats.uploadBytes += args[1];
+		break;
+	case RenderOp::CreateTexture:
+	case RenderOp::CreateHeap:
+		stats.resources++;
+		break;
+	case RenderOp::Write:
+		stats.uploadBytes += args[2];
+		break;
+	case RenderOp::SetPipelineState:
+		if (Bind(key, args, count)) stats.pipelineChanges++;
+		else stats.redundantStates++;
+		break;
+	case RenderOp::SetRootSignature:
+	case RenderOp::SetDescriptorHeap:
+	case RenderOp::SetViewport:
+	case RenderOp::SetScissor:
+	case RenderOp::SetTriangleList:
+	case RenderOp::SetVertexBuffer:
+	case RenderOp::SetIndexBuffer:
+	case RenderOp::SetRenderTarget:
+		if (Bind(key, args, count)) stats.bindingChanges++;
+		else stats.redundantStates++;
+		break;
+	case RenderOp::SetRootDescriptorTable:
+	case RenderOp::SetRootConstantBuffer:
+		if (Bind(key | static_cast<uint8_t>(args[0]), args + 1, count - 1)) stats.bindingChanges++;
+		else stats.redundantStates++;
+		break;
+	case RenderOp::ClearRenderTarget:
+	case RenderOp::ClearDepthStencil:
+		stats.clears++;
+		break;
+	case RenderOp::Barrier:
+		stats.barriers++;
+		break;
+	case RenderOp::CopyResource:
+		stats.copies++;
+		break;
+	case RenderOp::Draw:
+	case RenderOp::DrawIndexed:
+		stats.draws++;
+		stats.primitives += args[0] / 3;
+		break;
+	default:
+		break;
+	}
+
+	if (op == RenderOp::EndFrame) mInFrame = false;
+}
+
+void RenderStatsTracker::Clear()
+{
+	mBound.clear();
+	mFrames.clear();
+	mSetup = RenderFrameStats{};
+	mInFrame = false;
+}
+
+const std::vector<RenderFrameStats>& RenderStatsTracker::GetFrames() const
+{
+	return mFrames;
+}
+
+const RenderFrameStats& RenderStatsTracker::GetSetup() const
+{
+	return mSetup;
+}
+
+RenderFrameStats RenderStatsTracker::GetTotal() const
+{
+	RenderFrameStats total;
+	total.frame = mFrames.size();
+	for (const RenderFrameStats& stats : mFrames)
+	{
+		total.commands += stats.commands;
+		total.draws += stats.draws;
+		total.primitives += stats.primitives;
+		total.pipelineChanges += stats.pipelineChanges;
+		total.bindingChanges += stats.bindingChanges;
+		total.redundantStates += stats.redundantStates;
+		total.barriers += stats.barriers;
+		total.copies += stats.copies;
+		total.clears += stats.clears;
+		total.resources += stats.resources;
+		total.uploadBytes += stats.uploadBytes;
+		total.logBytes += stats.logBytes;
+	}
+	return total;
+}
+
+RenderFrameStats& RenderStatsTracker::GetCurrent()
+{
+	return mInFrame ? mFrames.back() : mSetup;
+}
+
+bool RenderStatsTracker::Bind(uint32_t key, const uint64_t* args, uint32_t count)
+{
+	// FNV-1a over the arguments; a collision only hides one state change from the counters.
+	uint64_t hash = 14695981039346656037ull;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		hash ^= args[i];
+		hash *= 1099511628211ull;
+	}
+
+	auto [it, inserted] = mBound.try_emplace(key, hash);
+	if (inserted) return true;
+	if (it->second == hash) return false;
+	it->second = hash;
+	return true;
+}
+
+RenderLogWriter::RenderLogWriter()
+{
+	Clear();
+}
+
+size_t RenderLogWriter::Append(RenderOp op, std::initializer_list<uint64_t> args)
+{
+	const size_t begin = mBytes.size();
+	mBytes.push_back(static_cast<uint8_t>(op));
+	for (uint64_t value : args)
+	{
+		while (value >= 0x80)
+		{
+			mBytes.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		mBytes.push_back(static_cast<uint8_t>(value));
+	}
+	return mBytes.size() - begin;
+}
+
+void RenderLogWriter::Clear()
+{
+	mBytes.resize(LogHeaderSize);
+	memcpy(mBytes.data(), &LogMagic, sizeof(LogMagic));
+	memcpy(mBytes.data() + 4, &RenderLogVersion, sizeof(RenderLogVersion));
+}
+
+const std::vector<uint8_t>& RenderLogWriter::GetBytes() const
+{
+	return mBytes;
+}
+
+bool RenderLogWriter::Save(const std::wstring& fileName) const
+{
+	std::ofstream out{ std::filesystem::path{ fileName }, std::ios::binary | std::ios::trunc };
+	if (!out) return false;
+	out.write(reinterpret_cast<const char*>(mBytes.data()), mBytes.size());
+	return static_cast<bool>(out);
+}
+
+bool ReadRenderLog(const uint8_t* data, size_t size, RenderStatsTracker& tracker)
+{
+	if (data == nullptr || size < LogHeaderSize) return false;
+	uint32_t magic, version;
+	memcpy(&magic, data, sizeof(magic));
+	memcpy(&version, data + 4, sizeof(version));
+	if (magic != LogMagic || version != RenderLogVersion) return false;
+
+	uint64_t args[MaxArgCount];
+	size_t position = LogHeaderSize;
+	while (position < size)
+	{
+		const size_t begin = position;
+		RenderOp op = static_cast<RenderOp>(data[position++]);
+		if (op < RenderOp::BeginFrame || op >= RenderOp::Count) return false;
+
+		const uint32_t count = GetRenderOpArgCount(op);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint64_t value = 0;
+			for (uint32_t shift = 0;; shift += 7)
+			{
+				if (position >= size || shift > 63) return false;
+				uint8_t byte = data[position++];
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) break;
+			}
+			args[i] = value;
+		}
+		tracker.Apply(op, args, position - begin);
+	}
+	return true;
+}
+
+bool LoadRenderLog(const std::wstring& fileName, RenderStatsTracker& tracker)
+{
+	std::ifstream in{ std::filesystem::path{ fileName }, std::ios::binary };
+	if (!in) return false;
+	std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+	return ReadRenderLog(bytes.data(), bytes.size(), tracker);
+}
+
+std::string CompareRenderStats(const RenderStatsTracker& baseline, const RenderStatsTracker& current)
+{
+	std::vector<std::string> lines;
+	const std::vector<RenderFrameStats>& before = baseline.GetFrames();
+	const std::vector<RenderFrameStats>& after = current.GetFrames();
+	if (before.size() != after.size())
+	{
+		lines.push_back("frames: " + std::to_string(before.size()) + " -> " + std::to_string(after.size()));
+	}
+	CompareFrame("setup", baseline.GetSetup(), current.GetSetup(), lines);
+	for (size_t i = 0; i < before.size() && i < after.size(); ++i)
+	{
+		CompareFrame("frame " + std::to_string(before[i].frame), before[i], after[i], lines);
+	}
+
+	std::string report;
+	for (size_t i = 0; i < lines.size() && i < MaxReportLines; ++i) report += lines[i] + "\n";
+	if (lines.size() > MaxReportLines) report += "... " + std::to_string(lines.size() - MaxReportLines) + " more\n";
+	return report;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+// Binary command log written by RecordingRenderDevice, little endian:
+//   "RLOG", uint32 version
+//   commands: one RenderOp byte followed by GetRenderOpArgCount(op) LEB128 varints
+// Floats are stored as their bit patterns and signed values zigzag encoded, so every argument is an
+// unsigned varint and a reader can skip commands it does not care about.
+enum class RenderOp : uint8_t
+{
+	BeginFrame = 1,         // frame
+	EndFrame,               //
+	CreateBuffer,           // resource, size, isStatic
+	CreateTexture,          // resource, width, height, state
+	CreateHeap,             // heap, type, count, shaderVisible
+	CreateView,             // kind, resource or address, descriptor
+	Release,                // resource
+	Write,                  // resource, offset, size
+	SetRootSignature,       // rootSignature
+	SetPipelineState,       // pipeline
+	SetDescriptorHeap,      // heap
+	SetRootDescriptorTable, // slot, descriptor
+	SetRootConstantBuffer,  // slot, address
+	SetViewport,            // x, y, width, height, minDepth, maxDepth
+	SetScissor,             // left, top, right, bottom
+	SetTriangleList,        //
+	SetVertexBuffer,        // address, size, stride
+	SetIndexBuffer,         // address, size
+	SetRenderTarget,        // renderTarget, depthStencil
+	ClearRenderTarget,      // renderTarget, r, g, b, a
+	ClearDepthStencil,      // depthStencil, depth, stencil
+	Barrier,                // resource, before, after
+	CopyResource,           // destination, source
+	Draw,                   // vertexCount, startVertex
+	DrawIndexed,            // indexCount, startIndex, baseVertex
+	Count
+};
+
+enum class RenderViewKind : uint8_t
+{
+	ConstantBuffer,
+	DepthStencil,
+	DepthShaderResource,
+	NullShaderResource,
+	StructuredBuffer,
+};
+
+const uint32_t RenderLogVersion = 1;
+
+uint32_t GetRenderOpArgCount(RenderOp op);
+const char* GetRenderOpName(RenderOp op);
+uint64_t EncodeRenderFloat(float value);
+uint64_t EncodeRenderSigned(int64_t value);
+
+// Counters for one frame, or for the setup commands recorded before the first frame.
+struct RenderFrameStats
+{
+	uint64_t frame = 0;
+	uint32_t commands = 0;
+	uint32_t draws = 0;
+	uint64_t primitives = 0;      // triangles
+	uint32_t pipelineChanges = 0;
+	uint32_t bindingChanges = 0;  // root signature, heap, tables, constant buffers, vertex/index buffers, targets, viewport, scissor, topology
+	uint32_t redundantStates = 0; // state commands that repeated the bound value
+	uint32_t barriers = 0;
+	uint32_t copies = 0;
+	uint32_t clears = 0;
+	uint32_t resources = 0;       // buffers, textures and heaps created
+	uint64_t uploadBytes = 0;     // bytes written to upload buffers plus static buffer contents
+	uint64_t logBytes = 0;
+};
+
+// Turns a command stream into per-frame counters. Bound state is forgotten at every BeginFrame,
+// like a reset command list, so the first binding of a frame always counts as a change.
+class RenderStatsTracker
+{
+public:
+	void Apply(RenderOp op, const uint64_t* args, size_t encodedBytes);
+	void Clear();
+
+	const std::vector<RenderFrameStats>& GetFrames() const;
+	const RenderFrameStats& GetSetup() const;
+	// Sum over all frames, frame is the frame count.
+	RenderFrameStats GetTotal() const;
+
+private:
+	RenderFrameStats& GetCurrent();
+	// Records the value bound to key; true when it differs from the previous one.
+	bool Bind(uint32_t key, const uint64_t* args, uint32_t count);
+
+	std::map<uint32_t, uint64_t> mBound; // (op << 8 | slot) -> hash of the arguments
+	std::vector<RenderFrameStats> mFrames;
+	RenderFrameStats mSetup;
+	bool mInFrame = false;
+};
+
+class RenderLogWriter
+{
+public:
+	RenderLogWriter();
+
+	// Returns the number of bytes the command took.
+	size_t Append(RenderOp op, std::initializer_list<uint64_t> args);
+	void Clear();
+	const std::vector<uint8_t>& GetBytes() const;
+	bool Save(const std::wstring& fileName) const;
+
+private:
+	std::vector<uint8_t> mBytes;
+};
+
+// Feeds every command of a log to the tracker. False on a bad header or a truncated or unknown command.
+bool ReadRenderLog(const uint8_t* data, size_t size, RenderStatsTracker& tracker);
+bool LoadRenderLog(const std::wstring& fileName, RenderStatsTracker& tracker);
+
+// One line per counter that differs between two runs, frame by frame; empty when they match.
+std::string CompareRenderStats(const RenderStatsTracker& baseline, const RenderStatsTracker& current);
@@ -1,5 +1,11 @@
 #include <fstream>
+#include <filesystem>
+#include <algorithm>
 #include "ResourceManager.h"
+#include "FbxExtractor.h"
+#include "JobSystem.h"
+#include "TerrainTileFile.h"
+#include "TerrainMesh.h"
 
 ResourceManager::ResourceManager() : mFbxExtractor{ nullptr }, mVertexBuffer{}
 {
@@ -55,7 +61,40 @@ void ResourceManager::CreatePlane(const string& name, float size, float wrap)
 	mVertexBuffer.insert(mVertexBuffer.end(), vertexData.begin(), vertexData.end());
 }
 
-void ResourceManager::CreateTerrain(const string& name, int maxHeight , int scale, int maxUV)
+void ResourceManager::CreateTerrain(JobSystem& jobSystem, const string& name, int maxHeight , int scale, int maxUV)
+{
+	int width, height;
+	vector<float> heightData = LoadHeightMap(jobSystem, name, maxHeight, width, height);
+	BuildTerrain(jobSystem, name, move(heightData), width, height, scale, maxUV);
+}
+
+bool ResourceManager::ConvertTerrainToTiles(JobSystem& jobSystem, const string& name, const wstring& fileName, int maxHeight, int scale)
+{
+	int width, height;
+	vector<float> heightData = LoadHeightMap(jobSystem, name, maxHeight, width, height);
+
+	TerrainTileInfo info;
+	if (!GetTerrainTileSource(name, maxHeight, scale, info.source)) return false;
+	info.tileSize = TERRAIN_TILE_SIZE;
+	info.tilesX = (width - 2) / TERRAIN_TILE_SIZE + 1;
+	info.tilesZ = (height - 2) / TERRAIN_TILE_SIZE + 1;
+	info.coarseStep = TERRAIN_TILE_COARSE_STEP;
+	info.scale = static_cast<float>(scale);
+	auto [lowest, highest] = minmax_element(heightData.begin(), heightData.end());
+	info.minHeight = *lowest;
+	info.maxHeight = *highest;
+	// Ÿ ̸ʺ ũ ڸ ǥ ÷ ä.
+	return WriteTerrainTiles(fileName, info, [&](uint32_t x, uint32_t z) {
+		return heightData[min<uint32_t>(z, height - 1) * width + min<uint32_t>(x, width - 1)];
+	});
+}
+
+bool ResourceManager::GetTerrainTileSource(const string& name, int maxHeight, int scale, TerrainTileSource& source)
+{
+	return HashTerrainTileSource(filesystem::path{ name }.wstring(), { maxHeight, scale, TERRAIN_TILE_SIZE, TERRAIN_TILE_COARSE_STEP }, source);
+}
+
+vector<float> ResourceManager::LoadHeightMap(JobSystem& jobSystem, const string& name, int maxHeight, int& width, int& height)
 {
 	ifstream in{ name };
 	if (!in) throw;
@@ -68,89 +107,68 @@ void ResourceManager::CreateTerrain(const string& name, int maxHeight , int scal
 	in.read(reinterpret_cast<char*>(heightMap.data()), fileSize);
 
 
-	int width = sqrt(fileSize);
-	int height = sqrt(fileSize);
-
-	mTerrainData.terrainWidth = width;
-	mTerrainData.terrainHeight = height;
-	mTerrainData.terrainScale = scale;
+	width = sqrt(fileSize);
+	height = sqrt(fileSize);
 
+	//     ýۿ .   ̿ ̿ ϹǷ  ķ  Ͱ Ʈ  .
 	float down{ 0.4f };
 	vector<float> heightData(width * height);
-	for (int z = 0; z < height; ++z) {
-		for (int x = 0; x < width; ++x) {
-			heightData[z * width + x] = (heightMap[(height - 1 - z) * width + x] / 255.f - down) * maxHeight; // (height - 1 - z)  Ʒ (   ) ϱ ̴.
-			//heightData[z * width + x] = heightMap[z * width + x] / 255.f * maxHeight; // (height - 1 - z)  ǹ̴  Ʒ  ϱ ̴.
-
+	jobSystem.ParallelFor(height, TERRAIN_JOB_ROWS, [&](size_t zBegin, size_t zEnd) {
+		for (size_t z = zBegin; z < zEnd; ++z) {
+			for (int x = 0; x < width; ++x) {
+				heightData[z * width + x] = (heightMap[(height - 1 - z) * width + x] / 255.f - down) * maxHeight; // (height - 1 - z)  Ʒ (   ) ϱ ̴.
+			}
 		}
-	}
+	});
+	return heightData;
+}
+
+void ResourceManager::BuildTerrain(JobSystem& jobSystem, const string& name, vector<float> heightData, int width, int height, int scale, int maxUV)
+{
+	mTerrainData.terrainWidth = width;
+	mTerrainData.terrainHeight = height;
+	mTerrainData.terrainScale = scale;
 
 	vector<Vertex> vertices(width * height);
-	for (int z = 0; z < height; ++z) {
-		for (int x = 0; x < width; ++x) {
-
-			int scaledX = x * scale;
-			int scaledZ = z * scale;
-			// position
-			vertices[z * width + x].position.x = scaledX;
-			vertices[z * width + x].position.y = heightData[z * width + x];
-			vertices[z * width + x].position.z = scaledZ;
-			// position.
-			
-			// normal
-			XMVECTOR left = XMVectorZero();
-			if (x == 0)
-				left = { (float)scaledX, heightData[z * width + x], (float)scaledZ };
-			else
-				left = { (float)scaledX - scale, heightData[z * width + x - 1], (float)scaledZ };
-
-			XMVECTOR right = XMVectorZero();
-			if (x == width - 1)
-				right = { (float)scaledX, heightData[z * width + x],(float)scaledZ };
-			else
-				right = { (float)scaledX + scale, heightData[z * width + x + 1], (float)scaledZ };
-
-			XMVECTOR up = XMVectorZero();
-			if (z == height - 1)
-				up = { (float)scaledX, heightData[z * width + x], (float)scaledZ };
-			else
-				up = { (float)scaledX, heightData[(z + 1) * width + x], (float)scaledZ + scale };
-
-			XMVECTOR down = XMVectorZero();
-			if (z == 0)
-				down = { (float)scaledX, heightData[z * width + x], (float)scaledZ };
-			else
-				down = { (float)scaledX, heightData[(z - 1) * width + x], (float)scaledZ - scale };
-
-			XMVECTOR normal = XMVector3Normalize(XMVector3Cross(up - down, right - left));			
-			XMStoreFloat3(&vertices[z * width + x].normal, normal);
-			// normal.
-			
-			// uv
-			vertices[z * width + x].uv.x = ((float)x / (width - 1)) * maxUV;
-			vertices[z * width + x].uv.y = (1 - (float)z / (height - 1)) * maxUV;
-			// uv.
+	jobSystem.ParallelFor(height, TERRAIN_JOB_ROWS, [&](size_t zBegin, size_t zEnd) {
+		for (size_t z = zBegin; z < zEnd; ++z) {
+			TerrainMesh::BuildRow(heightData, width, height, scale, maxUV, static_cast<int>(z), &vertices[z * width]);
 		}
-	}
-
-	vector<uint32_t> indices((width - 1) * (height - 1) * 2 * 3);
-	int i{ 0 };
-	for (int z = 0; z < height - 1; ++z) {
-		for (int x = 0; x < width - 1; ++x) {
-			int topLeft = (z + 1) * width + x;
-			int topRight = topLeft + 1;
-			int bottomLeft = z * width + x;
-			int bottomRight = bottomLeft + 1;
-
-			indices[i++] = bottomLeft;
-			indices[i++] = topLeft;
-			indices[i++] = topRight;
-
-			indices[i++] = bottomLeft;
-			indices[i++] = topRight;
-			indices[i++] = bottomRight;
+	});
+
+	// Ʈ  ( LOD)  ũ ûũ . ε  ûũ Ѵ.
+	mTerrainQuadTree.Build(heightData, width, height, scale, TERRAIN_CHUNK_QUADS);
+	mTerrainHeightField.Build(move(heightData), width, height, scale);
+
+	const uint32_t chunkQuads = mTerrainQuadTree.GetChunkQuads();
+	const uint32_t rowSize = chunkQuads + 1;
+	vector<Vertex> chunkVertices(mTerrainQuadTree.GetNodeCount() * mTerrainQuadTree.GetChunkVertexCount());
+	jobSystem.ParallelFor(mTerrainQuadTree.GetNodeCount(), TERRAIN_JOB_NODES, [&](size_t nodeBegin, size_t nodeEnd) {
+		for (size_t n = nodeBegin; n < nodeEnd; ++n) {
+			const TerrainNode& node = mTerrainQuadTree.GetNode(static_cast<uint32_t>(n));
+			Vertex* chunk = &chunkVertices[node.baseVertex];
+			for (uint32_t row = 0; row < rowSize; ++row) {
+				for (uint32_t column = 0; column < rowSize; ++column) {
+					chunk[row * rowSize + column] = vertices[mTerrainQuadTree.GetSampleIndex(node, column, row)];
+				}
+			}
+
+			// ĿƮ: ڸ  Ʒ  LOD  ٸ ûũ  ƴ .  , , , .
+			float skirtDepth = mTerrainQuadTree.GetSkirtDepth(node.level);
+			Vertex* skirt = chunk + rowSize * rowSize;
+			for (uint32_t i = 0; i < rowSize; ++i) {
+				skirt[i] = chunk[i];
+				skirt[rowSize + i] = chunk[chunkQuads * rowSize + i];
+				skirt[rowSize * 2 + i] = chunk[i * rowSize];
+				skirt[rowSize * 3 + i] = chunk[i * rowSize + chunkQuads];
+			}
+			for (uint32_t i = 0; i < rowSize * 4; ++i) skirt[i].position.y -= skirtDepth;
 		}
-	}
+	});
+	vertices = move(chunkVertices);
+
+	vector<uint32_t> indices;
+	mTerrainQuadTree.GetChunkIndices(indices);
 
 	SubMeshData subData{};
 	subData.vertexCountPerInstance = vertices.size();
@@ -186,7 +204,27 @@ SkinnedData& ResourceManager::GetAnimationData(string name)
 	return mAnimData.at(name);
 }
 
+vector<string> ResourceManager::GetAnimationNames()
+{
+	vector<string> names;
+	for (auto& [name, animData] : mAnimData) {
+		if (animData.BoneCount() > 0) names.push_back(name);
+	}
+	sort(names.begin(), names.end());
+	return names;
+}
+
 TerrainData& ResourceManager::GetTerrainData()
 {
 	return mTerrainData;
 }
+
+TerrainQuadTree& ResourceManager::GetTerrainQuadTree()
+{
+	return mTerrainQuadTree;
+}
+
+HeightField& ResourceManager::GetTerrainHeightField()
+{
+	return mTerrainHeightField;
+}
@@ -1,7 +1,19 @@
 #pragma once
-#include "stdafx.h"
-#include "FbxExtractor.h"
+#include "CoreTypes.h"
+#include "SkinnedData.h"
 #include "Info.h"
+#include "TerrainQuadTree.h"
+#include "HeightField.h"
+#define TERRAIN_CHUNK_QUADS 32
+#define TERRAIN_LOD_DISTANCE 2.0f
+#define TERRAIN_JOB_ROWS 16 // height map rows per job in CreateTerrain
+#define TERRAIN_JOB_NODES 4 // quadtree chunks per job in CreateTerrain
+#define TERRAIN_TILE_SIZE 64 // quads per tile side when a height map is converted to a .tiles file
+#define TERRAIN_TILE_COARSE_STEP 16 // coarse grid spacing of the converted file, in samples
+
+class FbxExtractor;
+class JobSystem;
+struct TerrainTileSource;
 
 struct TerrainData {
 	int terrainWidth;
@@ -16,12 +28,25 @@ public:
 	~ResourceManager();
 	void LoadFbx(const string& fileName, bool onlyAnimation, bool zUp);
 	void CreatePlane(const string& name, float size, float wrap);
-	void CreateTerrain(const string& name, int maxheight, int scale, int maxUV);
+	void CreateTerrain(JobSystem& jobSystem, const string& name, int maxheight, int scale, int maxUV);
+	// Writes the height map CreateTerrain would load as a .tiles file. Only ground queries use it (TerrainTileCache),
+	// the mesh is always built from the height map.
+	static bool ConvertTerrainToTiles(JobSystem& jobSystem, const string& name, const wstring& fileName, int maxHeight, int scale);
+	// The stamp ConvertTerrainToTiles writes for this height map and settings. A .tiles file with another one is stale.
+	static bool GetTerrainTileSource(const string& name, int maxHeight, int scale, TerrainTileSource& source);
 	vector<Vertex>& GetVertexBuffer();
 	vector<uint32_t>& GetIndexBuffer();
 	SubMeshData& GetSubMeshData(string name);
 	SkinnedData& GetAnimationData(string name);
+	vector<string> GetAnimationNames(); // sorted, every loaded file with a skeleton
 	TerrainData& GetTerrainData();
+	TerrainQuadTree& GetTerrainQuadTree();
+	HeightField& GetTerrainHeightField();
+
+private:
+	// Heights of a square 8-bit RAW file, row 0 at the bottom.
+	static vector<float> LoadHeightMap(JobSystem& jobSystem, const string& name, int maxHeight, int& width, int& height);
+	void BuildTerrain(JobSystem& jobSystem, const string& name, vector<float> heightData, int width, int height, int scale, int maxUV);
 private:
 	unique_ptr<FbxExtractor> mFbxExtractor;
 	vector<Vertex> mVertexBuffer;
@@ -29,5 +54,7 @@ private:
 	unordered_map<string, SubMeshData> mSubMeshData;
 	unordered_map<string, SkinnedData> mAnimData;
 	TerrainData mTerrainData;
+	TerrainQuadTree mTerrainQuadTree;
+	HeightField mTerrainHeightField;
 };
 
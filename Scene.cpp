@@ -1,10 +1,10 @@
 #include "Scene.h"
-#include "DXSampleHelper.h"
 #include "GameTimer.h"
 #include "string"
-#include "info.h"
+#include "Info.h"
 #include <array>
-#include "Framework.h"
+#include "Simulation.h"
+#include "Profiler.h"
 
 Scene::~Scene()
 {
@@ -12,50 +12,52 @@ Scene::~Scene()
     DeleteCurrentObjects();
 }
 
-Scene::Scene(Framework* parent, UINT width, UINT height) :
+Scene::Scene(Simulation* parent, UINT width, UINT height) :
     m_parent{ parent },
-    m_viewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)),
-    m_scissorRect(0, 0, static_cast<LONG>(width), static_cast<LONG>(height))
+    m_viewport{ 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f },
+    m_scissorRect{ 0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height) }
 {
 }
 
-void Scene::OnInit(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
+void Scene::OnInit(unique_ptr<SceneGraphics> graphics)
 {
     LoadMeshAnimationTexture();
     BuildProjMatrix();
     BuildBaseStage();
-    BuildRootSignature(device);
-    BuildInputElement();
-    BuildShaders();
-    BuildPSO(device);
-    BuildVertexBuffer(device, commandList);
-    BuildIndexBuffer(device, commandList);
-    BuildTextureBuffer(device, commandList);
-    BuildConstantBuffer(device);
-    BuildDescriptorHeap(device);
-    BuildVertexBufferView();
-    BuildIndexBufferView();
-    BuildConstantBufferView(device);
-    BuildTextureBufferView(device);
+    BuildConstantBuffer();
+    BuildVertexBuffer();
+    BuildIndexBuffer();
+    BuildDescriptorHeap();
+    BuildConstantBufferView();
+    BuildBonePalette(BONE_PALETTE_SIZE * 3 * sizeof(XMFLOAT4));
     BuildShadow();
+    m_graphics = move(graphics);
+    if (!m_graphics) { // 帮: ̴, PSO, ؽó Ʈ  Ͽ ̽ ɸ .
+        BuildNullPipelines();
+        return;
+    }
+
+    m_rootSignatureHandle = m_graphics->BuildPipelines(m_pipelines);
+    BuildTextures();
 }
 
 void Scene::BuildHuntingStage()
 {
     m_current_stage = L"Hunting";
+    m_terrainStage = true;
 
     Object* objectPtr = nullptr;
     {
         objectPtr = new CameraObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {0.f, 0.0f, 0.f} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(0.f, 0.0f, 0.f, 0.0f) });
         AddObj(objectPtr);
     }
 
     {
         float scale = 0.1f;
         objectPtr = new PlayerObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {300.f, 0.0f, 300.f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(300.f, 0.0f, 300.f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "1P(boy-idle).fbx" });
         objectPtr->AddComponent(new Texture{ L"boy" , 1.0f, 0.4f });
         objectPtr->AddComponent(new Animation{ "1P(boy-idle).fbx" });
@@ -66,7 +68,7 @@ void Scene::BuildHuntingStage()
 
     {
         objectPtr = new TerrainObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {0.f, 0.0f, 0.f} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(0.f, 0.0f, 0.f, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "HeightMap.raw" });
         objectPtr->AddComponent(new Texture{ L"grass" , 5.0f, 0.4f });
         AddObj(objectPtr);
@@ -82,8 +84,8 @@ void Scene::BuildHuntingStage()
         for (int i = 0; i < repeat; ++i) {
             for (int j = 0; j < repeat; ++j) {
                 objectPtr = new TreeObject(this, AllocateId());
-                objectPtr->AddComponent(new Transform{ {basePosX + offset * j, -100.f, basePosZ + offset * i} });
-                objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+                objectPtr->AddComponent(new Transform{ XMVectorSet(basePosX + offset * j, -100.f, basePosZ + offset * i, 0.0f) });
+                objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
                 objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
                 objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
                 objectPtr->AddComponent(new Collider{ {0.0f, 20.0f, 0.0f}, {4.0f, 20.0f, 4.0f} });
@@ -102,8 +104,8 @@ void Scene::BuildHuntingStage()
         for (int i = 0; i < repeat; ++i) {
             for (int j = 0; j < repeat; ++j) {
                 objectPtr = new TreeObject(this, AllocateId());
-                objectPtr->AddComponent(new Transform{ {basePosX + offset * j, -100.f, basePosZ + offset * i} });
-                objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+                objectPtr->AddComponent(new Transform{ XMVectorSet(basePosX + offset * j, -100.f, basePosZ + offset * i, 0.0f) });
+                objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
                 objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
                 objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
                 objectPtr->AddComponent(new Collider{ {0.0f, 20.0f, 0.0f}, {4.0f, 20.0f, 4.0f} });
@@ -122,8 +124,8 @@ void Scene::BuildHuntingStage()
         for (int i = 0; i < repeat; ++i) {
             for (int j = 0; j < repeat; ++j) {
                 objectPtr = new TigerObject(this, AllocateId());
-                objectPtr->AddComponent(new Transform{ {basePosX + offset * j, 0.0f, basePosZ + offset * i} });
-                objectPtr->AddComponent(new AdjustTransform{ {0.0f, 0.0f, -40.0f * scale}, {0.0f, 180.0f, 0.0f}, {scale, scale, scale} });
+                objectPtr->AddComponent(new Transform{ XMVectorSet(basePosX + offset * j, 0.0f, basePosZ + offset * i, 0.0f) });
+                objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f, 0.0f, -40.0f * scale, 0.0f), XMVectorSet(0.0f, 180.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
                 objectPtr->AddComponent(new Mesh{ "0113_tiger.fbx" });
                 objectPtr->AddComponent(new Texture{ L"tigercolor", 1.0f, 0.4f });
                 objectPtr->AddComponent(new Animation{ "0113_tiger_walk.fbx" });
@@ -139,12 +141,13 @@ void Scene::BuildHuntingStage()
 void Scene::BuildBaseStage()
 {
     m_current_stage = L"Base";
+    m_terrainStage = false;
     Object* objectPtr = nullptr;
 
     // ī޶
     {
         objectPtr = new CameraObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {0.0f, 0.0f, 0.0f} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f) });
         AddObj(objectPtr);
     }
 
@@ -152,8 +155,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 0.1f;
         objectPtr = new PlayerObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {430.f, 0.0f, 150.f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(430.f, 0.0f, 150.f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "1P(boy-idle).fbx" });
         objectPtr->AddComponent(new Texture{ L"boy" , 1.0f, 0.4f });
         objectPtr->AddComponent(new Animation{ "1P(boy-idle).fbx" });
@@ -163,8 +166,8 @@ void Scene::BuildBaseStage()
 
         scale = 2.0f;
         objectPtr = new TestObject(this, AllocateId(), objectPtr->GetId());
-        objectPtr->AddComponent(new Transform{ { 0.0f, 5.0f, -3.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(0.0f, 5.0f, -3.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
         objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
         AddObj(objectPtr);
@@ -173,7 +176,7 @@ void Scene::BuildBaseStage()
     // 
     {
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {0.0f, 0.0f, 0.0f} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "Plane" });
         objectPtr->AddComponent(new Texture{ L"grass", 1.0f, 0.4f });
         AddObj(objectPtr);
@@ -183,8 +186,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 4.0f;
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {200.0f, 0.0f, 350.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {85.0f * scale, 8.5f * scale, -291.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(200.0f, 0.0f, 350.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(85.0f * scale, 8.5f * scale, -291.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "background_house.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 6.0f * scale, 0.0f}, {7.0f * scale, 6.0f * scale, 19.0f * scale} });
@@ -192,8 +195,8 @@ void Scene::BuildBaseStage()
         AddObj(objectPtr);
 
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {500.0f, 0.0f, 700.0f}, {0.0f, 90.0f, 0.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {85.0f * scale, 8.5f * scale, -291.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(500.0f, 0.0f, 700.0f, 0.0f), XMVectorSet(0.0f, 90.0f, 0.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(85.0f * scale, 8.5f * scale, -291.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "background_house.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 6.0f * scale, 0.0f}, {7.0f * scale, 6.0f * scale, 19.0f * scale} });
@@ -205,8 +208,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 0.1f;
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {300.0f, 0.0f, 250.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, -100.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(300.0f, 0.0f, 250.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, -100.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "broken_house.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 300.0f * scale, 0.0f}, {400.0f * scale, 300.0f * scale, 200.0f * scale} });
@@ -214,8 +217,8 @@ void Scene::BuildBaseStage()
         AddObj(objectPtr);
 
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {400.0f, 0.0f, 600.0f}, {0.0f, 90.0f, 0.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, -100.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(400.0f, 0.0f, 600.0f, 0.0f), XMVectorSet(0.0f, 90.0f, 0.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, -100.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "broken_house.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 300.0f * scale, 0.0f}, {400.0f * scale, 300.0f * scale, 200.0f * scale} });
@@ -227,8 +230,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 0.1f;
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {300.0f, 0.0f, 480.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(300.0f, 0.0f, 480.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "broken_house2.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house2", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 300.0f * scale, 0.0f}, {500.0f * scale, 300.0f * scale, 300.0f * scale} });
@@ -236,8 +239,8 @@ void Scene::BuildBaseStage()
         AddObj(objectPtr);
 
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {600.0f, 0.0f, 600.0f}, {0.0f, 90.0f, 0.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(600.0f, 0.0f, 600.0f, 0.0f), XMVectorSet(0.0f, 90.0f, 0.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "broken_house2.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house2", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 300.0f * scale, 0.0f}, {500.0f * scale, 300.0f * scale, 300.0f * scale} });
@@ -249,8 +252,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 4.0f;
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {300.0f, 0.0f, 350.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 1.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(300.0f, 0.0f, 350.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 1.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "table.fbx" });
         objectPtr->AddComponent(new Texture{ L"Brown", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 1.2f * scale, 0.0f}, {6.5f * scale, 1.2f * scale, 5.0f * scale} });
@@ -258,8 +261,8 @@ void Scene::BuildBaseStage()
         AddObj(objectPtr);
 
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {500.0f, 0.0f, 600.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 1.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(500.0f, 0.0f, 600.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 1.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "table.fbx" });
         objectPtr->AddComponent(new Texture{ L"Brown", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 1.2f * scale, 0.0f}, {6.5f * scale, 1.2f * scale, 5.0f * scale} });
@@ -271,8 +274,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 0.4f;
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {430.0f, 0.0f, 300.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 13.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(430.0f, 0.0f, 300.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 13.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "well.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 37.5f * scale, 0.0f}, {12.5f * scale, 37.5f * scale, 12.5f * scale} });
@@ -280,8 +283,8 @@ void Scene::BuildBaseStage()
         AddObj(objectPtr);
 
         objectPtr = new TestObject(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {600.0f, 0.0f, 500.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 13.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(600.0f, 0.0f, 500.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 13.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "well.fbx" });
         objectPtr->AddComponent(new Texture{ L"broken_house", 1.0f, 0.4f });
         objectPtr->AddComponent(new Collider{ {0.0f, 37.5f * scale, 0.0f}, {12.5f * scale, 37.5f * scale, 12.5f * scale} });
@@ -299,8 +302,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX + offset * i, 0.0f, baseZ} });
-            objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX + offset * i, 0.0f, baseZ, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
             objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {0.0f, 1.0f * scale, 0.0f}, {0.15f * scale, 1.0f * scale, 0.15f * scale} });
@@ -310,8 +313,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX + offset * i, 0.0f, baseZ + offset * (repeat - 1)} });
-            objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX + offset * i, 0.0f, baseZ + offset * (repeat - 1), 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
             objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {0.0f, 1.0f * scale, 0.0f}, {0.15f * scale, 1.0f * scale, 0.15f * scale} });
@@ -321,8 +324,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX , 0.0f, baseZ + offset * i} });
-            objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX, 0.0f, baseZ + offset * i, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
             objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {0.0f, 1.0f * scale, 0.0f}, {0.15f * scale, 1.0f * scale, 0.15f * scale} });
@@ -332,8 +335,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX + offset * (repeat - 1) , 0.0f, baseZ + offset * i} });
-            objectPtr->AddComponent(new AdjustTransform{ {-0.8f * scale, 0.3f * scale, -2.5f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX + offset * (repeat - 1), 0.0f, baseZ + offset * i, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-0.8f * scale, 0.3f * scale, -2.5f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "long_tree.fbx" });
             objectPtr->AddComponent(new Texture{ L"longTree", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {0.0f, 1.0f * scale, 0.0f}, {0.15f * scale, 1.0f * scale, 0.15f * scale} });
@@ -353,8 +356,8 @@ void Scene::BuildBaseStage()
             for (int j = 0; j < 2; ++j)
             {
                 objectPtr = new TestObject(this, AllocateId());
-                objectPtr->AddComponent(new Transform{ {200.0f + baseX + offset * j, 0.0f, 600.0f + baseZ + offset * i} });
-                objectPtr->AddComponent(new AdjustTransform{ {-1.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+                objectPtr->AddComponent(new Transform{ XMVectorSet(200.0f + baseX + offset * j, 0.0f, 600.0f + baseZ + offset * i, 0.0f) });
+                objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-1.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
                 objectPtr->AddComponent(new Mesh{ "normal_tree.fbx" });
                 objectPtr->AddComponent(new Texture{ L"normalTree", 1.0f, 0.4f });
                 objectPtr->AddComponent(new Collider{ {0.0f, 1.0f * scale, 0.0f}, {0.15f * scale, 1.0f * scale, 0.15f * scale} });
@@ -369,8 +372,8 @@ void Scene::BuildBaseStage()
             for (int j = 0; j < 2; ++j)
             {
                 objectPtr = new TestObject(this, AllocateId());
-                objectPtr->AddComponent(new Transform{ {700.0f + baseX + offset * j, 0.0f, 600.0f + baseZ + offset * i} });
-                objectPtr->AddComponent(new AdjustTransform{ {-1.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+                objectPtr->AddComponent(new Transform{ XMVectorSet(700.0f + baseX + offset * j, 0.0f, 600.0f + baseZ + offset * i, 0.0f) });
+                objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(-1.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
                 objectPtr->AddComponent(new Mesh{ "normal_tree.fbx" });
                 objectPtr->AddComponent(new Texture{ L"normalTree", 1.0f, 0.4f });
                 objectPtr->AddComponent(new Collider{ {0.0f, 1.0f * scale, 0.0f}, {0.15f * scale, 1.0f * scale, 0.15f * scale} });
@@ -387,8 +390,8 @@ void Scene::BuildBaseStage()
     {
         float scale = 0.2f;
         objectPtr = new TigerMockup(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {550.0f, 0.0f, 250.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f, 0.0f, -40.0f * scale}, {0.0f, 180.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(550.0f, 0.0f, 250.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f, 0.0f, -40.0f * scale, 0.0f), XMVectorSet(0.0f, 180.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "0113_tiger.fbx" });
         objectPtr->AddComponent(new Texture{ L"tigercolor", 1.0f, 0.4f });
         objectPtr->AddComponent(new Animation{ "0113_tiger_walk.fbx" });
@@ -397,8 +400,8 @@ void Scene::BuildBaseStage()
         AddObj(objectPtr);
 
         objectPtr = new TigerMockup(this, AllocateId());
-        objectPtr->AddComponent(new Transform{ {650.0f, 0.0f, 350.0f} });
-        objectPtr->AddComponent(new AdjustTransform{ {0.0f, 0.0f, -40.0f * scale}, {0.0f, 180.0f, 0.0f}, {scale, scale, scale} });
+        objectPtr->AddComponent(new Transform{ XMVectorSet(650.0f, 0.0f, 350.0f, 0.0f) });
+        objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f, 0.0f, -40.0f * scale, 0.0f), XMVectorSet(0.0f, 180.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
         objectPtr->AddComponent(new Mesh{ "0113_tiger.fbx" });
         objectPtr->AddComponent(new Texture{ L"tigercolor", 1.0f, 0.4f });
         objectPtr->AddComponent(new Animation{ "0113_tiger_walk.fbx" });
@@ -417,8 +420,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX + offset * i, 0.0f, baseZ} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {-90.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX + offset * i, 0.0f, baseZ, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(-90.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "fence.fbx" });
             objectPtr->AddComponent(new Texture{ L"Brown", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {150.0f * scale, 100.0f * scale, 0.0f}, {150.0f * scale, 100.0f * scale, 50.0f * scale } });
@@ -428,8 +431,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX + offset * i, 0.0f, baseZ + offset * repeat} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {-90.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX + offset * i, 0.0f, baseZ + offset * repeat, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(-90.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "fence.fbx" });
             objectPtr->AddComponent(new Texture{ L"Brown", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {150.0f * scale, 100.0f * scale, 0.0f}, {150.0f * scale, 100.0f * scale, 50.0f * scale} });
@@ -439,8 +442,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX, 0.0f, baseZ + offset * i}, {0.0f, -90.0f, 0.0f} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {-90.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX, 0.0f, baseZ + offset * i, 0.0f), XMVectorSet(0.0f, -90.0f, 0.0f, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(-90.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "fence.fbx" });
             objectPtr->AddComponent(new Texture{ L"Brown", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {150.0f * scale, 100.0f * scale, 0.0f}, {150.0f * scale, 100.0f * scale, 50.0f * scale} });
@@ -450,8 +453,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {baseX + offset * repeat, 0.0f, baseZ + offset * i}, {0.0f, -90.0f, 0.0f} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {-90.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(baseX + offset * repeat, 0.0f, baseZ + offset * i, 0.0f), XMVectorSet(0.0f, -90.0f, 0.0f, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(-90.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Mesh{ "fence.fbx" });
             objectPtr->AddComponent(new Texture{ L"Brown", 1.0f, 0.4f });
             objectPtr->AddComponent(new Collider{ {150.0f * scale, 100.0f * scale, 0.0f}, {150.0f * scale, 100.0f * scale, 50.0f * scale} });
@@ -468,8 +471,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {100.0f + 200.0f * i, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(100.0f + 200.0f * i, 0.0f, 0.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {2.3f * scale, 1.5f * scale, 1.3f * scale} });
             objectPtr->AddComponent(new Mesh{ "cloud1.fbx" });
             objectPtr->AddComponent(new Texture{ L"stone", 1.0f, 0.4f });
@@ -480,8 +483,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {100.0f + 200.0f * i, 0.0f, 1000.0f}, {0.0f, 0.0f, 0.0f} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(100.0f + 200.0f * i, 0.0f, 1000.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {2.3f * scale, 1.5f * scale, 1.3f * scale} });
             objectPtr->AddComponent(new Mesh{ "cloud1.fbx" });
             objectPtr->AddComponent(new Texture{ L"stone", 1.0f, 0.4f });
@@ -492,8 +495,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {0.0f, 0.0f, 100.0f + 200.0f * i}, {0.0f, 90.0f, 0.0f} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(0.0f, 0.0f, 100.0f + 200.0f * i, 0.0f), XMVectorSet(0.0f, 90.0f, 0.0f, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {2.3f * scale, 1.5f * scale, 1.3f * scale} });
             objectPtr->AddComponent(new Mesh{ "cloud1.fbx" });
             objectPtr->AddComponent(new Texture{ L"stone", 1.0f, 0.4f });
@@ -504,8 +507,8 @@ void Scene::BuildBaseStage()
         for (int i = 0; i < repeat; ++i)
         {
             objectPtr = new TestObject(this, AllocateId());
-            objectPtr->AddComponent(new Transform{ {1000.0f, 0.0f, 100.0f + 200.0f * i}, {0.0f, 90.0f, 0.0f} });
-            objectPtr->AddComponent(new AdjustTransform{ {0.0f * scale, 0.0f * scale, 0.0f * scale}, {0.0f, 0.0f, 0.0f}, {scale, scale, scale} });
+            objectPtr->AddComponent(new Transform{ XMVectorSet(1000.0f, 0.0f, 100.0f + 200.0f * i, 0.0f), XMVectorSet(0.0f, 90.0f, 0.0f, 0.0f) });
+            objectPtr->AddComponent(new AdjustTransform{ XMVectorSet(0.0f * scale, 0.0f * scale, 0.0f * scale, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(scale, scale, scale, 0.0f) });
             objectPtr->AddComponent(new Collider{ {0.0f, 0.0f, 0.0f}, {2.3f * scale, 1.5f * scale, 1.3f * scale} });
             objectPtr->AddComponent(new Mesh{ "cloud1.fbx" });
             objectPtr->AddComponent(new Texture{ L"stone", 1.0f, 0.4f });
@@ -530,6 +533,7 @@ void Scene::BuildBaseStage()
 void Scene::BuildGodStage()
 {
     m_current_stage = L"God";
+    m_terrainStage = false;
 }
 
 void Scene::BuildShadow()
@@ -537,66 +541,48 @@ void Scene::BuildShadow()
     m_shadow = make_unique<Shadow>(this, 2048, 2048);
 }
 
-void Scene::BuildShaders()
+void Scene::RenderObjects(RenderDevice& renderDevice, eCaster caster)
 {
-    m_shaders["VS_Opaque"] = CompileShader(L"Shaders/Opaque.hlsl", nullptr, "VS", "vs_5_1");
-    m_shaders["PS_Opaque"] = CompileShader(L"Shaders/Opaque.hlsl", nullptr, "PS", "ps_5_1");
-    m_shaders["VS_Shadow"] = CompileShader(L"Shaders/Shadow.hlsl", nullptr, "VS", "vs_5_1");
-    m_shaders["PS_Shadow"] = CompileShader(L"Shaders/Shadow.hlsl", nullptr, "PS", "ps_5_1");
-}
-
-void Scene::BuildInputElement()
-{
-    // Define the vertex input layout.
-    //m_inputElement.reserve(5);
-    m_inputElement =
+    PROFILE_ZONE("Scene::RenderObjects");
+    // ̸ Ű Ʈ  ۿ PSO  ޶ ڿ  ׸,    ´.
+    m_preSkinnedObjects.clear();
+    for (Object* obj : m_objects)
     {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "WEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "BONEINDEX", 0, DXGI_FORMAT_R32G32B32A32_SINT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-    };
-}
-
-ComPtr<ID3DBlob> Scene::CompileShader(
-    const std::wstring& fileName, const D3D_SHADER_MACRO* defines, const std::string& entryPoint, const std::string& target)
-{
-    UINT compileFlags = 0;
-#if defined(_DEBUG) || defined(DBG)
-    compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
-
-    HRESULT hr;
-
-    Microsoft::WRL::ComPtr<ID3DBlob> byteCode = nullptr;
-    Microsoft::WRL::ComPtr<ID3DBlob> errors;
-    hr = D3DCompileFromFile(fileName.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
-        entryPoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
+        if (!obj->GetValid()) continue;
+        if (caster == eCaster::Static && !obj->IsStatic()) continue;
+        if (caster == eCaster::Dynamic && obj->IsStatic()) continue;
+        if (obj->IsPreSkinned()) {
+            m_preSkinnedObjects.push_back(obj);
+            continue;
+        }
+        obj->OnRender(renderDevice);
+    }
+    if (m_preSkinnedObjects.empty()) return;
 
-    if (errors != nullptr)
+    const bool shadow = m_current_pass == ePass::Shadow;
+    renderDevice.SetPipelineState(m_pipelines.at(shadow ? "PSO_ShadowSkinned" : "PSO_OpaqueSkinned"));
+    renderDevice.SetVertexBuffer(m_skinnedVertexBuffer.address, static_cast<UINT>(m_skinnedVertexBuffer.size), sizeof(SkinnedVertex));
+    for (Object* obj : m_preSkinnedObjects)
     {
-        OutputDebugStringA((char*)errors->GetBufferPointer());
+        obj->OnRender(renderDevice);
+        m_preSkinningStats.drawnVertices += obj->GetPreSkinnedVertexCount();
     }
-    ThrowIfFailed(hr);
-
-    return byteCode;
+    renderDevice.SetVertexBuffer(m_vertexBuffer.address, static_cast<UINT>(m_vertexBuffer.size), sizeof(Vertex));
+    renderDevice.SetPipelineState(m_pipelines.at(shadow ? "PSO_Shadow" : "PSO_Opaque"));
 }
 
-void Scene::RenderObjects(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
+char Scene::ClampToBounds(XMVECTOR& pos, XMVECTOR offset)
 {
-    for (Object* obj : m_objects)
-    {
-        if (!obj->GetValid()) continue;
-        obj->OnRender(device, commandList);
-    }
+    XMFLOAT3 p;
+    XMStoreFloat3(&p, pos);
+    return ClampToBounds(pos, offset, GetBounds(p.x, p.z));
 }
 
-char Scene::ClampToBounds(XMVECTOR& pos, XMVECTOR offset)
+char Scene::ClampToBounds(XMVECTOR& pos, XMVECTOR offset, const std::tuple<float, float, float, float, float>& bounds)
 {
     XMFLOAT3 p;
     XMStoreFloat3(&p, pos);
-    auto [minX, minY, minZ, maxX, maxZ] = GetBounds(p.x, p.z);
+    auto [minX, minY, minZ, maxX, maxZ] = bounds;
 
     float offsetX = XMVectorGetX(offset);
     float offsetY = XMVectorGetY(offset);
@@ -653,45 +639,48 @@ std::tuple<float, float, float, float, float> Scene::GetBounds(float x, float z)
         maxZ = 500.0f;
     }
 
-    if (m_current_stage == L"Hunting")
+    if (m_terrainStage)
     {
         ResourceManager& rm = GetResourceManager();
         int width = rm.GetTerrainData().terrainWidth;
         int height = rm.GetTerrainData().terrainHeight;
         int terrainScale = rm.GetTerrainData().terrainScale;
-
-        vector<Vertex>& vertexBuffer = rm.GetVertexBuffer();
-        UINT startVertex = rm.GetSubMeshData("HeightMap.raw").baseVertexLocation;
-
-        int indexX = (int)(x / terrainScale);
-        int indexZ = (int)(z / terrainScale);
-        if (indexX < 0) indexX = 0;
-        if (indexZ < 0) indexZ = 0;
-
-        float leftBottom = vertexBuffer[startVertex + indexZ * width + indexX].position.y;
-        float rightBottom = vertexBuffer[startVertex + indexZ * width + indexX + 1].position.y;
-        float leftTop = vertexBuffer[startVertex + (indexZ + 1) * width + indexX].position.y;
-        float rightTop = vertexBuffer[startVertex + (indexZ + 1) * width + indexX + 1].position.y;
-
-        float offsetX = x / terrainScale - indexX;
-        float offsetZ = z / terrainScale - indexZ;
-
-        float lerpXBottom = (1 - offsetX) * leftBottom + offsetX * rightBottom;
-        float lerpXTop = (1 - offsetX) * leftTop + offsetX * rightTop;
-
-        float lerpZ = (1 - offsetZ) * lerpXBottom + offsetZ * lerpXTop;
-
-        minY = lerpZ;
         maxX = (width - 1) * terrainScale;
         maxZ = (height - 1) * terrainScale;
+
+        // Ÿ    ö Ÿ ޽ ̸ 16 Ʈ ȭ , ö  Ÿ  ̷
+        // Ѵ. ƴϸ ޽ÿ   ʵ忡 øѴ.
+        if (m_terrainTiles.IsOpen())
+            minY = m_terrainTiles.SampleHeight(x, z);
+        else
+            minY = rm.GetTerrainHeightField().SampleHeight(x, z);
     }
 
     return { minX, minY, minZ, maxX, maxZ };
 }
 
+bool Scene::CastTerrainSegment(XMVECTOR from, XMVECTOR to, float* hitT)
+{
+    if (!m_terrainStage) return false;
+    XMFLOAT3 p0, p1;
+    XMStoreFloat3(&p0, from);
+    XMStoreFloat3(&p1, to);
+    return GetResourceManager().GetTerrainHeightField().SegmentCast(p0.x, p0.y, p0.z, p1.x, p1.y, p1.z, hitT);
+}
+
 int Scene::GetTextureIndex(wstring name)
 {
-    return m_texture_name_to_index.at(name);
+    return m_textureTable.GetSlot(name);
+}
+
+XMFLOAT4X4& Scene::GetProjMatrix()
+{
+    return m_proj;
+}
+
+ePass Scene::GetCurrentPass()
+{
+    return m_current_pass;
 }
 
 std::tuple<XMVECTOR, float> Scene::GetCollisionData(BoundingOrientedBox OBB1, BoundingOrientedBox OBB2)
@@ -702,15 +691,15 @@ std::tuple<XMVECTOR, float> Scene::GetCollisionData(BoundingOrientedBox OBB1, Bo
 
     XMVECTOR quaternion1 = XMLoadFloat4(&OBB1.Orientation);
     XMVECTOR axes1[3]{};
-    axes1[0] = XMVector3Rotate({ 1.0f, 0.0f, 0.0f }, quaternion1);
-    axes1[1] = XMVector3Rotate({ 0.0f, 1.0f, 0.0f }, quaternion1);
-    axes1[2] = XMVector3Rotate({ 0.0f, 0.0f, 1.0f }, quaternion1);
+    axes1[0] = XMVector3Rotate(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), quaternion1);
+    axes1[1] = XMVector3Rotate(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), quaternion1);
+    axes1[2] = XMVector3Rotate(XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), quaternion1);
 
     XMVECTOR quaternion2 = XMLoadFloat4(&OBB2.Orientation);
     XMVECTOR axes2[3]{};
-    axes2[0] = XMVector3Normalize(XMVector3Rotate({ 1.0f, 0.0f, 0.0f }, quaternion2));
-    axes2[1] = XMVector3Normalize(XMVector3Rotate({ 0.0f, 1.0f, 0.0f }, quaternion2));
-    axes2[2] = XMVector3Normalize(XMVector3Rotate({ 0.0f, 0.0f, 1.0f }, quaternion2));
+    axes2[0] = XMVector3Normalize(XMVector3Rotate(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), quaternion2));
+    axes2[1] = XMVector3Normalize(XMVector3Rotate(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), quaternion2));
+    axes2[2] = XMVector3Normalize(XMVector3Rotate(XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), quaternion2));
 
     const int testAxesCount = 15;
     XMVECTOR testAxes[testAxesCount] = {
@@ -769,17 +758,49 @@ Object* Scene::GetObjFromId(uint32_t id)
 
 void Scene::CompactObjects()
 {
-    m_objects.erase(std::remove_if(m_objects.begin(), m_objects.end(),[](Object* obj) { return !(obj->GetValid()); }), m_objects.end());
+    auto removed = std::remove_if(m_objects.begin(), m_objects.end(),[](Object* obj) { return !(obj->GetValid()); });
+    for (auto it = removed; it != m_objects.end(); ++it) {
+        if ((*it)->IsStatic() && m_shadow) m_shadow->GetCache().RemoveStaticCaster((*it)->GetId());
+        m_transformHierarchy.RemoveNode((*it)->GetTransformNode());
+        m_transformObjects[(*it)->GetTransformNode()] = nullptr;
+    }
+    m_objects.erase(removed, m_objects.end());
 }
 
 void Scene::ProcessObjectQueue()
 {
     for (int i = 0; i < m_object_queue_index; ++i) {
-        m_objects.push_back(m_object_queue[i]);
+        Object* obj = m_object_queue[i];
+        if (obj->IsStatic()) InvalidateStaticShadow();
+        obj->BuildConstantBuffer();
+        m_objects.push_back(obj);
+
+        uint32_t node = m_transformHierarchy.AddNode();
+        if (node >= m_transformObjects.size()) m_transformObjects.resize(node + 1);
+        m_transformObjects[node] = obj;
+        obj->SetTransformNode(node);
+        m_transformHierarchy.SetLocal(node, obj->GetComponent<Transform>()->GetTransformM());
     }
     m_object_queue_index = 0;
 }
 
+void Scene::UpdateStaticCaster(uint32_t id, const XMFLOAT4X4& world)
+{
+    //  ü   ĳø ׸  ޶(鿡  ɰų Ű) ٽ ׸.
+    if (m_shadow) m_shadow->GetCache().UpdateStaticCaster(id, world);
+}
+
+void Scene::InvalidateStaticShadow()
+{
+    //  ü ߰ǰų  LOD  ٲ ĳõ ׸  ٽ ׸.
+    if (m_shadow) m_shadow->InvalidateStaticCache();
+}
+
+const ShadowCache& Scene::GetShadowCache()
+{
+    return m_shadow->GetCache();
+}
+
 uint32_t Scene::AllocateId()
 {
     return m_id_counter++;
@@ -787,7 +808,7 @@ uint32_t Scene::AllocateId()
 
 void Scene::SetStage(wstring stage)
 {
-    m_stage_queue = stage;
+    Defer([this, stage]() { m_stage_queue = stage; });
 }
 
 void Scene::ProcessStageQueue()
@@ -817,291 +838,221 @@ void Scene::DeleteCurrentObjects()
         delete obj;
     }
     m_objects.clear();
+    m_transformHierarchy.Clear();
+    m_transformObjects.clear();
+    if (m_shadow) m_shadow->GetCache().ClearStaticCasters();
 }
 
-void Scene::BuildRootSignature(ID3D12Device* device)
+void Scene::BuildNullPipelines()
 {
-    // Create a root signature consisting of a descriptor table with a single CBV.
-    D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData{};
+    // Ͽ ̽  и Ǹ ȴ.  ̶ ึ  αװ ´.
+    m_rootSignatureHandle = 1;
+    m_pipelines["PSO_Opaque"] = 1;
+    m_pipelines["PSO_Shadow"] = 2;
+    m_pipelines["PSO_OpaqueSkinned"] = 3;
+    m_pipelines["PSO_ShadowSkinned"] = 4;
+}
 
-    // This is the highest version the sample supports. If CheckFeatureSupport succeeds, the HighestVersion returned will not be greater than this.
-    featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+void Scene::BuildVertexBuffer()
+{
+    // ⺻    ÷ ΰ  . ¡ ۴ ̽  ִ.
+    const vector<Vertex>& vertices = m_resourceManager->GetVertexBuffer();
+    m_vertexBuffer = m_parent->GetRenderDevice().CreateStaticBuffer(vertices.data(), vertices.size() * sizeof(Vertex));
+}
 
-    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
-    {
-        featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
-    }
+void Scene::BuildIndexBuffer()
+{
+    const vector<uint32_t>& indices = m_resourceManager->GetIndexBuffer();
+    m_indexBuffer = m_parent->GetRenderDevice().CreateStaticBuffer(indices.data(), indices.size() * sizeof(uint32_t));
+}
 
-    CD3DX12_DESCRIPTOR_RANGE1 ranges[3] = {};
-    ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0, 0);
-    ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0);
-    ranges[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 1, 0);
-
-    CD3DX12_ROOT_PARAMETER1 rootParameters[4] = {};
-    rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_VERTEX);
-    rootParameters[1].InitAsDescriptorTable(1, &ranges[1], D3D12_SHADER_VISIBILITY_PIXEL);
-    rootParameters[2].InitAsConstantBufferView(1);
-    rootParameters[3].InitAsDescriptorTable(1, &ranges[2], D3D12_SHADER_VISIBILITY_PIXEL);
-
-    std::array<D3D12_STATIC_SAMPLER_DESC, 2> samplerDesc = {};
-    D3D12_STATIC_SAMPLER_DESC* descPtr = nullptr;
-
-    descPtr = &samplerDesc[0];
-    descPtr->Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
-    descPtr->AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-    descPtr->AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-    descPtr->AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
-    descPtr->MipLODBias = 0;
-    descPtr->MaxAnisotropy = 0; // filter  type  anisotropy ϶ 
-    descPtr->ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-    descPtr->BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
-    descPtr->MinLOD = 0.0f;
-    descPtr->MaxLOD = D3D12_FLOAT32_MAX;
-    descPtr->ShaderRegister = 0;
-    descPtr->RegisterSpace = 0;
-    descPtr->ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    descPtr = &samplerDesc[1];
-    descPtr->Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
-    descPtr->AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    descPtr->AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    descPtr->AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    descPtr->MipLODBias = 0;
-    descPtr->MaxAnisotropy = 0; // filter  type  anisotropy ϶ 
-    descPtr->ComparisonFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
-    descPtr->BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
-    descPtr->MinLOD = 0.0f;
-    descPtr->MaxLOD = 0.0f;
-    descPtr->ShaderRegister = 1;
-    descPtr->RegisterSpace = 0;
-    descPtr->ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    D3D12_ROOT_SIGNATURE_FLAGS flags = 
-        D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
-
-    CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
-    rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, samplerDesc.size(), samplerDesc.data(), flags);
-
-    ComPtr<ID3DBlob> signature;
-    ComPtr<ID3DBlob> error;
-    ThrowIfFailed(D3DX12SerializeVersionedRootSignature(&rootSignatureDesc, featureData.HighestVersion, &signature, &error));
-    ThrowIfFailed(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&m_rootSignature)));
-}
-
-void Scene::BuildPSO(ID3D12Device* device)
-{
-    // Describe and create the graphics pipeline state object (PSO).
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-    psoDesc.InputLayout = { m_inputElement.data(), static_cast<UINT>(m_inputElement.size())};
-    psoDesc.pRootSignature = m_rootSignature.Get();
-    psoDesc.VS = CD3DX12_SHADER_BYTECODE(m_shaders.at("VS_Opaque").Get());
-    psoDesc.PS = CD3DX12_SHADER_BYTECODE(m_shaders.at("PS_Opaque").Get());
-    psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-    psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-    psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
-    psoDesc.SampleMask = UINT_MAX;
-    psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    psoDesc.NumRenderTargets = 1;
-    psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-    psoDesc.SampleDesc.Count = 1;
-    psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    ThrowIfFailed(device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(m_PSOs["PSO_Opaque"].GetAddressOf())));
-
-    psoDesc.RasterizerState.DepthBias = 10000;
-    psoDesc.RasterizerState.DepthBiasClamp = 0.0f;
-    psoDesc.RasterizerState.SlopeScaledDepthBias = 1.2f;
-    psoDesc.VS = CD3DX12_SHADER_BYTECODE(m_shaders.at("VS_Shadow").Get());
-    psoDesc.PS = CD3DX12_SHADER_BYTECODE(m_shaders.at("PS_Shadow").Get());
-    psoDesc.NumRenderTargets = 0;
-    psoDesc.RTVFormats[0] = DXGI_FORMAT_UNKNOWN;
-    ThrowIfFailed(device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(m_PSOs["PSO_Shadow"].GetAddressOf())));
-}
-
-void Scene::BuildVertexBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
-{
-    const UINT vertexBufferSize = m_resourceManager->GetVertexBuffer().size() * sizeof(Vertex);
-    // Create the vertex buffer.
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-        D3D12_RESOURCE_STATE_COMMON,
-        nullptr,
-        IID_PPV_ARGS(m_vertexBuffer_default.GetAddressOf())));
-
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(m_vertexBuffer_upload.GetAddressOf())));
-
-    D3D12_SUBRESOURCE_DATA subResourceData{};
-    subResourceData.pData = m_resourceManager->GetVertexBuffer().data();
-    subResourceData.RowPitch = vertexBufferSize;
-    subResourceData.SlicePitch = subResourceData.RowPitch;
-
-    commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_vertexBuffer_default.Get(),
-        D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-    UpdateSubresources(commandList, m_vertexBuffer_default.Get(), m_vertexBuffer_upload.Get(), 0, 0, 1, &subResourceData);
-    commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_vertexBuffer_default.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
-}
-
-void Scene::BuildIndexBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
-{
-    // Create the index buffer.
-    const UINT indexBufferSize = m_resourceManager->GetIndexBuffer().size() * sizeof(uint32_t);
-
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(indexBufferSize),
-        D3D12_RESOURCE_STATE_COMMON,
-        nullptr,
-        IID_PPV_ARGS(m_indexBuffer_default.GetAddressOf())));
-
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(indexBufferSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(m_indexBuffer_upload.GetAddressOf())));
+void Scene::BuildDescriptorHeap()
+{
+    //  (free-list) + Ӻ  .  ٽ  ʰ Ÿӿ 並    ִ.
+    m_descriptorHeap = m_parent->GetRenderDevice().CreateDescriptorHeap(RenderDescriptorType::CbvSrvUav, m_descriptorAllocator.GetHeapSize(), true);
 
-    D3D12_SUBRESOURCE_DATA subResourceData = {};
-    subResourceData.pData = m_resourceManager->GetIndexBuffer().data();
-    subResourceData.RowPitch = indexBufferSize;
-    subResourceData.SlicePitch = subResourceData.RowPitch;
+    m_commonCbvHandle = m_descriptorAllocator.Allocate(1);
+    m_textureTableHandle = m_descriptorAllocator.Allocate(MAX_TEXTURE); // bindless ̺ ӵ  Ѵ.
+    ThrowIfFailed(!m_commonCbvHandle.IsNull() && !m_textureTableHandle.IsNull());
+}
 
-    commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_indexBuffer_default.Get(),
-        D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-    UpdateSubresources(commandList, m_indexBuffer_default.Get(), m_indexBuffer_upload.Get(), 0, 0, 1, &subResourceData);
-    commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_indexBuffer_default.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+void Scene::BuildConstantBuffer()
+{
+    // ε ۴   ε ä д.
+    m_constantBuffer = m_parent->GetRenderDevice().CreateUploadBuffer(CalcConstantBufferByteSize(sizeof(CommonCB)));    // CB size is required to be 256-byte aligned.
 }
 
-void Scene::BuildVertexBufferView()
+void Scene::BuildConstantBufferView()
 {
-    // Initialize the vertex buffer view.
-    m_vertexBufferView.BufferLocation = m_vertexBuffer_default->GetGPUVirtualAddress();
-    m_vertexBufferView.StrideInBytes = sizeof(Vertex);
-    m_vertexBufferView.SizeInBytes = m_resourceManager->GetVertexBuffer().size() * sizeof(Vertex);
+    m_parent->GetRenderDevice().CreateConstantBufferView(m_constantBuffer.address, CalcConstantBufferByteSize(sizeof(CommonCB)), GetCpuDescriptorHandle(m_commonCbvHandle));
 }
 
-void Scene::BuildIndexBufferView()
+void Scene::BuildBonePalette(UINT64 size)
 {
-    m_indexBufferView.BufferLocation = m_indexBuffer_default->GetGPUVirtualAddress();
-    m_indexBufferView.Format = DXGI_FORMAT_R32_UINT;
-    m_indexBufferView.SizeInBytes = m_resourceManager->GetIndexBuffer().size() * sizeof(uint32_t);
+    // ִϸ̼ Ʈ   ȷƮ  ε  ϳ. Ʈ CB   ุ д.
+    // ٽ    ۸ д  ̹ Ƿ ٷ ´.  ׸  Ӹ .
+    RenderDevice& renderDevice = m_parent->GetRenderDevice();
+    if (m_bonePaletteBuffer.resource) renderDevice.Release(m_bonePaletteBuffer.resource);
+    m_bonePaletteBuffer = renderDevice.CreateUploadBuffer(size);
 }
 
-void Scene::BuildDescriptorHeap(ID3D12Device* device)
+UINT Scene::AddBonePalette(const vector<XMFLOAT4>& rows)
 {
-    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
-    HeapDesc.NumDescriptors = static_cast<UINT>(1 + m_DDSFileName.size() + 2); //  1 cbv ڿ 1 shdowmap
-    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    ThrowIfFailed(device->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(m_descriptorHeap.GetAddressOf())));
+    // ȷƮ ̹ 3x4   Ƿ ״ ̾ δ.
+    UINT offset = static_cast<UINT>(m_bonePalette.size());
+    m_bonePalette.insert(m_bonePalette.end(), rows.begin(), rows.end());
+    m_paletteObjects++;
+    return offset;
+}
 
-    m_cbvsrvuavDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+void Scene::UploadBonePalette()
+{
+    // ̹  ȷƮ   . ڸ ڶ ۸  辿 Ű.
+    if (m_bonePalette.empty()) return;
+    UINT64 size = m_bonePalette.size() * sizeof(XMFLOAT4);
+    if (size > m_bonePaletteBuffer.size) {
+        UINT64 capacity = m_bonePaletteBuffer.size;
+        while (capacity < size) capacity *= 2;
+        BuildBonePalette(capacity);
+    }
+    m_parent->GetRenderDevice().Write(m_bonePaletteBuffer, 0, m_bonePalette.data(), size);
+}
+
+ConstantMemoryStats Scene::GetConstantMemoryStats()
+{
+    ConstantMemoryStats stats;
+    for (Object* obj : m_objects) {
+        if (!obj->GetValid()) continue;
+        stats.objects++;
+        if (!obj->IsStatic()) stats.uploadObjects++;
+    }
+    stats.paletteBytes = m_bonePaletteBuffer.size;
+    stats.paletteUsedBytes = m_bonePalette.size() * sizeof(XMFLOAT4);
+    return stats;
+}
+
+void Scene::SetPreSkinning(bool enabled)
+{
+    m_preSkinning = enabled;
 }
 
-void Scene::BuildConstantBuffer(ID3D12Device* device)
+bool Scene::IsPreSkinning()
 {
-    const UINT constantBufferSize = CalcConstantBufferByteSize(sizeof(CommonCB));    // CB size is required to be 256-byte aligned.
+    return m_preSkinning;
+}
 
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(constantBufferSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_constantBuffer)));
+UINT Scene::AddSkinning(const SkinningRequest& request)
+{
+    return m_skinning.Add(request);
+}
 
-    // Map and initialize the constant buffer. We don't unmap this until the
-    // app closes. Keeping things mapped for the lifetime of the resource is okay.
-    CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
-    ThrowIfFailed(m_constantBuffer->Map(0, &readRange, &m_mappedData));
+void Scene::PreSkin(RenderDevice& renderDevice)
+{
+    // ȷƮ ܸ ٲǷ   ڷ  ٸ ۿ ִ  ״ ׸.
+    //  ̶   д ε ۸ ٷ ٽ ᵵ ȴ.
+    PROFILE_ZONE("Scene::PreSkin");
+    if (!m_preSkinning) return;
+    m_preSkinningStats.frames++;
+    if (!m_skinningDirty) return;
+    m_skinningDirty = false;
+
+    const UINT reserved = m_skinning.GetReservedVertexCount();
+    if (reserved == 0) return;
+    m_skinnedVertices.resize(reserved);
+    m_skinning.Execute(m_parent->GetJobSystem(), m_resourceManager->GetVertexBuffer().data(), m_bonePalette.data(), m_skinnedVertices.data());
+
+    UINT64 size = UINT64(reserved) * sizeof(SkinnedVertex);
+    if (size > m_skinnedVertexBuffer.size) {
+        UINT64 capacity = std::max<UINT64>(m_skinnedVertexBuffer.size, PRESKIN_BUFFER_VERTICES * sizeof(SkinnedVertex));
+        while (capacity < size) capacity *= 2;
+        if (m_skinnedVertexBuffer.resource) renderDevice.Release(m_skinnedVertexBuffer.resource);
+        m_skinnedVertexBuffer = renderDevice.CreateUploadBuffer(capacity);
+    }
+    renderDevice.Write(m_skinnedVertexBuffer, 0, m_skinnedVertices.data(), size);
+    m_preSkinningStats.skinnedObjects += m_skinning.GetRequests().size();
+    m_preSkinningStats.skinnedVertices += m_skinning.GetSkinnedVertexCount();
 }
 
-void Scene::BuildConstantBufferView(ID3D12Device* device)
+PreSkinningStats Scene::GetPreSkinningStats()
 {
-    // Describe and create a constant buffer view.
-    D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
-    cbvDesc.BufferLocation = m_constantBuffer->GetGPUVirtualAddress();
-    cbvDesc.SizeInBytes = CalcConstantBufferByteSize(sizeof(CommonCB));
+    return m_preSkinningStats;
+}
 
-    CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor(m_descriptorHeap->GetCPUDescriptorHandleForHeapStart());
-    hDescriptor.Offset(0, m_cbvsrvuavDescriptorSize);
+void Scene::ResetPreSkinningStats()
+{
+    m_preSkinningStats = {};
+}
 
-    device->CreateConstantBufferView(&cbvDesc, hDescriptor);
+void Scene::BuildTextures()
+{
+    //  б Ľ δ 忡, ε  ť óѴ. ̺ ü ÷̽Ȧ ä ΰ ε尡  Ը .
+    // ó TEXTURE_TAIL_SIZE   Ӹ ø,    UpdateTextureStreaming  ûѴ.
+    m_graphics->BuildTextures(m_descriptorHeap, m_textureTableHandle.index, MAX_TEXTURE, m_DDSFileName, TEXTURE_TAIL_SIZE);
+}
 
+void Scene::ProcessTextureLoads()
+{
+    // ε尡  ؽó   ְ   並 ٲ۴.
+    if (m_graphics) m_graphics->ProcessTextureLoads(m_textureResidency);
 }
 
-void Scene::BuildTextureBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* commandList)
+void Scene::UpdateTextureStreaming()
 {
-    // Create the texture.
-    for(auto& fileName: m_DDSFileName)
+    CameraObject* camera = GetObj<CameraObject>();
+    if (!camera || !m_graphics) return;
+
+    XMVECTOR eye = camera->GetComponent<Transform>()->GetPosition();
+    float pixelScale = m_viewport.height * 0.5f * m_proj._22; // Ÿ 1   1  ϴ ȼ 
+
+    // Ʈ ȭ鿡 ϴ ũ ؽó ʿ  Ѵ.
+    m_textureResidency.BeginFrame();
+    for (Object* obj : m_objects)
     {
-        ComPtr<ID3D12Resource> defaultBuffer;
-        ComPtr<ID3D12Resource> uploadBuffer;
-
-        // DDSTexture  ϴ 
-        unique_ptr<uint8_t[]> ddsData;
-        vector<D3D12_SUBRESOURCE_DATA> subresources;
-        ThrowIfFailed(LoadDDSTextureFromFile(device, fileName.c_str(), defaultBuffer.GetAddressOf(), ddsData, subresources));
-
-        //// DirectTex ϴ 
-        //ScratchImage image;
-        //TexMetadata metadata;
-
-        //ThrowIfFailed(LoadFromDDSFile(L"./Textures/grass.dds", DDS_FLAGS_NONE, &metadata, image));
-        ////metadata = image.GetMetadata(); // ڵ带 ϰ  ڵ 3° ڸ nullptr ص ȴ.
-
-        //ThrowIfFailed(CreateTexture(device, metadata, m_textureBuffer_default.GetAddressOf()));
-        //ThrowIfFailed(PrepareUpload(device, image.GetImages(), image.GetImageCount(), metadata, subresources));
-
-        const UINT64 uploadBufferSize = GetRequiredIntermediateSize(defaultBuffer.Get(), 0, subresources.size());
-        
-        OutputDebugStringA(string{ "current texture subresource size = " + to_string(subresources.size()) + "\n"}.c_str());
-        OutputDebugStringA(string{ "current texture mip level = " + to_string(defaultBuffer->GetDesc().MipLevels) + "\n"}.c_str());
-        OutputDebugStringA(string{ "current texture format = " + to_string(defaultBuffer->GetDesc().Format) + "\n"}.c_str());
-
-        // Create the GPU upload buffer.
-        ThrowIfFailed(device->CreateCommittedResource(
-            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-            D3D12_HEAP_FLAG_NONE,
-            &CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(uploadBuffer.GetAddressOf())));
-        
-        UpdateSubresources(commandList, defaultBuffer.Get(), uploadBuffer.Get(), 0, 0, static_cast<UINT>(subresources.size()), subresources.data());
-        commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
-
-        m_textureBuffer_defaults.push_back(move(defaultBuffer));
-        m_textureBuffer_uploads.push_back(move(uploadBuffer));
+        if (!obj->GetValid()) continue;
+        Texture* texture = obj->GetComponent<Texture>();
+        Mesh* mesh = obj->GetComponent<Mesh>();
+        Transform* transform = obj->GetComponent<Transform>();
+        if (!texture || !mesh || !transform) continue;
+
+        int slot = GetTextureIndex(texture->mName);
+        if (!m_textureResidency.Contains(slot)) continue;
+
+        XMMATRIX world = obj->GetModelM();
+
+        auto [localCenter, localRadius] = GetMeshBoundingSphere(mesh->mName);
+        float scale = 0.0f;
+        for (int i = 0; i < 3; ++i) scale = std::max<float>(scale, XMVectorGetX(XMVector3Length(world.r[i])));
+        float radius = localRadius * scale;
+        XMVECTOR center = XMVector3Transform(XMLoadFloat3(&localCenter), world);
+        float distance = std::max<float>(XMVectorGetX(XMVector3Length(center - eye)) - radius, 0.1f);
+
+        float screenPixels = 2.0f * radius / distance * pixelScale;
+        uint32_t mip = TextureResidency::ComputeRequiredMip(screenPixels, m_textureResidency.GetMipExtent(slot, 0), m_textureResidency.GetMipCount(slot));
+        m_textureResidency.RequestMip(slot, mip);
     }
-}
 
-void Scene::BuildTextureBufferView(ID3D12Device* device)
-{
-    // Describe and create a SRV for the texture.
-    for (int i = 0; i < m_DDSFileName.size(); ++i)
+    vector<ResidencyChange> changes;
+    m_textureResidency.Update(changes);
+    for (ResidencyChange& change : changes)
     {
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Format = m_textureBuffer_defaults[i]->GetDesc().Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels = m_textureBuffer_defaults[i]->GetDesc().MipLevels;
+        // maxSize  ū  ǳʶٹǷ change.mip    ؽó .
+        m_graphics->RequestTexture(change.slot, m_DDSFileName[change.slot], m_textureResidency.GetMipExtent(change.slot, change.mip));
+    }
+}
 
-        CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor(m_descriptorHeap->GetCPUDescriptorHandleForHeapStart());
-        hDescriptor.Offset(1 + i, m_cbvsrvuavDescriptorSize); // 1 + i   1 ǹ̴   constant buffer view  ̴.     
+std::pair<XMFLOAT3, float> Scene::GetMeshBoundingSphere(const string& meshName)
+{
+    auto it = m_meshBoundingSphere.find(meshName);
+    if (it != m_meshBoundingSphere.end()) return it->second;
 
-        device->CreateShaderResourceView(m_textureBuffer_defaults[i].Get(), &srvDesc, hDescriptor);
+    SubMeshData& data = m_resourceManager->GetSubMeshData(meshName);
+    vector<Vertex>& vertices = m_resourceManager->GetVertexBuffer();
+    BoundingSphere sphere{};
+    if (data.vertexCountPerInstance > 0)
+    {
+        BoundingSphere::CreateFromPoints(sphere, data.vertexCountPerInstance, &vertices[data.startVertexLocation].position, sizeof(Vertex));
     }
+    return m_meshBoundingSphere[meshName] = { sphere.Center, sphere.Radius };
 }
 
 UINT Scene::CalcConstantBufferByteSize(UINT byteSize)
@@ -1109,7 +1060,7 @@ UINT Scene::CalcConstantBufferByteSize(UINT byteSize)
     return (byteSize + 255) & ~255;
 }
 
-Framework* Scene::GetFramework()
+Simulation* Scene::GetSimulation()
 {
     return m_parent;
 }
@@ -1119,21 +1070,66 @@ UINT Scene::GetNumOfTexture()
     return static_cast<UINT>(m_DDSFileName.size());
 }
 
+
 void Scene::AddObj(Object* object)
 {
     if (m_object_queue_index > MAX_QUEUE - 1) throw; // 
     m_object_queue[m_object_queue_index++] = object;
 }
 
+void Scene::Defer(function<void()> command)
+{
+    SceneCommandBuffer* buffer = SceneCommandBuffer::GetCurrent();
+    if (buffer) buffer->Record(move(command));
+    else command();
+}
+
+void Scene::Spawn(function<Object*()> factory)
+{
+    // ڰ  ۸  id  Ƿ  ü   ̷.
+    Defer([this, factory = move(factory)]() { AddObj(factory()); });
+}
+
+void Scene::UpdateObjects(GameTimer& gTimer)
+{
+    // Ʈ  忡 Ѵ. ٸ Ʈ     а(Transform::GetStepStart*),
+    //  ٲٴ (//) ûũ  ִ  ۿ ߴٰ    ûũ  Ѵ.
+    // ûũ    ϹǷ    ϴ.
+    const size_t chunkCount = (m_objects.size() + UPDATE_JOB_CHUNK - 1) / UPDATE_JOB_CHUNK;
+    if (m_commandBuffers.size() < chunkCount) m_commandBuffers.resize(chunkCount);
+    m_parent->GetJobSystem().ParallelFor(m_objects.size(), UPDATE_JOB_CHUNK, [this, &gTimer](size_t begin, size_t end) {
+        SceneCommandBuffer::Scope scope{ m_commandBuffers[begin / UPDATE_JOB_CHUNK] };
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (!m_objects[i]->GetValid()) continue;
+            m_objects[i]->OnUpdate(gTimer);
+        }
+    });
+    for (size_t i = 0; i < chunkCount; ++i) m_commandBuffers[i].Execute();
+
+    // θ 踦    θ     ռϰ,   ٲ Ʈ ش.
+    for (Object* obj : m_objects)
+    {
+        if (!obj->GetValid()) continue;
+        obj->ResolveParent();
+    }
+    m_transformHierarchy.Update();
+    for (uint32_t node : m_transformHierarchy.GetChangedNodes())
+    {
+        m_transformObjects[node]->ApplyWorld(m_transformHierarchy.GetWorld(node));
+    }
+}
+
 void Scene::BuildProjMatrix()
 {
-    XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PI * 0.25f, m_viewport.Width / m_viewport.Height, 0.1f, 1000.0f);
+    XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PI * 0.25f, m_viewport.width / m_viewport.height, 0.1f, 1000.0f);
     XMStoreFloat4x4(&m_proj, proj);
+    m_projDirty = true;
 }
 
-std::unordered_map<std::string, ComPtr<ID3D12PipelineState>>& Scene::GetPSOs()
+RenderHandle Scene::GetPipeline(const std::string& name)
 {
-    return m_PSOs;
+    return m_pipelines.at(name);
 }
 
 void Scene::ProcessInput()
@@ -1149,7 +1145,20 @@ void Scene::LoadMeshAnimationTexture()
     m_resourceManager = make_unique<ResourceManager>();
     m_resourceManager->CreatePlane("Plane", 1000, 10);
     m_resourceManager->CreatePlane("HalfPlane", 500, 5);
-    m_resourceManager->CreateTerrain("HeightMap.raw", 50, 5, 50);
+    //  ޽ô HeightMap.raw  . Ÿ   (Ÿ ĳ) . Ÿ   ȯ ̸
+    // ũ ؽð ־,  ų ų HeightMap.raw  ȯ  ٲ ٽ ȯѴ.
+    // ׷      ޽ÿ   ʵ带 .
+    JobSystem& jobSystem = m_parent->GetJobSystem();
+    m_resourceManager->CreateTerrain(jobSystem, "HeightMap.raw", 50, 5, 50);
+    TerrainTileSource tileSource;
+    auto openCurrentTiles = [&]() {
+        return m_terrainTiles.Open(L"HeightMap.tiles") && m_terrainTiles.GetInfo().source == tileSource;
+    };
+    if (ResourceManager::GetTerrainTileSource("HeightMap.raw", 50, 5, tileSource) && !openCurrentTiles())
+    {
+        m_terrainTiles.Close();
+        if (!ResourceManager::ConvertTerrainToTiles(jobSystem, "HeightMap.raw", L"HeightMap.tiles", 50, 5) || !openCurrentTiles()) m_terrainTiles.Close();
+    }
     m_resourceManager->LoadFbx("1P(boy-idle).fbx", false, true);
     m_resourceManager->LoadFbx("boy_walk_fix.fbx", true, true);
     m_resourceManager->LoadFbx("boy_run_fix.fbx", true, true);
@@ -1188,90 +1197,99 @@ void Scene::LoadMeshAnimationTexture()
 
 
 
-    int i = 0;
     m_DDSFileName.push_back(L"./Textures/boy.dds");
-    m_texture_name_to_index.insert({ L"boy", i++ });
+    m_textureTable.Register(L"boy");
     m_DDSFileName.push_back(L"./Textures/bricks3.dds");
-    m_texture_name_to_index.insert({ L"bricks3", i++ });
+    m_textureTable.Register(L"bricks3");
     m_DDSFileName.push_back(L"./Textures/checkboard.dds");
-    m_texture_name_to_index.insert({ L"checkboard", i++ });
+    m_textureTable.Register(L"checkboard");
     m_DDSFileName.push_back(L"./Textures/grass.dds");
-    m_texture_name_to_index.insert({ L"grass", i++ });
+    m_textureTable.Register(L"grass");
     m_DDSFileName.push_back(L"./Textures/tile.dds");
-    m_texture_name_to_index.insert({ L"tile", i++ });
+    m_textureTable.Register(L"tile");
     m_DDSFileName.push_back(L"./Textures/god.dds");
-    m_texture_name_to_index.insert({ L"god", i++ });
+    m_textureTable.Register(L"god");
     m_DDSFileName.push_back(L"./Textures/sister.dds");
-    m_texture_name_to_index.insert({ L"sister", i++ });
+    m_textureTable.Register(L"sister");
     m_DDSFileName.push_back(L"./Textures/water1.dds");
-    m_texture_name_to_index.insert({ L"water1", i++ });
+    m_textureTable.Register(L"water1");
     m_DDSFileName.push_back(L"./Textures/PP_Color_Palette.dds");
-    m_texture_name_to_index.insert({ L"PP_Color_Palette", i++ });
+    m_textureTable.Register(L"PP_Color_Palette");
     m_DDSFileName.push_back(L"./Textures/tigercolor.dds");
-    m_texture_name_to_index.insert({ L"tigercolor", i++ });
+    m_textureTable.Register(L"tigercolor");
     m_DDSFileName.push_back(L"./Textures/stone.dds");
-    m_texture_name_to_index.insert({ L"stone", i++ });
+    m_textureTable.Register(L"stone");
     m_DDSFileName.push_back(L"./Textures/normaltree_texture.dds");
-    m_texture_name_to_index.insert({ L"normalTree", i++ });
+    m_textureTable.Register(L"normalTree");
     m_DDSFileName.push_back(L"./Textures/longtree_texture.dds");
-    m_texture_name_to_index.insert({ L"longTree", i++ });
+    m_textureTable.Register(L"longTree");
     m_DDSFileName.push_back(L"./Textures/rock(smooth).dds");
-    m_texture_name_to_index.insert({ L"rock", i++ });
+    m_textureTable.Register(L"rock");
     m_DDSFileName.push_back(L"./Textures/broken_house.dds");
-    m_texture_name_to_index.insert({ L"broken_house", i++ });
+    m_textureTable.Register(L"broken_house");
     m_DDSFileName.push_back(L"./Textures/broken_house2.dds");
-    m_texture_name_to_index.insert({ L"broken_house2", i++ });
+    m_textureTable.Register(L"broken_house2");
     m_DDSFileName.push_back(L"./Textures/Brown.dds");
-    m_texture_name_to_index.insert({ L"Brown", i++ });
+    m_textureTable.Register(L"Brown");
     m_DDSFileName.push_back(L"./Textures/tiger.dds");
-    m_texture_name_to_index.insert({ L"tigerLeather", i++ });
+    m_textureTable.Register(L"tigerLeather");
 }
 
 // Update frame-based values.
 void Scene::OnUpdate(GameTimer& gTimer)
 {
+    PROFILE_ZONE("Scene::OnUpdate");
     ProcessInput();
+    ProcessTextureLoads();
+    UpdateTerrainTiles();
     ProcessStageQueue();
     CompactObjects();
     ProcessObjectQueue();
-    for (Object* obj : m_objects)
-    {
-        if (!obj->GetValid()) continue;
-        obj->OnUpdate(gTimer);
-    }
+    UpdateObjects(gTimer);
 
-    m_shadow->UpdateShadow();
+    if (m_shadow) m_shadow->UpdateShadow();
 
-    // ̴ 
-    memcpy(static_cast<UINT8*>(m_mappedData) + sizeof(XMMATRIX), &XMMatrixTranspose(XMLoadFloat4x4(&m_proj)), sizeof(XMMATRIX)); // ó Ű ּ
+    // ̴ . ũⰡ ٲ ٽ   .
+    if (m_projDirty) {
+        XMMATRIX proj = XMMatrixTranspose(XMLoadFloat4x4(&m_proj));
+        WriteConstantBuffer(offsetof(CommonCB, proj), &proj, sizeof(XMMATRIX));
+        m_projDirty = false;
+    }
 }
 
 // Render the scene.
-void Scene::OnRender(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, ePass pass)
+void Scene::OnRender(RenderDevice& renderDevice, ePass pass)
 {
+    m_current_pass = pass;
     switch (pass)
     {
     case ePass::Shadow:
     {
-        commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-        ID3D12DescriptorHeap* ppHeaps[] = { m_descriptorHeap.Get() };
-        commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
-        commandList->SetGraphicsRootDescriptorTable(3, m_shadow->GetGpuDescHandleForNullShadow());
-        CD3DX12_GPU_DESCRIPTOR_HANDLE hDescriptor(m_descriptorHeap->GetGPUDescriptorHandleForHeapStart());
-        commandList->SetGraphicsRootDescriptorTable(0, hDescriptor);
-        commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
-        commandList->IASetIndexBuffer(&m_indexBufferView);
-        m_shadow->DrawShadowMap();
+        // ׸ н  ù н.  н   Ű  ⼭ .
+        PreSkin(renderDevice);
+        renderDevice.SetRootSignature(m_rootSignatureHandle);
+        renderDevice.SetDescriptorHeap(m_descriptorHeap.heap);
+        renderDevice.SetRootDescriptorTable(3, m_shadow->GetGpuDescHandleForNullShadow());
+        renderDevice.SetRootDescriptorTable(0, GetGpuDescriptorHandle(m_commonCbvHandle));
+        renderDevice.SetRootDescriptorTable(1, GetGpuDescriptorHandle(m_textureTableHandle)); // ؽó ̺ Ӵ   ε
+        // ȷƮ  Ӹ    . ۸ Ű ٽ    д   ʴ´.
+        m_bonePaletteView = m_descriptorAllocator.AllocateTransient(1);
+        ThrowIfFailed(m_bonePaletteView != UINT32_MAX);
+        renderDevice.CreateStructuredBufferView(m_bonePaletteBuffer, sizeof(XMFLOAT4), GetCpuDescriptorHandle(m_bonePaletteView));
+        renderDevice.SetRootDescriptorTable(4, GetGpuDescriptorHandle(m_bonePaletteView));
+        renderDevice.SetTriangleList();
+        renderDevice.SetVertexBuffer(m_vertexBuffer.address, static_cast<UINT>(m_vertexBuffer.size), sizeof(Vertex));
+        renderDevice.SetIndexBuffer(m_indexBuffer.address, static_cast<UINT>(m_indexBuffer.size));
+        m_shadow->DrawShadowMap(renderDevice);
         break;
     }
     case ePass::Default:
     {
-        commandList->RSSetViewports(1, &m_viewport);
-        commandList->RSSetScissorRects(1, &m_scissorRect);
-        commandList->SetPipelineState(m_PSOs.at("PSO_Opaque").Get());
-        commandList->SetGraphicsRootDescriptorTable(3, m_shadow->GetGpuDescHandleForShadow());
-        RenderObjects(device, commandList);
+        renderDevice.SetViewport(m_viewport);
+        renderDevice.SetScissor(m_scissorRect);
+        renderDevice.SetPipelineState(m_pipelines.at("PSO_Opaque"));
+        renderDevice.SetRootDescriptorTable(3, m_shadow->GetGpuDescHandleForShadow());
+        RenderObjects(renderDevice);
         break;
     }
     default:
@@ -1281,49 +1299,210 @@ void Scene::OnRender(ID3D12Device* device, ID3D12GraphicsCommandList* commandLis
 
 void Scene::OnResize(UINT width, UINT height)
 {
-    m_viewport = { CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f) };
-    m_scissorRect = { CD3DX12_RECT(0, 0, static_cast<LONG>(width), static_cast<LONG>(height)) };
+    m_viewport = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f };
+    m_scissorRect = { 0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height) };
     BuildProjMatrix();
 }
 
+void Scene::OnFrameEnd(UINT64 frameFenceValue, UINT64 completedFenceValue)
+{
+    //   ̹ ӿ  ũʹ GPU   ڿ Ѵ.
+    m_descriptorAllocator.FinishFrame(frameFenceValue);
+    m_descriptorAllocator.Retire(completedFenceValue);
+}
+
 void Scene::OnDestroy()
 {
-    m_constantBuffer->Unmap(0, nullptr);
+    if (m_constantBuffer.resource) m_parent->GetRenderDevice().Release(m_constantBuffer.resource);
+    m_constantBuffer = {};
+    if (m_bonePaletteBuffer.resource) m_parent->GetRenderDevice().Release(m_bonePaletteBuffer.resource);
+    m_bonePaletteBuffer = {};
+    if (m_skinnedVertexBuffer.resource) m_parent->GetRenderDevice().Release(m_skinnedVertexBuffer.resource);
+    m_skinnedVertexBuffer = {};
 }
 
 void Scene::OnProcessCollision()
 {
-    size_t objCount = m_objects.size();
-    for (int i = 0; i < objCount - 1; ++i)
+    PROFILE_ZONE("Scene::OnProcessCollision");
+    // 浹  ġ ű 浹 ڴ  OnUpdate  ŵǹǷ,  ܰ  ڴ  ʴ´.
+    // ׷ ħ ˻ /ħ   ķ    ,   ڿ  忡 Ѵ.
+    m_collisionBoxes.clear();
+    for (Object* obj : m_objects)
+    {
+        Collider* collider = obj->GetValid() ? obj->GetComponent<Collider>() : nullptr;
+        m_collisionBoxes.push_back(collider ? &collider->GetOBB() : nullptr);
+    }
+    FindContacts(m_parent->GetJobSystem(), m_collisionBoxes, m_contacts);
+
+    // (first, second)      . ռ   Ʈ ǳʶڴ.
+    for (const Contact& contact : m_contacts)
+    {
+        Object* obj = m_objects[contact.first];
+        Object* otherObj = m_objects[contact.second];
+        if (!obj->GetValid() || !otherObj->GetValid()) continue;
+        XMVECTOR normal = XMLoadFloat3(&contact.normal);
+        obj->OnProcessCollision(*otherObj, normal, contact.penetration);
+        otherObj->OnProcessCollision(*obj, -normal, contact.penetration);
+    }
+}
+
+CollisionSnapshot Scene::SaveCollisionSnapshot()
+{
+    CollisionSnapshot snapshot;
+    snapshot.stageQueue = m_stage_queue;
+    for (Object* obj : m_objects)
     {
-        if (!m_objects[i]->GetValid()) continue;
-        Object* obj = m_objects[i];
-        Collider* collider = obj->GetComponent<Collider>();
-        if (!collider) continue;
-        auto& OBB = collider->GetOBB();
-        for (int j = i + 1; j < objCount; ++j)
+        Transform* transform = obj->GetComponent<Transform>();
+        XMFLOAT3 position{};
+        if (transform) XMStoreFloat3(&position, transform->GetPosition());
+        snapshot.positions.push_back(position);
+        snapshot.valid.push_back(obj->GetValid());
+    }
+    return snapshot;
+}
+
+void Scene::RestoreCollisionSnapshot(const CollisionSnapshot& snapshot)
+{
+    // 浹  Ʈ ߰ϰų  ʰ ȿ ǥø ٲٹǷ  ״δ.
+    ThrowIfFailed(snapshot.positions.size() == m_objects.size());
+    m_stage_queue = snapshot.stageQueue;
+    for (size_t i = 0; i < m_objects.size(); ++i)
+    {
+        Transform* transform = m_objects[i]->GetComponent<Transform>();
+        if (transform) transform->SetPosition(XMLoadFloat3(&snapshot.positions[i]));
+        m_objects[i]->SetValid(snapshot.valid[i]);
+    }
+}
+
+void Scene::FindContacts(JobSystem& jobSystem, const vector<const BoundingOrientedBox*>& boxes, vector<Contact>& contacts)
+{
+    // ù °    ûũ  ûũ  . ûũ ȿ (first, second)  ̰
+    // ûũ    ϹǷ, ûũ  ̾ ̸ ׻  ĵ  ȴ.
+    const size_t count = boxes.size();
+    const size_t chunkCount = (count + COLLISION_JOB_CHUNK - 1) / COLLISION_JOB_CHUNK;
+    if (m_contactChunks.size() < chunkCount) m_contactChunks.resize(chunkCount);
+    jobSystem.ParallelFor(count, COLLISION_JOB_CHUNK, [&](size_t begin, size_t end) {
+        vector<Contact>& chunk = m_contactChunks[begin / COLLISION_JOB_CHUNK];
+        chunk.clear();
+        for (size_t i = begin; i < end; ++i)
         {
-            if (!m_objects[i]->GetValid()) break;
-            if (!m_objects[j]->GetValid()) continue;
-            Object* otherObj = m_objects[j];
-            Collider* otherCollider = otherObj->GetComponent<Collider>();
-            if (!otherCollider) continue;
-            auto& otherOBB = otherCollider->GetOBB();
-            if (!OBB.Intersects(otherOBB)) continue;
-            auto [normal, penetration] = GetCollisionData(OBB, otherOBB);
-            obj->OnProcessCollision(*otherObj, normal, penetration);
-            otherObj->OnProcessCollision(*obj, -normal, penetration);
+            if (!boxes[i]) continue;
+            for (size_t j = i + 1; j < count; ++j)
+            {
+                if (!boxes[j] || !boxes[i]->Intersects(*boxes[j])) continue;
+                auto [normal, penetration] = GetCollisionData(*boxes[i], *boxes[j]);
+                Contact contact{ static_cast<uint32_t>(i), static_cast<uint32_t>(j), {}, penetration };
+                XMStoreFloat3(&contact.normal, normal);
+                chunk.push_back(contact);
+            }
         }
+    });
+
+    contacts.clear();
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        contacts.insert(contacts.end(), m_contactChunks[i].begin(), m_contactChunks[i].end());
     }
 }
 
 void Scene::LateUpdate(GameTimer& gTimer)
 {
+    PROFILE_ZONE("Scene::LateUpdate");
+    ClampObjectsToBounds();
+    //    Ʈ ̶  ýۿ  ,    Ʒ  Ѵ.
+    m_parent->GetJobSystem().ParallelFor(m_objects.size(), ANIMATION_JOB_CHUNK, [this, &gTimer](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (!m_objects[i]->GetValid()) continue;
+            m_objects[i]->UpdateAnimation(gTimer);
+        }
+    });
+    m_bonePalette.clear();
+    m_paletteObjects = 0;
+    m_skinning.Reset();
     for (Object* obj : m_objects)
     {
         if (!obj->GetValid()) continue;
         obj->LateUpdate(gTimer);
     }
+    // ̸ Ű׵ Ʈ ȷƮ CPU Ŀθ д´. ε ޽ó Ű Ͽ  ø Ʈ
+    // ϳ  ̴ ȷƮ Ƿ ø. Ű   ׸ н  Ѵ.
+    if (m_skinning.GetRequests().size() < m_paletteObjects) UploadBonePalette();
+    m_skinningDirty = true;
+    UpdateTextureStreaming();
+}
+
+void Scene::BeginStep()
+{
+    // ̹      , ġ ȸ    ٸ Ʈ   .
+    for (Object* obj : m_objects)
+    {
+        if (!obj->GetValid()) continue;
+        obj->GetComponent<Transform>()->SaveStepStart();
+    }
+}
+
+void Scene::UpdateRenderTransforms(float alpha)
+{
+    for (Object* obj : m_objects)
+    {
+        if (!obj->GetValid()) continue;
+        obj->UpdateRenderTransform(alpha);
+    }
+}
+
+void Scene::UpdateTerrainTiles()
+{
+    // ÷̾ ֺ Ÿ ׶忡 ø,      ŸϺ .
+    if (!m_terrainTiles.IsOpen() || !m_terrainStage) return;
+    PlayerObject* player = GetObj<PlayerObject>();
+    if (!player) return;
+    XMFLOAT3 pos;
+    XMStoreFloat3(&pos, player->GetComponent<Transform>()->GetPosition());
+    m_terrainTiles.Update(pos.x, pos.z, TERRAIN_TILE_RADIUS);
+}
+
+void Scene::ClampObjectsToBounds()
+{
+    // ֻ Ʈ  ̸   ø     о ִ´.
+    m_clampObjects.clear();
+    m_clampPositions.clear();
+    for (Object* obj : m_objects)
+    {
+        if (!obj->GetValid() || obj->GetParentId() != -1) continue;
+        if (dynamic_cast<TerrainObject*>(obj)) continue;
+        Transform* transform = obj->GetComponent<Transform>();
+        if (!transform) continue;
+        XMFLOAT3 pos;
+        XMStoreFloat3(&pos, transform->GetPosition());
+        m_clampObjects.push_back(obj);
+        m_clampPositions.push_back(pos);
+    }
+    if (m_clampObjects.empty()) return;
+
+    auto bounds = GetBounds(0.0f, 0.0f);
+    m_clampHeights.assign(m_clampObjects.size(), std::get<1>(bounds));
+    if (m_terrainStage)
+    {
+        if (m_terrainTiles.IsOpen())
+            m_terrainTiles.SampleHeights(&m_clampPositions[0].x, m_clampPositions.size(), 3, m_clampHeights.data());
+        else
+            GetResourceManager().GetTerrainHeightField().SampleHeights(&m_clampPositions[0].x, m_clampPositions.size(), 3, m_clampHeights.data());
+    }
+
+    for (size_t i = 0; i < m_clampObjects.size(); ++i)
+    {
+        std::get<1>(bounds) = m_clampHeights[i];
+        XMVECTOR pos = XMLoadFloat3(&m_clampPositions[i]);
+        char outstatus = ClampToBounds(pos, XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f), bounds);
+        m_clampObjects[i]->GetComponent<Transform>()->SetPosition(pos);
+
+        Gravity* gravity = m_clampObjects[i]->GetComponent<Gravity>();
+        if ((outstatus & 0x04) && gravity)
+        {
+            gravity->ResetElapseTime();
+        }
+    }
 }
 
 ResourceManager& Scene::GetResourceManager()
@@ -1331,13 +1510,45 @@ ResourceManager& Scene::GetResourceManager()
     return *(m_resourceManager.get());
 }
 
-void* Scene::GetConstantBufferMappedData()
+TransformHierarchy& Scene::GetTransformHierarchy()
+{
+    return m_transformHierarchy;
+}
+
+void Scene::WriteConstantBuffer(UINT offset, const void* data, UINT size)
+{
+    m_parent->GetRenderDevice().Write(m_constantBuffer, offset, data, size);
+}
+
+const RenderDescriptorHeap& Scene::GetDescriptorHeap()
+{
+    return m_descriptorHeap;
+}
+
+DescriptorAllocator& Scene::GetDescriptorAllocator()
+{
+    return m_descriptorAllocator;
+}
+
+RenderDescriptor Scene::GetCpuDescriptorHandle(const DescriptorHandle& handle)
+{
+    // ̹  ڵ̸   ޶ ܸ .
+    ThrowIfFailed(m_descriptorAllocator.IsAlive(handle));
+    return GetCpuDescriptorHandle(handle.index);
+}
+
+RenderDescriptor Scene::GetGpuDescriptorHandle(const DescriptorHandle& handle)
+{
+    ThrowIfFailed(m_descriptorAllocator.IsAlive(handle));
+    return GetGpuDescriptorHandle(handle.index);
+}
+
+RenderDescriptor Scene::GetCpuDescriptorHandle(UINT heapIndex)
 {
-    // TODO: ⿡ return  մϴ.
-    return m_mappedData;
+    return m_descriptorHeap.GetCpu(heapIndex);
 }
 
-ID3D12DescriptorHeap* Scene::GetDescriptorHeap()
+RenderDescriptor Scene::GetGpuDescriptorHandle(UINT heapIndex)
 {
-    return m_descriptorHeap.Get();
+    return m_descriptorHeap.GetGpu(heapIndex);
 }
@@ -1,41 +1,147 @@
 #pragma once
-#include "stdafx.h"
+#include "CoreTypes.h"
 #include "Object.h"
 #include "ResourceManager.h"
 #include <utility>
 #include "Shadow.h"
+#include "TextureTable.h"
+#include "DescriptorAllocator.h"
+#include "SceneGraphics.h"
+#include "TextureResidency.h"
+#include "TerrainTileCache.h"
+#include "RenderDevice.h"
+#include "SceneCommandBuffer.h"
+#include "TransformHierarchy.h"
+#include "SkinningScheduler.h"
 #define MAX_QUEUE 700
+#define MAX_TEXTURE 64
+#define MAX_PERSISTENT_DESCRIPTOR 256
+#define MAX_TRANSIENT_DESCRIPTOR 256
+#define TEXTURE_STAGING_SIZE (32 * 1024 * 1024)
+#define TEXTURE_LOAD_THREAD 2
+#define TEXTURE_TAIL_SIZE 128
+#define TEXTURE_STREAMING_BUDGET (64 * 1024 * 1024)
+#define TERRAIN_TILE_BUDGET (128 * 1024 * 1024)
+#define TERRAIN_TILE_RADIUS 1000.0f
+#define UPDATE_JOB_CHUNK 16 // objects per job in OnUpdate, each chunk records into its own command buffer
+#define ANIMATION_JOB_CHUNK 8 // objects per job when LateUpdate computes bone palettes
+#define COLLISION_JOB_CHUNK 8 // collider rows per narrow-phase job
+#define BONE_PALETTE_SIZE 2048 // bones the shared palette buffer starts with, doubled when a step needs more
+#define PRESKIN_ANIMATED_OBJECTS 0 // 1 skins animated meshes once per frame on the CPU for both passes; 0 skins them in the vertex shaders. -preskinning turns it on
+#define PRESKIN_JOB_VERTICES 4096 // vertices per pre-skinning job
+#define PRESKIN_BUFFER_VERTICES 16384 // skinned vertices the transient buffer starts with, doubled when a frame needs more
 class GameTimer;
-class Framework;
+class Simulation;
+class JobSystem;
+
+// One overlapping collider pair from the narrow phase. first < second index the box list.
+struct Contact
+{
+    uint32_t first;
+    uint32_t second;
+    XMFLOAT3 normal; // from first towards second
+    float penetration;
+};
+
+// What the object constants and bone palettes of the current stage hold in memory.
+struct ConstantMemoryStats
+{
+    UINT objects = 0;             // each with its own constant buffer
+    UINT uploadObjects = 0;       // the ones in upload memory, the static rest is on the default heap
+    UINT64 paletteBytes = 0;      // shared bone palette buffer, upload memory
+    UINT64 paletteUsedBytes = 0;  // palettes written by the last step
+};
+
+// Pre-skinning totals since the last ResetPreSkinningStats. Every drawn vertex used to be skinned by the
+// vertex shader of its pass, so drawnVertices - skinnedVertices is the skinning work no longer repeated.
+struct PreSkinningStats
+{
+    UINT64 frames = 0;
+    UINT64 skinnedObjects = 0;
+    UINT64 skinnedVertices = 0;  // by the CPU kernel, once per frame and only after a step
+    UINT64 drawnVertices = 0;    // from the skinned buffer, over both passes
+};
+
+// What collision responses change: object positions, which objects are still valid and the queued stage.
+// The benchmarks restore it so every run of the collision phase starts from the same scene.
+struct CollisionSnapshot
+{
+    vector<XMFLOAT3> positions; // per object, the origin without a Transform
+    vector<bool> valid;
+    wstring stageQueue;
+};
 
 class Scene
 {
 public:
     ~Scene();
-    Scene(Framework* parent, UINT width, UINT height);
-    void OnInit(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
+    Scene(Simulation* parent, UINT width, UINT height);
+    // graphics 가 없으면(헤드리스) 셰이더, PSO, 텍스처 스트리밍 없이 기록용 디바이스에 명령만 남긴다.
+    void OnInit(unique_ptr<SceneGraphics> graphics);
     void OnUpdate(GameTimer& gTimer);
     void OnProcessCollision();
+    CollisionSnapshot SaveCollisionSnapshot();
+    void RestoreCollisionSnapshot(const CollisionSnapshot& snapshot);
     void LateUpdate(GameTimer& gTimer);
-    void OnRender(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, ePass pass);
+    void BeginStep();
+    void UpdateRenderTransforms(float alpha);
+    void OnRender(RenderDevice& renderDevice, ePass pass);
     void OnResize(UINT width, UINT height);
+    void OnFrameEnd(UINT64 frameFenceValue, UINT64 completedFenceValue);
     void OnDestroy();
     ResourceManager& GetResourceManager();
-    void* GetConstantBufferMappedData();
-    ID3D12DescriptorHeap* GetDescriptorHeap();
+    TransformHierarchy& GetTransformHierarchy();
+    void WriteConstantBuffer(UINT offset, const void* data, UINT size);
+    // Appends a bone palette for this step (three rows per bone, from SkinnedData::GetFinalPalette) and
+    // returns its first row for ObjectCB::paletteOffset. Called from Object::LateUpdate; the whole step is
+    // uploaded in one write afterwards.
+    UINT AddBonePalette(const vector<XMFLOAT4>& rows);
+    ConstantMemoryStats GetConstantMemoryStats();
+    // Pre-skinning: every animated mesh is skinned once per frame on the CPU into a transient vertex buffer
+    // and both passes draw the result. Object::LateUpdate registers its mesh with AddSkinning and gets its
+    // first vertex there; the shadow pass skins before it draws. Indexed meshes are not pre-skinned and stay
+    // on the shader, so the palette is still uploaded in any step that has one. Takes effect from the next step.
+    void SetPreSkinning(bool enabled);
+    bool IsPreSkinning();
+    UINT AddSkinning(const SkinningRequest& request);
+    PreSkinningStats GetPreSkinningStats();
+    void ResetPreSkinningStats();
+    const RenderDescriptorHeap& GetDescriptorHeap();
+    DescriptorAllocator& GetDescriptorAllocator();
+    RenderDescriptor GetCpuDescriptorHandle(const DescriptorHandle& handle);
+    RenderDescriptor GetGpuDescriptorHandle(const DescriptorHandle& handle);
+    RenderDescriptor GetCpuDescriptorHandle(UINT heapIndex);
+    RenderDescriptor GetGpuDescriptorHandle(UINT heapIndex);
     UINT CalcConstantBufferByteSize(UINT byteSize);
-    Framework* GetFramework();
+    Simulation* GetSimulation();
     UINT GetNumOfTexture();
     void AddObj(Object* object);
-    std::unordered_map<std::string, ComPtr<ID3D12PipelineState>>& GetPSOs();
-    void RenderObjects(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
+    // Scene changes made from Object::OnUpdate. While objects update in parallel they are recorded and
+    // applied after every object has updated; anywhere else they apply immediately.
+    void Defer(function<void()> command);
+    void Spawn(function<Object*()> factory);
+    RenderHandle GetPipeline(const std::string& name);
+    void RenderObjects(RenderDevice& renderDevice, eCaster caster = eCaster::All);
     char ClampToBounds(XMVECTOR& pos, XMVECTOR offset);
     std::tuple<float, float, float, float, float> GetBounds(float x, float z);
+    // Fraction along from -> to where the segment first touches the terrain. False when the stage has no
+    // terrain or the segment stays above it.
+    bool CastTerrainSegment(XMVECTOR from, XMVECTOR to, float* hitT);
     int GetTextureIndex(wstring name);
+    XMFLOAT4X4& GetProjMatrix();
+    ePass GetCurrentPass();
     std::tuple<XMVECTOR, float> GetCollisionData(BoundingOrientedBox OBB1, BoundingOrientedBox OBB2);
+    // Every intersecting pair of boxes (nullptr entries are skipped), tested in parallel. The list comes out
+    // sorted by (first, second) whatever the number of threads.
+    void FindContacts(JobSystem& jobSystem, const vector<const BoundingOrientedBox*>& boxes, vector<Contact>& contacts);
     Object* GetObjFromId(uint32_t id);
     uint32_t AllocateId();
     void SetStage(wstring stage);
+    // Static shadow cache: static objects report the world matrix they are drawn with, and anything else that
+    // changes what the static shadow map holds (the terrain's LOD selection) invalidates it.
+    void UpdateStaticCaster(uint32_t id, const XMFLOAT4X4& world);
+    void InvalidateStaticShadow();
+    const ShadowCache& GetShadowCache();
 
     template<typename T>
     T* GetObj()
@@ -53,67 +159,90 @@ private:
     void ProcessStageQueue();
     void CompactObjects();
     void ProcessObjectQueue();
+    void UpdateObjects(GameTimer& gTimer);
     void DeleteCurrentObjects();
     void ProcessInput();
     void LoadMeshAnimationTexture();
-    void BuildRootSignature(ID3D12Device* device);
-    void BuildPSO(ID3D12Device* device);
-    void BuildVertexBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
-    void BuildIndexBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
-    void BuildVertexBufferView();
-    void BuildIndexBufferView();
-    void BuildConstantBuffer(ID3D12Device* device);
-    void BuildConstantBufferView(ID3D12Device* device);
-    void BuildTextureBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* commandList);
-    void BuildTextureBufferView(ID3D12Device* device);
-    void BuildDescriptorHeap(ID3D12Device* device);
+    void BuildNullPipelines();
+    void BuildVertexBuffer();
+    void BuildIndexBuffer();
+    void BuildConstantBuffer();
+    void BuildConstantBufferView();
+    void BuildBonePalette(UINT64 size);
+    void UploadBonePalette();
+    void PreSkin(RenderDevice& renderDevice);
+    void BuildTextures();
+    void ProcessTextureLoads();
+    void UpdateTextureStreaming();
+    void UpdateTerrainTiles();
+    void ClampObjectsToBounds();
+    char ClampToBounds(XMVECTOR& pos, XMVECTOR offset, const std::tuple<float, float, float, float, float>& bounds);
+    std::pair<XMFLOAT3, float> GetMeshBoundingSphere(const string& meshName);
+    void BuildDescriptorHeap();
     void BuildProjMatrix();
     void BuildBaseStage();
     void BuildHuntingStage();
     void BuildGodStage();
     void BuildShadow();
-    void BuildShaders();
-    void BuildInputElement();
-    ComPtr<ID3DBlob> CompileShader(
-        const std::wstring& fileName, const D3D_SHADER_MACRO* defines, const std::string& entryPoint, const std::string& target);
 private:
-    Framework* m_parent = nullptr;
+    Simulation* m_parent = nullptr;
     wstring m_current_stage = L"Base";
+    bool m_terrainStage = false; // the stage stands on the height map: bounds, clamping and tile streaming follow it
     wstring m_stage_queue = L"";
     vector<Object*> m_objects;
     uint32_t m_id_counter = 0;
     Object* m_object_queue[MAX_QUEUE]{};
     int m_object_queue_index = 0;
+    vector<SceneCommandBuffer> m_commandBuffers; // one per OnUpdate chunk, executed in chunk order
+    TransformHierarchy m_transformHierarchy; // world matrices of every object in m_objects
+    vector<Object*> m_transformObjects; // indexed by hierarchy node
+    vector<const BoundingOrientedBox*> m_collisionBoxes; // per object, nullptr without a collider; reused every step
+    vector<Contact> m_contacts;
+    vector<vector<Contact>> m_contactChunks; // narrow-phase output per chunk before it is joined
     //
     unique_ptr<ResourceManager> m_resourceManager;
     //
-    CD3DX12_VIEWPORT m_viewport;
-    CD3DX12_RECT m_scissorRect;
-    ComPtr<ID3D12RootSignature> m_rootSignature;
-    std::unordered_map<std::string, ComPtr<ID3D12PipelineState>> m_PSOs;
-    std::unordered_map<std::string, ComPtr<ID3DBlob>> m_shaders;
+    RenderViewport m_viewport;
+    RenderRect m_scissorRect;
+    unique_ptr<SceneGraphics> m_graphics; // 루트 시그니처, PSO, 텍스처 로드. 헤드리스에는 없다
+    RenderHandle m_rootSignatureHandle = 0;
+    std::unordered_map<std::string, RenderHandle> m_pipelines;
     //
-    ComPtr<ID3D12DescriptorHeap> m_descriptorHeap;
-    UINT m_cbvsrvuavDescriptorSize;
+    RenderDescriptorHeap m_descriptorHeap;
+    DescriptorAllocator m_descriptorAllocator{ MAX_PERSISTENT_DESCRIPTOR, MAX_TRANSIENT_DESCRIPTOR };
+    DescriptorHandle m_commonCbvHandle;
+    DescriptorHandle m_textureTableHandle;
     //
-    ComPtr<ID3D12Resource> m_vertexBuffer_default;
-    ComPtr<ID3D12Resource> m_indexBuffer_default;
-    ComPtr<ID3D12Resource> m_vertexBuffer_upload;
-    ComPtr<ID3D12Resource> m_indexBuffer_upload;
-    D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
-    D3D12_INDEX_BUFFER_VIEW m_indexBufferView;
+    RenderBuffer m_vertexBuffer;
+    RenderBuffer m_indexBuffer;
     //
-    unordered_map<wstring, int> m_texture_name_to_index;
+    TextureTable m_textureTable{ MAX_TEXTURE };
     vector<wstring> m_DDSFileName;
-    vector<ComPtr<ID3D12Resource>> m_textureBuffer_defaults;
-    vector<ComPtr<ID3D12Resource>> m_textureBuffer_uploads;
+    TextureResidency m_textureResidency{ TEXTURE_STREAMING_BUDGET };
+    unordered_map<string, std::pair<XMFLOAT3, float>> m_meshBoundingSphere;
     //
-    ComPtr<ID3D12Resource> m_constantBuffer;
-    void* m_mappedData = nullptr;
+    vector<Object*> m_clampObjects; // scratch for the batched ground clamp, reused every frame
+    vector<XMFLOAT3> m_clampPositions;
+    vector<float> m_clampHeights;
+    TerrainTileCache m_terrainTiles{ TERRAIN_TILE_BUDGET }; // ground queries when open; the terrain mesh is built from HeightMap.raw
+    //
+    RenderBuffer m_constantBuffer;
+    RenderBuffer m_bonePaletteBuffer;
+    UINT m_bonePaletteView = UINT32_MAX; // heap index of this frame's palette view, in the descriptor ring
+    vector<XMFLOAT4> m_bonePalette; // rows of this step's palettes, three per bone
+    UINT m_paletteObjects = 0; // animated objects of this step; those without a skinning request read the palette in the shader
+    //
+    bool m_preSkinning = PRESKIN_ANIMATED_OBJECTS;
+    SkinningScheduler m_skinning{ PRESKIN_JOB_VERTICES }; // this step's meshes and their ranges in the skinned buffer
+    bool m_skinningDirty = false; // a step ran since the last PreSkin
+    vector<SkinnedVertex> m_skinnedVertices;
+    RenderBuffer m_skinnedVertexBuffer; // upload memory, rewritten at most once per frame
+    vector<Object*> m_preSkinnedObjects; // scratch for RenderObjects
+    PreSkinningStats m_preSkinningStats;
     //
     XMFLOAT4X4 m_proj;
+    bool m_projDirty = true; // set by BuildProjMatrix, cleared once the common CB has it
+    ePass m_current_pass = ePass::Default;
     //
     unique_ptr<Shadow> m_shadow = nullptr;
-
-    std::vector<D3D12_INPUT_ELEMENT_DESC> m_inputElement;
 };
@@ -0,0 +1,41 @@
+#include "SceneCommandBuffer.h"
+
+namespace
+{
+	thread_local SceneCommandBuffer* tCurrent = nullptr;
+}
+
+SceneCommandBuffer::Scope::Scope(SceneCommandBuffer& buffer) : mPrevious{ tCurrent }
+{
+	tCurrent = &buffer;
+}
+
+SceneCommandBuffer::Scope::~Scope()
+{
+	tCurrent = mPrevious;
+}
+
+SceneCommandBuffer* SceneCommandBuffer::GetCurrent()
+{
+	return tCurrent;
+}
+
+void SceneCommandBuffer::Record(std::function<void()> command)
+{
+	mCommands.push_back(std::move(command));
+}
+
+void SceneCommandBuffer::Execute()
+{
+	for (size_t i = 0; i < mCommands.size(); ++i)
+	{
+		std::function<void()> command = std::move(mCommands[i]);
+		command();
+	}
+	mCommands.clear();
+}
+
+size_t SceneCommandBuffer::GetCount() const
+{
+	return mCommands.size();
+}
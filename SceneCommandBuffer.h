@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+// Scene changes recorded while objects update in parallel, applied later on the main thread.
+// A job binds its own buffer with Scope for as long as it runs, so recording takes no locks.
+// Buffers are executed one after another in a fixed order, which keeps the merged result the
+// same however the jobs were spread over threads.
+class SceneCommandBuffer
+{
+public:
+	class Scope
+	{
+	public:
+		explicit Scope(SceneCommandBuffer& buffer);
+		~Scope();
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		SceneCommandBuffer* mPrevious;
+	};
+
+	// The buffer bound to the calling thread, nullptr when changes may apply immediately.
+	static SceneCommandBuffer* GetCurrent();
+
+	void Record(std::function<void()> command);
+	// Runs the commands in recording order and empties the buffer, keeping its capacity.
+	void Execute();
+	size_t GetCount() const;
+
+private:
+	std::vector<std::function<void()>> mCommands;
+};
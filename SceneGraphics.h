@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RenderDevice.h"
+
+class TextureResidency;
+
+// The part of a Scene that only exists with a real GPU: the root signature and pipelines it draws with, which
+// need compiled shaders, and the textures it streams from disk. Framework gives each scene a D3D12SceneGraphics;
+// headless runs (Simulation, and the Linux build) give none, and Scene then draws with fixed null pipeline
+// handles and never loads a texture.
+class SceneGraphics
+{
+public:
+	virtual ~SceneGraphics() = default;
+
+	// Returns the root signature and fills pipelines with every pipeline Scene draws with, by name.
+	virtual RenderHandle BuildPipelines(std::unordered_map<std::string, RenderHandle>& pipelines) = 0;
+	// Points the views heap[tableIndex, tableIndex + viewCount) at a placeholder and starts loading the tail mips
+	// (up to tailSize) of fileNames[slot] into each slot.
+	virtual void BuildTextures(const RenderDescriptorHeap& heap, uint32_t tableIndex, uint32_t viewCount,
+		const std::vector<std::wstring>& fileNames, uint32_t tailSize) = 0;
+	// Once per frame. Records every finished load in residency and points its view at the new texture.
+	virtual void ProcessTextureLoads(TextureResidency& residency) = 0;
+	// Loads fileName again into slot, skipping mips larger than maxSize.
+	virtual void RequestTexture(int slot, const std::wstring& fileName, uint32_t maxSize) = 0;
+};
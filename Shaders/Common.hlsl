@@ -1,9 +1,10 @@
 cbuffer WoldTranslate : register(b1)
 {
     float4x4 world;
-    float4x4 finalTranforms[90];
     int isAnimation;
-    int3 padding0;
+    int textureIndex;
+    uint paletteOffset;
+    int padding0;
     float powValue;
     float ambiantValue;
     float2 padding1;
@@ -17,12 +18,20 @@ cbuffer SceneConstantBuffer : register(b0)
     float4x4 lightTexCoord;
 };
 
-Texture2D Texture : register(t0);
+Texture2D Textures[] : register(t0, space1);
 Texture2D ShadowMap : register(t1);
+// Bone palettes of every animated object, three float4 rows (a 3x4 matrix) per bone.
+StructuredBuffer<float4> BonePalette : register(t2);
 
 SamplerState Sampler : register(s0);
 SamplerComparisonState SamplerShadowMap : register(s1);
 
+float3 SkinTransform(float4 v, int bone)
+{
+    uint row = paletteOffset + bone * 3;
+    return float3(dot(BonePalette[row], v), dot(BonePalette[row + 1], v), dot(BonePalette[row + 2], v));
+}
+
 
 //---------------------------------------------------------------------------------------
 // PCF for shadow mapping.
@@ -5,8 +5,10 @@ struct VSInput
     float3 position : POSITION;
     float3 normal : NORMAL;
     float2 uv : TEXCOORD;
+#ifndef PRESKINNED
     float4 weight : WEIGHT;
     int4 boneIndex : BONEINDEX;
+#endif
 };
 
 struct VSOutput
@@ -19,7 +21,7 @@ struct VSOutput
 
 VSOutput VS(VSInput input)
 {
-    
+#ifndef PRESKINNED // pre-skinned vertices arrive already skinned by Scene::PreSkin
     if (isAnimation == 1)
     {
         float3 pos = 0.0f;
@@ -27,13 +29,14 @@ VSOutput VS(VSInput input)
         
         for (int i = 0; i < 4; ++i)
         {
-            pos += input.weight[i] * mul(float4(input.position, 1.0f), finalTranforms[input.boneIndex[i]]).xyz;
-            normal += input.weight[i] * mul(float4(input.normal, 0.0f), finalTranforms[input.boneIndex[i]]).xyz;
+            pos += input.weight[i] * SkinTransform(float4(input.position, 1.0f), input.boneIndex[i]);
+            normal += input.weight[i] * SkinTransform(float4(input.normal, 0.0f), input.boneIndex[i]);
         }
         input.position = pos;
         normal = normalize(normal);
         input.normal = normal;
     }
+#endif
     
     VSOutput output;
     float4 posW = mul(float4(input.position, 1.0f), world);
@@ -52,6 +55,6 @@ float4 PS(VSOutput input) : SV_TARGET
     shadow = max(shadow, 0.6f);
     float4 lightVector = float4(0.0f, 1.0f, -0.3f, 0.0f);
     lightVector = normalize(lightVector);
-    float4 result = Texture.Sample(Sampler, input.uv) * (pow(max(dot(input.normal, lightVector), 0.f), powValue) + ambiantValue) * shadow;
+    float4 result = Textures[textureIndex].Sample(Sampler, input.uv) * (pow(max(dot(input.normal, lightVector), 0.f), powValue) + ambiantValue) * shadow;
     return result;
 }
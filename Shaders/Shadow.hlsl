@@ -3,8 +3,10 @@
 struct VertexIn
 {
     float3 position : POSITION;
+#ifndef PRESKINNED
     float4 weight : WEIGHT;
     int4 boneIndex : BONEINDEX;
+#endif
 };
 
 struct VertexOut
@@ -14,16 +16,18 @@ struct VertexOut
 
 VertexOut VS(VertexIn input)
 {
+#ifndef PRESKINNED // pre-skinned vertices arrive already skinned by Scene::PreSkin
     if (isAnimation == 1)
     {
         float3 pos = 0.0f;
         
         for (int i = 0; i < 4; ++i)
         {
-            pos += input.weight[i] * mul(float4(input.position, 1.0f), finalTranforms[input.boneIndex[i]]).xyz;
+            pos += input.weight[i] * SkinTransform(float4(input.position, 1.0f), input.boneIndex[i]);
         }
         input.position = pos;
     }
+#endif
 
     VertexOut vertexOut = (VertexOut)0.0f;
     float4 PosW = mul(float4(input.position, 1.0f), world);
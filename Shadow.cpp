@@ -1,34 +1,33 @@
 #include "Shadow.h"
 #include "Scene.h"
-#include "Framework.h"
-#include "DXSampleHelper.h"
+#include "Simulation.h"
+#include "Profiler.h"
 
 Shadow::Shadow(Scene* parent, UINT width, UINT height) :
 	mParent{ parent },
 	mWidth{ width },
 	mHeight{ height },
 	mViewport{ 0.f, 0.f, static_cast<float>(width), static_cast<float>(height), 0.f, 1.f },
-	mScissorRect{ 0, 0, static_cast<long>(width), static_cast<long>(height) },
+	mScissorRect{ 0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height) },
 	mSceneSphere{ XMFLOAT3{0.f,0.f,0.f}, 500.f }
 {
 	XMStoreFloat3(&mLightDirection, XMVector3Normalize(XMVECTOR{ 0.0f, -1.f, 0.3f }));
 
-	ID3D12DescriptorHeap* cbvSrvUavDescHeap = mParent->GetDescriptorHeap();
-	D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = cbvSrvUavDescHeap->GetCPUDescriptorHandleForHeapStart();
-	UINT descriptorHeapIndex = 1 + mParent->GetNumOfTexture();
-	ID3D12Device* device = mParent->GetFramework()->GetDevice();
-	UINT incrementSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	mSrvCpuHandle.ptr = cpuHandle.ptr + descriptorHeapIndex * incrementSize;
-	
-	D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = cbvSrvUavDescHeap->GetGPUDescriptorHandleForHeapStart();
-	mSrvGpuHandle.ptr = gpuHandle.ptr + descriptorHeapIndex * incrementSize;
-
-	mNullSrvCpuHandle.ptr = mSrvCpuHandle.ptr + 1 * incrementSize;
-	mNullSrvGpuHandle.ptr = mSrvGpuHandle.ptr + 1 * incrementSize;
-
-	cpuHandle = mParent->GetFramework()->GetDsvDescHeap()->GetCPUDescriptorHandleForHeapStart();
-	incrementSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
-	mDsvCpuHandle.ptr = cpuHandle.ptr + 1 * incrementSize;
+	// ũ ġ   ʰ Ҵڿ ޴´.
+	DescriptorAllocator& srvAllocator = mParent->GetDescriptorAllocator();
+	mSrvHandle = srvAllocator.Allocate();
+	mNullSrvHandle = srvAllocator.Allocate();
+	mSrvCpuHandle = mParent->GetCpuDescriptorHandle(mSrvHandle);
+	mSrvGpuHandle = mParent->GetGpuDescriptorHandle(mSrvHandle);
+	mNullSrvCpuHandle = mParent->GetCpuDescriptorHandle(mNullSrvHandle);
+	mNullSrvGpuHandle = mParent->GetGpuDescriptorHandle(mNullSrvHandle);
+
+	Simulation* framework = mParent->GetSimulation();
+	DescriptorAllocator& dsvAllocator = framework->GetDsvAllocator();
+	mDsvHandle = dsvAllocator.Allocate();
+	mStaticDsvHandle = dsvAllocator.Allocate();
+	mDsvCpuHandle = framework->GetDsvDescriptor(mDsvHandle);
+	mStaticDsvCpuHandle = framework->GetDsvDescriptor(mStaticDsvHandle);
 	
 	BuildResource();
 	BuildDescView();
@@ -37,11 +36,15 @@ Shadow::Shadow(Scene* parent, UINT width, UINT height) :
 void Shadow::UpdateShadow()
 {
 	PlayerObject* player = mParent->GetObj<PlayerObject>();
+	if (!player) return; // ÷̾      ״ .
 	Transform* transform = player->GetComponent<Transform>();
 	XMVECTOR pos = transform->GetPosition();
 	float posX = XMVectorGetX(pos);
 	float posZ = XMVectorGetZ(pos);
-	mSceneSphere.Center = { posX, 0.0f, posZ };
+	//   ÷̾ Ӱ谪 ̻   ű. ű  ĳð ȿȭȴ.
+	//    ߽θ Ƿ, ű ʾ  ۿ ִ  ״ .
+	if (!mCache.UpdateLightVolume({ posX, 0.0f, posZ })) return;
+	mSceneSphere.Center = mCache.GetCenter();
 	//ȸ Ǹ Framework   ð ͼ  ġ  ׸ڰ ǰ .
 	XMVECTOR lightDir = XMLoadFloat3(&mLightDirection);
 	XMVECTOR lightPos = -100.0f * mSceneSphere.Radius * lightDir;
@@ -76,39 +79,63 @@ void Shadow::UpdateShadow()
 	XMMATRIX finalTransformMatrix = lightViewMatrix * lightProjMatrix * textureMatrix;
 	XMStoreFloat4x4(&mFinalMatrix, finalTransformMatrix);
 
-	UINT8* mappedData = static_cast<UINT8*>(mParent->GetConstantBufferMappedData());
-	memcpy(mappedData + 2 * sizeof(XMFLOAT4X4), &XMMatrixTranspose(lightViewMatrix * lightProjMatrix), sizeof(XMMATRIX));
-	memcpy(mappedData + 3 * sizeof(XMFLOAT4X4), &XMMatrixTranspose(textureMatrix), sizeof(XMMATRIX));
+	XMMATRIX lightViewProj = XMMatrixTranspose(lightViewMatrix * lightProjMatrix);
+	XMMATRIX texture = XMMatrixTranspose(textureMatrix);
+	mParent->WriteConstantBuffer(2 * sizeof(XMFLOAT4X4), &lightViewProj, sizeof(XMMATRIX));
+	mParent->WriteConstantBuffer(3 * sizeof(XMFLOAT4X4), &texture, sizeof(XMMATRIX));
 }
 
-void Shadow::DrawShadowMap()
+void Shadow::DrawShadowMap(RenderDevice& renderDevice)
 {
-	ID3D12Device* device = mParent->GetFramework()->GetDevice();
-	ID3D12GraphicsCommandList* commandList = mParent->GetFramework()->GetCommandList();
-
-	commandList->RSSetViewports(1, &mViewport);
-	commandList->RSSetScissorRects(1, &mScissorRect);
-
-	D3D12_RESOURCE_BARRIER barrier{};
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.pResource = mShadowMap.Get();
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_DEPTH_WRITE;
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	commandList->ResourceBarrier(1, &barrier);
-
-	commandList->ClearDepthStencilView(mDsvCpuHandle, D3D12_CLEAR_FLAG_DEPTH| D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
-	commandList->OMSetRenderTargets(0, nullptr, false, &mDsvCpuHandle);
-	
-	auto& PSOs = mParent->GetPSOs();
-	commandList->SetPipelineState(PSOs["PSO_Shadow"].Get());
+	PROFILE_ZONE("Shadow::DrawShadowMap");
+	renderDevice.SetViewport(mViewport);
+	renderDevice.SetScissor(mScissorRect);
+	renderDevice.SetPipelineState(mParent->GetPipeline("PSO_Shadow"));
+
+	if (mCache.NeedsStaticRedraw())
+	{
+		DrawStaticShadowMap(renderDevice);
+		mCache.OnStaticRedrawn();
+	}
+
+	// ĳõ  ̿ ؼ    ü ׸.
+	renderDevice.Barrier(mShadowMap.resource, RenderState::GenericRead, RenderState::CopyDest);
+	renderDevice.CopyResource(mShadowMap.resource, mStaticShadowMap.resource);
+	renderDevice.Barrier(mShadowMap.resource, RenderState::CopyDest, RenderState::DepthWrite);
+
+	renderDevice.SetRenderTarget(0, mDsvCpuHandle);
+
+	mParent->RenderObjects(renderDevice, eCaster::Dynamic);
+
+	renderDevice.Barrier(mShadowMap.resource, RenderState::DepthWrite, RenderState::GenericRead);
+}
+
+void Shadow::DrawStaticShadowMap(RenderDevice& renderDevice)
+{
+	renderDevice.Barrier(mStaticShadowMap.resource, RenderState::CopySource, RenderState::DepthWrite);
+
+	renderDevice.ClearDepthStencil(mStaticDsvCpuHandle, 1.0f, 0);
+	renderDevice.SetRenderTarget(0, mStaticDsvCpuHandle);
 
-	mParent->RenderObjects(device, commandList);
+	mParent->RenderObjects(renderDevice, eCaster::Static);
 
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_DEPTH_WRITE;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
-	commandList->ResourceBarrier(1, &barrier);
+	renderDevice.Barrier(mStaticShadowMap.resource, RenderState::DepthWrite, RenderState::CopySource);
+}
+
+void Shadow::InvalidateStaticCache()
+{
+	mCache.Invalidate();
+}
+
+Shadow::~Shadow()
+{
+	RenderDevice& renderDevice = mParent->GetSimulation()->GetRenderDevice();
+	renderDevice.Release(mShadowMap.resource);
+	renderDevice.Release(mStaticShadowMap.resource);
+	mParent->GetDescriptorAllocator().Free(mSrvHandle);
+	mParent->GetDescriptorAllocator().Free(mNullSrvHandle);
+	mParent->GetSimulation()->GetDsvAllocator().Free(mDsvHandle);
+	mParent->GetSimulation()->GetDsvAllocator().Free(mStaticDsvHandle);
 }
 
 Scene* Shadow::GetScene()
@@ -116,77 +143,37 @@ Scene* Shadow::GetScene()
 	return mParent;
 }
 
-D3D12_GPU_DESCRIPTOR_HANDLE& Shadow::GetGpuDescHandleForShadow()
+ShadowCache& Shadow::GetCache()
+{
+	return mCache;
+}
+
+RenderDescriptor Shadow::GetGpuDescHandleForShadow()
 {
 	return mSrvGpuHandle;
 }
 
-D3D12_GPU_DESCRIPTOR_HANDLE& Shadow::GetGpuDescHandleForNullShadow()
+RenderDescriptor Shadow::GetGpuDescHandleForNullShadow()
 {
 	return mNullSrvGpuHandle;
 }
 
 void Shadow::BuildDescView()
 {
-	ID3D12Device* device = mParent->GetFramework()->GetDevice();
-
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-	srvDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.Texture2D.MostDetailedMip = 0;
-	srvDesc.Texture2D.MipLevels = 1;
-	srvDesc.Texture2D.PlaneSlice = 0;
-	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
-	device->CreateShaderResourceView(mShadowMap.Get(), &srvDesc, mSrvCpuHandle);
-
-	device->CreateShaderResourceView(nullptr, &srvDesc, mNullSrvCpuHandle);
-
-	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
-	dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
-	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-	dsvDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	dsvDesc.Texture2D.MipSlice = 0;
-	device->CreateDepthStencilView(mShadowMap.Get(), &dsvDesc, mDsvCpuHandle);
+	RenderDevice& renderDevice = mParent->GetSimulation()->GetRenderDevice();
+	renderDevice.CreateDepthShaderResourceView(&mShadowMap, mSrvCpuHandle);
+	renderDevice.CreateDepthShaderResourceView(nullptr, mNullSrvCpuHandle);
+	renderDevice.CreateDepthStencilView(mShadowMap, mDsvCpuHandle);
+	renderDevice.CreateDepthStencilView(mStaticShadowMap, mStaticDsvCpuHandle);
 }
 
 void Shadow::BuildResource()
 {
-
-	D3D12_HEAP_PROPERTIES heapProp{};
-	heapProp.Type = D3D12_HEAP_TYPE_DEFAULT;
-	heapProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN; // heapType custom 쿡 
-	heapProp.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN; // heapType custom 쿡 
-	heapProp.CreationNodeMask = 0x01; // Ƽ GPU ϰ Ư ̽ ÿ
-	heapProp.VisibleNodeMask = 0x01; // Ƽ GPU ϰ Ư ̽ ÿ
-	
-	D3D12_RESOURCE_DESC resourceDesc{};
-	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-	resourceDesc.Alignment = 0;
-	resourceDesc.Width = mWidth;
-	resourceDesc.Height = mHeight;
-	resourceDesc.DepthOrArraySize = 1;
-	resourceDesc.MipLevels = 1;
-	resourceDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
-	resourceDesc.SampleDesc.Count = 1;
-	resourceDesc.SampleDesc.Quality = 0;
-	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-	resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-
-	D3D12_CLEAR_VALUE clearValue{};
-	clearValue.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	clearValue.DepthStencil.Depth = 1.f;
-	clearValue.DepthStencil.Stencil = 0;
-
-	ID3D12Device* device = GetScene()->GetFramework()->GetDevice();
+	RenderDevice& renderDevice = mParent->GetSimulation()->GetRenderDevice();
 
 	// Depth stencil  Shader resource   ҽ 
-	ThrowIfFailed(device->CreateCommittedResource(
-		&heapProp,
-		D3D12_HEAP_FLAG_NONE,
-		&resourceDesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		&clearValue,
-		IID_PPV_ARGS(mShadowMap.GetAddressOf())
-	));
-}
\ No newline at end of file
+	mShadowMap = renderDevice.CreateDepthTexture(mWidth, mHeight, RenderState::GenericRead);
+
+	//  ĳô ҿ   · д.
+	mStaticShadowMap = renderDevice.CreateDepthTexture(mWidth, mHeight, RenderState::CopySource);
+}
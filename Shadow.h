@@ -1,6 +1,9 @@
 #pragma once
 #include <DirectXCollision.h>
-#include "stdafx.h"
+#include "CoreTypes.h"
+#include "ShadowCache.h"
+#include "DescriptorAllocator.h"
+#include "RenderDevice.h"
 
 class Scene;
 class Shadow
@@ -9,16 +12,19 @@ public:
 	Shadow(Scene* parent, UINT width, UINT height);
 	Shadow(const Shadow&) = delete;
 	Shadow& operator=(const Shadow&) = delete;
-	~Shadow() = default;
+	~Shadow();
 
 	void UpdateShadow();
-	void DrawShadowMap();
+	void DrawShadowMap(RenderDevice& renderDevice);
+	void InvalidateStaticCache();
 	Scene* GetScene();
-	D3D12_GPU_DESCRIPTOR_HANDLE& GetGpuDescHandleForShadow();
-	D3D12_GPU_DESCRIPTOR_HANDLE& GetGpuDescHandleForNullShadow();
+	ShadowCache& GetCache();
+	RenderDescriptor GetGpuDescHandleForShadow();
+	RenderDescriptor GetGpuDescHandleForNullShadow();
 private:
 	void BuildResource();
 	void BuildDescView();
+	void DrawStaticShadowMap(RenderDevice& renderDevice);
 private:
 	Scene* mParent = nullptr;
 
@@ -29,19 +35,27 @@ private:
 	XMFLOAT4X4 mTextureMatrix;
 	XMFLOAT4X4 mFinalMatrix;
 
-	D3D12_CPU_DESCRIPTOR_HANDLE mSrvCpuHandle;
-	D3D12_GPU_DESCRIPTOR_HANDLE mSrvGpuHandle;
-	D3D12_CPU_DESCRIPTOR_HANDLE mNullSrvCpuHandle;
-	D3D12_GPU_DESCRIPTOR_HANDLE mNullSrvGpuHandle;
-	D3D12_CPU_DESCRIPTOR_HANDLE mDsvCpuHandle;
+	DescriptorHandle mSrvHandle;
+	DescriptorHandle mNullSrvHandle;
+	DescriptorHandle mDsvHandle;
+	DescriptorHandle mStaticDsvHandle;
 
-	D3D12_VIEWPORT mViewport;
-	D3D12_RECT mScissorRect;
+	RenderDescriptor mSrvCpuHandle = 0;
+	RenderDescriptor mSrvGpuHandle = 0;
+	RenderDescriptor mNullSrvCpuHandle = 0;
+	RenderDescriptor mNullSrvGpuHandle = 0;
+	RenderDescriptor mDsvCpuHandle = 0;
+	RenderDescriptor mStaticDsvCpuHandle = 0;
+
+	RenderViewport mViewport;
+	RenderRect mScissorRect;
 
 	UINT mWidth = 0;
 	UINT mHeight = 0;
 
-	ComPtr<ID3D12Resource> mShadowMap = nullptr;
-	ComPtr<ID3D12Resource> mShadowPassBuffer = nullptr;
+	ShadowCache mCache;
+
+	RenderTexture mShadowMap;
+	RenderTexture mStaticShadowMap; // depth of static casters only, copied into mShadowMap each frame
 };
 
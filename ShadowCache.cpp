@@ -0,0 +1,87 @@
+#include "ShadowCache.h"
+#include <cmath>
+
+using namespace DirectX;
+
+ShadowCache::ShadowCache(float moveThreshold) : mMoveThreshold{ moveThreshold }
+{
+}
+
+bool ShadowCache::UpdateLightVolume(const XMFLOAT3& center)
+{
+	if (mHasCenter)
+	{
+		float dx = center.x - mCenter.x;
+		float dy = center.y - mCenter.y;
+		float dz = center.z - mCenter.z;
+		if (dx * dx + dy * dy + dz * dz < mMoveThreshold * mMoveThreshold) return false;
+	}
+
+	mCenter = center;
+	mHasCenter = true;
+	mDirty = true;
+	return true;
+}
+
+const XMFLOAT3& ShadowCache::GetCenter() const
+{
+	return mCenter;
+}
+
+void ShadowCache::UpdateStaticCaster(uint32_t id, const XMFLOAT4X4& world)
+{
+	mCasters[id] = world;
+	auto drawn = mDrawnCasters.find(id);
+	if (drawn == mDrawnCasters.end())
+	{
+		mDirty = true;
+		return;
+	}
+	for (int r = 0; r < 4; ++r)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			if (std::fabs(world.m[r][c] - drawn->second.m[r][c]) > SHADOW_STATIC_TOLERANCE) mDirty = true;
+		}
+	}
+}
+
+void ShadowCache::RemoveStaticCaster(uint32_t id)
+{
+	mCasters.erase(id);
+	if (mDrawnCasters.erase(id)) mDirty = true;
+}
+
+void ShadowCache::ClearStaticCasters()
+{
+	mCasters.clear();
+	mDrawnCasters.clear();
+	mDirty = true;
+}
+
+void ShadowCache::Invalidate()
+{
+	mDirty = true;
+}
+
+bool ShadowCache::NeedsStaticRedraw() const
+{
+	return mDirty;
+}
+
+void ShadowCache::OnStaticRedrawn()
+{
+	mDrawnCasters = mCasters;
+	mDirty = false;
+	++mStaticRedrawCount;
+}
+
+float ShadowCache::GetMoveThreshold() const
+{
+	return mMoveThreshold;
+}
+
+uint64_t ShadowCache::GetStaticRedrawCount() const
+{
+	return mStaticRedrawCount;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <unordered_map>
+
+#define SHADOW_STATIC_TOLERANCE 0.05f // how far a static caster may drift from where the cached map drew it before a redraw
+
+// Invalidation policy for the static-caster shadow map.
+// Keeps no D3D12 state so it can be driven without a device.
+class ShadowCache
+{
+public:
+	ShadowCache(float moveThreshold = 100.0f);
+
+	// Moves the light volume to center only when it drifted further than the threshold.
+	// Returns true when the volume moved (the static depth map is then invalid).
+	bool UpdateLightVolume(const DirectX::XMFLOAT3& center);
+	const DirectX::XMFLOAT3& GetCenter() const;
+
+	// Reports the world matrix a static caster is drawn with, whenever it changes. The map becomes invalid
+	// when the caster is new or any element differs by more than SHADOW_STATIC_TOLERANCE from the matrix
+	// the map was drawn with, so ground-clamp jitter of resting objects does not force a redraw every step.
+	void UpdateStaticCaster(uint32_t id, const DirectX::XMFLOAT4X4& world);
+	void RemoveStaticCaster(uint32_t id);
+	void ClearStaticCasters();
+
+	void Invalidate();
+	bool NeedsStaticRedraw() const;
+	void OnStaticRedrawn();
+
+	float GetMoveThreshold() const;
+	uint64_t GetStaticRedrawCount() const;
+
+private:
+	float mMoveThreshold = 100.0f;
+	DirectX::XMFLOAT3 mCenter{ 0.0f, 0.0f, 0.0f };
+	bool mHasCenter = false;
+	bool mDirty = true;
+	uint64_t mStaticRedrawCount = 0;
+	std::unordered_map<uint32_t, DirectX::XMFLOAT4X4> mCasters;      // latest world of every static caster
+	std::unordered_map<uint32_t, DirectX::XMFLOAT4X4> mDrawnCasters; // the worlds the cached map was drawn with
+};
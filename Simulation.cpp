@@ -0,0 +1,243 @@
+#include "Simulation.h"
+#include "SceneGraphics.h"
+#include "RecordingRenderDevice.h"
+#include "Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+Simulation::~Simulation()
+{
+    DeleteScenes();
+}
+
+void Simulation::OnInitHeadless(UINT width, UINT height, bool keepRenderLog)
+{
+    // â D3D12 ̽  ʴ´. ҽ  Ͽ ̽ ޾Ƽ ý ޸𸮿 ΰ α׷ .
+    m_headless = true;
+    auto recordingDevice = make_unique<RecordingRenderDevice>(keepRenderLog);
+    m_recordingDevice = recordingDevice.get();
+    m_renderDevice = move(recordingDevice);
+    BuildDsvDescriptorHeap();
+    BuildScenes(width, height);
+
+    m_stepTimer.Reset();
+}
+
+bool Simulation::RunHeadless(const HeadlessOptions& options)
+{
+    //    ܸ ִ   ùķ̼  .
+    // Է ũƮ  ȣ  ֹǷ  ũƮ ׻  ùķ̼ ȴ.
+    // recordFileName   ܸ  Ӿ Ͽ ̽ ׸  α׸ Ѵ.
+    // profileFileName   Ϸ Ѱ   Chrome trace  .
+    if (!options.scriptFileName.empty()) {
+        string error;
+        if (!m_inputScript.Load(options.scriptFileName, &error)) {
+            wstring message = L"headless: bad input script, " + wstring(error.begin(), error.end()) + L"\n";
+            OutputDebugStringW(message.c_str());
+            fputws(message.c_str(), stderr);
+            return false;
+        }
+    }
+    m_inputScript.Reset();
+
+    Scene& scene = *m_scenes.at(L"BaseScene");
+    const bool record = !options.recordFileName.empty();
+    const bool profile = !options.profileFileName.empty();
+    if (profile) {
+        Profiler::Clear();
+        Profiler::SetEnabled(true);
+    }
+    scene.ResetPreSkinningStats();
+    UINT64 steps = 0;
+    auto begin = chrono::steady_clock::now();
+    for (; steps < options.stepCount; ++steps) {
+        InputScript::StepEvents events = m_inputScript.Advance(steps);
+        if (events.quit) break;
+        if (!events.stage.empty()) scene.SetStage(events.stage);
+        if (record) RecordStep();
+        else Step();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    const UINT64 stepCount = steps;
+
+    wstring report = L"headless: " + to_wstring(stepCount) + L" steps in " + to_wstring(seconds) + L" s";
+    if (stepCount > 0 && seconds > 0.0) {
+        report += L", " + to_wstring(seconds * 1000.0 / stepCount) + L" ms/step, " + to_wstring(stepCount / seconds) + L" steps/s";
+    }
+    report += L"\n";
+
+    if (record) {
+        RenderFrameStats total = m_recordingDevice->GetStats().GetTotal();
+        const UINT64 frames = max<UINT64>(total.frame, 1);
+        report += L"render: " + to_wstring(total.frame) + L" frames, " + to_wstring(total.draws / frames) + L" draws/frame, "
+            + to_wstring(total.pipelineChanges / frames) + L" pipeline + " + to_wstring(total.bindingChanges / frames) + L" binding changes/frame, "
+            + to_wstring(total.redundantStates / frames) + L" redundant/frame, " + to_wstring(total.uploadBytes / frames) + L" upload bytes/frame\n";
+        // ̸ Ű:  н ׸ Ű   CPU   Ű   ŭ پ Ű ۾̴.
+        PreSkinningStats skinning = scene.GetPreSkinningStats();
+        if (skinning.frames > 0) {
+            report += L"preskin: " + to_wstring(skinning.skinnedObjects / skinning.frames) + L" objects/frame, "
+                + to_wstring(skinning.skinnedVertices / skinning.frames) + L" vertices skinned/frame, "
+                + to_wstring(skinning.drawnVertices / skinning.frames) + L" drawn/frame, "
+                + to_wstring((skinning.drawnVertices - min(skinning.drawnVertices, skinning.skinnedVertices)) / skinning.frames) + L" saved/frame\n";
+        }
+        if (!m_recordingDevice->SaveLog(options.recordFileName)) {
+            report += L"render: could not write " + options.recordFileName + L"\n";
+        }
+    }
+
+    if (profile) {
+        Profiler::SetEnabled(false);
+        string zones = Profiler::FormatZoneStats();
+        report += wstring(zones.begin(), zones.end());
+        if (!Profiler::SaveChromeTrace(options.profileFileName)) {
+            report += L"profile: could not write " + options.profileFileName + L"\n";
+        }
+    }
+    OutputDebugStringW(report.c_str());
+    fputws(report.c_str(), stdout);
+    fflush(stdout);
+    return true;
+}
+
+void Simulation::RenderHeadlessFrame()
+{
+    //  ۰ Ƿ  н  ۿ ׸.      ׸.
+    Scene& scene = *m_scenes.at(L"BaseScene");
+    scene.UpdateRenderTransforms(1.0f);
+
+    RenderDescriptor dsv = GetDsvDescriptor(m_mainDsvHandle);
+    scene.OnRender(*m_renderDevice, ePass::Shadow);
+    m_renderDevice->ClearDepthStencil(dsv, 1.0f, 0);
+    m_renderDevice->SetRenderTarget(0, dsv);
+    scene.OnRender(*m_renderDevice, ePass::Default);
+    m_renderDevice->EndFrame();
+    // Ͽ ̽  ٷ Ƿ, ̹   ũ͸ ٷ ´.
+    scene.OnFrameEnd(m_renderFrame, m_renderFrame);
+}
+
+void Simulation::RecordStep()
+{
+    m_renderDevice->BeginFrame(m_renderFrame++); // ܿ     ε .
+    Step();
+    RenderHeadlessFrame();
+}
+
+void Simulation::Step()
+{
+    PROFILE_ZONE("Simulation::Step");
+    m_stepTimer.Step(m_fixedTimestep.GetStep());
+    m_scenes.at(L"BaseScene")->BeginStep();
+    OnUpdate();
+    OnProcessCollision();
+    LateUpdate();
+}
+
+void Simulation::OnUpdate()
+{
+    ProcessInput();
+    m_scenes.at(L"BaseScene")->OnUpdate(m_stepTimer);
+}
+
+void Simulation::OnProcessCollision()
+{
+    m_scenes.at(L"BaseScene")->OnProcessCollision();
+}
+
+void Simulation::LateUpdate()
+{
+    m_scenes.at(L"BaseScene")->LateUpdate(m_stepTimer);
+}
+
+void Simulation::BuildDsvDescriptorHeap()
+{
+    // shadow map  Shadow   ҴѴ.
+    m_dsvHeap = m_renderDevice->CreateDescriptorHeap(RenderDescriptorType::Dsv, m_dsvAllocator.GetHeapSize(), false);
+    m_mainDsvHandle = m_dsvAllocator.Allocate();
+}
+
+void Simulation::BuildScenes(UINT width, UINT height)
+{
+    UINT workerCount = JOB_WORKER_THREAD;
+    if (workerCount == 0) workerCount = max<UINT>(thread::hardware_concurrency(), 2) - 1;
+    m_jobSystem = make_unique<JobSystem>(workerCount);
+
+    wstring name = L"BaseScene";
+    m_scenes.emplace(name, new Scene{ this, width, height });
+    m_scenes.at(name)->OnInit(CreateSceneGraphics());
+    m_currentSceneName = name;
+}
+
+void Simulation::DeleteScenes()
+{
+    for (auto [key, value] : m_scenes) {
+        delete value;
+    }
+    m_scenes.clear();
+}
+
+unique_ptr<SceneGraphics> Simulation::CreateSceneGraphics()
+{
+    return nullptr;
+}
+
+void Simulation::ReadKeyState(BYTE* keyState)
+{
+    m_inputScript.GetKeyState(keyState);
+}
+
+void Simulation::ProcessInput()
+{
+    // ̹  Ű .  ܿ  ִ Ű 0x08  ؼ   Ű Ѵ.
+    static const int keySize = 256;
+    static BYTE keyState[keySize]{};
+    ReadKeyState(keyState);
+
+    for (int i = 0; i < keySize; ++i)
+    {
+        if (mKeyState[i] & 0x80) keyState[i] |= 0x08;
+    }
+    memcpy(mKeyState, keyState, keySize);
+}
+
+Scene& Simulation::GetScene(const wstring& name)
+{
+    return *m_scenes.at(name);
+}
+
+const wstring& Simulation::GetCurrentSceneName()
+{
+    return m_currentSceneName;
+}
+
+RenderDevice& Simulation::GetRenderDevice()
+{
+    return *m_renderDevice;
+}
+
+JobSystem& Simulation::GetJobSystem()
+{
+    return *m_jobSystem;
+}
+
+DescriptorAllocator& Simulation::GetDsvAllocator()
+{
+    return m_dsvAllocator;
+}
+
+RenderDescriptor Simulation::GetDsvDescriptor(const DescriptorHandle& handle)
+{
+    ThrowIfFailed(m_dsvAllocator.IsAlive(handle));
+    return m_dsvHeap.GetCpu(handle.index);
+}
+
+BYTE* Simulation::GetKeyState()
+{
+    return mKeyState;
+}
+
+bool Simulation::IsHeadless()
+{
+    return m_headless;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "CoreTypes.h"
+#include "Scene.h"
+#include "GameTimer.h"
+#include "FixedTimestep.h"
+#include "InputScript.h"
+#include "RenderDevice.h"
+#include "JobSystem.h"
+#define SIMULATION_STEP (1.0 / 60.0)
+#define MAX_SIMULATION_SUBSTEPS 5
+#define JOB_WORKER_THREAD 0 // workers for the update phases, 0 uses one less than the hardware threads
+
+class RecordingRenderDevice;
+class SceneGraphics;
+
+struct HeadlessOptions
+{
+	UINT64 stepCount = 0;
+	wstring scriptFileName;  // InputScript; empty runs without input
+	wstring recordFileName;  // render log; empty skips rendering
+	wstring profileFileName; // Chrome trace; empty leaves the profiler off
+};
+
+// The fixed-step loop and the scenes, without a window or a GPU. Headless runs use it directly, with the
+// recording null device (HeadlessMain.cpp, which is the Linux target in CMakeLists.txt); Framework derives
+// from it and adds the window, the D3D12 device and the swap chain.
+class Simulation
+{
+public:
+	virtual ~Simulation();
+	// keepRenderLog = false only counts draws, for runs that render many frames without saving a log.
+	void OnInitHeadless(UINT width, UINT height, bool keepRenderLog = true);
+	bool RunHeadless(const HeadlessOptions& options);
+	void Step();
+	// One step and its frame on the recording device; headless only.
+	void RecordStep();
+	void OnUpdate();
+	void OnProcessCollision();
+	void LateUpdate();
+
+	Scene& GetScene(const wstring& name);
+	const wstring& GetCurrentSceneName();
+	RenderDevice& GetRenderDevice();
+	JobSystem& GetJobSystem();
+	DescriptorAllocator& GetDsvAllocator();
+	RenderDescriptor GetDsvDescriptor(const DescriptorHandle& handle);
+	BYTE* GetKeyState();
+	bool IsHeadless();
+
+protected:
+	// This step's key state: the input script headless, the keyboard in a window.
+	virtual void ReadKeyState(BYTE* keyState);
+	virtual void ProcessInput();
+	// What each scene gets for its pipelines and textures; none headless.
+	virtual unique_ptr<SceneGraphics> CreateSceneGraphics();
+
+	void BuildDsvDescriptorHeap();
+	void BuildScenes(UINT width, UINT height);
+	void RenderHeadlessFrame();
+	void DeleteScenes();
+
+	GameTimer m_stepTimer; // advanced by SIMULATION_STEP per step, what the scene sees
+	FixedTimestep m_fixedTimestep{ SIMULATION_STEP, MAX_SIMULATION_SUBSTEPS };
+
+	bool m_headless = false; // no window and no device; the scene only simulates
+
+	InputScript m_inputScript; // key state for headless runs
+
+	static const UINT DsvDescriptorCount = 8;
+
+	// Everything the scene draws goes through here: D3D12 in a window, the recording null device headless.
+	unique_ptr<RenderDevice> m_renderDevice;
+	RecordingRenderDevice* m_recordingDevice = nullptr; // same object as m_renderDevice when headless
+	UINT64 m_renderFrame = 0;
+
+	unique_ptr<JobSystem> m_jobSystem; // shared by the scenes' update phases
+
+	RenderDescriptorHeap m_dsvHeap;
+	DescriptorAllocator m_dsvAllocator{ DsvDescriptorCount };
+	DescriptorHandle m_mainDsvHandle;
+
+	unordered_map<wstring, Scene*> m_scenes;
+	wstring m_currentSceneName;
+
+	BYTE mKeyState[256]{};
+};
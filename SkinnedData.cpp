@@ -1,6 +1,12 @@
 #include "SkinnedData.h"
 #include "MathHelper.h"
+#include <cmath>
 
+namespace
+{
+	// GetFinalTransforms   ۾ 忡 ÿ Ҹ. Ź Ҵ ʵ 帶 д.
+	thread_local std::vector<XMFLOAT4X4> tToRootTransforms;
+}
 
 Keyframe::Keyframe()
 	: TimePos(0.0f),
@@ -134,50 +140,136 @@ void SkinnedData::Set(std::vector<int>& boneHierarchy,
 	mBoneHierarchy = boneHierarchy;
 	mBoneOffsets   = boneOffsets;
 	mAnimations    = animations;
+	if (mBoneOffsets.empty()) return;
+
+	//   ( -90 ȸ ϴ )   ø ΰ,  ڿ Ѵ.
+	XMMATRIX adjustRotXM = XMMatrixRotationX(XMConvertToRadians(-90.0f));
+	std::unordered_map<std::string, std::vector<XMFLOAT4X4>> reference;
+	std::vector<XMFLOAT4X4> finalTransforms(mBoneOffsets.size());
+	for (auto& [clipName, clip] : mAnimations) {
+		std::vector<XMFLOAT4X4>& samples = reference[clipName];
+		for (int k = 0; k < AXIS_FOLD_SAMPLES; ++k) {
+			float t = clip.GetClipStartTime() + (clip.GetClipEndTime() - clip.GetClipStartTime()) * k / (AXIS_FOLD_SAMPLES - 1);
+			GetFinalTransforms(clipName, t, finalTransforms);
+			for (const XMFLOAT4X4& m : finalTransforms) {
+				samples.emplace_back();
+				XMStoreFloat4x4(&samples.back(), XMMatrixTranspose(XMMatrixTranspose(XMLoadFloat4x4(&m)) * adjustRotXM));
+			}
+		}
+	}
+
+	FoldAxisCorrection();
+	mAxisFoldError = MeasureAxisFold(reference);
 }
- 
-void SkinnedData::GetFinalTransforms(const std::string& clipName, float timePos,  std::vector<XMFLOAT4X4>& finalTransforms)const
+
+void SkinnedData::FoldAxisCorrection()
+{
+	// ִϸ̼Ǹ ϸ x   90 ȸѴ.   Ź x  -90 ȸ ,
+	// Ѹ  ȯ ڿ ϴ ȸ̹Ƿ Ѹ  Űӿ   ־ θ ȴ.
+	// S * Q * T(P) * R = S * (Q * R) * T(P * R) ̰,  ȸ R  slerp/lerp  ȯȴ.
+	XMMATRIX adjustRotXM = XMMatrixRotationX(XMConvertToRadians(-90.0f));
+	XMVECTOR adjustRotQ = XMQuaternionRotationMatrix(adjustRotXM);
+	for (auto& [clipName, clip] : mAnimations) {
+		for (UINT i = 0; i < clip.BoneAnimations.size() && i < mBoneHierarchy.size(); ++i) {
+			if (mBoneHierarchy[i] >= 0) continue;
+			for (Keyframe& keyframe : clip.BoneAnimations[i].Keyframes) {
+				XMVECTOR Q = XMQuaternionMultiply(XMLoadFloat4(&keyframe.RotationQuat), adjustRotQ);
+				XMVECTOR P = XMVector3Transform(XMLoadFloat3(&keyframe.Translation), adjustRotXM);
+				XMStoreFloat4(&keyframe.RotationQuat, Q);
+				XMStoreFloat3(&keyframe.Translation, P);
+			}
+		}
+	}
+}
+
+float SkinnedData::MeasureAxisFold(const std::unordered_map<std::string, std::vector<XMFLOAT4X4>>& reference)const
+{
+	float error = 0.0f;
+	std::vector<XMFLOAT4> palette;
+	for (auto& [clipName, samples] : reference) {
+		const AnimationClip& clip = mAnimations.at(clipName);
+		for (int k = 0; k < AXIS_FOLD_SAMPLES; ++k) {
+			float t = clip.GetClipStartTime() + (clip.GetClipEndTime() - clip.GetClipStartTime()) * k / (AXIS_FOLD_SAMPLES - 1);
+			GetFinalPalette(clipName, t, palette);
+			for (size_t bone = 0; bone < mBoneOffsets.size(); ++bone) {
+				const XMFLOAT4X4& expected = samples[k * mBoneOffsets.size() + bone];
+				for (int row = 0; row < 3; ++row) {
+					const float* a = &expected.m[row][0];
+					const float* b = &palette[bone * 3 + row].x;
+					for (int col = 0; col < 4; ++col) {
+						error = MathHelper::Max(error, fabsf(a[col] - b[col]) / MathHelper::Max(1.0f, fabsf(a[col])));
+					}
+				}
+			}
+		}
+	}
+	return error;
+}
+
+float SkinnedData::GetAxisFoldError()const
+{
+	return mAxisFoldError;
+}
+
+const std::vector<XMFLOAT4X4>& SkinnedData::GetToRootTransforms(const std::string& clipName, float timePos)const
 {
 	UINT numBones = mBoneOffsets.size();
-	//finalTransforms.resize(numBones);
-	std::vector<XMFLOAT4X4> toParentTransforms(numBones);
+	std::vector<XMFLOAT4X4>& toRootTransforms = tToRootTransforms;
+	toRootTransforms.resize(numBones);
 
 	// Interpolate all the bones of this clip at the given time instance.
-	auto clip = mAnimations.at(clipName);
-	clip.Interpolate(timePos, toParentTransforms);
+	const AnimationClip& clip = mAnimations.at(clipName);
+	clip.Interpolate(timePos, toRootTransforms);
 
 	//
 	// Traverse the hierarchy and transform all the bones to the root space.
+	// Parents come before their children, so the to-parent transforms are replaced in place.
+	// A root bone has no parent, so its toRootTransform is just its local bone transform.
 	//
-
-	std::vector<XMFLOAT4X4> toRootTransforms(numBones);
-
-	// The root bone has index 0.  The root bone has no parent, so its toRootTransform
-	// is just its local bone transform.
-	toRootTransforms[0] = toParentTransforms[0];
-
-	// Now find the toRootTransform of the children.
-	for(UINT i = 1; i < numBones; ++i)
+	for(UINT i = 0; i < numBones; ++i)
 	{
-		XMMATRIX toParent = XMLoadFloat4x4(&toParentTransforms[i]);
-
 		int parentIndex = mBoneHierarchy[i];
+		if (parentIndex < 0) continue;
+
+		XMMATRIX toParent = XMLoadFloat4x4(&toRootTransforms[i]);
 		XMMATRIX parentToRoot = XMLoadFloat4x4(&toRootTransforms[parentIndex]);
 
 		XMMATRIX toRoot = XMMatrixMultiply(toParent, parentToRoot);
 
 		XMStoreFloat4x4(&toRootTransforms[i], toRoot);
 	}
+	return toRootTransforms;
+}
+ 
+void SkinnedData::GetFinalTransforms(const std::string& clipName, float timePos,  std::vector<XMFLOAT4X4>& finalTransforms)const
+{
+	const std::vector<XMFLOAT4X4>& toRootTransforms = GetToRootTransforms(clipName, timePos);
 
 	// Premultiply by the bone offset transform to get the final transform.
-	for(UINT i = 0; i < numBones; ++i)
+	for(UINT i = 0; i < mBoneOffsets.size(); ++i)
 	{
 		XMMATRIX offset = XMLoadFloat4x4(&mBoneOffsets[i]);
 		XMMATRIX toRoot = XMLoadFloat4x4(&toRootTransforms[i]);
-        XMMATRIX finalTransform = XMMatrixMultiply(offset, toRoot);
+		XMMATRIX finalTransform = XMMatrixMultiply(offset, toRoot);
 
-		// ִϸ̼Ǹ ϸ x   90 ȸ  ׷ 𸣰.  x  -90 ȸŴ.
-		XMMATRIX adjustRotXM = XMMatrixRotationX(XMConvertToRadians(-90.0f));
-		XMStoreFloat4x4(&finalTransforms[i], XMMatrixTranspose(finalTransform * adjustRotXM));
+		XMStoreFloat4x4(&finalTransforms[i], XMMatrixTranspose(finalTransform));
 	}
-}
\ No newline at end of file
+}
+
+void SkinnedData::GetFinalPalette(const std::string& clipName, float timePos, std::vector<XMFLOAT4>& palette)const
+{
+	const std::vector<XMFLOAT4X4>& toRootTransforms = GetToRootTransforms(clipName, timePos);
+
+	// ġϸ   ׻ (0, 0, 0, 1) ̹Ƿ   ุ .
+	palette.resize(mBoneOffsets.size() * 3);
+	for(UINT i = 0; i < mBoneOffsets.size(); ++i)
+	{
+		XMMATRIX offset = XMLoadFloat4x4(&mBoneOffsets[i]);
+		XMMATRIX toRoot = XMLoadFloat4x4(&toRootTransforms[i]);
+		XMMATRIX finalTransform = XMMatrixTranspose(XMMatrixMultiply(offset, toRoot));
+
+		XMStoreFloat4(&palette[i * 3 + 0], finalTransform.r[0]);
+		XMStoreFloat4(&palette[i * 3 + 1], finalTransform.r[1]);
+		XMStoreFloat4(&palette[i * 3 + 2], finalTransform.r[2]);
+	}
+}
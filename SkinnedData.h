@@ -1,11 +1,14 @@
+#pragma once
 //#ifndef SKINNEDDATA_H
 //#define SKINNEDDATA_H
 
 #include <vector>
 #include <DirectXMath.h>
-#include <Windows.h>
+#include "CoreTypes.h"
 #include <string>
 #include <unordered_map>
+#define AXIS_FOLD_SAMPLES 8 // samples per clip when Set checks the folded axis correction
+#define AXIS_FOLD_TOLERANCE 1e-4f // relative error above which the benchmark run fails
 
 
 using namespace DirectX;
@@ -65,6 +68,7 @@ public:
 	float GetClipStartTime(const std::string& clipName)const;
 	float GetClipEndTime(const std::string& clipName)const;
 
+	// Also folds the model's axis correction into the root keyframes, see FoldAxisCorrection.
 	void Set(
 		std::vector<int>& boneHierarchy, 
 		std::vector<DirectX::XMFLOAT4X4>& boneOffsets,
@@ -76,13 +80,34 @@ public:
     void GetFinalTransforms(const std::string& clipName, float timePos,
 		 std::vector<DirectX::XMFLOAT4X4>& finalTransforms)const;
 
+	// Same transforms as GetFinalTransforms, written as the shader's 3x4 palette: three float4 rows
+	// per bone (the transposed matrix without its constant last row). Resizes palette to 3 * BoneCount().
+	void GetFinalPalette(const std::string& clipName, float timePos,
+		std::vector<DirectX::XMFLOAT4>& palette)const;
+
+	// Largest relative difference Set measured between the folded palette and the old per-bone
+	// rotation, over a few samples of every clip.
+	float GetAxisFoldError()const;
+
 private:
+	// Interpolates the clip and walks the hierarchy. The result lives in thread-local scratch.
+	const std::vector<DirectX::XMFLOAT4X4>& GetToRootTransforms(const std::string& clipName, float timePos)const;
+
+	// The rigs come out of the FBX rotated 90 degrees about x, and every final transform used to be
+	// multiplied by RotationX(-90). A rotation applied after the root's transform is one applied to
+	// the root's keyframes, so Set bakes it into the rotation and translation of every root bone.
+	// Slerp and lerp commute with it, so GetFinalTransforms gives the same matrices without the multiply.
+	void FoldAxisCorrection();
+	float MeasureAxisFold(const std::unordered_map<std::string, std::vector<DirectX::XMFLOAT4X4>>& reference)const;
+
     // Gives parentIndex of ith bone.
 	std::vector<int> mBoneHierarchy;
 
 	std::vector<DirectX::XMFLOAT4X4> mBoneOffsets;
    
 	std::unordered_map<std::string, AnimationClip> mAnimations;
+
+	float mAxisFoldError = 0.0f;
 };
  
 //#endif // SKINNEDDATA_H
\ No newline at end of file
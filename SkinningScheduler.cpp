@@ -0,0 +1,104 @@
+#include "SkinningScheduler.h"
+#include <algorithm>
+#include "JobSystem.h"
+#include "Info.h"
+
+using namespace DirectX;
+
+static_assert(SKINNING_ALIGN_VERTICES * sizeof(SkinnedVertex) == 64, "SKINNING_ALIGN_VERTICES must cover one 64-byte line");
+
+SkinningScheduler::SkinningScheduler(uint32_t jobVertices)
+	: mJobVertices((std::max<uint32_t>(jobVertices, 1) + SKINNING_ALIGN_VERTICES - 1) / SKINNING_ALIGN_VERTICES * SKINNING_ALIGN_VERTICES)
+{
+}
+
+void SkinningScheduler::Reset()
+{
+	mRequests.clear();
+	mOffsets.clear();
+	mJobs.clear();
+	mJobStarts.clear();
+	mReserved = 0;
+	mSkinned = 0;
+}
+
+uint32_t SkinningScheduler::Add(const SkinningRequest& request)
+{
+	uint32_t offset = (mReserved + SKINNING_ALIGN_VERTICES - 1) / SKINNING_ALIGN_VERTICES * SKINNING_ALIGN_VERTICES;
+	mRequests.push_back(request);
+	mOffsets.push_back(offset);
+	mReserved = offset + request.vertexCount;
+	mSkinned += request.vertexCount;
+	return offset;
+}
+
+const std::vector<SkinningRequest>& SkinningScheduler::GetRequests() const
+{
+	return mRequests;
+}
+
+uint32_t SkinningScheduler::GetOffset(uint32_t request) const
+{
+	return mOffsets[request];
+}
+
+uint32_t SkinningScheduler::GetReservedVertexCount() const
+{
+	return mReserved;
+}
+
+uint64_t SkinningScheduler::GetSkinnedVertexCount() const
+{
+	return mSkinned;
+}
+
+const std::vector<SkinningJob>& SkinningScheduler::BuildJobs()
+{
+	mJobs.clear();
+	mJobStarts.clear();
+	uint32_t jobVertices = mJobVertices; // full, so the first run opens a job
+	for (uint32_t request = 0; request < mRequests.size(); ++request) {
+		const uint32_t count = mRequests[request].vertexCount;
+		for (uint32_t begin = 0; begin < count;) {
+			if (jobVertices == mJobVertices) {
+				mJobStarts.push_back(static_cast<uint32_t>(mJobs.size()));
+				jobVertices = 0;
+			}
+			uint32_t end = std::min(count, begin + (mJobVertices - jobVertices));
+			// A split inside a request falls on a line like the request's offset does; if the job has no
+			// room left for a whole line, the run goes to the next job.
+			if (end < count) end -= end % SKINNING_ALIGN_VERTICES;
+			if (end == begin) {
+				jobVertices = mJobVertices;
+				continue;
+			}
+			mJobs.push_back({ request, begin, end });
+			jobVertices += end - begin;
+			begin = end;
+		}
+	}
+	mJobStarts.push_back(static_cast<uint32_t>(mJobs.size()));
+	return mJobs;
+}
+
+size_t SkinningScheduler::GetJobCount() const
+{
+	return mJobStarts.empty() ? 0 : mJobStarts.size() - 1;
+}
+
+void SkinningScheduler::Execute(JobSystem& jobSystem, const Vertex* source, const XMFLOAT4* palette, SkinnedVertex* out)
+{
+	BuildJobs();
+	jobSystem.ParallelFor(GetJobCount(), 1, [&](size_t begin, size_t end) {
+		for (size_t job = begin; job < end; ++job) {
+			for (uint32_t run = mJobStarts[job]; run < mJobStarts[job + 1]; ++run) SkinJob(mJobs[run], source, palette, out);
+		}
+	});
+}
+
+void SkinningScheduler::SkinJob(const SkinningJob& job, const Vertex* source, const XMFLOAT4* palette, SkinnedVertex* out) const
+{
+	const SkinningRequest& request = mRequests[job.request];
+	CpuSkinning::Skin(source + request.sourceVertex + job.begin, job.end - job.begin, palette + request.paletteRow,
+		out + mOffsets[job.request] + job.begin);
+}
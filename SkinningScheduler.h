@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include "CpuSkinning.h"
+
+#define SKINNING_ALIGN_VERTICES 2 // one 64-byte line; request offsets and job splits are multiples of it, so no two jobs write the same line of an aligned buffer
+
+class JobSystem;
+
+// One animated mesh to skin: its vertices in the source array and its palette rows.
+struct SkinningRequest
+{
+	uint32_t sourceVertex;
+	uint32_t vertexCount;
+	uint32_t paletteRow; // first of three rows per bone
+};
+
+// A run of one request's vertices, [begin, end) relative to the request's first vertex. A job is one
+// or more consecutive runs.
+struct SkinningJob
+{
+	uint32_t request;
+	uint32_t begin;
+	uint32_t end;
+};
+
+// Plans one frame of pre-skinning. Every request gets its own range of a transient vertex buffer,
+// handed out front to back, and the work is cut into jobs of at most jobVertices vertices so large
+// meshes spread over several threads and small ones do not cost a job each. Placement and job
+// boundaries depend only on the requests and their order, never on the number of threads.
+// No device calls: the caller owns the buffer the ranges point into.
+class SkinningScheduler
+{
+public:
+	explicit SkinningScheduler(uint32_t jobVertices);
+
+	// Forgets the requests of the previous frame.
+	void Reset();
+	// Returns the first skinned vertex reserved for the request.
+	uint32_t Add(const SkinningRequest& request);
+
+	const std::vector<SkinningRequest>& GetRequests() const;
+	uint32_t GetOffset(uint32_t request) const;
+	// Vertices the transient buffer needs, alignment gaps included.
+	uint32_t GetReservedVertexCount() const;
+	// Vertices actually skinned, without the gaps.
+	uint64_t GetSkinnedVertexCount() const;
+
+	// Cuts the requests into runs and groups the runs into jobs of at most jobVertices vertices, rounded up
+	// to SKINNING_ALIGN_VERTICES. A large request is split over several jobs at multiples of
+	// SKINNING_ALIGN_VERTICES, consecutive small ones share one.
+	const std::vector<SkinningJob>& BuildJobs();
+	size_t GetJobCount() const;
+	// Builds the jobs and runs them on the job system. out must hold GetReservedVertexCount() vertices.
+	void Execute(JobSystem& jobSystem, const Vertex* source, const DirectX::XMFLOAT4* palette, SkinnedVertex* out);
+
+private:
+	void SkinJob(const SkinningJob& job, const Vertex* source, const DirectX::XMFLOAT4* palette, SkinnedVertex* out) const;
+
+	uint32_t mJobVertices;
+	std::vector<SkinningRequest> mRequests;
+	std::vector<uint32_t> mOffsets;
+	std::vector<SkinningJob> mJobs;
+	std::vector<uint32_t> mJobStarts; // first run of every job, then the run count
+	uint32_t mReserved = 0;
+	uint64_t mSkinned = 0;
+};
@@ -0,0 +1,104 @@
+#include "TerrainMesh.h"
+#include <algorithm>
+#include <cmath>
+#include "Info.h"
+
+using namespace DirectX;
+
+void TerrainMesh::BuildRow(const std::vector<float>& heightData, int width, int height, int scale, int maxUV, int z, Vertex* row, bool soaNormals)
+{
+	for (int x = 0; x < width; ++x) {
+		row[x].position.x = x * scale;
+		row[x].position.y = heightData[z * width + x];
+		row[x].position.z = z * scale;
+		row[x].uv.x = ((float)x / (width - 1)) * maxUV;
+		row[x].uv.y = (1 - (float)z / (height - 1)) * maxUV;
+	}
+
+	// Four vertices per XMVECTOR, one in each lane: the cross product and the normalization are done on the
+	// x, y and z components as separate vectors.
+	int x = 0;
+	for (; soaNormals && x + 4 <= width; x += 4) {
+		float soa[4][3][4]; // [left, right, up, down][x, y, z][lane = vertex]
+		for (int lane = 0; lane < 4; ++lane) {
+			XMFLOAT3 neighbors[4];
+			GetNeighbors(heightData, width, height, scale, x + lane, z, neighbors);
+			for (int n = 0; n < 4; ++n) {
+				soa[n][0][lane] = neighbors[n].x;
+				soa[n][1][lane] = neighbors[n].y;
+				soa[n][2][lane] = neighbors[n].z;
+			}
+		}
+		auto load = [&soa](int neighbor, int axis) {
+			const float* lanes = soa[neighbor][axis];
+			return XMVectorSet(lanes[0], lanes[1], lanes[2], lanes[3]);
+		};
+		XMVECTOR ax = XMVectorSubtract(load(2, 0), load(3, 0)); // up - down
+		XMVECTOR ay = XMVectorSubtract(load(2, 1), load(3, 1));
+		XMVECTOR az = XMVectorSubtract(load(2, 2), load(3, 2));
+		XMVECTOR bx = XMVectorSubtract(load(1, 0), load(0, 0)); // right - left
+		XMVECTOR by = XMVectorSubtract(load(1, 1), load(0, 1));
+		XMVECTOR bz = XMVectorSubtract(load(1, 2), load(0, 2));
+
+		XMVECTOR nx = XMVectorSubtract(XMVectorMultiply(ay, bz), XMVectorMultiply(az, by));
+		XMVECTOR ny = XMVectorSubtract(XMVectorMultiply(az, bx), XMVectorMultiply(ax, bz));
+		XMVECTOR nz = XMVectorSubtract(XMVectorMultiply(ax, by), XMVectorMultiply(ay, bx));
+
+		// up - down always steps along z and right - left along x, so ny > 0 and the length is never zero.
+		XMVECTOR lengthSq = XMVectorAdd(XMVectorAdd(XMVectorMultiply(nx, nx), XMVectorMultiply(ny, ny)), XMVectorMultiply(nz, nz));
+		XMVECTOR length = XMVectorSqrt(lengthSq);
+		nx = XMVectorDivide(nx, length);
+		ny = XMVectorDivide(ny, length);
+		nz = XMVectorDivide(nz, length);
+
+		for (int lane = 0; lane < 4; ++lane) {
+			row[x + lane].normal = { XMVectorGetByIndex(nx, lane), XMVectorGetByIndex(ny, lane), XMVectorGetByIndex(nz, lane) };
+		}
+	}
+	for (; x < width; ++x) {
+		XMFLOAT3 neighbors[4];
+		GetNeighbors(heightData, width, height, scale, x, z, neighbors);
+		XMVECTOR left = XMLoadFloat3(&neighbors[0]);
+		XMVECTOR right = XMLoadFloat3(&neighbors[1]);
+		XMVECTOR up = XMLoadFloat3(&neighbors[2]);
+		XMVECTOR down = XMLoadFloat3(&neighbors[3]);
+		XMStoreFloat3(&row[x].normal, XMVector3Normalize(XMVector3Cross(XMVectorSubtract(up, down), XMVectorSubtract(right, left))));
+	}
+}
+
+float TerrainMesh::CompareNormals(const Vertex* expected, const Vertex* actual, size_t count)
+{
+	float error = 0.0f;
+	for (size_t i = 0; i < count; ++i) {
+		const float* a = &expected[i].normal.x;
+		const float* b = &actual[i].normal.x;
+		for (int k = 0; k < 3; ++k) error = std::max(error, fabsf(a[k] - b[k]));
+	}
+	return error;
+}
+
+void TerrainMesh::GetNeighbors(const std::vector<float>& heightData, int width, int height, int scale, int x, int z, XMFLOAT3(&neighbors)[4])
+{
+	int scaledX = x * scale;
+	int scaledZ = z * scale;
+	float center = heightData[z * width + x];
+	if (x == 0)
+		neighbors[0] = { (float)scaledX, center, (float)scaledZ };
+	else
+		neighbors[0] = { (float)scaledX - scale, heightData[z * width + x - 1], (float)scaledZ };
+
+	if (x == width - 1)
+		neighbors[1] = { (float)scaledX, center, (float)scaledZ };
+	else
+		neighbors[1] = { (float)scaledX + scale, heightData[z * width + x + 1], (float)scaledZ };
+
+	if (z == height - 1)
+		neighbors[2] = { (float)scaledX, center, (float)scaledZ };
+	else
+		neighbors[2] = { (float)scaledX, heightData[(z + 1) * width + x], (float)scaledZ + scale };
+
+	if (z == 0)
+		neighbors[3] = { (float)scaledX, center, (float)scaledZ };
+	else
+		neighbors[3] = { (float)scaledX, heightData[(z - 1) * width + x], (float)scaledZ - scale };
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <DirectXMath.h>
+
+#define TERRAIN_NORMAL_TOLERANCE 1e-5f // largest normal component difference allowed against the per-vertex math
+
+struct Vertex;
+
+// Terrain vertices from a height map of width x height samples, row 0 at the bottom, scale world units
+// apart. Each vertex's normal is the normalized cross product of its up - down and right - left neighbors;
+// at the edges a vertex stands in for its missing neighbor.
+class TerrainMesh
+{
+public:
+	// Row z of the mesh: position, normal and uv (maxUV repeats over the whole map). Normals are computed
+	// four vertices at a time unless soaNormals is false, which computes them one by one with XMVector3Cross
+	// and XMVector3Normalize. The two paths round differently and agree within TERRAIN_NORMAL_TOLERANCE.
+	static void BuildRow(const std::vector<float>& heightData, int width, int height, int scale, int maxUV, int z, Vertex* row, bool soaNormals = true);
+
+	// Largest difference between the normal components of two vertex arrays.
+	static float CompareNormals(const Vertex* expected, const Vertex* actual, size_t count);
+
+private:
+	// Left, right, up and down of (x, z).
+	static void GetNeighbors(const std::vector<float>& heightData, int width, int height, int scale, int x, int z, DirectX::XMFLOAT3(&neighbors)[4]);
+};
@@ -0,0 +1,329 @@
+#include "TerrainQuadTree.h"
+#include <algorithm>
+#include <cmath>
+
+void TerrainQuadTree::Build(const std::vector<float>& heights, uint32_t width, uint32_t height, float scale, uint32_t chunkQuads)
+{
+	mHeights = heights;
+	mWidth = width;
+	mHeight = height;
+	mScale = scale;
+	mChunkQuads = chunkQuads;
+	mNodes.clear();
+	mSkirtDepths.clear();
+
+	uint32_t quads = std::max(width, height) - 1;
+	uint32_t maxLevel = 0;
+	while ((chunkQuads << maxLevel) < quads) ++maxLevel;
+	mRoot = static_cast<uint32_t>(BuildNode(0, 0, maxLevel));
+
+	// A chunk's skirt has to reach down past the worst edge error of its own level and of the
+	// next coarser one, since balanced neighbours are never more than one level apart.
+	std::vector<float> levelError(maxLevel + 2, 0.0f);
+	for (const TerrainNode& node : mNodes) levelError[node.level] = std::max(levelError[node.level], node.edgeError);
+	for (uint32_t level = 0; level <= maxLevel; ++level)
+		mSkirtDepths.push_back(std::max(levelError[level], levelError[level + 1]) + mScale * 0.5f);
+
+	const uint32_t chunkVertexCount = GetChunkVertexCount();
+	for (uint32_t i = 0; i < mNodes.size(); ++i) mNodes[i].baseVertex = i * chunkVertexCount;
+}
+
+void TerrainQuadTree::Select(float cameraX, float cameraY, float cameraZ, float lodDistance, std::vector<uint32_t>& leaves) const
+{
+	leaves.clear();
+	if (mNodes.empty()) return;
+
+	std::vector<bool> split(mNodes.size(), false);
+	std::vector<uint32_t> stack{ mRoot };
+	while (!stack.empty())
+	{
+		uint32_t index = stack.back();
+		stack.pop_back();
+		const TerrainNode& node = mNodes[index];
+		if (node.level == 0) continue;
+
+		// Distance from the camera to the node's bounding box.
+		float minX = node.x * mScale;
+		float maxX = std::min(node.x + node.size, mWidth - 1) * mScale;
+		float minZ = node.z * mScale;
+		float maxZ = std::min(node.z + node.size, mHeight - 1) * mScale;
+		float dx = std::max({ minX - cameraX, 0.0f, cameraX - maxX });
+		float dy = std::max({ node.minHeight - cameraY, 0.0f, cameraY - node.maxHeight });
+		float dz = std::max({ minZ - cameraZ, 0.0f, cameraZ - maxZ });
+		if (std::sqrt(dx * dx + dy * dy + dz * dz) >= lodDistance * node.size * mScale) continue;
+
+		split[index] = true;
+		for (int32_t child : node.children)
+			if (child >= 0) stack.push_back(static_cast<uint32_t>(child));
+	}
+
+	// Restrict the tree: split any leaf that is more than one level coarser than a neighbour.
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		leaves.clear();
+		CollectLeaves(split, mRoot, leaves);
+		for (uint32_t index : leaves)
+		{
+			const TerrainNode& node = mNodes[index];
+			float east = static_cast<float>(std::min(node.x + node.size, mWidth - 1));
+			float north = static_cast<float>(std::min(node.z + node.size, mHeight - 1));
+			float midX = (node.x + east) * 0.5f;
+			float midZ = (node.z + north) * 0.5f;
+			const float probes[4][2] = { { midX, node.z - 0.5f }, { midX, north + 0.5f }, { node.x - 0.5f, midZ }, { east + 0.5f, midZ } };
+			for (const auto& probe : probes)
+			{
+				int32_t neighbor = LeafAt(split, probe[0], probe[1]);
+				if (neighbor < 0 || mNodes[neighbor].level <= node.level + 1) continue;
+				split[neighbor] = true;
+				changed = true;
+			}
+		}
+	}
+}
+
+bool TerrainQuadTree::CheckCrackFree(const std::vector<uint32_t>& leaves, float* worstGap) const
+{
+	if (worstGap) *worstGap = 0.0f;
+	if (mNodes.empty()) return leaves.empty();
+
+	// Rebuild the split flags from the leaves; the leaves must tile the tree exactly once.
+	std::vector<bool> isLeaf(mNodes.size(), false);
+	for (uint32_t index : leaves)
+	{
+		if (index >= mNodes.size() || isLeaf[index]) return false;
+		isLeaf[index] = true;
+	}
+	std::vector<bool> split(mNodes.size(), false);
+	std::vector<bool> containsLeaf(mNodes.size(), false);
+	for (uint32_t i = static_cast<uint32_t>(mNodes.size()); i-- > 0;) // children are stored after their parent
+	{
+		bool childHasLeaf = false;
+		for (int32_t child : mNodes[i].children)
+			if (child >= 0 && containsLeaf[child]) childHasLeaf = true;
+		if (isLeaf[i] && childHasLeaf) return false; // a leaf overlaps one of its descendants
+		split[i] = childHasLeaf;
+		containsLeaf[i] = isLeaf[i] || childHasLeaf;
+	}
+	std::vector<uint32_t> collected;
+	CollectLeaves(split, mRoot, collected);
+	std::vector<uint32_t> expected = leaves;
+	std::sort(collected.begin(), collected.end());
+	std::sort(expected.begin(), expected.end());
+	if (collected != expected) return false; // part of the terrain is not covered
+
+	bool crackFree = true;
+	auto checkSample = [&](const TerrainNode& node, uint32_t x, uint32_t z, float probeX, float probeZ) {
+		int32_t neighbor = LeafAt(split, probeX, probeZ);
+		if (neighbor < 0) return;
+		const TerrainNode& other = mNodes[neighbor];
+		if (other.level == node.level) return;
+		if (std::max(other.level, node.level) - std::min(other.level, node.level) > 1) { crackFree = false; return; }
+
+		float gap = std::fabs(EdgeHeight(node, x, z) - EdgeHeight(other, x, z));
+		if (worstGap) *worstGap = std::max(*worstGap, gap);
+		if (gap > std::min(mSkirtDepths[node.level], mSkirtDepths[other.level])) crackFree = false;
+	};
+
+	for (uint32_t index : leaves)
+	{
+		const TerrainNode& node = mNodes[index];
+		uint32_t east = std::min(node.x + node.size, mWidth - 1);
+		uint32_t north = std::min(node.z + node.size, mHeight - 1);
+		for (uint32_t x = node.x; x <= east; ++x)
+		{
+			float probeX = std::min(static_cast<float>(x), east - 0.5f);
+			checkSample(node, x, node.z, probeX, node.z - 0.5f);
+			checkSample(node, x, north, probeX, north + 0.5f);
+		}
+		for (uint32_t z = node.z; z <= north; ++z)
+		{
+			float probeZ = std::min(static_cast<float>(z), north - 0.5f);
+			checkSample(node, node.x, z, node.x - 0.5f, probeZ);
+			checkSample(node, east, z, east + 0.5f, probeZ);
+		}
+	}
+	return crackFree;
+}
+
+uint32_t TerrainQuadTree::GetSampleIndex(const TerrainNode& node, uint32_t column, uint32_t row) const
+{
+	uint32_t x = std::min(node.x + (column << node.level), mWidth - 1);
+	uint32_t z = std::min(node.z + (row << node.level), mHeight - 1);
+	return z * mWidth + x;
+}
+
+void TerrainQuadTree::GetChunkIndices(std::vector<uint32_t>& indices) const
+{
+	const uint32_t n = mChunkQuads;
+	const uint32_t r = n + 1;
+	const uint32_t south = r * r;
+	const uint32_t north = south + r;
+	const uint32_t west = north + r;
+	const uint32_t east = west + r;
+
+	indices.clear();
+	for (uint32_t z = 0; z < n; ++z) {
+		for (uint32_t x = 0; x < n; ++x) {
+			uint32_t bottomLeft = z * r + x;
+			uint32_t topLeft = (z + 1) * r + x;
+			indices.insert(indices.end(), { bottomLeft, topLeft, topLeft + 1, bottomLeft, topLeft + 1, bottomLeft + 1 });
+		}
+	}
+
+	// Skirts are clockwise seen from outside the chunk.
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t a = i, b = i + 1;
+		indices.insert(indices.end(), { a, b, south + i + 1, a, south + i + 1, south + i });
+		a = n * r + i, b = a + 1;
+		indices.insert(indices.end(), { b, a, north + i, b, north + i, north + i + 1 });
+		a = i * r, b = (i + 1) * r;
+		indices.insert(indices.end(), { b, a, west + i, b, west + i, west + i + 1 });
+		a = i * r + n, b = (i + 1) * r + n;
+		indices.insert(indices.end(), { a, b, east + i + 1, a, east + i + 1, east + i });
+	}
+}
+
+uint32_t TerrainQuadTree::GetChunkVertexCount() const
+{
+	const uint32_t r = mChunkQuads + 1;
+	return r * r + 4 * r;
+}
+
+const TerrainNode& TerrainQuadTree::GetNode(uint32_t index) const
+{
+	return mNodes.at(index);
+}
+
+uint32_t TerrainQuadTree::GetNodeCount() const
+{
+	return static_cast<uint32_t>(mNodes.size());
+}
+
+uint32_t TerrainQuadTree::GetRoot() const
+{
+	return mRoot;
+}
+
+uint32_t TerrainQuadTree::GetChunkQuads() const
+{
+	return mChunkQuads;
+}
+
+float TerrainQuadTree::GetSkirtDepth(uint32_t level) const
+{
+	return mSkirtDepths.at(level);
+}
+
+float TerrainQuadTree::GetScale() const
+{
+	return mScale;
+}
+
+int32_t TerrainQuadTree::BuildNode(uint32_t x, uint32_t z, uint32_t level)
+{
+	if (x >= mWidth - 1 || z >= mHeight - 1) return -1; // no quads left here
+
+	TerrainNode node;
+	node.x = x;
+	node.z = z;
+	node.level = level;
+	node.size = mChunkQuads << level;
+
+	uint32_t east = std::min(x + node.size, mWidth - 1);
+	uint32_t north = std::min(z + node.size, mHeight - 1);
+	node.minHeight = node.maxHeight = SampleHeight(x, z);
+	for (uint32_t sz = z; sz <= north; ++sz) {
+		for (uint32_t sx = x; sx <= east; ++sx) {
+			float h = SampleHeight(sx, sz);
+			node.minHeight = std::min(node.minHeight, h);
+			node.maxHeight = std::max(node.maxHeight, h);
+		}
+	}
+	if (level > 0)
+	{
+		for (uint32_t sx = x; sx <= east; ++sx) {
+			node.edgeError = std::max(node.edgeError, std::fabs(SampleHeight(sx, z) - EdgeHeight(node, sx, z)));
+			node.edgeError = std::max(node.edgeError, std::fabs(SampleHeight(sx, north) - EdgeHeight(node, sx, north)));
+		}
+		for (uint32_t sz = z; sz <= north; ++sz) {
+			node.edgeError = std::max(node.edgeError, std::fabs(SampleHeight(x, sz) - EdgeHeight(node, x, sz)));
+			node.edgeError = std::max(node.edgeError, std::fabs(SampleHeight(east, sz) - EdgeHeight(node, east, sz)));
+		}
+	}
+
+	int32_t index = static_cast<int32_t>(mNodes.size());
+	mNodes.push_back(node);
+	if (level == 0) return index;
+
+	uint32_t half = node.size / 2;
+	int32_t children[4] = {
+		BuildNode(x, z, level - 1),
+		BuildNode(x + half, z, level - 1),
+		BuildNode(x, z + half, level - 1),
+		BuildNode(x + half, z + half, level - 1) };
+	std::copy(children, children + 4, mNodes[index].children);
+	return index;
+}
+
+float TerrainQuadTree::SampleHeight(int64_t x, int64_t z) const
+{
+	x = std::clamp<int64_t>(x, 0, mWidth - 1);
+	z = std::clamp<int64_t>(z, 0, mHeight - 1);
+	return mHeights[z * mWidth + x];
+}
+
+float TerrainQuadTree::EdgeHeight(const TerrainNode& node, uint32_t x, uint32_t z) const
+{
+	// Chunk vertices sit every `stride` samples (clamped to the map), the edge is linear between them.
+	const uint32_t stride = 1u << node.level;
+	uint32_t east = std::min(node.x + node.size, mWidth - 1);
+	uint32_t north = std::min(node.z + node.size, mHeight - 1);
+	if (z == node.z || z == north)
+	{
+		uint32_t x0 = node.x + (x - node.x) / stride * stride;
+		uint32_t x1 = std::min(x0 + stride, east);
+		x0 = std::min(x0, east);
+		if (x1 == x0) return SampleHeight(x0, z);
+		float t = static_cast<float>(x - x0) / (x1 - x0);
+		return (1 - t) * SampleHeight(x0, z) + t * SampleHeight(x1, z);
+	}
+	if (x == node.x || x == east)
+	{
+		uint32_t z0 = node.z + (z - node.z) / stride * stride;
+		uint32_t z1 = std::min(z0 + stride, north);
+		z0 = std::min(z0, north);
+		if (z1 == z0) return SampleHeight(x, z0);
+		float t = static_cast<float>(z - z0) / (z1 - z0);
+		return (1 - t) * SampleHeight(x, z0) + t * SampleHeight(x, z1);
+	}
+	return SampleHeight(x, z);
+}
+
+int32_t TerrainQuadTree::LeafAt(const std::vector<bool>& split, float x, float z) const
+{
+	if (x < 0.0f || z < 0.0f || x > mWidth - 1 || z > mHeight - 1) return -1;
+
+	int32_t index = static_cast<int32_t>(mRoot);
+	while (split[index])
+	{
+		const TerrainNode& node = mNodes[index];
+		float half = node.size * 0.5f;
+		int child = (x >= node.x + half ? 1 : 0) + (z >= node.z + half ? 2 : 0);
+		index = node.children[child];
+		if (index < 0) return -1;
+	}
+	return index;
+}
+
+void TerrainQuadTree::CollectLeaves(const std::vector<bool>& split, uint32_t index, std::vector<uint32_t>& leaves) const
+{
+	if (!split[index])
+	{
+		leaves.push_back(index);
+		return;
+	}
+	for (int32_t child : mNodes[index].children)
+		if (child >= 0) CollectLeaves(split, static_cast<uint32_t>(child), leaves);
+}
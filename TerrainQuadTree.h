@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct TerrainNode
+{
+	uint32_t x = 0;          // first height sample covered
+	uint32_t z = 0;
+	uint32_t level = 0;      // 0 = full resolution, sample stride is 1 << level
+	uint32_t size = 0;       // quads covered along each side, chunkQuads << level
+	float minHeight = 0.0f;
+	float maxHeight = 0.0f;
+	float edgeError = 0.0f;  // worst height difference between the chunk edges and the full-resolution samples on them
+	int32_t children[4] = { -1, -1, -1, -1 };
+	uint32_t baseVertex = 0; // first vertex of this chunk inside the terrain's vertex block
+};
+
+// Quadtree of terrain chunks. Every node is a (chunkQuads + 1)^2 grid sampled with stride 1 << level,
+// so all chunks share one index list; a skirt around each chunk hides the T-junction gaps between
+// chunks of neighbouring levels. Pure CPU, the renderer only reads the selected node list.
+class TerrainQuadTree
+{
+public:
+	void Build(const std::vector<float>& heights, uint32_t width, uint32_t height, float scale, uint32_t chunkQuads);
+
+	// Splits a node while the camera is closer than lodDistance * node width, then splits coarse
+	// nodes further until every pair of neighbouring leaves differs by at most one level.
+	void Select(float cameraX, float cameraY, float cameraZ, float lodDistance, std::vector<uint32_t>& leaves) const;
+	// True when the leaves are 2:1 balanced and every gap along a shared edge is covered by the skirts.
+	bool CheckCrackFree(const std::vector<uint32_t>& leaves, float* worstGap = nullptr) const;
+
+	// Index of the full-resolution sample behind chunk vertex (column, row), clamped to the height map.
+	uint32_t GetSampleIndex(const TerrainNode& node, uint32_t column, uint32_t row) const;
+	// Triangle list for one chunk: grid first, then the south, north, west and east skirts.
+	void GetChunkIndices(std::vector<uint32_t>& indices) const;
+	uint32_t GetChunkVertexCount() const;
+
+	const TerrainNode& GetNode(uint32_t index) const;
+	uint32_t GetNodeCount() const;
+	uint32_t GetRoot() const;
+	uint32_t GetChunkQuads() const;
+	float GetSkirtDepth(uint32_t level) const;
+	float GetScale() const;
+
+private:
+	int32_t BuildNode(uint32_t x, uint32_t z, uint32_t level);
+	float SampleHeight(int64_t x, int64_t z) const;
+	// Height of the node's surface along one of its edges at full-resolution sample (x, z).
+	float EdgeHeight(const TerrainNode& node, uint32_t x, uint32_t z) const;
+	int32_t LeafAt(const std::vector<bool>& split, float x, float z) const;
+	void CollectLeaves(const std::vector<bool>& split, uint32_t index, std::vector<uint32_t>& leaves) const;
+
+	std::vector<float> mHeights;
+	uint32_t mWidth = 0;
+	uint32_t mHeight = 0;
+	float mScale = 1.0f;
+	uint32_t mChunkQuads = 0;
+	std::vector<TerrainNode> mNodes;
+	std::vector<float> mSkirtDepths; // per level
+	uint32_t mRoot = 0;
+};
@@ -0,0 +1,320 @@
+#include "TerrainTileCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+TerrainTileCache::TerrainTileCache(uint64_t budgetBytes) : mBudget{ budgetBytes }
+{
+}
+
+TerrainTileCache::~TerrainTileCache()
+{
+	Close();
+}
+
+bool TerrainTileCache::Open(const std::wstring& fileName)
+{
+	Close();
+	if (!mFile.Open(fileName)) return false;
+	if (!ParseTerrainTileHeader(mFile.GetData(), mFile.GetSize(), mInfo))
+	{
+		Close();
+		return false;
+	}
+
+	mCoarse.resize(static_cast<size_t>(mInfo.GetCoarseWidth()) * mInfo.GetCoarseHeight());
+	memcpy(mCoarse.data(), mFile.GetData() + mInfo.GetCoarseOffset(), mCoarse.size() * sizeof(float));
+	mTileLookup.assign(static_cast<size_t>(mInfo.tilesX) * mInfo.tilesZ, nullptr);
+
+	mStop = false;
+	mWorker = std::thread{ &TerrainTileCache::WorkerLoop, this };
+	return true;
+}
+
+void TerrainTileCache::Close()
+{
+	if (mWorker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mMutex };
+			mStop = true;
+		}
+		mCondition.notify_all();
+		mWorker.join();
+	}
+	mRequests.clear();
+	mDecoded.clear();
+	mTiles.clear();
+	mTileLookup.clear();
+	mPending.clear();
+	mCoarse.clear();
+	mResidentBytes = 0;
+	mInfo = TerrainTileInfo{};
+	mFile.Close();
+}
+
+bool TerrainTileCache::IsOpen() const
+{
+	return mFile.IsOpen();
+}
+
+void TerrainTileCache::Update(float focusX, float focusZ, float radius)
+{
+	if (!IsOpen()) return;
+	++mFrame;
+
+	// Tiles touching the circle, nearest first, as many as fit in the budget.
+	const float tileWorld = mInfo.tileSize * mInfo.scale;
+	auto toTile = [tileWorld](float value, uint32_t count) {
+		return static_cast<uint32_t>(std::clamp(std::floor(value / tileWorld), 0.0f, static_cast<float>(count - 1)));
+	};
+	const uint32_t beginX = toTile(focusX - radius, mInfo.tilesX), endX = toTile(focusX + radius, mInfo.tilesX);
+	const uint32_t beginZ = toTile(focusZ - radius, mInfo.tilesZ), endZ = toTile(focusZ + radius, mInfo.tilesZ);
+	std::vector<std::pair<float, uint32_t>> candidates;
+	for (uint32_t tileZ = beginZ; tileZ <= endZ; ++tileZ)
+	{
+		for (uint32_t tileX = beginX; tileX <= endX; ++tileX)
+		{
+			float dx = std::max({ tileX * tileWorld - focusX, 0.0f, focusX - (tileX + 1) * tileWorld });
+			float dz = std::max({ tileZ * tileWorld - focusZ, 0.0f, focusZ - (tileZ + 1) * tileWorld });
+			float distanceSq = dx * dx + dz * dz;
+			if (distanceSq <= radius * radius) candidates.emplace_back(distanceSq, tileZ * mInfo.tilesX + tileX);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.resize(std::min<size_t>(candidates.size(), mBudget / GetTileBytes()));
+
+	std::set<uint32_t> wanted;
+	std::vector<uint32_t> requests;
+	for (const auto& candidate : candidates)
+	{
+		uint32_t index = candidate.second;
+		wanted.insert(index);
+		auto found = mTiles.find(index);
+		if (found != mTiles.end())
+			found->second.lastWantedFrame = mFrame;
+		else if (mPending.insert(index).second)
+			requests.push_back(index);
+	}
+
+	std::deque<DecodedTile> decoded;
+	{
+		std::lock_guard<std::mutex> lock{ mMutex };
+		// Drop queued requests the camera has moved away from before the worker spends time on them.
+		for (auto it = mRequests.begin(); it != mRequests.end();)
+		{
+			if (wanted.count(*it)) { ++it; continue; }
+			mPending.erase(*it);
+			it = mRequests.erase(it);
+		}
+		mRequests.insert(mRequests.end(), requests.begin(), requests.end());
+		decoded.swap(mDecoded);
+	}
+	if (!requests.empty()) mCondition.notify_one();
+
+	for (DecodedTile& result : decoded)
+	{
+		mPending.erase(result.index);
+		if (!wanted.count(result.index) || mTiles.count(result.index)) continue;
+		while (mResidentBytes + GetTileBytes() > mBudget && EvictOne()) {}
+		if (mResidentBytes + GetTileBytes() > mBudget) continue;
+
+		Tile& tile = mTiles[result.index];
+		tile = std::move(result.tile);
+		tile.lastWantedFrame = mFrame;
+		mTileLookup[result.index] = &tile;
+		mResidentBytes += GetTileBytes();
+	}
+}
+
+float TerrainTileCache::SampleHeight(float x, float z, bool* resident) const
+{
+	if (!IsOpen())
+	{
+		if (resident) *resident = false;
+		return 0.0f;
+	}
+
+	float localX, localZ;
+	const Tile* tile = mTileLookup[Locate(x, z, localX, localZ)];
+	if (resident) *resident = tile != nullptr;
+	if (!tile) return SampleCoarse(x, z);
+
+	const uint32_t rowSize = mInfo.tileSize + 1;
+	uint32_t column = std::min<uint32_t>(static_cast<uint32_t>(localX), mInfo.tileSize - 1);
+	uint32_t row = std::min<uint32_t>(static_cast<uint32_t>(localZ), mInfo.tileSize - 1);
+	float offsetX = localX - column;
+	float offsetZ = localZ - row;
+	const float* bottom = &tile->heights[static_cast<size_t>(row) * rowSize + column];
+	const float* top = bottom + rowSize;
+	float lerpXBottom = (1 - offsetX) * bottom[0] + offsetX * bottom[1];
+	float lerpXTop = (1 - offsetX) * top[0] + offsetX * top[1];
+	return (1 - offsetZ) * lerpXBottom + offsetZ * lerpXTop;
+}
+
+void TerrainTileCache::SampleHeights(const float* positions, size_t count, size_t stride, float* heights) const
+{
+	for (size_t i = 0; i < count; ++i, positions += stride)
+		heights[i] = SampleHeight(positions[0], positions[2]);
+}
+
+bool TerrainTileCache::SampleNormal(float x, float z, float normal[3]) const
+{
+	normal[0] = 0.0f;
+	normal[1] = 1.0f;
+	normal[2] = 0.0f;
+	if (!IsOpen()) return false;
+
+	float localX, localZ;
+	const Tile* tile = mTileLookup[Locate(x, z, localX, localZ)];
+	if (!tile) return false;
+
+	const uint32_t rowSize = mInfo.tileSize + 1;
+	size_t sample = static_cast<size_t>(std::lround(localZ)) * rowSize + static_cast<size_t>(std::lround(localX));
+	memcpy(normal, &tile->normals[sample * 3], sizeof(float) * 3);
+	return true;
+}
+
+bool TerrainTileCache::IsResident(uint32_t tileX, uint32_t tileZ) const
+{
+	if (tileX >= mInfo.tilesX || tileZ >= mInfo.tilesZ) return false;
+	return mTileLookup[static_cast<size_t>(tileZ) * mInfo.tilesX + tileX] != nullptr;
+}
+
+uint32_t TerrainTileCache::GetResidentCount() const
+{
+	return static_cast<uint32_t>(mTiles.size());
+}
+
+uint64_t TerrainTileCache::GetResidentBytes() const
+{
+	return mResidentBytes;
+}
+
+uint64_t TerrainTileCache::GetBudget() const
+{
+	return mBudget;
+}
+
+uint32_t TerrainTileCache::GetPendingCount() const
+{
+	return static_cast<uint32_t>(mPending.size());
+}
+
+uint64_t TerrainTileCache::GetFrame() const
+{
+	return mFrame;
+}
+
+const TerrainTileInfo& TerrainTileCache::GetInfo() const
+{
+	return mInfo;
+}
+
+float TerrainTileCache::GetExtentX() const
+{
+	return static_cast<float>(mInfo.tilesX) * mInfo.tileSize * mInfo.scale;
+}
+
+float TerrainTileCache::GetExtentZ() const
+{
+	return static_cast<float>(mInfo.tilesZ) * mInfo.tileSize * mInfo.scale;
+}
+
+void TerrainTileCache::WorkerLoop()
+{
+	while (true)
+	{
+		uint32_t index;
+		{
+			std::unique_lock<std::mutex> lock{ mMutex };
+			mCondition.wait(lock, [this] { return mStop || !mRequests.empty(); });
+			if (mStop) return;
+			index = mRequests.front();
+			mRequests.pop_front();
+		}
+
+		// The first read of the mapping pages the tile in, on this thread rather than the frame's.
+		DecodedTile result{ index, {} };
+		DecodeTile(index, result.tile);
+
+		std::lock_guard<std::mutex> lock{ mMutex };
+		mDecoded.push_back(std::move(result));
+	}
+}
+
+void TerrainTileCache::DecodeTile(uint32_t index, Tile& tile) const
+{
+	const uint32_t rowSize = mInfo.tileSize + 1;
+	const size_t sampleCount = static_cast<size_t>(rowSize) * rowSize;
+	const uint8_t* source = mFile.GetData() + mInfo.GetTileOffset(index % mInfo.tilesX, index / mInfo.tilesX);
+
+	tile.heights.resize(sampleCount);
+	tile.normals.resize(sampleCount * 3);
+	for (size_t i = 0; i < sampleCount; ++i, source += TerrainTileSampleSize)
+	{
+		uint16_t quantized;
+		memcpy(&quantized, source, sizeof(quantized));
+		tile.heights[i] = DecodeTerrainTileHeight(mInfo, quantized);
+
+		float nx = static_cast<int8_t>(source[2]) / 127.0f;
+		float nz = static_cast<int8_t>(source[3]) / 127.0f;
+		tile.normals[i * 3 + 0] = nx;
+		tile.normals[i * 3 + 1] = std::sqrt(std::max(0.0f, 1.0f - nx * nx - nz * nz));
+		tile.normals[i * 3 + 2] = nz;
+	}
+}
+
+uint64_t TerrainTileCache::GetTileBytes() const
+{
+	const uint64_t rowSize = mInfo.tileSize + 1;
+	return rowSize * rowSize * sizeof(float) * 4; // height and three normal components
+}
+
+bool TerrainTileCache::EvictOne()
+{
+	// Least recently wanted tile that is not wanted this frame.
+	auto victim = mTiles.end();
+	for (auto it = mTiles.begin(); it != mTiles.end(); ++it)
+	{
+		if (it->second.lastWantedFrame >= mFrame) continue;
+		if (victim == mTiles.end() || it->second.lastWantedFrame < victim->second.lastWantedFrame) victim = it;
+	}
+	if (victim == mTiles.end()) return false;
+
+	mTileLookup[victim->first] = nullptr;
+	mTiles.erase(victim);
+	mResidentBytes -= GetTileBytes();
+	return true;
+}
+
+uint32_t TerrainTileCache::Locate(float x, float z, float& localX, float& localZ) const
+{
+	const float T = static_cast<float>(mInfo.tileSize);
+	float sampleX = std::clamp(x / mInfo.scale, 0.0f, mInfo.tilesX * T);
+	float sampleZ = std::clamp(z / mInfo.scale, 0.0f, mInfo.tilesZ * T);
+	uint32_t tileX = std::min<uint32_t>(static_cast<uint32_t>(sampleX / T), mInfo.tilesX - 1);
+	uint32_t tileZ = std::min<uint32_t>(static_cast<uint32_t>(sampleZ / T), mInfo.tilesZ - 1);
+	localX = sampleX - tileX * T;
+	localZ = sampleZ - tileZ * T;
+	return tileZ * mInfo.tilesX + tileX;
+}
+
+float TerrainTileCache::SampleCoarse(float x, float z) const
+{
+	const uint32_t width = mInfo.GetCoarseWidth();
+	const uint32_t height = mInfo.GetCoarseHeight();
+	const float spacing = mInfo.coarseStep * mInfo.scale;
+	float gridX = std::clamp(x / spacing, 0.0f, static_cast<float>(width - 1));
+	float gridZ = std::clamp(z / spacing, 0.0f, static_cast<float>(height - 1));
+	uint32_t column = std::min<uint32_t>(static_cast<uint32_t>(gridX), width - 2);
+	uint32_t row = std::min<uint32_t>(static_cast<uint32_t>(gridZ), height - 2);
+	float offsetX = gridX - column;
+	float offsetZ = gridZ - row;
+	const float* bottom = &mCoarse[static_cast<size_t>(row) * width + column];
+	const float* top = bottom + width;
+	float lerpXBottom = (1 - offsetX) * bottom[0] + offsetX * bottom[1];
+	float lerpXTop = (1 - offsetX) * top[0] + offsetX * top[1];
+	return (1 - offsetZ) * lerpXBottom + offsetZ * lerpXTop;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "MappedFile.h"
+#include "TerrainTileFile.h"
+
+// Keeps the tiles of a .tiles file around a focus point resident within a byte budget.
+// The file is memory mapped once; a background thread touches and decodes the tiles the main
+// thread asks for, and the main thread evicts the least recently wanted tiles when a new one
+// would not fit. Height queries on tiles that are not resident fall back to the coarse grid,
+// which is read at open and never evicted. No D3D12 calls.
+class TerrainTileCache
+{
+public:
+	TerrainTileCache(uint64_t budgetBytes = 0);
+	TerrainTileCache(const TerrainTileCache&) = delete;
+	TerrainTileCache& operator=(const TerrainTileCache&) = delete;
+	~TerrainTileCache();
+
+	bool Open(const std::wstring& fileName);
+	void Close();
+	bool IsOpen() const;
+
+	// Main thread, once per frame. Wants every tile within radius of (x, z), nearest first, as many
+	// as the budget holds, and takes in the tiles the worker finished.
+	void Update(float focusX, float focusZ, float radius);
+
+	// Bilinear height at world (x, z), clamped to the map. resident is false when the coarse grid answered.
+	float SampleHeight(float x, float z, bool* resident = nullptr) const;
+	// Same layout as HeightField::SampleHeights.
+	void SampleHeights(const float* positions, size_t count, size_t stride, float* heights) const;
+	// Normal of the nearest sample; straight up when the tile is not resident.
+	bool SampleNormal(float x, float z, float normal[3]) const;
+
+	bool IsResident(uint32_t tileX, uint32_t tileZ) const;
+	uint32_t GetResidentCount() const;
+	uint64_t GetResidentBytes() const;
+	uint64_t GetBudget() const;
+	uint32_t GetPendingCount() const;
+	uint64_t GetFrame() const;
+	const TerrainTileInfo& GetInfo() const;
+	float GetExtentX() const; // world size covered by the samples
+	float GetExtentZ() const;
+
+private:
+	struct Tile
+	{
+		std::vector<float> heights; // (tileSize + 1)^2, row 0 is the tile's lowest z
+		std::vector<float> normals; // x, y, z per sample
+		uint64_t lastWantedFrame = 0;
+	};
+	struct DecodedTile
+	{
+		uint32_t index;
+		Tile tile;
+	};
+
+	void WorkerLoop();
+	void DecodeTile(uint32_t index, Tile& tile) const;
+	uint64_t GetTileBytes() const;
+	bool EvictOne();
+	// Tile holding world (x, z) and the sample coordinates inside it, clamped to the map.
+	uint32_t Locate(float x, float z, float& localX, float& localZ) const;
+	float SampleCoarse(float x, float z) const;
+
+	MappedFile mFile;
+	TerrainTileInfo mInfo;
+	std::vector<float> mCoarse;
+	uint64_t mBudget = 0;
+
+	// Main thread only.
+	std::map<uint32_t, Tile> mTiles;       // ordered so eviction ties resolve by index, deterministically
+	std::vector<const Tile*> mTileLookup;  // tilesX * tilesZ, nullptr when not resident
+	std::set<uint32_t> mPending;
+	uint64_t mResidentBytes = 0;
+	uint64_t mFrame = 0;
+
+	// Shared with the worker, guarded by mMutex.
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque<uint32_t> mRequests;
+	std::deque<DecodedTile> mDecoded;
+	bool mStop = false;
+	std::thread mWorker;
+};
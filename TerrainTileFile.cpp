@@ -0,0 +1,227 @@
+#include "TerrainTileFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	const uint32_t TileMagic = 0x4C495454; // "TTIL"
+	const uint32_t TileVersion = 2; // 2 added the source stamp, older files are converted again
+	const uint32_t MaxTileSize = 4096;
+	const uint32_t MaxTileCount = 65536; // per axis
+
+	uint32_t ReadU32(const uint8_t* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	uint64_t ReadU64(const uint8_t* p)
+	{
+		uint64_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	float ReadF32(const uint8_t* p)
+	{
+		float value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	uint64_t AlignPage(uint64_t size)
+	{
+		return (size + TerrainTilePageSize - 1) / TerrainTilePageSize * TerrainTilePageSize;
+	}
+
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		return hash;
+	}
+
+	int8_t ToSnorm8(float value)
+	{
+		return static_cast<int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+	}
+}
+
+uint32_t TerrainTileInfo::GetCoarseWidth() const
+{
+	return tilesX * (tileSize / coarseStep) + 1;
+}
+
+uint32_t TerrainTileInfo::GetCoarseHeight() const
+{
+	return tilesZ * (tileSize / coarseStep) + 1;
+}
+
+uint64_t TerrainTileInfo::GetCoarseOffset() const
+{
+	return TerrainTileHeaderSize;
+}
+
+uint64_t TerrainTileInfo::GetTileStride() const
+{
+	uint64_t samples = static_cast<uint64_t>(tileSize + 1) * (tileSize + 1);
+	return AlignPage(samples * TerrainTileSampleSize);
+}
+
+uint64_t TerrainTileInfo::GetTileOffset(uint32_t tileX, uint32_t tileZ) const
+{
+	uint64_t coarseBytes = static_cast<uint64_t>(GetCoarseWidth()) * GetCoarseHeight() * sizeof(float);
+	uint64_t first = AlignPage(GetCoarseOffset() + coarseBytes);
+	return first + (static_cast<uint64_t>(tileZ) * tilesX + tileX) * GetTileStride();
+}
+
+uint64_t TerrainTileInfo::GetFileSize() const
+{
+	return GetTileOffset(0, tilesZ);
+}
+
+bool TerrainTileInfo::IsValid() const
+{
+	if (tileSize == 0 || tileSize > MaxTileSize) return false;
+	if (tilesX == 0 || tilesZ == 0 || tilesX > MaxTileCount || tilesZ > MaxTileCount) return false;
+	if (coarseStep == 0 || tileSize % coarseStep != 0) return false;
+	if (!(scale > 0.0f) || !(maxHeight >= minHeight)) return false;
+	return true;
+}
+
+bool ParseTerrainTileHeader(const uint8_t* data, size_t size, TerrainTileInfo& info)
+{
+	info = TerrainTileInfo{};
+	if (data == nullptr || size < TerrainTileHeaderSize) return false;
+	if (ReadU32(data) != TileMagic || ReadU32(data + 4) != TileVersion) return false;
+
+	info.tileSize = ReadU32(data + 8);
+	info.tilesX = ReadU32(data + 12);
+	info.tilesZ = ReadU32(data + 16);
+	info.coarseStep = ReadU32(data + 20);
+	info.scale = ReadF32(data + 24);
+	info.minHeight = ReadF32(data + 28);
+	info.maxHeight = ReadF32(data + 32);
+	info.source.size = ReadU64(data + 36);
+	info.source.hash = ReadU64(data + 44);
+	if (!info.IsValid()) return false;
+	return info.GetFileSize() <= size;
+}
+
+bool HashTerrainTileSource(const std::wstring& fileName, std::initializer_list<int32_t> settings, TerrainTileSource& source)
+{
+	source = TerrainTileSource{};
+	std::ifstream in{ std::filesystem::path{ fileName }, std::ios::binary };
+	if (!in) return false;
+	uint64_t hash = 0xCBF29CE484222325ull;
+	char buffer[64 * 1024];
+	while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+	{
+		hash = HashBytes(buffer, static_cast<size_t>(in.gcount()), hash);
+		source.size += static_cast<uint64_t>(in.gcount());
+	}
+	if (in.bad()) return false;
+	for (int32_t setting : settings) hash = HashBytes(&setting, sizeof(setting), hash);
+	source.hash = hash;
+	return true;
+}
+
+float DecodeTerrainTileHeight(const TerrainTileInfo& info, uint16_t quantized)
+{
+	const float heightStep = (info.maxHeight - info.minHeight) / 65535.0f;
+	return info.minHeight + quantized * heightStep;
+}
+
+bool WriteTerrainTiles(const std::wstring& fileName, const TerrainTileInfo& info, const std::function<float(uint32_t, uint32_t)>& height)
+{
+	if (!info.IsValid()) return false;
+	std::ofstream out{ std::filesystem::path{ fileName }, std::ios::binary | std::ios::trunc };
+	if (!out) return false;
+
+	uint8_t header[TerrainTileHeaderSize]{};
+	const uint32_t fields[] = { TileMagic, TileVersion, info.tileSize, info.tilesX, info.tilesZ, info.coarseStep };
+	memcpy(header, fields, sizeof(fields));
+	memcpy(header + 24, &info.scale, sizeof(float));
+	memcpy(header + 28, &info.minHeight, sizeof(float));
+	memcpy(header + 32, &info.maxHeight, sizeof(float));
+	memcpy(header + 36, &info.source.size, sizeof(uint64_t));
+	memcpy(header + 44, &info.source.hash, sizeof(uint64_t));
+	out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+	const uint32_t coarseWidth = info.GetCoarseWidth();
+	const uint32_t coarseHeight = info.GetCoarseHeight();
+	std::vector<float> coarseRow(coarseWidth);
+	for (uint32_t z = 0; z < coarseHeight; ++z)
+	{
+		for (uint32_t x = 0; x < coarseWidth; ++x) coarseRow[x] = height(x * info.coarseStep, z * info.coarseStep);
+		out.write(reinterpret_cast<const char*>(coarseRow.data()), coarseRow.size() * sizeof(float));
+	}
+
+	const uint32_t T = info.tileSize;
+	const uint32_t width = info.tilesX * T + 1;  // samples
+	const uint32_t depth = info.tilesZ * T + 1;
+	const float range = info.maxHeight - info.minHeight;
+	const float s = info.scale;
+
+	// One tile row of heights plus a one-sample border for the normals.
+	std::vector<float> rows(static_cast<size_t>(T + 3) * width);
+	std::vector<uint8_t> tile(info.GetTileStride());
+	for (uint32_t tileZ = 0; tileZ < info.tilesZ; ++tileZ)
+	{
+		const int64_t firstRow = static_cast<int64_t>(tileZ) * T - 1;
+		for (uint32_t r = 0; r < T + 3; ++r)
+		{
+			int64_t z = std::clamp<int64_t>(firstRow + r, 0, depth - 1);
+			for (uint32_t x = 0; x < width; ++x) rows[static_cast<size_t>(r) * width + x] = height(x, static_cast<uint32_t>(z));
+		}
+
+		for (uint32_t tileX = 0; tileX < info.tilesX; ++tileX)
+		{
+			std::fill(tile.begin(), tile.end(), uint8_t{ 0 });
+			for (uint32_t row = 0; row <= T; ++row)
+			{
+				const uint32_t z = tileZ * T + row;
+				const float* center = &rows[static_cast<size_t>(row + 1) * width];
+				const float* up = z < depth - 1 ? center + width : center;
+				const float* down = z > 0 ? center - width : center;
+				const float dz = (z < depth - 1 ? s : 0.0f) + (z > 0 ? s : 0.0f);
+				for (uint32_t column = 0; column <= T; ++column)
+				{
+					const uint32_t x = tileX * T + column;
+					const uint32_t left = x > 0 ? x - 1 : x;
+					const uint32_t right = x < width - 1 ? x + 1 : x;
+					const float dx = static_cast<float>(right - left) * s;
+
+					// cross(up - down, right - left), the same normal CreateTerrain builds.
+					float hx = center[right] - center[left];
+					float hz = up[x] - down[x];
+					float nx = -dz * hx;
+					float ny = dz * dx;
+					float nz = -hz * dx;
+					float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+					if (length > 0.0f)
+					{
+						nx /= length;
+						nz /= length;
+					}
+
+					float normalized = range > 0.0f ? (center[x] - info.minHeight) / range : 0.0f;
+					uint16_t quantized = static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+					uint8_t* sample = &tile[(static_cast<size_t>(row) * (T + 1) + column) * TerrainTileSampleSize];
+					memcpy(sample, &quantized, sizeof(quantized));
+					sample[2] = static_cast<uint8_t>(ToSnorm8(nx));
+					sample[3] = static_cast<uint8_t>(ToSnorm8(nz));
+				}
+			}
+
+			out.seekp(static_cast<std::streamoff>(info.GetTileOffset(tileX, tileZ)));
+			out.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+		}
+	}
+	return static_cast<bool>(out);
+}
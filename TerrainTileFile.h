@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <string>
+
+// Tiled terrain file (.tiles), little endian:
+//   header, TerrainTileHeaderSize bytes, ending with the TerrainTileSource the file was converted from
+//   coarse height grid, float, one sample every coarseStep samples, read once at open
+//   tiles in row-major order, each starting on a TerrainTilePageSize boundary and holding
+//   (tileSize + 1)^2 samples of { uint16 height, int8 normalX, int8 normalZ }
+// Neighbouring tiles repeat their shared border samples, so a tile is sampled without its neighbours.
+const size_t TerrainTileHeaderSize = 64;
+const size_t TerrainTileSampleSize = 4;
+const uint64_t TerrainTilePageSize = 4096;
+
+// The map a .tiles file was converted from: its size and an FNV-1a hash of its bytes followed by the
+// conversion settings. Kept in the header so a loader can tell a stale file and convert again.
+struct TerrainTileSource
+{
+	uint64_t size = 0;
+	uint64_t hash = 0;
+
+	bool operator==(const TerrainTileSource&) const = default;
+};
+
+struct TerrainTileInfo
+{
+	uint32_t tileSize = 0;   // quads along each tile side
+	uint32_t tilesX = 0;
+	uint32_t tilesZ = 0;
+	uint32_t coarseStep = 0; // coarse grid spacing in samples, divides tileSize
+	float scale = 1.0f;      // world units between samples
+	float minHeight = 0.0f;  // range the 16-bit heights are quantized to
+	float maxHeight = 0.0f;
+	TerrainTileSource source; // zero when the heights did not come from a file
+
+	// Derived from the fields above.
+	uint32_t GetCoarseWidth() const;
+	uint32_t GetCoarseHeight() const;
+	uint64_t GetCoarseOffset() const;
+	uint64_t GetTileOffset(uint32_t tileX, uint32_t tileZ) const;
+	uint64_t GetTileStride() const;
+	uint64_t GetFileSize() const;
+	bool IsValid() const;
+};
+
+bool ParseTerrainTileHeader(const uint8_t* data, size_t size, TerrainTileInfo& info);
+// Reads fileName and hashes it with the settings it is converted with. False if it cannot be read.
+bool HashTerrainTileSource(const std::wstring& fileName, std::initializer_list<int32_t> settings, TerrainTileSource& source);
+// Height of a stored 16-bit sample. Every reader decodes through this, so they agree to the bit.
+float DecodeTerrainTileHeight(const TerrainTileInfo& info, uint16_t quantized);
+
+// Streams the file out one tile row at a time, so the source map never has to fit in memory.
+// height(x, z) is called with sample coordinates in [0, tilesX * tileSize] x [0, tilesZ * tileSize].
+// Normals follow CreateTerrain: central differences, clamped to the sample itself on the map border.
+bool WriteTerrainTiles(const std::wstring& fileName, const TerrainTileInfo& info, const std::function<float(uint32_t, uint32_t)>& height);
@@ -0,0 +1,143 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "DDSHeader.h"
+#include "Test.h"
+
+// ParseDDSHeader against a texture the game ships, cut short, with single fields broken, with a DX10
+// header spliced in, and with random header bytes and lengths. Every input is copied into a heap buffer of
+// exactly its size, so a read past the end shows up under the address sanitizer build.
+//   DDSHeaderTest <grass.dds>
+
+namespace
+{
+	bool Parse(const uint8_t* data, size_t size, DDSInfo& info)
+	{
+		std::vector<uint8_t> exact(data, data + size);
+		return ParseDDSHeader(exact.empty() ? nullptr : exact.data(), exact.size(), info);
+	}
+
+	bool Parse(const std::vector<uint8_t>& bytes, DDSInfo& info)
+	{
+		return Parse(bytes.data(), bytes.size(), info);
+	}
+
+	void Write(std::vector<uint8_t>& bytes, size_t offset, uint32_t value)
+	{
+		memcpy(bytes.data() + offset, &value, sizeof(value));
+	}
+
+	// A 512x512 DDS without a DX10 header: the game's grass texture.
+	void TestValid(const std::vector<uint8_t>& dds)
+	{
+		DDSInfo info;
+		TEST_CHECK(Parse(dds, info));
+		TEST_CHECK(info.width == 512 && info.height == 512 && info.depth == 1 && !info.hasDX10Header);
+		TEST_CHECK(info.dataOffset == 128 && info.dataOffset + info.dataSize == dds.size());
+		TEST_CHECK(!ParseDDSHeader(nullptr, 0, info));
+	}
+
+	void TestTruncated(const std::vector<uint8_t>& dds)
+	{
+		// Without a single byte of pixel data every length fails.
+		DDSInfo info;
+		for (size_t size = 0; size <= 128; ++size) TEST_CHECK(!Parse(dds.data(), size, info));
+		TEST_CHECK(Parse(dds.data(), 129, info) && info.dataSize == 1);
+	}
+
+	void TestCorrupted(const std::vector<uint8_t>& dds)
+	{
+		auto corrupt = [&dds](size_t offset, uint32_t value) {
+			std::vector<uint8_t> copy{ dds };
+			Write(copy, offset, value);
+			DDSInfo info;
+			return Parse(copy, info);
+		};
+		TEST_CHECK(!corrupt(0, 0x20534445));      // magic
+		TEST_CHECK(!corrupt(4, 123));             // header size
+		TEST_CHECK(!corrupt(4 + 72, 31));         // pixel format size
+		TEST_CHECK(!corrupt(4 + 8, 0));           // height 0
+		TEST_CHECK(!corrupt(4 + 12, 16385));      // width over the limit
+		TEST_CHECK(!corrupt(4 + 20, 0xFFFFFFFF)); // depth
+		TEST_CHECK(!corrupt(4 + 24, 16));         // mip count
+		TEST_CHECK(corrupt(4 + 24, 15));
+	}
+
+	// grass.dds with a DX10 header of the given array size between the header and the pixels.
+	std::vector<uint8_t> WithDX10Header(const std::vector<uint8_t>& dds, uint32_t arraySize)
+	{
+		std::vector<uint8_t> dx10{ dds.begin(), dds.begin() + 128 };
+		Write(dx10, 4 + 72 + 4, 4);          // DDPF_FOURCC
+		Write(dx10, 4 + 72 + 8, 0x30315844); // "DX10"
+		dx10.insert(dx10.end(), 20, 0);
+		Write(dx10, 128 + 12, arraySize);
+		dx10.insert(dx10.end(), dds.begin() + 128, dds.end());
+		return dx10;
+	}
+
+	void TestDX10(const std::vector<uint8_t>& dds)
+	{
+		DDSInfo info;
+		const std::vector<uint8_t> cube = WithDX10Header(dds, 6);
+		TEST_CHECK(Parse(cube, info) && info.hasDX10Header && info.arraySize == 6);
+		TEST_CHECK(info.dataOffset == 148 && info.dataOffset + info.dataSize == cube.size());
+		TEST_CHECK(!Parse(cube.data(), 138, info)); // extension header cut short
+		TEST_CHECK(!Parse(cube.data(), 148, info)); // no pixel data
+		TEST_CHECK(!Parse(WithDX10Header(dds, 0), info));
+		TEST_CHECK(!Parse(WithDX10Header(dds, 2049), info));
+	}
+
+	void TestFuzz(const std::vector<uint8_t>& dds)
+	{
+		// Random bytes in the headers and a random length around them. What is accepted must keep to the
+		// limits and point inside the input.
+		const std::vector<uint8_t> dx10 = WithDX10Header(dds, 6);
+		std::mt19937 random{ 31 };
+		size_t accepted = 0;
+		for (int i = 0; i < 100000; ++i)
+		{
+			// Only the headers and a little pixel data take part, the length never grows past that.
+			const std::vector<uint8_t>& source = (i & 1) ? dx10 : dds;
+			const size_t headerSize = 148;
+			std::vector<uint8_t> copy{ source.begin(), source.begin() + headerSize + 16 };
+			for (int k = std::uniform_int_distribution<int>{ 1, 8 }(random); k > 0; --k)
+				copy[std::uniform_int_distribution<size_t>{ 0, headerSize - 1 }(random)] = uint8_t(random());
+			copy.resize(std::uniform_int_distribution<size_t>{ 0, headerSize + 16 }(random));
+			DDSInfo info;
+			if (!Parse(copy, info)) continue;
+			++accepted;
+			TEST_CHECK(info.width > 0 && info.width <= 16384 && info.height > 0 && info.height <= 16384);
+			TEST_CHECK(info.depth > 0 && info.depth <= 16384 && info.mipCount > 0 && info.mipCount <= 15);
+			TEST_CHECK(!info.hasDX10Header || (info.arraySize > 0 && info.arraySize <= 2048));
+			TEST_CHECK(info.dataOffset < copy.size() && info.dataOffset + info.dataSize == copy.size());
+		}
+		// Most mutations hit bytes the parser does not look at, so a fair share must still get through.
+		TEST_CHECK(accepted > 1000);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: DDSHeaderTest <grass.dds>\n");
+		return 2;
+	}
+	std::ifstream file{ argv[1], std::ios::binary };
+	const std::vector<uint8_t> dds{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	if (dds.size() <= 148)
+	{
+		std::fprintf(stderr, "could not read %s\n", argv[1]);
+		return 2;
+	}
+
+	TestValid(dds);
+	TestTruncated(dds);
+	TestCorrupted(dds);
+	TestDX10(dds);
+	TestFuzz(dds);
+	return TestResult();
+}
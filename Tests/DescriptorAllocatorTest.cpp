@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+#include "DescriptorAllocator.h"
+#include "Test.h"
+
+// DescriptorAllocator without a device: the persistent free list and its generations, and the per-frame ring
+// retired one frame late as if the GPU still held the last frame.
+
+namespace
+{
+	void TestPersistent()
+	{
+		DescriptorAllocator allocator{ 8, 0 };
+		const DescriptorHandle a = allocator.Allocate(3);
+		const DescriptorHandle b = allocator.Allocate(2);
+		TEST_CHECK(a.index == 0 && b.index == 3 && allocator.GetFreePersistentCount() == 3);
+		TEST_CHECK(allocator.Allocate(4).IsNull());
+
+		// A freed handle is dead, and stays dead after its slots are handed out again.
+		TEST_CHECK(allocator.Free(a));
+		TEST_CHECK(!allocator.IsAlive(a) && !allocator.Free(a));
+		const DescriptorHandle c = allocator.Allocate(3);
+		TEST_CHECK(c.index == 0 && allocator.IsAlive(c) && !allocator.IsAlive(a));
+
+		// Freed neighbours merge, so the whole heap fits again.
+		TEST_CHECK(allocator.Free(b) && allocator.Free(c));
+		const DescriptorHandle all = allocator.Allocate(8);
+		TEST_CHECK(all.index == 0 && all.count == 8);
+		TEST_CHECK(allocator.Allocate(0).IsNull());
+	}
+
+	void TestRing()
+	{
+		// Ranges of 1, 2 and 3 slots every frame on a small ring, released a frame late. Wrapping at the end must not
+		// hand out a range outside the ring or over one still in flight.
+		DescriptorAllocator ring{ 4, 13 };
+		std::deque<std::vector<std::pair<uint32_t, uint32_t>>> inFlight;
+		uint64_t wraps = 0;
+		for (uint64_t frame = 1; frame <= 100; ++frame)
+		{
+			std::vector<std::pair<uint32_t, uint32_t>> ranges;
+			for (uint32_t count : { 1u, 2u, 3u })
+			{
+				const uint32_t index = ring.AllocateTransient(count);
+				TEST_CHECK(index != UINT32_MAX);
+				if (index == UINT32_MAX) continue;
+				TEST_CHECK(index >= ring.GetPersistentCount() && index + count <= ring.GetHeapSize());
+				if (!ranges.empty() && index < ranges.back().first) ++wraps;
+				for (const auto& frameRanges : inFlight)
+				{
+					for (auto [first, size] : frameRanges) TEST_CHECK(index + count <= first || first + size <= index);
+				}
+				for (auto [first, size] : ranges) TEST_CHECK(index + count <= first || first + size <= index);
+				ranges.push_back({ index, count });
+			}
+			ring.FinishFrame(frame);
+			inFlight.push_back(std::move(ranges));
+			ring.Retire(frame - 1);
+			if (inFlight.size() > 1) inFlight.pop_front();
+		}
+		TEST_CHECK(wraps > 0);
+
+		// With the last frame's 6 slots still in flight 8 do not fit; once it is retired the whole ring does.
+		TEST_CHECK(ring.AllocateTransient(8) == UINT32_MAX);
+		ring.Retire(100);
+		TEST_CHECK(ring.GetUsedRingCount() == 0);
+		TEST_CHECK(ring.AllocateTransient(ring.GetRingCount()) == ring.GetPersistentCount());
+		TEST_CHECK(ring.AllocateTransient(ring.GetRingCount() + 1) == UINT32_MAX);
+	}
+}
+
+int main()
+{
+	TestPersistent();
+	TestRing();
+	return TestResult();
+}
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "JobSystem.h"
+#include "Test.h"
+
+// JobSystem semantics for 1 to 8 threads in both modes, then seeded random patterns meant for the thread
+// sanitizer build: nested ParallelFor trees, dependency graphs waited on from jobs, and jobs stolen off a
+// worker's queue. A data race or a lost wakeup fails here instead of as a hitch in the game.
+
+namespace
+{
+	const uint32_t ThreadCounts[] = { 1, 2, 4, 8 };
+
+	void TestChain(JobSystem& jobSystem)
+	{
+		// A job starts only once the counter it depends on is zero.
+		std::vector<JobCounter> chain(64);
+		std::atomic<size_t> next{ 0 };
+		std::atomic<bool> ordered{ true };
+		for (size_t i = 0; i < chain.size(); ++i)
+			jobSystem.Schedule([&next, &ordered, i]() { if (next.fetch_add(1) != i) ordered = false; }, &chain[i], i > 0 ? &chain[i - 1] : nullptr);
+		for (JobCounter& counter : chain) jobSystem.Wait(counter);
+		TEST_CHECK(ordered && next == chain.size());
+	}
+
+	void TestFanIn(JobSystem& jobSystem)
+	{
+		JobCounter parts, joined;
+		std::atomic<int> finished{ 0 };
+		bool joinSawAll = false;
+		for (int i = 0; i < 64; ++i) jobSystem.Schedule([&finished]() { finished.fetch_add(1); }, &parts);
+		jobSystem.Schedule([&finished, &joinSawAll]() { joinSawAll = finished.load() == 64; }, &joined, &parts);
+		jobSystem.Wait(joined);
+		jobSystem.Wait(parts);
+		TEST_CHECK(joinSawAll);
+	}
+
+	void TestNestedWait(JobSystem& jobSystem)
+	{
+		// Jobs that Schedule, Wait and ParallelFor themselves.
+		std::vector<uint64_t> sums(32, 0);
+		jobSystem.ParallelFor(sums.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				std::atomic<uint64_t> sum{ 0 };
+				JobCounter inner;
+				for (uint64_t k = 0; k < 8; ++k) jobSystem.Schedule([&sum, i, k]() { sum.fetch_add(i * 8 + k); }, &inner);
+				jobSystem.ParallelFor(64, 8, [&sum](size_t innerBegin, size_t innerEnd) {
+					for (size_t k = innerBegin; k < innerEnd; ++k) sum.fetch_add(k);
+				});
+				jobSystem.Wait(inner);
+				sums[i] = sum.load();
+			}
+		});
+		for (size_t i = 0; i < sums.size(); ++i) TEST_CHECK(sums[i] == i * 64 + 28 + 2016);
+	}
+
+	void TestChunkOrder(JobSystem& jobSystem)
+	{
+		// Chunks are 0, 7, 14, ... whatever thread runs them. Deterministic mode runs them in that order and
+		// scheduled jobs inside Wait in submission order; otherwise each chunk and job runs once in any order.
+		std::mutex orderMutex;
+		std::vector<size_t> order;
+		JobCounter sequence;
+		for (size_t i = 0; i < 16; ++i)
+			jobSystem.Schedule([&orderMutex, &order, i]() { std::lock_guard<std::mutex> lock{ orderMutex }; order.push_back(1000 + i); }, &sequence);
+		jobSystem.ParallelFor(100, 7, [&orderMutex, &order](size_t begin, size_t end) {
+			std::lock_guard<std::mutex> lock{ orderMutex };
+			order.push_back(begin);
+			order.push_back(end);
+		});
+		jobSystem.Wait(sequence);
+
+		std::vector<size_t> expected;
+		for (size_t begin = 0; begin < 100; begin += 7) expected.insert(expected.end(), { begin, std::min<size_t>(begin + 7, 100) });
+		for (size_t i = 0; i < 16; ++i) expected.push_back(1000 + i);
+		if (!jobSystem.IsDeterministic())
+		{
+			std::vector<std::pair<size_t, size_t>> chunks;
+			std::vector<size_t> jobs;
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				if (order[i] >= 1000) jobs.push_back(order[i]);
+				else if (i + 1 < order.size()) chunks.push_back({ order[i], order[i + 1] }), ++i;
+			}
+			std::sort(chunks.begin(), chunks.end());
+			std::sort(jobs.begin(), jobs.end());
+			order.clear();
+			for (auto [begin, end] : chunks) order.insert(order.end(), { begin, end });
+			order.insert(order.end(), jobs.begin(), jobs.end());
+		}
+		TEST_CHECK(order == expected);
+	}
+
+	// A random tree of ParallelFor calls, built up front from a seed so it is the same on every run. Every
+	// item has its own slot, which must be hit exactly once however the chunks are spread over threads.
+	struct ForNode
+	{
+		size_t chunkSize = 1;
+		std::vector<size_t> slots;
+		std::vector<std::unique_ptr<ForNode>> children; // per item, null for a leaf
+	};
+
+	std::unique_ptr<ForNode> BuildForTree(std::mt19937& random, uint32_t depth, size_t& slotCount)
+	{
+		auto node = std::make_unique<ForNode>();
+		const size_t count = 1 + random() % 24;
+		node->chunkSize = 1 + random() % 5;
+		for (size_t i = 0; i < count; ++i)
+		{
+			node->slots.push_back(slotCount++);
+			node->children.push_back(depth > 0 && random() % 3 == 0 ? BuildForTree(random, depth - 1, slotCount) : nullptr);
+		}
+		return node;
+	}
+
+	void RunForTree(JobSystem& jobSystem, const ForNode& node, std::vector<std::atomic<uint32_t>>& hits)
+	{
+		jobSystem.ParallelFor(node.slots.size(), node.chunkSize, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				hits[node.slots[i]].fetch_add(1, std::memory_order_relaxed);
+				if (node.children[i]) RunForTree(jobSystem, *node.children[i], hits);
+			}
+		});
+	}
+
+	void TestRandomNestedParallelFor(JobSystem& jobSystem)
+	{
+		std::mt19937 random{ 17 };
+		for (int tree = 0; tree < 40; ++tree)
+		{
+			size_t slotCount = 0;
+			const std::unique_ptr<ForNode> root = BuildForTree(random, 3, slotCount);
+			std::vector<std::atomic<uint32_t>> hits(slotCount);
+			RunForTree(jobSystem, *root, hits);
+			for (std::atomic<uint32_t>& hit : hits) TEST_CHECK(hit.load() == 1);
+		}
+	}
+
+	void TestRandomDependencies(JobSystem& jobSystem)
+	{
+		// Random graphs: each job depends on the counter of a random earlier job, or on none, and some jobs
+		// wait on another earlier counter from inside. A job must never start before its dependency finished.
+		// Waiting runs other jobs on the same stack, so like the game a job only waits on jobs that never
+		// wait themselves, directly or through a dependency; anything else can deadlock by design.
+		std::mt19937 random{ 41 };
+		for (int graph = 0; graph < 20; ++graph)
+		{
+			const size_t jobCount = 200;
+			std::vector<JobCounter> counters(jobCount);
+			std::vector<std::atomic<bool>> finished(jobCount);
+			std::vector<size_t> nonWaiting;
+			std::vector<bool> waits(jobCount, false);
+			std::atomic<int> violations{ 0 };
+			for (size_t i = 0; i < jobCount; ++i)
+			{
+				const size_t dependency = i > 0 && random() % 4 ? random() % i : SIZE_MAX;
+				const size_t waited = !nonWaiting.empty() && random() % 8 == 0 ? nonWaiting[random() % nonWaiting.size()] : SIZE_MAX;
+				waits[i] = waited != SIZE_MAX || (dependency != SIZE_MAX && waits[dependency]);
+				if (!waits[i]) nonWaiting.push_back(i);
+				jobSystem.Schedule([&, i, dependency, waited]() {
+					if (dependency != SIZE_MAX && !finished[dependency].load()) violations.fetch_add(1);
+					if (waited != SIZE_MAX)
+					{
+						jobSystem.Wait(counters[waited]);
+						if (!finished[waited].load()) violations.fetch_add(1);
+					}
+					finished[i].store(true);
+				}, &counters[i], dependency != SIZE_MAX ? &counters[dependency] : nullptr);
+			}
+			for (JobCounter& counter : counters) jobSystem.Wait(counter);
+			TEST_CHECK(violations == 0);
+			for (std::atomic<bool>& done : finished) TEST_CHECK(done.load());
+		}
+	}
+
+	void TestShortLivedCounters(JobSystem& jobSystem)
+	{
+		// A counter may go out of scope as soon as Wait returns, while the job that finished it is still
+		// releasing its dependents.
+		std::atomic<int> ran{ 0 };
+		for (int i = 0; i < 500; ++i)
+		{
+			JobCounter counter, dependents;
+			jobSystem.Schedule([&ran]() { ran.fetch_add(1); }, &counter);
+			for (int k = 0; k < 4; ++k) jobSystem.Schedule([&ran]() { ran.fetch_add(1); }, &dependents, &counter);
+			jobSystem.Wait(dependents);
+			jobSystem.Wait(counter);
+		}
+		TEST_CHECK(ran == 500 * 5);
+	}
+
+	void TestSteal(JobSystem& jobSystem)
+	{
+		// One job fills its worker's own queue; the other workers can only get at those jobs by stealing.
+		std::mutex threadsMutex;
+		std::set<std::thread::id> threads;
+		std::atomic<int> ran{ 0 };
+		JobCounter outer, inner;
+		jobSystem.Schedule([&]() {
+			for (int i = 0; i < 64; ++i)
+			{
+				jobSystem.Schedule([&]() {
+					std::this_thread::sleep_for(std::chrono::microseconds(500));
+					std::lock_guard<std::mutex> lock{ threadsMutex };
+					threads.insert(std::this_thread::get_id());
+					ran.fetch_add(1);
+				}, &inner);
+			}
+			jobSystem.Wait(inner);
+		}, &outer);
+		jobSystem.Wait(outer);
+		TEST_CHECK(ran == 64);
+		if (jobSystem.GetWorkerCount() >= 2 && !jobSystem.IsDeterministic()) TEST_CHECK(threads.size() >= 2);
+		if (jobSystem.IsDeterministic()) TEST_CHECK(threads.size() == 1 && *threads.begin() == std::this_thread::get_id());
+	}
+}
+
+int main()
+{
+	for (uint32_t threads : ThreadCounts)
+	{
+		for (bool deterministic : { false, true })
+		{
+			JobSystem jobSystem{ threads - 1 };
+			jobSystem.SetDeterministic(deterministic);
+			TestChain(jobSystem);
+			TestFanIn(jobSystem);
+			TestNestedWait(jobSystem);
+			TestChunkOrder(jobSystem);
+			TestRandomNestedParallelFor(jobSystem);
+			TestRandomDependencies(jobSystem);
+			TestShortLivedCounters(jobSystem);
+			TestSteal(jobSystem);
+		}
+	}
+	return TestResult();
+}
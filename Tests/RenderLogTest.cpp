@@ -0,0 +1,171 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "RecordingRenderDevice.h"
+#include "RenderLog.h"
+#include "Test.h"
+
+// Records a fixed command sequence on the null device and compares the log with the checked-in golden
+// one, byte for byte and counter by counter. A change to the log format or to what the device records
+// shows up here first. Run with --update after an intended change to rewrite the golden log.
+//   RenderLogTest <golden.rlog> [--update]
+
+namespace
+{
+	// A setup with every kind of resource and view, two frames of a shadow and a main pass, and the
+	// resources released afterwards. Some state is set twice on purpose so redundant states are counted.
+	void RecordSequence(RecordingRenderDevice& device)
+	{
+		RenderDescriptorHeap heap = device.CreateDescriptorHeap(RenderDescriptorType::CbvSrvUav, 16, true);
+		RenderDescriptorHeap rtvHeap = device.CreateDescriptorHeap(RenderDescriptorType::Rtv, 1, false);
+		RenderDescriptorHeap dsvHeap = device.CreateDescriptorHeap(RenderDescriptorType::Dsv, 1, false);
+		RenderBuffer constants = device.CreateUploadBuffer(256);
+		const uint32_t indices[96] = {};
+		RenderBuffer vertexBuffer = device.CreateStaticBuffer(indices, 384);
+		RenderBuffer indexBuffer = device.CreateStaticBuffer(indices, 120);
+		RenderTexture depth = device.CreateDepthTexture(64, 64, RenderState::GenericRead);
+		RenderHandle rootSignature = device.CreateHandle();
+		RenderHandle opaque = device.CreateHandle();
+		RenderHandle shadow = device.CreateHandle();
+		device.CreateConstantBufferView(constants.address, 256, heap.GetCpu(0));
+		device.CreateDepthStencilView(depth, dsvHeap.GetCpu(0));
+		device.CreateDepthShaderResourceView(&depth, heap.GetCpu(1));
+		device.CreateDepthShaderResourceView(nullptr, heap.GetCpu(2));
+		device.CreateStructuredBufferView(constants, 16, heap.GetCpu(3));
+
+		for (uint64_t frame = 0; frame < 2; ++frame)
+		{
+			device.BeginFrame(frame);
+			const float world[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -0.5f * frame, 1.0f };
+			device.Write(constants, 0, world, sizeof(world));
+			device.SetRootSignature(rootSignature);
+			device.SetDescriptorHeap(heap.heap);
+			device.SetRootDescriptorTable(0, heap.GetGpu(0));
+			device.SetRootDescriptorTable(3, heap.GetGpu(2));
+			device.SetViewport({ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f });
+			device.SetScissor({ 0, 0, 1280, 720 });
+			device.SetTriangleList();
+			device.SetVertexBuffer(vertexBuffer.address, 384, 32);
+			device.SetIndexBuffer(indexBuffer.address, 120);
+
+			device.Barrier(depth.resource, RenderState::GenericRead, RenderState::DepthWrite);
+			device.SetRenderTarget(0, dsvHeap.GetCpu(0));
+			device.ClearDepthStencil(dsvHeap.GetCpu(0), 1.0f, 0);
+			device.SetPipelineState(shadow);
+			device.Draw(36, 0);
+			device.DrawIndexed(30, 0, 4);
+			device.Barrier(depth.resource, RenderState::DepthWrite, RenderState::GenericRead);
+
+			device.SetRootDescriptorTable(3, heap.GetGpu(1));
+			device.SetRootDescriptorTable(0, heap.GetGpu(0));
+			const float clearColor[4] = { 0.1f, 0.2f, 0.3f, 1.0f };
+			device.SetRenderTarget(rtvHeap.GetCpu(0), dsvHeap.GetCpu(0));
+			device.ClearRenderTarget(rtvHeap.GetCpu(0), clearColor);
+			device.SetPipelineState(opaque);
+			device.Draw(36, 0);
+			device.SetPipelineState(opaque);
+			device.DrawIndexed(30, 0, 4);
+			if (frame == 1)
+			{
+				device.CopyResource(vertexBuffer.resource, indexBuffer.resource);
+				device.DrawIndexed(6, 30, -2);
+			}
+			device.EndFrame();
+		}
+
+		device.Release(constants.resource);
+		device.Release(vertexBuffer.resource);
+		device.Release(indexBuffer.resource);
+		device.Release(depth.resource);
+	}
+
+	void CheckFrame(const RenderFrameStats& stats, uint32_t commands, uint32_t draws, uint64_t primitives, uint32_t copies)
+	{
+		TEST_CHECK(stats.commands == commands);
+		TEST_CHECK(stats.draws == draws);
+		TEST_CHECK(stats.primitives == primitives);
+		TEST_CHECK(stats.pipelineChanges == 2);
+		TEST_CHECK(stats.bindingChanges == 12);
+		TEST_CHECK(stats.redundantStates == 2);
+		TEST_CHECK(stats.barriers == 2);
+		TEST_CHECK(stats.copies == copies);
+		TEST_CHECK(stats.clears == 2);
+		TEST_CHECK(stats.resources == 0);
+		TEST_CHECK(stats.uploadBytes == 64);
+	}
+
+	std::vector<uint8_t> ReadFile(const std::filesystem::path& fileName)
+	{
+		std::ifstream in{ fileName, std::ios::binary };
+		return { std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: RenderLogTest <golden.rlog> [--update]\n");
+		return 2;
+	}
+	const std::filesystem::path goldenFile{ argv[1] };
+
+	RecordingRenderDevice device;
+	RecordSequence(device);
+	const std::vector<uint8_t>& bytes = device.GetLog().GetBytes();
+
+	if (argc > 2 && std::strcmp(argv[2], "--update") == 0)
+	{
+		if (!device.SaveLog(goldenFile.wstring()))
+		{
+			std::fprintf(stderr, "could not write %s\n", argv[1]);
+			return 2;
+		}
+		std::printf("wrote %zu bytes to %s\n", bytes.size(), argv[1]);
+		return 0;
+	}
+
+	// The counters the device kept while recording, against what the sequence does.
+	const RenderStatsTracker& stats = device.GetStats();
+	TEST_CHECK(stats.GetFrames().size() == 2);
+	if (stats.GetFrames().size() == 2)
+	{
+		CheckFrame(stats.GetFrames()[0], 27, 4, 44, 0);
+		CheckFrame(stats.GetFrames()[1], 29, 5, 46, 1);
+	}
+	TEST_CHECK(stats.GetSetup().commands == 16);
+	TEST_CHECK(stats.GetSetup().resources == 7);
+	TEST_CHECK(stats.GetSetup().uploadBytes == 384 + 120);
+	TEST_CHECK(device.GetLiveBytes() == 0);
+
+	// Reading the log back gives the same counters, and a cut or corrupted log is rejected.
+	RenderStatsTracker readBack;
+	TEST_CHECK(ReadRenderLog(bytes.data(), bytes.size(), readBack));
+	TEST_CHECK(CompareRenderStats(stats, readBack).empty());
+	RenderStatsTracker rejected;
+	TEST_CHECK(!ReadRenderLog(bytes.data(), bytes.size() - 1, rejected));
+	std::vector<uint8_t> corrupted = bytes;
+	corrupted[8] = static_cast<uint8_t>(RenderOp::Count);
+	TEST_CHECK(!ReadRenderLog(corrupted.data(), corrupted.size(), rejected));
+	corrupted = bytes;
+	corrupted[4] ^= 0xFF;
+	TEST_CHECK(!ReadRenderLog(corrupted.data(), corrupted.size(), rejected));
+
+	// The golden log: same bytes, and if not, the counters that moved.
+	const std::vector<uint8_t> golden = ReadFile(goldenFile);
+	TEST_CHECK(!golden.empty());
+	if (golden != bytes)
+	{
+		size_t offset = 0;
+		while (offset < golden.size() && offset < bytes.size() && golden[offset] == bytes[offset]) ++offset;
+		std::fprintf(stderr, "log differs from %s at byte %zu (%zu bytes, golden %zu)\n", argv[1], offset, bytes.size(), golden.size());
+		RenderStatsTracker goldenStats;
+		if (ReadRenderLog(golden.data(), golden.size(), goldenStats))
+			std::fputs(CompareRenderStats(goldenStats, stats).c_str(), stderr);
+		++gTestFailures;
+	}
+	return TestResult();
+}
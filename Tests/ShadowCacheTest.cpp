@@ -0,0 +1,73 @@
+#include <DirectXMath.h>
+#include "ShadowCache.h"
+#include "Test.h"
+
+// ShadowCache invalidation without a device: when the static shadow map has to be drawn again after the light
+// volume moves, and after static casters appear, move, settle within SHADOW_STATIC_TOLERANCE or go away.
+
+namespace
+{
+	DirectX::XMFLOAT4X4 Translation(float x, float y, float z)
+	{
+		return { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, x, y, z, 1.0f };
+	}
+
+	void TestLightVolume()
+	{
+		ShadowCache cache;
+		TEST_CHECK(cache.NeedsStaticRedraw()); // nothing drawn yet
+		TEST_CHECK(cache.UpdateLightVolume({ 0.0f, 0.0f, 0.0f }));
+		cache.OnStaticRedrawn();
+		TEST_CHECK(!cache.UpdateLightVolume({ cache.GetMoveThreshold() * 0.5f, 0.0f, 0.0f }) && !cache.NeedsStaticRedraw());
+		TEST_CHECK(cache.GetCenter().x == 0.0f);
+		TEST_CHECK(cache.UpdateLightVolume({ cache.GetMoveThreshold() * 1.5f, 0.0f, 0.0f }) && cache.NeedsStaticRedraw());
+		TEST_CHECK(cache.GetCenter().x == cache.GetMoveThreshold() * 1.5f);
+	}
+
+	void TestStaticCasters()
+	{
+		ShadowCache cache;
+		cache.UpdateLightVolume({ 0.0f, 0.0f, 0.0f });
+		cache.OnStaticRedrawn();
+
+		DirectX::XMFLOAT4X4 world = Translation(10.0f, 5.0f, 10.0f);
+		cache.UpdateStaticCaster(1, world);
+		TEST_CHECK(cache.NeedsStaticRedraw()); // a new caster
+		cache.OnStaticRedrawn();
+		cache.UpdateStaticCaster(1, world);
+		TEST_CHECK(!cache.NeedsStaticRedraw());
+		world._42 += SHADOW_STATIC_TOLERANCE * 0.5f; // ground-clamp jitter
+		cache.UpdateStaticCaster(1, world);
+		TEST_CHECK(!cache.NeedsStaticRedraw());
+		world._42 += 1.0f; // settling
+		cache.UpdateStaticCaster(1, world);
+		TEST_CHECK(cache.NeedsStaticRedraw());
+		cache.OnStaticRedrawn();
+
+		// The jitter is measured against the matrix the map was drawn with, so small steps cannot add up unseen.
+		for (int i = 0; i < 4; ++i)
+		{
+			world._41 += SHADOW_STATIC_TOLERANCE * 0.4f;
+			cache.UpdateStaticCaster(1, world);
+		}
+		TEST_CHECK(cache.NeedsStaticRedraw());
+		cache.OnStaticRedrawn();
+
+		cache.RemoveStaticCaster(1);
+		TEST_CHECK(cache.NeedsStaticRedraw());
+		cache.OnStaticRedrawn();
+		cache.RemoveStaticCaster(1); // already gone
+		TEST_CHECK(!cache.NeedsStaticRedraw());
+		cache.Invalidate();
+		TEST_CHECK(cache.NeedsStaticRedraw());
+		cache.OnStaticRedrawn();
+		TEST_CHECK(cache.GetStaticRedrawCount() == 6);
+	}
+}
+
+int main()
+{
+	TestLightVolume();
+	TestStaticCasters();
+	return TestResult();
+}
@@ -0,0 +1,115 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "Info.h"
+#include "TerrainMesh.h"
+#include "Test.h"
+
+// TerrainMesh::BuildRow against vertices saved from the terrain code before it computed normals four at a
+// time: one XMVector3Cross and XMVector3Normalize per vertex, on HeightMap.raw with the scale and uv repeat
+// ResourceManager uses. Both the SoA and the scalar path must stay within TERRAIN_NORMAL_TOLERANCE of them.
+// Data/TerrainMeshTest.bin is the reference; it is not regenerated from BuildRow, or the test would only
+// compare the new code with itself.
+//
+// Data/TerrainMeshTest.bin: uint32 width, uint32 row count, then per row uint32 z and width vertices of
+// 8 floats (position xyz, normal xyz, uv xy), little-endian.
+
+namespace
+{
+	const int Scale = 5;
+	const int MaxUV = 50;
+
+	std::vector<uint8_t> ReadBytes(const std::filesystem::path& fileName)
+	{
+		std::ifstream in{ fileName, std::ios::binary };
+		return { std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+	}
+
+	// The same heights ResourceManager::BuildTerrain makes from the raw bytes, row 0 at the bottom.
+	std::vector<float> LoadHeights(const std::vector<uint8_t>& raw, int width, int height)
+	{
+		std::vector<float> heights(raw.size());
+		for (int z = 0; z < height; ++z) {
+			for (int x = 0; x < width; ++x) {
+				heights[z * width + x] = (raw[(height - 1 - z) * width + x] / 255.0f - 0.4f) * 50;
+			}
+		}
+		return heights;
+	}
+
+	uint32_t ReadUint32(const uint8_t*& p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		p += sizeof(value);
+		return value;
+	}
+
+	void CheckRow(const std::vector<float>& heights, int width, int height, int z, const std::vector<Vertex>& golden, bool soaNormals)
+	{
+		std::vector<Vertex> row(width);
+		TerrainMesh::BuildRow(heights, width, height, Scale, MaxUV, z, row.data(), soaNormals);
+
+		int positionErrors = 0;
+		for (int x = 0; x < width; ++x) {
+			const Vertex& a = golden[x];
+			const Vertex& b = row[x];
+			if (a.position.x != b.position.x || a.position.y != b.position.y || a.position.z != b.position.z
+				|| std::fabs(a.uv.x - b.uv.x) > 1e-5f || std::fabs(a.uv.y - b.uv.y) > 1e-5f) ++positionErrors;
+		}
+		TEST_CHECK(positionErrors == 0);
+
+		const float normalError = TerrainMesh::CompareNormals(golden.data(), row.data(), width);
+		if (normalError > TERRAIN_NORMAL_TOLERANCE) {
+			std::fprintf(stderr, "row %d (%s): normals differ by %g\n", z, soaNormals ? "soa" : "scalar", normalError);
+			++gTestFailures;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::fprintf(stderr, "usage: TerrainMeshTest <HeightMap.raw> <TerrainMeshTest.bin>\n");
+		return 2;
+	}
+	const std::vector<uint8_t> raw = ReadBytes(argv[1]);
+	const std::vector<uint8_t> golden = ReadBytes(argv[2]);
+	if (raw.empty() || golden.size() < 8)
+	{
+		std::fprintf(stderr, "could not read %s or %s\n", argv[1], argv[2]);
+		return 2;
+	}
+
+	const uint8_t* p = golden.data();
+	const int width = static_cast<int>(ReadUint32(p));
+	const uint32_t rowCount = ReadUint32(p);
+	const int height = static_cast<int>(raw.size() / width);
+	TEST_CHECK(static_cast<size_t>(width) * height == raw.size());
+	TEST_CHECK(golden.size() == 8 + rowCount * (4 + static_cast<size_t>(width) * 8 * sizeof(float)));
+	if (gTestFailures) return TestResult();
+
+	const std::vector<float> heights = LoadHeights(raw, width, height);
+	for (uint32_t i = 0; i < rowCount; ++i) {
+		const int z = static_cast<int>(ReadUint32(p));
+		std::vector<Vertex> row(width);
+		for (Vertex& vertex : row) {
+			float values[8];
+			std::memcpy(values, p, sizeof(values));
+			p += sizeof(values);
+			vertex.position = { values[0], values[1], values[2] };
+			vertex.normal = { values[3], values[4], values[5] };
+			vertex.uv = { values[6], values[7] };
+		}
+		TEST_CHECK(z >= 0 && z < height);
+		if (z < 0 || z >= height) continue;
+		CheckRow(heights, width, height, z, row, true);
+		CheckRow(heights, width, height, z, row, false);
+	}
+	return TestResult();
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "TerrainQuadTree.h"
+#include "Test.h"
+
+// TerrainQuadTree LOD selections on the game's height map, with the chunk size, scale and LOD distance
+// ResourceManager uses (TERRAIN_CHUNK_QUADS, TERRAIN_LOD_DISTANCE). The camera moves on a grid above, below and
+// beyond the terrain; every selection must be 2:1 balanced with its gaps covered by the skirts. The check itself
+// must reject a selection with a chunk missing or listed twice.
+//   TerrainQuadTreeTest <HeightMap.raw>
+
+namespace
+{
+	const float Scale = 5.0f;
+	const uint32_t ChunkQuads = 32;
+	const float LodDistance = 2.0f;
+
+	// The heights ResourceManager::LoadHeightMap makes from the raw bytes, row 0 at the bottom.
+	std::vector<float> LoadHeights(const std::vector<uint8_t>& raw, uint32_t width, uint32_t height)
+	{
+		std::vector<float> heights(raw.size());
+		for (uint32_t z = 0; z < height; ++z)
+		{
+			for (uint32_t x = 0; x < width; ++x) heights[z * width + x] = (raw[(height - 1 - z) * width + x] / 255.0f - 0.4f) * 50;
+		}
+		return heights;
+	}
+
+	void TestSelections(const TerrainQuadTree& quadTree, float extentX, float extentZ)
+	{
+		const TerrainNode& root = quadTree.GetNode(quadTree.GetRoot());
+		std::vector<uint32_t> leaves;
+		size_t selections = 0, crackedSelections = 0;
+		float worstGap = 0.0f;
+		for (float lodDistance : { 1.0f, LodDistance, 4.0f })
+		{
+			for (float y : { root.minHeight - 10.0f, root.maxHeight + 1.0f, root.maxHeight + extentX * 0.25f })
+			{
+				for (float z = -extentZ * 0.25f; z <= extentZ * 1.25f; z += extentZ / 32)
+				{
+					for (float x = -extentX * 0.25f; x <= extentX * 1.25f; x += extentX / 32)
+					{
+						quadTree.Select(x, y, z, lodDistance, leaves);
+						float gap = 0.0f;
+						++selections;
+						crackedSelections += !quadTree.CheckCrackFree(leaves, &gap);
+						worstGap = std::max(worstGap, gap);
+					}
+				}
+			}
+		}
+		TEST_CHECK(selections > 0 && crackedSelections == 0);
+		if (crackedSelections) std::fprintf(stderr, "%zu of %zu selections cracked, worst edge gap %g\n", crackedSelections, selections, worstGap);
+	}
+
+	void TestBrokenSelections(const TerrainQuadTree& quadTree, float extentX, float extentZ)
+	{
+		const TerrainNode& root = quadTree.GetNode(quadTree.GetRoot());
+		std::vector<uint32_t> leaves;
+		quadTree.Select(extentX * 0.5f, root.maxHeight + 1.0f, extentZ * 0.5f, LodDistance, leaves);
+		TEST_CHECK(leaves.size() > 1 && quadTree.CheckCrackFree(leaves));
+
+		std::vector<uint32_t> broken{ leaves.begin(), leaves.end() - 1 };
+		TEST_CHECK(!quadTree.CheckCrackFree(broken));
+		broken.push_back(leaves.back());
+		broken.push_back(leaves.front());
+		TEST_CHECK(!quadTree.CheckCrackFree(broken));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: TerrainQuadTreeTest <HeightMap.raw>\n");
+		return 2;
+	}
+	std::ifstream file{ argv[1], std::ios::binary };
+	const std::vector<uint8_t> raw{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+	uint32_t width = 0;
+	while ((width + 1) * (width + 1) <= raw.size()) ++width;
+	if (raw.empty() || width * width != raw.size())
+	{
+		std::fprintf(stderr, "could not read a square height map from %s\n", argv[1]);
+		return 2;
+	}
+
+	TerrainQuadTree quadTree;
+	quadTree.Build(LoadHeights(raw, width, width), width, width, Scale, ChunkQuads);
+	const float extent = (width - 1) * quadTree.GetScale();
+	TestSelections(quadTree, extent, extent);
+	TestBrokenSelections(quadTree, extent, extent);
+	return TestResult();
+}
@@ -0,0 +1,110 @@
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "TerrainTileCache.h"
+#include "TerrainTileFile.h"
+#include "Test.h"
+
+// The .tiles header round trip and the source stamp Scene uses to tell a stale HeightMap.tiles: a file
+// converted from other bytes, or with other settings, or written by an older version, must not pass.
+
+namespace
+{
+	const std::filesystem::path Directory = std::filesystem::temp_directory_path();
+
+	void WriteBytes(const std::filesystem::path& fileName, const std::vector<uint8_t>& bytes)
+	{
+		std::ofstream out{ fileName, std::ios::binary | std::ios::trunc };
+		out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+
+	std::vector<uint8_t> ReadBytes(const std::filesystem::path& fileName)
+	{
+		std::ifstream in{ fileName, std::ios::binary };
+		return { std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+	}
+
+	void TestSourceHash()
+	{
+		const std::filesystem::path sourceFile = Directory / "TerrainTileFileTest.raw";
+		TerrainTileSource source;
+
+		// FNV-1a 64 reference values.
+		WriteBytes(sourceFile, {});
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), {}, source));
+		TEST_CHECK(source.size == 0 && source.hash == 0xCBF29CE484222325ull);
+		WriteBytes(sourceFile, { 'a' });
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), {}, source));
+		TEST_CHECK(source.size == 1 && source.hash == 0xAF63DC4C8601EC8Cull);
+
+		// Larger than one read, so the file is hashed in pieces.
+		std::vector<uint8_t> map(257 * 257 * 2);
+		for (size_t i = 0; i < map.size(); ++i) map[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+		WriteBytes(sourceFile, map);
+		TerrainTileSource original;
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), { 50, 5 }, original));
+		TEST_CHECK(original.size == map.size());
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), { 50, 5 }, source) && source == original);
+
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), { 50, 6 }, source) && !(source == original));
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), { 5, 50 }, source) && !(source == original));
+		map[map.size() / 2] ^= 1;
+		WriteBytes(sourceFile, map);
+		TEST_CHECK(HashTerrainTileSource(sourceFile.wstring(), { 50, 5 }, source) && source.size == original.size && !(source == original));
+
+		std::filesystem::remove(sourceFile);
+		TEST_CHECK(!HashTerrainTileSource(sourceFile.wstring(), { 50, 5 }, source));
+		TEST_CHECK(source == TerrainTileSource{});
+	}
+
+	void TestHeaderRoundTrip()
+	{
+		const std::filesystem::path tileFile = Directory / "TerrainTileFileTest.tiles";
+		TerrainTileInfo info;
+		info.tileSize = 16;
+		info.tilesX = 3;
+		info.tilesZ = 2;
+		info.coarseStep = 4;
+		info.scale = 5.0f;
+		info.minHeight = -20.0f;
+		info.maxHeight = 30.0f;
+		info.source = { 66049, 0x0123456789ABCDEFull };
+		auto height = [](uint32_t x, uint32_t z) { return std::sin(x * 0.3f) * 20.0f + std::cos(z * 0.2f) * 5.0f; };
+		TEST_CHECK(WriteTerrainTiles(tileFile.wstring(), info, height));
+
+		const std::vector<uint8_t> bytes = ReadBytes(tileFile);
+		TEST_CHECK(bytes.size() == info.GetFileSize());
+		TerrainTileInfo read;
+		TEST_CHECK(ParseTerrainTileHeader(bytes.data(), bytes.size(), read));
+		TEST_CHECK(read.tileSize == 16 && read.tilesX == 3 && read.tilesZ == 2 && read.coarseStep == 4);
+		TEST_CHECK(read.scale == 5.0f && read.minHeight == -20.0f && read.maxHeight == 30.0f);
+		TEST_CHECK(read.source == info.source);
+
+		// The cache reports the same stamp, which is what Scene compares against the height map.
+		TerrainTileCache cache{ 1 << 20 };
+		TEST_CHECK(cache.Open(tileFile.wstring()));
+		TEST_CHECK(cache.GetInfo().source == info.source);
+		TEST_CHECK(cache.SampleHeight(0.0f, 0.0f) == height(0, 0));
+		cache.Close();
+
+		// A file cut short, or written before the stamp existed (version 1), is rejected and converted again.
+		TEST_CHECK(!ParseTerrainTileHeader(bytes.data(), bytes.size() - 1, read));
+		std::vector<uint8_t> older = bytes;
+		older[4] = 1;
+		TEST_CHECK(!ParseTerrainTileHeader(older.data(), older.size(), read));
+		WriteBytes(tileFile, older);
+		TEST_CHECK(!cache.Open(tileFile.wstring()));
+		std::filesystem::remove(tileFile);
+	}
+}
+
+int main()
+{
+	TestSourceHash();
+	TestHeaderRoundTrip();
+	return TestResult();
+}
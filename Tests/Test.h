@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdio>
+
+// Checks for the test executables. A failed check prints where it failed and the test goes on, so one
+// run reports every failure; main returns TestResult().
+inline int gTestFailures = 0;
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			++gTestFailures; \
+		} \
+	} while (false)
+
+inline int TestResult()
+{
+	if (gTestFailures) std::fprintf(stderr, "%d checks failed\n", gTestFailures);
+	return gTestFailures ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "TextureResidency.h"
+#include "Test.h"
+
+// Drives TextureResidency with scripted and random per-frame visibility, the way Scene does from
+// on-screen sizes: BeginFrame, RequestMip for every visible texture, Update.
+
+namespace
+{
+	const uint32_t TailMip = 3; // 128 texels for a 1024 texture, like TEXTURE_TAIL_SIZE
+
+	// RGBA8 mip chain of a square texture.
+	std::vector<uint64_t> MipChain(uint32_t extent)
+	{
+		std::vector<uint64_t> bytes;
+		for (uint32_t size = extent; size > 0; size >>= 1) bytes.push_back(uint64_t(size) * size * 4);
+		return bytes;
+	}
+
+	// Bytes charged to the budget when mip is the finest resident one.
+	uint64_t Streamed(const std::vector<uint64_t>& mipBytes, uint32_t mip, uint32_t tailMip)
+	{
+		uint64_t bytes = 0;
+		for (uint32_t i = mip; i < tailMip; ++i) bytes += mipBytes[i];
+		return bytes;
+	}
+
+	using Requests = std::vector<std::pair<int, uint32_t>>; // slot, mip
+
+	std::vector<ResidencyChange> RunFrame(TextureResidency& residency, const Requests& requests)
+	{
+		residency.BeginFrame();
+		for (auto [slot, mip] : requests) residency.RequestMip(slot, mip);
+		std::vector<ResidencyChange> changes;
+		residency.Update(changes);
+		TEST_CHECK(residency.GetResidentBytes() <= residency.GetBudget());
+		return changes;
+	}
+
+	void TestLruEviction()
+	{
+		// Room for two textures at full resolution. Every new one pushes out the least recently used.
+		const std::vector<uint64_t> mips = MipChain(1024);
+		const uint64_t full = Streamed(mips, 0, TailMip);
+		TextureResidency residency{ 2 * full };
+		for (int slot = 0; slot < 4; ++slot) residency.AddTexture(slot, 1024, mips, TailMip);
+
+		RunFrame(residency, { { 0, 0 } });
+		RunFrame(residency, { { 1, 0 } });
+		TEST_CHECK(residency.GetResidentMip(0) == 0 && residency.GetResidentMip(1) == 0);
+		TEST_CHECK(residency.GetResidentBytes() == 2 * full);
+
+		// Slot 0 was last seen before slot 1, so slot 2 takes its place.
+		std::vector<ResidencyChange> changes = RunFrame(residency, { { 2, 0 } });
+		TEST_CHECK(residency.GetResidentMip(0) == TailMip);
+		TEST_CHECK(residency.GetResidentMip(1) == 0);
+		TEST_CHECK(residency.GetResidentMip(2) == 0);
+		TEST_CHECK(changes.size() == 2);
+
+		// Seeing slot 1 again makes it the most recent, so slot 2 goes next.
+		RunFrame(residency, { { 1, 0 } });
+		RunFrame(residency, { { 3, 0 } });
+		TEST_CHECK(residency.GetResidentMip(1) == 0);
+		TEST_CHECK(residency.GetResidentMip(2) == TailMip);
+		TEST_CHECK(residency.GetResidentMip(3) == 0);
+
+		// Textures visible this frame are never evicted for one another: the newcomer settles for less.
+		RunFrame(residency, { { 0, 0 }, { 1, 0 }, { 3, 0 } });
+		TEST_CHECK(residency.GetResidentMip(1) == 0 && residency.GetResidentMip(3) == 0);
+		TEST_CHECK(residency.GetResidentMip(0) == TailMip);
+		TEST_CHECK(residency.GetResidentBytes() == 2 * full);
+	}
+
+	void TestLargestShortfallFirst()
+	{
+		// The budget covers one texture at mip 0. Slot 1 is three mips short, slot 0 only one, so slot 1
+		// is served first even though slot 0 comes first in slot order; slot 0 stays at its tail.
+		const std::vector<uint64_t> mips = MipChain(1024);
+		TextureResidency residency{ Streamed(mips, 0, TailMip) };
+		residency.AddTexture(0, 1024, mips, TailMip);
+		residency.AddTexture(1, 1024, mips, TailMip);
+
+		std::vector<ResidencyChange> changes = RunFrame(residency, { { 0, 2 }, { 1, 0 } });
+		TEST_CHECK(residency.GetResidentMip(1) == 0);
+		TEST_CHECK(residency.GetResidentMip(0) == TailMip);
+		TEST_CHECK(changes.size() == 1 && changes[0].slot == 1 && changes[0].mip == 0);
+
+		// With room for mip 1 only, the request is granted as far as the budget allows.
+		TextureResidency partial{ Streamed(mips, 1, TailMip) };
+		partial.AddTexture(0, 1024, mips, TailMip);
+		RunFrame(partial, { { 0, 0 } });
+		TEST_CHECK(partial.GetResidentMip(0) == 1);
+		TEST_CHECK(partial.GetResidentBytes() == Streamed(mips, 1, TailMip));
+
+		// Equal shortfalls go in slot order.
+		TextureResidency tie{ Streamed(mips, 0, TailMip) };
+		tie.AddTexture(5, 1024, mips, TailMip);
+		tie.AddTexture(7, 1024, mips, TailMip);
+		RunFrame(tie, { { 7, 0 }, { 5, 0 } });
+		TEST_CHECK(tie.GetResidentMip(5) == 0 && tie.GetResidentMip(7) == TailMip);
+	}
+
+	void TestRandomStream()
+	{
+		// Random visibility over many frames: the budget holds every frame, the byte count matches the
+		// resident mips, changes report exactly the textures that moved, and nothing is finer than asked.
+		std::mt19937 random{ 7 };
+		std::map<int, std::vector<uint64_t>> chains;
+		std::map<int, uint32_t> tails;
+		const uint64_t budget = 24ull << 20;
+		TextureResidency residency{ budget };
+		for (int slot = 0; slot < 32; ++slot)
+		{
+			const uint32_t extent = 256u << (random() % 4);
+			chains[slot] = MipChain(extent);
+			tails[slot] = static_cast<uint32_t>(chains[slot].size()) - 8; // 128 texels
+			residency.AddTexture(slot, extent, chains[slot], tails[slot]);
+		}
+
+		for (int frame = 0; frame < 2000; ++frame)
+		{
+			std::map<int, uint32_t> before;
+			for (auto& [slot, chain] : chains) before[slot] = residency.GetResidentMip(slot);
+
+			Requests requests;
+			std::map<int, uint32_t> finest;
+			for (int slot = 0; slot < 32; ++slot)
+			{
+				if (random() % 3) continue;
+				const uint32_t mip = random() % (tails[slot] + 2);
+				requests.push_back({ slot, mip });
+				auto it = finest.find(slot);
+				finest[slot] = it == finest.end() ? mip : std::min(it->second, mip);
+			}
+			std::vector<ResidencyChange> changes = RunFrame(residency, requests);
+
+			uint64_t resident = 0;
+			size_t moved = 0;
+			for (auto& [slot, chain] : chains)
+			{
+				const uint32_t mip = residency.GetResidentMip(slot);
+				resident += Streamed(chain, mip, tails[slot]);
+				TEST_CHECK(mip <= tails[slot]);
+				if (mip < before[slot]) TEST_CHECK(finest.count(slot) && mip >= finest[slot]);
+				if (mip != before[slot]) ++moved;
+			}
+			TEST_CHECK(resident == residency.GetResidentBytes());
+			TEST_CHECK(changes.size() == moved);
+			for (const ResidencyChange& change : changes) TEST_CHECK(residency.GetResidentMip(change.slot) == change.mip);
+		}
+	}
+
+	void TestRequiredMip()
+	{
+		TEST_CHECK(TextureResidency::ComputeRequiredMip(1024.0f, 1024, 11) == 0);
+		TEST_CHECK(TextureResidency::ComputeRequiredMip(2048.0f, 1024, 11) == 0);
+		TEST_CHECK(TextureResidency::ComputeRequiredMip(512.0f, 1024, 11) == 1);
+		TEST_CHECK(TextureResidency::ComputeRequiredMip(300.0f, 1024, 11) == 1);
+		TEST_CHECK(TextureResidency::ComputeRequiredMip(0.5f, 1024, 11) == 10);
+		TEST_CHECK(TextureResidency::ComputeRequiredMip(100.0f, 1024, 0) == 0);
+	}
+}
+
+int main()
+{
+	TestLruEviction();
+	TestLargestShortfallFirst();
+	TestRandomStream();
+	TestRequiredMip();
+	return TestResult();
+}
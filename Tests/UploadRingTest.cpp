@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "UploadRing.h"
+#include "Test.h"
+
+// UploadRing the way TextureLoader uses it: allocations during a copy batch, FinishBatch with the fence
+// the batch signals, Retire with the fence value the copy queue has reached.
+
+namespace
+{
+	struct Live
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint64_t fenceValue; // 0 while its batch is still open
+	};
+
+	bool Overlaps(const Live& a, uint64_t offset, uint64_t size)
+	{
+		return offset < a.offset + a.size && a.offset < offset + size;
+	}
+
+	void TestOversize()
+	{
+		UploadRing ring{ 1024 };
+		TEST_CHECK(ring.Allocate(1025, 1) == UploadRing::InvalidOffset);
+		TEST_CHECK(ring.Allocate(0, 1) == UploadRing::InvalidOffset);
+		TEST_CHECK(ring.GetUsed() == 0);
+		TEST_CHECK(ring.Allocate(1024, 512) == 0);
+		TEST_CHECK(ring.GetUsed() == 1024);
+		TEST_CHECK(ring.Allocate(1, 1) == UploadRing::InvalidOffset);
+
+		UploadRing empty;
+		TEST_CHECK(empty.Allocate(1, 1) == UploadRing::InvalidOffset);
+	}
+
+	void TestWraparound()
+	{
+		UploadRing ring{ 1024 };
+		TEST_CHECK(ring.Allocate(400, 256) == 0);
+		TEST_CHECK(ring.Allocate(400, 256) == 512);
+		ring.FinishBatch(1);
+		TEST_CHECK(ring.GetUsed() == 912);
+
+		// 300 bytes do not fit behind 912, and the front is still read by batch 1.
+		TEST_CHECK(ring.Allocate(300, 256) == UploadRing::InvalidOffset);
+		ring.Retire(0);
+		TEST_CHECK(ring.Allocate(300, 256) == UploadRing::InvalidOffset);
+		ring.Retire(1);
+		TEST_CHECK(ring.GetUsed() == 0);
+
+		// Empty again, so it starts over at 0.
+		TEST_CHECK(ring.Allocate(300, 256) == 0);
+		TEST_CHECK(ring.Allocate(300, 256) == 512);
+		ring.FinishBatch(2);
+		TEST_CHECK(ring.Allocate(100, 1) == 812);
+		ring.FinishBatch(3);
+
+		// Batch 2 done: the next allocation skips the 112-byte tail and reuses the front.
+		ring.Retire(2);
+		TEST_CHECK(ring.GetUsed() == 100);
+		TEST_CHECK(ring.Allocate(200, 256) == 0);
+		TEST_CHECK(ring.GetUsed() == 100 + 112 + 200);
+		// The old second allocation at 512 is free too, but the head is at 200.
+		TEST_CHECK(ring.Allocate(256, 256) == 256);
+		TEST_CHECK(ring.Allocate(400, 1) == UploadRing::InvalidOffset);
+		ring.FinishBatch(4);
+		ring.Retire(4);
+		TEST_CHECK(ring.GetUsed() == 0);
+	}
+
+	void TestFenceGating()
+	{
+		// Batches retire in order and only once their fence is reached; an empty batch is not recorded.
+		UploadRing ring{ 4096 };
+		TEST_CHECK(ring.Allocate(1000, 1) == 0);
+		ring.FinishBatch(1);
+		ring.FinishBatch(2);
+		TEST_CHECK(ring.Allocate(1000, 1) == 1000);
+		ring.FinishBatch(3);
+		TEST_CHECK(ring.Allocate(1000, 1) == 2000);
+		ring.FinishBatch(5);
+		ring.Retire(2);
+		TEST_CHECK(ring.GetUsed() == 2000);
+		ring.Retire(4);
+		TEST_CHECK(ring.GetUsed() == 1000);
+		ring.Retire(5);
+		TEST_CHECK(ring.GetUsed() == 0);
+	}
+
+	void TestRandomBatches()
+	{
+		// Random sizes and alignments over many batches, with the copy queue a random number of batches
+		// behind. No allocation may overlap memory a batch still in flight (or the open one) reads.
+		std::mt19937 random{ 3 };
+		const uint64_t size = 1 << 16;
+		UploadRing ring{ size };
+		std::vector<Live> live;
+		uint64_t signaled = 0;
+		uint64_t completed = 0;
+		uint64_t allocations = 0;
+		for (int step = 0; step < 100000; ++step)
+		{
+			const uint32_t action = random() % 16;
+			if (action < 12)
+			{
+				const uint64_t bytes = 1 + random() % (random() % 8 ? 2048 : size);
+				const uint64_t alignment = uint64_t(1) << (random() % 10);
+				const uint64_t offset = ring.Allocate(bytes, alignment);
+				if (offset == UploadRing::InvalidOffset) continue;
+				++allocations;
+				TEST_CHECK(offset % alignment == 0);
+				TEST_CHECK(offset + bytes <= size);
+				for (const Live& other : live) TEST_CHECK(!Overlaps(other, offset, bytes));
+				live.push_back({ offset, bytes, 0 });
+			}
+			else if (action < 14)
+			{
+				ring.FinishBatch(++signaled);
+				for (Live& allocation : live)
+					if (allocation.fenceValue == 0) allocation.fenceValue = signaled;
+			}
+			else
+			{
+				completed += random() % (signaled - completed + 1);
+				ring.Retire(completed);
+				std::erase_if(live, [completed](const Live& allocation) { return allocation.fenceValue != 0 && allocation.fenceValue <= completed; });
+			}
+			TEST_CHECK(ring.GetUsed() <= size);
+		}
+		TEST_CHECK(allocations > 10000);
+
+		// Once the copy queue catches up the whole ring is available again.
+		ring.FinishBatch(++signaled);
+		ring.Retire(signaled);
+		TEST_CHECK(ring.GetUsed() == 0);
+		TEST_CHECK(ring.Allocate(size, 1) == 0);
+	}
+}
+
+int main()
+{
+	TestOversize();
+	TestWraparound();
+	TestFenceGating();
+	TestRandomBatches();
+	return TestResult();
+}
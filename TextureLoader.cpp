@@ -0,0 +1,308 @@
+#include "TextureLoader.h"
+#include "DXSampleHelper.h"
+#include "DDSHeader.h"
+#include <fstream>
+
+TextureLoader::TextureLoader(ID3D12Device* device, UINT64 stagingSize, UINT workerCount, TextureLoadMode mode) :
+	mDevice{ device },
+	mMode{ mode },
+	mRing{ stagingSize }
+{
+	BuildCopyQueue();
+	BuildStagingBuffer();
+	BuildPlaceholder();
+
+	if (workerCount == 0) workerCount = 1;
+	for (UINT i = 0; i < workerCount; ++i)
+		mWorkers.emplace_back(&TextureLoader::WorkerLoop, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock{ mMutex };
+		mStop = true;
+	}
+	mCondition.notify_all();
+	for (std::thread& worker : mWorkers) worker.join();
+
+	// Textures and staging memory must outlive the copies that reference them.
+	WaitForCopies(mCopyFenceValue);
+	mStagingBuffer->Unmap(0, nullptr);
+	CloseHandle(mCopyFenceEvent);
+}
+
+void TextureLoader::Request(int slot, const wstring& fileName, UINT maxSize)
+{
+	{
+		std::lock_guard<std::mutex> lock{ mMutex };
+		mRequests.push_back({ slot, fileName, maxSize });
+	}
+	++mPendingCount;
+	mCondition.notify_one();
+}
+
+void TextureLoader::Update(vector<LoadedTexture>& completed)
+{
+	// Hand back textures whose copies are done and recycle their staging memory.
+	const UINT64 completedFence = mCopyFence->GetCompletedValue();
+	mRing.Retire(completedFence);
+	for (auto it = mInFlight.begin(); it != mInFlight.end();)
+	{
+		if (it->fenceValue > completedFence) { ++it; continue; }
+		completed.push_back(move(it->loaded));
+		--mPendingCount;
+		it = mInFlight.erase(it);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mMutex };
+		while (!mParsed.empty())
+		{
+			mReady.push_back(move(mParsed.front()));
+			mParsed.pop_front();
+		}
+	}
+
+	bool recording = false;
+	while (!mReady.empty())
+	{
+		ParsedTexture& parsed = mReady.front();
+		if (!parsed.loaded.texture)
+		{
+			--mPendingCount; // load failed, the slot keeps the placeholder
+			mReady.pop_front();
+			continue;
+		}
+
+		if (!recording) { BeginCopyList(); recording = true; }
+
+		InFlightTexture inFlight{};
+		if (!RecordUpload(parsed, inFlight)) break; // ring is full, retry next frame
+		mInFlight.push_back(move(inFlight));
+		mReady.pop_front();
+	}
+	if (!recording) return;
+
+	const UINT64 fenceValue = SubmitCopyList();
+	for (InFlightTexture& inFlight : mInFlight)
+	{
+		if (inFlight.fenceValue == 0) inFlight.fenceValue = fenceValue;
+	}
+}
+
+ID3D12Resource* TextureLoader::GetPlaceholder()
+{
+	return mPlaceholder.Get();
+}
+
+UINT TextureLoader::GetPendingCount()
+{
+	return mPendingCount;
+}
+
+UINT64 TextureLoader::GetStagingSize()
+{
+	return mRing.GetSize();
+}
+
+UINT64 TextureLoader::GetStagingUsed()
+{
+	return mRing.GetUsed();
+}
+
+void TextureLoader::WorkerLoop()
+{
+	while (true)
+	{
+		LoadRequest request;
+		{
+			std::unique_lock<std::mutex> lock{ mMutex };
+			mCondition.wait(lock, [this] { return mStop || !mRequests.empty(); });
+			if (mStop) return;
+			request = move(mRequests.front());
+			mRequests.pop_front();
+		}
+
+		// File read, header parse and resource creation run here. The device is free-threaded.
+		ParsedTexture parsed{};
+		parsed.loaded.slot = request.slot;
+		if (FAILED(ParseTexture(request, parsed)))
+		{
+			OutputDebugStringW(wstring{ L"texture load failed: " + request.fileName + L"\n" }.c_str());
+			parsed.loaded.texture.Reset();
+		}
+
+		std::lock_guard<std::mutex> lock{ mMutex };
+		mParsed.push_back(move(parsed));
+	}
+}
+
+HRESULT TextureLoader::ParseTexture(const LoadRequest& request, ParsedTexture& parsed)
+{
+	const uint8_t* fileData = nullptr;
+	size_t fileSize = 0;
+	if (mMode == TextureLoadMode::MemoryMap)
+	{
+		if (!parsed.mapping.Open(request.fileName)) return E_FAIL;
+		fileData = parsed.mapping.GetData();
+		fileSize = parsed.mapping.GetSize();
+	}
+	else
+	{
+		ifstream file{ request.fileName, ios::binary | ios::ate };
+		if (!file) return E_FAIL;
+		fileSize = static_cast<size_t>(file.tellg());
+		parsed.ddsData = make_unique<uint8_t[]>(fileSize);
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(parsed.ddsData.get()), fileSize)) return E_FAIL;
+		fileData = parsed.ddsData.get();
+	}
+
+	// Reject bad headers before the device sees them.
+	DDSInfo info;
+	if (!ParseDDSHeader(fileData, fileSize, info)) return E_FAIL;
+
+	HRESULT hr = LoadDDSTextureFromMemoryEx(mDevice, fileData, fileSize, request.maxSize,
+		D3D12_RESOURCE_FLAG_NONE, DDS_LOADER_DEFAULT, parsed.loaded.texture.GetAddressOf(), parsed.subresources);
+	if (FAILED(hr)) return hr;
+
+	parsed.loaded.width = info.width;
+	parsed.loaded.height = info.height;
+	parsed.loaded.mipCount = info.mipCount;
+	parsed.loaded.topMipBytes = parsed.subresources.front().SlicePitch;
+	return S_OK;
+}
+
+void TextureLoader::BuildCopyQueue()
+{
+	D3D12_COMMAND_QUEUE_DESC queueDesc{};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+	ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCopyQueue)));
+
+	mCopyAllocators.push_back({});
+	ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&mCopyAllocators.back().allocator)));
+	ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, mCopyAllocators.back().allocator.Get(), nullptr, IID_PPV_ARGS(&mCopyList)));
+	ThrowIfFailed(mCopyList->Close());
+
+	ThrowIfFailed(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mCopyFence)));
+	mCopyFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (mCopyFenceEvent == nullptr)
+	{
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+	}
+}
+
+void TextureLoader::BuildStagingBuffer()
+{
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(mRing.GetSize()),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&mStagingBuffer)));
+
+	// Kept mapped for the loader's lifetime so UpdateSubresources' own Map calls are cheap.
+	void* mapped = nullptr;
+	CD3DX12_RANGE readRange(0, 0);
+	ThrowIfFailed(mStagingBuffer->Map(0, &readRange, &mapped));
+}
+
+void TextureLoader::BuildPlaceholder()
+{
+	ThrowIfFailed(mDevice->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1, 1, 1),
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&mPlaceholder)));
+
+	const uint32_t grey = 0xff808080;
+	ParsedTexture parsed{};
+	parsed.loaded.slot = -1;
+	parsed.loaded.texture = mPlaceholder;
+	parsed.subresources.push_back({ &grey, sizeof(grey), sizeof(grey) });
+
+	InFlightTexture inFlight{};
+	BeginCopyList();
+	ThrowIfFailed(RecordUpload(parsed, inFlight));
+	WaitForCopies(SubmitCopyList());
+	mRing.Retire(mCopyFence->GetCompletedValue());
+}
+
+bool TextureLoader::RecordUpload(ParsedTexture& parsed, InFlightTexture& inFlight)
+{
+	const UINT numSubresources = static_cast<UINT>(parsed.subresources.size());
+	const UINT64 uploadSize = GetRequiredIntermediateSize(parsed.loaded.texture.Get(), 0, numSubresources);
+
+	ID3D12Resource* intermediate = mStagingBuffer.Get();
+	UINT64 offset = 0;
+	if (uploadSize > mRing.GetSize())
+	{
+		ThrowIfFailed(mDevice->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(uploadSize),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&inFlight.dedicatedUpload)));
+		intermediate = inFlight.dedicatedUpload.Get();
+	}
+	else
+	{
+		offset = mRing.Allocate(uploadSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		if (offset == UploadRing::InvalidOffset) return false;
+	}
+
+	// The texture was created in COMMON. The copy promotes it to COPY_DEST and it decays back
+	// to COMMON when the copy queue finishes, so the direct queue can sample it without a barrier.
+	UpdateSubresources(mCopyList.Get(), parsed.loaded.texture.Get(), intermediate, offset, 0, numSubresources, parsed.subresources.data());
+
+	inFlight.loaded = move(parsed.loaded);
+	inFlight.fenceValue = 0;
+	return true;
+}
+
+void TextureLoader::BeginCopyList()
+{
+	// Reuse an allocator whose last batch has finished, otherwise grow the pool.
+	const UINT64 completedFence = mCopyFence->GetCompletedValue();
+	CopyAllocator* target = nullptr;
+	for (CopyAllocator& copyAllocator : mCopyAllocators)
+	{
+		if (copyAllocator.fenceValue <= completedFence) { target = &copyAllocator; break; }
+	}
+	if (target == nullptr)
+	{
+		mCopyAllocators.push_back({});
+		target = &mCopyAllocators.back();
+		ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&target->allocator)));
+	}
+	target->fenceValue = mCopyFenceValue + 1;
+
+	ThrowIfFailed(target->allocator->Reset());
+	ThrowIfFailed(mCopyList->Reset(target->allocator.Get(), nullptr));
+}
+
+UINT64 TextureLoader::SubmitCopyList()
+{
+	ThrowIfFailed(mCopyList->Close());
+	ID3D12CommandList* ppCommandLists[] = { mCopyList.Get() };
+	mCopyQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+
+	ThrowIfFailed(mCopyQueue->Signal(mCopyFence.Get(), ++mCopyFenceValue));
+	mRing.FinishBatch(mCopyFenceValue);
+	return mCopyFenceValue;
+}
+
+void TextureLoader::WaitForCopies(UINT64 fenceValue)
+{
+	if (mCopyFence->GetCompletedValue() < fenceValue)
+	{
+		ThrowIfFailed(mCopyFence->SetEventOnCompletion(fenceValue, mCopyFenceEvent));
+		WaitForSingleObject(mCopyFenceEvent, INFINITE);
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "stdafx.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include "UploadRing.h"
+#include "MappedFile.h"
+
+enum class TextureLoadMode
+{
+	ReadFile,  // whole file copied into a heap buffer first
+	MemoryMap, // subresources point into a read-only mapping, the only copy is into the staging ring
+};
+
+// Loads DDS files without stalling the frame.
+// Worker threads read and parse files in parallel, the main thread records the copies on a
+// dedicated copy queue through one shared staging ring, and a texture is handed back only
+// after the copy fence has passed. Until then its slot is bound to a 1x1 placeholder.
+class TextureLoader
+{
+public:
+	struct LoadedTexture
+	{
+		int slot;
+		ComPtr<ID3D12Resource> texture;
+		UINT width;        // of mip 0 in the file, the texture may hold fewer mips
+		UINT height;
+		UINT mipCount;
+		UINT64 topMipBytes; // size of the most detailed mip that was loaded
+	};
+
+	TextureLoader(ID3D12Device* device, UINT64 stagingSize, UINT workerCount, TextureLoadMode mode = TextureLoadMode::MemoryMap);
+	TextureLoader(const TextureLoader&) = delete;
+	TextureLoader& operator=(const TextureLoader&) = delete;
+	~TextureLoader();
+
+	// maxSize > 0 skips mips larger than maxSize, leaving only the tail resident.
+	void Request(int slot, const wstring& fileName, UINT maxSize = 0);
+	// Main thread, once per frame. Submits parsed textures and appends the ones whose copies finished.
+	void Update(vector<LoadedTexture>& completed);
+	ID3D12Resource* GetPlaceholder();
+	UINT GetPendingCount();
+	UINT64 GetStagingSize();
+	UINT64 GetStagingUsed();
+private:
+	struct LoadRequest
+	{
+		int slot;
+		wstring fileName;
+		UINT maxSize;
+	};
+	struct ParsedTexture
+	{
+		LoadedTexture loaded;
+		MappedFile mapping;
+		unique_ptr<uint8_t[]> ddsData;
+		vector<D3D12_SUBRESOURCE_DATA> subresources;
+	};
+	struct InFlightTexture
+	{
+		LoadedTexture loaded;
+		ComPtr<ID3D12Resource> dedicatedUpload; // only for textures larger than the whole ring
+		UINT64 fenceValue;
+	};
+	struct CopyAllocator
+	{
+		ComPtr<ID3D12CommandAllocator> allocator;
+		UINT64 fenceValue;
+	};
+
+	void WorkerLoop();
+	HRESULT ParseTexture(const LoadRequest& request, ParsedTexture& parsed);
+	void BuildCopyQueue();
+	void BuildStagingBuffer();
+	void BuildPlaceholder();
+	bool RecordUpload(ParsedTexture& parsed, InFlightTexture& inFlight);
+	void BeginCopyList();
+	UINT64 SubmitCopyList();
+	void WaitForCopies(UINT64 fenceValue);
+private:
+	ID3D12Device* mDevice = nullptr;
+	TextureLoadMode mMode = TextureLoadMode::MemoryMap;
+
+	ComPtr<ID3D12CommandQueue> mCopyQueue;
+	ComPtr<ID3D12GraphicsCommandList> mCopyList;
+	vector<CopyAllocator> mCopyAllocators;
+	ComPtr<ID3D12Fence> mCopyFence;
+	UINT64 mCopyFenceValue = 0;
+	HANDLE mCopyFenceEvent = nullptr;
+
+	UploadRing mRing;
+	ComPtr<ID3D12Resource> mStagingBuffer;
+	ComPtr<ID3D12Resource> mPlaceholder;
+
+	// Shared with the workers, guarded by mMutex.
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque<LoadRequest> mRequests;
+	std::deque<ParsedTexture> mParsed;
+	bool mStop = false;
+	vector<std::thread> mWorkers;
+
+	// Main thread only.
+	std::deque<ParsedTexture> mReady;
+	vector<InFlightTexture> mInFlight;
+	UINT mPendingCount = 0;
+};
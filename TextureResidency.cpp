@@ -0,0 +1,167 @@
+#include "TextureResidency.h"
+#include <algorithm>
+#include <cmath>
+
+TextureResidency::TextureResidency(uint64_t budgetBytes) : mBudget{ budgetBytes }
+{
+}
+
+void TextureResidency::AddTexture(int slot, uint32_t extent, const std::vector<uint64_t>& mipBytes, uint32_t tailMip)
+{
+	RemoveTexture(slot);
+
+	Entry entry;
+	entry.extent = extent;
+	entry.mipBytes = mipBytes;
+	entry.tailMip = mipBytes.empty() ? 0 : std::min(tailMip, static_cast<uint32_t>(mipBytes.size()) - 1);
+	entry.residentMip = entry.tailMip;
+	entry.requestedMip = entry.tailMip;
+	mEntries.emplace(slot, std::move(entry));
+}
+
+void TextureResidency::RemoveTexture(int slot)
+{
+	auto it = mEntries.find(slot);
+	if (it == mEntries.end()) return;
+
+	mResidentBytes -= StreamedBytes(it->second, it->second.residentMip);
+	mEntries.erase(it);
+}
+
+bool TextureResidency::Contains(int slot) const
+{
+	return mEntries.find(slot) != mEntries.end();
+}
+
+void TextureResidency::BeginFrame()
+{
+	++mFrame;
+}
+
+void TextureResidency::RequestMip(int slot, uint32_t mip)
+{
+	auto it = mEntries.find(slot);
+	if (it == mEntries.end()) return;
+
+	Entry& entry = it->second;
+	mip = std::min(mip, entry.tailMip);
+	if (entry.lastUsedFrame != mFrame) entry.requestedMip = mip;
+	else entry.requestedMip = std::min(entry.requestedMip, mip);
+	entry.lastUsedFrame = mFrame;
+}
+
+void TextureResidency::Update(std::vector<ResidencyChange>& changes)
+{
+	std::vector<std::pair<int, uint32_t>> before;
+	std::vector<int> promotions;
+	for (auto& [slot, entry] : mEntries)
+	{
+		before.push_back({ slot, entry.residentMip });
+		if (entry.lastUsedFrame == mFrame && entry.requestedMip < entry.residentMip) promotions.push_back(slot);
+	}
+
+	// Largest shortfall first, so the blurriest visible textures get the budget.
+	std::stable_sort(promotions.begin(), promotions.end(), [this](int a, int b) {
+		const Entry& ea = mEntries.at(a);
+		const Entry& eb = mEntries.at(b);
+		return ea.residentMip - ea.requestedMip > eb.residentMip - eb.requestedMip;
+	});
+
+	for (int slot : promotions)
+	{
+		Entry& entry = mEntries.at(slot);
+		uint32_t target = entry.requestedMip;
+		while (target < entry.residentMip)
+		{
+			uint64_t need = StreamedBytes(entry, target) - StreamedBytes(entry, entry.residentMip);
+			if (mResidentBytes + need <= mBudget) break;
+			if (!EvictOne(slot)) ++target; // nothing left to evict, settle for a coarser mip
+		}
+		if (target >= entry.residentMip) continue;
+
+		mResidentBytes += StreamedBytes(entry, target) - StreamedBytes(entry, entry.residentMip);
+		entry.residentMip = target;
+	}
+
+	for (auto& [slot, mip] : before)
+	{
+		uint32_t residentMip = mEntries.at(slot).residentMip;
+		if (residentMip != mip) changes.push_back({ slot, residentMip });
+	}
+}
+
+uint32_t TextureResidency::GetResidentMip(int slot) const
+{
+	auto it = mEntries.find(slot);
+	if (it == mEntries.end()) return UINT32_MAX;
+	return it->second.residentMip;
+}
+
+uint32_t TextureResidency::GetMipExtent(int slot, uint32_t mip) const
+{
+	auto it = mEntries.find(slot);
+	if (it == mEntries.end()) return 0;
+	return std::max(it->second.extent >> std::min(mip, 31u), 1u);
+}
+
+uint32_t TextureResidency::GetMipCount(int slot) const
+{
+	auto it = mEntries.find(slot);
+	if (it == mEntries.end()) return 0;
+	return static_cast<uint32_t>(it->second.mipBytes.size());
+}
+
+uint64_t TextureResidency::GetResidentBytes() const
+{
+	return mResidentBytes;
+}
+
+uint64_t TextureResidency::GetBudget() const
+{
+	return mBudget;
+}
+
+uint64_t TextureResidency::GetFrame() const
+{
+	return mFrame;
+}
+
+uint32_t TextureResidency::ComputeRequiredMip(float screenPixels, uint32_t extent, uint32_t mipCount)
+{
+	if (mipCount == 0) return 0;
+	if (screenPixels <= 1.0f) return mipCount - 1;
+
+	float ratio = static_cast<float>(extent) / screenPixels;
+	if (ratio <= 1.0f) return 0;
+	uint32_t mip = static_cast<uint32_t>(std::floor(std::log2(ratio)));
+	return std::min(mip, mipCount - 1);
+}
+
+uint64_t TextureResidency::StreamedBytes(const Entry& entry, uint32_t mip) const
+{
+	uint64_t bytes = 0;
+	for (uint32_t i = mip; i < entry.tailMip; ++i) bytes += entry.mipBytes[i];
+	return bytes;
+}
+
+uint32_t TextureResidency::DesiredMip(const Entry& entry) const
+{
+	return entry.lastUsedFrame == mFrame ? entry.requestedMip : entry.tailMip;
+}
+
+bool TextureResidency::EvictOne(int keepSlot)
+{
+	// Least recently used texture that holds mips it does not need this frame.
+	Entry* victim = nullptr;
+	for (auto& [slot, entry] : mEntries)
+	{
+		if (slot == keepSlot || entry.residentMip >= DesiredMip(entry)) continue;
+		if (victim == nullptr || entry.lastUsedFrame < victim->lastUsedFrame) victim = &entry;
+	}
+	if (victim == nullptr) return false;
+
+	uint32_t desired = DesiredMip(*victim);
+	mResidentBytes -= StreamedBytes(*victim, victim->residentMip) - StreamedBytes(*victim, desired);
+	victim->residentMip = desired;
+	return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <map>
+
+struct ResidencyChange
+{
+	int slot;
+	uint32_t mip; // new most detailed resident mip
+};
+
+// Decides which mips of each streamed texture should be resident.
+// Mips from the tail mip down are always resident and not charged to the budget; finer
+// mips are requested per frame from on-screen size and granted while the budget allows,
+// evicting the least recently used surplus first. No D3D12 calls, so it can be driven by
+// synthetic visibility streams.
+class TextureResidency
+{
+public:
+	TextureResidency(uint64_t budgetBytes = 0);
+
+	// mipBytes[i] is the size of mip i, extent the larger dimension of mip 0.
+	void AddTexture(int slot, uint32_t extent, const std::vector<uint64_t>& mipBytes, uint32_t tailMip);
+	void RemoveTexture(int slot);
+	bool Contains(int slot) const;
+
+	void BeginFrame();
+	// Keeps the finest mip requested for the slot this frame.
+	void RequestMip(int slot, uint32_t mip);
+	// Appends one change per texture whose resident mip moved.
+	void Update(std::vector<ResidencyChange>& changes);
+
+	uint32_t GetResidentMip(int slot) const;
+	uint32_t GetMipExtent(int slot, uint32_t mip) const;
+	uint32_t GetMipCount(int slot) const;
+	uint64_t GetResidentBytes() const;
+	uint64_t GetBudget() const;
+	uint64_t GetFrame() const;
+
+	// Mip whose texel density roughly matches screenPixels covering the whole texture.
+	static uint32_t ComputeRequiredMip(float screenPixels, uint32_t extent, uint32_t mipCount);
+
+private:
+	struct Entry
+	{
+		uint32_t extent = 0;
+		std::vector<uint64_t> mipBytes;
+		uint32_t tailMip = 0;
+		uint32_t residentMip = 0;
+		uint32_t requestedMip = 0;
+		uint64_t lastUsedFrame = 0;
+	};
+
+	uint64_t StreamedBytes(const Entry& entry, uint32_t mip) const;
+	uint32_t DesiredMip(const Entry& entry) const;
+	bool EvictOne(int keepSlot);
+
+	std::map<int, Entry> mEntries; // ordered so ties resolve by slot, deterministically
+	uint64_t mBudget = 0;
+	uint64_t mResidentBytes = 0;
+	uint64_t mFrame = 0;
+};
@@ -0,0 +1,66 @@
+#include "TextureTable.h"
+
+TextureTable::TextureTable(uint32_t capacity) : mCapacity{ capacity }
+{
+}
+
+int TextureTable::Register(const std::wstring& name)
+{
+	auto it = mNameToSlot.find(name);
+	if (it != mNameToSlot.end()) return it->second;
+
+	int slot = -1;
+	if (!mFreeSlots.empty())
+	{
+		// Hand out the lowest free slot so the layout stays compact and deterministic.
+		auto lowest = mFreeSlots.begin();
+		for (auto i = mFreeSlots.begin(); i != mFreeSlots.end(); ++i) {
+			if (*i < *lowest) lowest = i;
+		}
+		slot = *lowest;
+		mFreeSlots.erase(lowest);
+		mSlots[slot] = name;
+	}
+	else
+	{
+		if (mSlots.size() >= mCapacity) return -1;
+		slot = static_cast<int>(mSlots.size());
+		mSlots.push_back(name);
+	}
+
+	mNameToSlot.emplace(name, slot);
+	return slot;
+}
+
+bool TextureTable::Release(const std::wstring& name)
+{
+	auto it = mNameToSlot.find(name);
+	if (it == mNameToSlot.end()) return false;
+
+	mSlots[it->second].clear();
+	mFreeSlots.push_back(it->second);
+	mNameToSlot.erase(it);
+	return true;
+}
+
+int TextureTable::GetSlot(const std::wstring& name) const
+{
+	auto it = mNameToSlot.find(name);
+	if (it == mNameToSlot.end()) return -1;
+	return it->second;
+}
+
+const std::wstring& TextureTable::GetName(int slot) const
+{
+	return mSlots.at(slot);
+}
+
+uint32_t TextureTable::GetCapacity() const
+{
+	return mCapacity;
+}
+
+uint32_t TextureTable::GetCount() const
+{
+	return static_cast<uint32_t>(mNameToSlot.size());
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Maps texture names to slots of the bindless SRV range (Texture2D Textures[] : register(t0, space1)).
+// Slot numbers are what objects write into their constant buffer, so the shader can index
+// the texture without a per-draw descriptor table change. Released slots are reused.
+class TextureTable
+{
+public:
+	TextureTable(uint32_t capacity);
+
+	// Returns the slot of name, registering it if needed. -1 when the table is full.
+	int Register(const std::wstring& name);
+	bool Release(const std::wstring& name);
+	int GetSlot(const std::wstring& name) const;
+	const std::wstring& GetName(int slot) const;
+
+	uint32_t GetCapacity() const;
+	uint32_t GetCount() const;
+
+private:
+	uint32_t mCapacity = 0;
+	std::vector<std::wstring> mSlots;
+	std::vector<int> mFreeSlots;
+	std::unordered_map<std::wstring, int> mNameToSlot;
+};
@@ -0,0 +1,215 @@
+#include "TransformHierarchy.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+
+uint32_t TransformHierarchy::AddNode(uint32_t parent)
+{
+	uint32_t handle;
+	if (!mFreeHandles.empty())
+	{
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<uint32_t>(mHandleSlot.size());
+		mHandleSlot.push_back(InvalidNode);
+		mHandleParent.push_back(InvalidNode);
+	}
+
+	// Appending keeps the order valid: an existing parent always has a smaller slot.
+	const uint32_t slot = static_cast<uint32_t>(mLocal.size());
+	XMFLOAT4X4A identity;
+	XMStoreFloat4x4A(&identity, XMMatrixIdentity());
+	mLocal.push_back(identity);
+	mWorld.push_back(identity);
+	mParentSlot.push_back(parent == InvalidNode ? InvalidNode : mHandleSlot[parent]);
+	mDirty.push_back(1);
+	mSlotHandle.push_back(handle);
+	mHandleSlot[handle] = slot;
+	mHandleParent[handle] = parent;
+	return handle;
+}
+
+void TransformHierarchy::RemoveNode(uint32_t node)
+{
+	const uint32_t slot = mHandleSlot[node];
+	if (slot == InvalidNode) return;
+	mSlotHandle[slot] = InvalidNode;
+	mHandleSlot[node] = InvalidNode;
+	mRemovedHandles.push_back(node);
+	mOrderDirty = true;
+}
+
+void TransformHierarchy::Clear()
+{
+	mLocal.clear();
+	mWorld.clear();
+	mParentSlot.clear();
+	mDirty.clear();
+	mSlotHandle.clear();
+	mHandleSlot.clear();
+	mHandleParent.clear();
+	mFreeHandles.clear();
+	mRemovedHandles.clear();
+	mChanged.clear();
+	mOrderDirty = false;
+}
+
+void TransformHierarchy::SetParent(uint32_t node, uint32_t parent)
+{
+	if (mHandleParent[node] == parent) return;
+	mHandleParent[node] = parent;
+	const uint32_t slot = mHandleSlot[node];
+	const uint32_t parentSlot = parent == InvalidNode ? InvalidNode : mHandleSlot[parent];
+	// A parent that is already earlier in the arrays, or none, keeps the order valid.
+	if (parentSlot == InvalidNode || parentSlot < slot) mParentSlot[slot] = parentSlot;
+	else mOrderDirty = true;
+	mDirty[slot] = 1;
+}
+
+uint32_t TransformHierarchy::GetParent(uint32_t node) const
+{
+	return mHandleParent[node];
+}
+
+void TransformHierarchy::SetLocal(uint32_t node, FXMMATRIX local)
+{
+	const uint32_t slot = mHandleSlot[node];
+	XMFLOAT4X4A value;
+	XMStoreFloat4x4A(&value, local);
+	if (memcmp(&value, &mLocal[slot], sizeof(value)) == 0) return;
+	mLocal[slot] = value;
+	mDirty[slot] = 1;
+}
+
+XMMATRIX TransformHierarchy::GetWorld(uint32_t node) const
+{
+	return XMLoadFloat4x4A(&mWorld[mHandleSlot[node]]);
+}
+
+void TransformHierarchy::Update()
+{
+	if (mOrderDirty) Sort();
+
+	// Dirty flags first, scalar: a node is dirty when it or its parent is. Parents come first, so one pass
+	// covers whole subtrees. The slots to compose are collected in order for the batch below.
+	mChanged.clear();
+	const size_t count = mLocal.size();
+	for (size_t slot = 0; slot < count; ++slot)
+	{
+		const uint32_t parentSlot = mParentSlot[slot];
+		if (parentSlot != InvalidNode && mDirty[parentSlot]) mDirty[slot] = 1;
+		if (mDirty[slot]) mChanged.push_back(static_cast<uint32_t>(slot));
+	}
+
+	// Composition over the collected slots: aligned loads and DirectXMath's SIMD multiply, no branches on the flags.
+	for (uint32_t slot : mChanged)
+	{
+		const uint32_t parentSlot = mParentSlot[slot];
+		XMMATRIX world = XMLoadFloat4x4A(&mLocal[slot]);
+		if (parentSlot != InvalidNode) world = XMMatrixMultiply(world, XMLoadFloat4x4A(&mWorld[parentSlot]));
+		XMStoreFloat4x4A(&mWorld[slot], world);
+		mDirty[slot] = 0;
+	}
+	for (uint32_t& slot : mChanged) slot = mSlotHandle[slot];
+}
+
+const std::vector<uint32_t>& TransformHierarchy::GetChangedNodes() const
+{
+	return mChanged;
+}
+
+size_t TransformHierarchy::GetNodeCount() const
+{
+	return mHandleSlot.size() - mFreeHandles.size() - mRemovedHandles.size();
+}
+
+void TransformHierarchy::Sort()
+{
+	// Children of every live node, listed in current slot order so the new order is stable.
+	const size_t oldCount = mLocal.size();
+	std::vector<uint32_t> childStart(mHandleSlot.size() + 1, 0);
+	std::vector<uint32_t> children;
+	for (size_t slot = 0; slot < oldCount; ++slot)
+	{
+		const uint32_t handle = mSlotHandle[slot];
+		if (handle == InvalidNode) continue;
+		uint32_t& parent = mHandleParent[handle];
+		if (parent != InvalidNode && mHandleSlot[parent] == InvalidNode)
+		{
+			parent = InvalidNode; // orphaned by RemoveNode
+			mDirty[slot] = 1;
+		}
+		if (parent != InvalidNode) ++childStart[parent + 1];
+	}
+	for (size_t i = 1; i < childStart.size(); ++i) childStart[i] += childStart[i - 1];
+	children.resize(childStart.back());
+	std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+	for (size_t slot = 0; slot < oldCount; ++slot)
+	{
+		const uint32_t handle = mSlotHandle[slot];
+		if (handle == InvalidNode || mHandleParent[handle] == InvalidNode) continue;
+		children[fill[mHandleParent[handle]]++] = handle;
+	}
+
+	// Breadth-first from each root. Nodes left over sit on a parent cycle; the first of them becomes a root.
+	std::vector<uint32_t> order;
+	std::vector<uint8_t> placed(mHandleSlot.size(), 0);
+	auto placeTree = [&](uint32_t root) {
+		size_t next = order.size();
+		order.push_back(root);
+		placed[root] = 1;
+		for (; next < order.size(); ++next)
+		{
+			const uint32_t handle = order[next];
+			for (uint32_t i = childStart[handle]; i < childStart[handle + 1]; ++i)
+			{
+				if (placed[children[i]]) continue;
+				placed[children[i]] = 1;
+				order.push_back(children[i]);
+			}
+		}
+	};
+	for (size_t slot = 0; slot < oldCount; ++slot)
+	{
+		const uint32_t handle = mSlotHandle[slot];
+		if (handle != InvalidNode && mHandleParent[handle] == InvalidNode) placeTree(handle);
+	}
+	for (size_t slot = 0; slot < oldCount; ++slot)
+	{
+		const uint32_t handle = mSlotHandle[slot];
+		if (handle == InvalidNode || placed[handle]) continue;
+		mHandleParent[handle] = InvalidNode;
+		mDirty[slot] = 1;
+		placeTree(handle);
+	}
+
+	std::vector<XMFLOAT4X4A> local(order.size());
+	std::vector<XMFLOAT4X4A> world(order.size());
+	std::vector<uint8_t> dirty(order.size());
+	for (size_t slot = 0; slot < order.size(); ++slot)
+	{
+		const uint32_t oldSlot = mHandleSlot[order[slot]];
+		local[slot] = mLocal[oldSlot];
+		world[slot] = mWorld[oldSlot];
+		dirty[slot] = mDirty[oldSlot];
+	}
+	for (size_t slot = 0; slot < order.size(); ++slot) mHandleSlot[order[slot]] = static_cast<uint32_t>(slot);
+	mParentSlot.resize(order.size());
+	for (size_t slot = 0; slot < order.size(); ++slot)
+	{
+		const uint32_t parent = mHandleParent[order[slot]];
+		mParentSlot[slot] = parent == InvalidNode ? InvalidNode : mHandleSlot[parent];
+	}
+	mLocal.swap(local);
+	mWorld.swap(world);
+	mDirty.swap(dirty);
+	mSlotHandle.swap(order);
+
+	mFreeHandles.insert(mFreeHandles.end(), mRemovedHandles.begin(), mRemovedHandles.end());
+	mRemovedHandles.clear();
+	mOrderDirty = false;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+// World matrices for a forest of transforms. Nodes live in flat arrays kept sorted parents-first,
+// so one forward pass composes world = local * parentWorld with every parent already final.
+// Only nodes whose local matrix changed, and their descendants, are recomputed; a node that never
+// moves costs nothing after its first update. Handles stay valid while the arrays are reordered.
+class TransformHierarchy
+{
+public:
+	static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+	uint32_t AddNode(uint32_t parent = InvalidNode);
+	// Children of a removed node become roots. Handles are reused only after the next Update.
+	void RemoveNode(uint32_t node);
+	void Clear();
+	void SetParent(uint32_t node, uint32_t parent);
+	uint32_t GetParent(uint32_t node) const;
+
+	// Marks the node dirty only when the matrix differs from the stored one. Different nodes may be set
+	// from different threads at once, as long as nothing adds, removes or reparents nodes meanwhile.
+	void SetLocal(uint32_t node, DirectX::FXMMATRIX local);
+	DirectX::XMMATRIX GetWorld(uint32_t node) const;
+
+	// Re-sorts if the structure changed, then composes the dirty nodes and their descendants.
+	void Update();
+	// Nodes whose world matrix changed in the last Update, parents before children.
+	const std::vector<uint32_t>& GetChangedNodes() const;
+	size_t GetNodeCount() const;
+
+private:
+	void Sort();
+
+	// Indexed by slot, in parents-first order.
+	std::vector<DirectX::XMFLOAT4X4A> mLocal;
+	std::vector<DirectX::XMFLOAT4X4A> mWorld;
+	std::vector<uint32_t> mParentSlot; // InvalidNode for roots, always smaller than the node's own slot
+	std::vector<uint8_t> mDirty;
+	std::vector<uint32_t> mSlotHandle;
+
+	// Indexed by handle.
+	std::vector<uint32_t> mHandleSlot;   // InvalidNode once removed
+	std::vector<uint32_t> mHandleParent; // parent handle
+	std::vector<uint32_t> mFreeHandles;
+	std::vector<uint32_t> mRemovedHandles; // freed at the next Update
+
+	std::vector<uint32_t> mChanged;
+	bool mOrderDirty = false;
+};
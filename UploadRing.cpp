@@ -0,0 +1,55 @@
+#include "UploadRing.h"
+
+UploadRing::UploadRing(uint64_t size) : mSize{ size }
+{
+}
+
+uint64_t UploadRing::Allocate(uint64_t size, uint64_t alignment)
+{
+	if (size == 0 || size > mSize) return InvalidOffset;
+	if (alignment == 0) alignment = 1;
+
+	if (mUsed == 0) mHead = 0;
+
+	uint64_t aligned = (mHead + alignment - 1) & ~(alignment - 1);
+	uint64_t padding = aligned - mHead;
+	if (aligned + size > mSize)
+	{
+		// Copies need contiguous memory, skip the tail and restart at 0.
+		padding = mSize - mHead;
+		aligned = 0;
+	}
+	if (mUsed + padding + size > mSize) return InvalidOffset;
+
+	mHead = aligned + size;
+	if (mHead == mSize) mHead = 0;
+	mUsed += padding + size;
+	mBatchUsed += padding + size;
+	return aligned;
+}
+
+void UploadRing::FinishBatch(uint64_t fenceValue)
+{
+	if (mBatchUsed == 0) return;
+	mBatches.push_back({ fenceValue, mBatchUsed });
+	mBatchUsed = 0;
+}
+
+void UploadRing::Retire(uint64_t completedFenceValue)
+{
+	while (!mBatches.empty() && mBatches.front().fenceValue <= completedFenceValue)
+	{
+		mUsed -= mBatches.front().used;
+		mBatches.pop_front();
+	}
+}
+
+uint64_t UploadRing::GetSize() const
+{
+	return mSize;
+}
+
+uint64_t UploadRing::GetUsed() const
+{
+	return mUsed;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+// Byte ring over one persistently mapped upload buffer. Allocations are tagged with the
+// fence value of the batch that reads them and come back once that fence has completed,
+// so the same staging memory is reused instead of keeping one upload buffer per resource.
+// Pure bookkeeping, no D3D12 calls.
+class UploadRing
+{
+public:
+	static const uint64_t InvalidOffset = UINT64_MAX;
+
+	UploadRing(uint64_t size = 0);
+
+	// Returns the offset of size bytes aligned to alignment (a power of two), or InvalidOffset
+	// when the ring is full until older batches retire.
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+	void FinishBatch(uint64_t fenceValue);
+	void Retire(uint64_t completedFenceValue);
+
+	uint64_t GetSize() const;
+	uint64_t GetUsed() const;
+
+private:
+	struct BatchMarker
+	{
+		uint64_t fenceValue;
+		uint64_t used;
+	};
+
+	uint64_t mSize = 0;
+	uint64_t mHead = 0;
+	uint64_t mUsed = 0;
+	uint64_t mBatchUsed = 0;
+	std::deque<BatchMarker> mBatches;
+};
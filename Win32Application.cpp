@@ -62,8 +62,17 @@ LRESULT CALLBACK Win32Application::WindowProc(HWND hWnd, UINT message, WPARAM wP
     case WM_MOUSEMOVE:
         if (pSample)
         {
-            pSample->GetScene(pSample->GetCurrentSceneName()).GetObj<CameraObject>()->OnMouseInput(
-                wParam, pSample->GetWin32App().GetHwnd());
+            //  wnd  ǥ ˾ƿ´. Ŀ Ϳ  ŭ ī޶  ٽ ͷ ű.
+            RECT clientRect{};
+            GetWindowRect(hWnd, &clientRect);
+            int centerX = clientRect.left + int(clientRect.right - clientRect.left) / 2;
+            int centerY = clientRect.top + int(clientRect.bottom - clientRect.top) / 2;
+
+            POINT currentMousePos;
+            GetCursorPos(&currentMousePos);
+            pSample->GetScene(pSample->GetCurrentSceneName()).GetObj<CameraObject>()->OnMouseMove(
+                static_cast<float>(currentMousePos.x - centerX), static_cast<float>(currentMousePos.y - centerY));
+            SetCursorPos(centerX, centerY);
         }
         break;
 
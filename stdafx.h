@@ -18,18 +18,10 @@
 #include <DirectXMath.h>
 #include "d3dx12.h"
 
-#include <string>
 #include <wrl.h>
 
-#include <unordered_map>
-#include <vector>
-#include <array>
-
 #include "include/fbxsdk.h"
 #include "DDSTextureLoader12.h"
+#include "CoreTypes.h"
 
-using namespace std;
-using namespace DirectX;
 using Microsoft::WRL::ComPtr;
-
-template<typename T> using ptr = T*;